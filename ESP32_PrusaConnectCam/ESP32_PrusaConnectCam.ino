@@ -75,6 +75,11 @@ void setup() {
   Serial.setDebugOutput(true);
 #endif
 
+#if (true == TRACE_ENABLE)
+  /* init span tracing buffer */
+  SystemTrace.Init();
+#endif
+
   /* Init EEPROM */
   EEPROM.begin(EEPROM_SIZE);
 
@@ -83,6 +88,7 @@ void setup() {
 
   /* init micro SD card and logs */
   SystemLog.SetLogLevel((LogLevel_enum)EEPROM.read(EEPROM_ADDR_LOG_LEVEL));
+  SystemLog.SetBus4Bit(1 == EEPROM.read(EEPROM_ADDR_SD_BUS_4BIT_START));
   SystemLog.Init();
 
   /* init System lib */
@@ -102,24 +108,36 @@ void setup() {
 
   /* init camera interface */
   SystemCamera.Init();
-  SystemCamera.CapturePhoto();
+  SystemPhotoStore.Release(SystemCamera.CapturePhoto());
 
   /* init WEB server */
   Server_InitWebServer();
 
+  /* init offline snapshot queue */
+  SystemSnapshotQueue.Init();
+
+  /* init thumbnail of the last photo */
+  SystemThumbnail.Init();
+
   /* init class for communication with PrusaConnect */
   Connect.Init();
 
+  /* init print failure heuristic */
+  SystemFrameAnalysis.Init();
+
+  /* init motion triggered burst capture */
+  SystemMotion.Init();
+
+  /* per-core load measurement */
+  System_CoreLoadInit();
+
   /* init tasks */
   SystemLog.AddEvent(LogLevel_Info, "Start tasks");
-  xTaskCreatePinnedToCore(System_TaskMain, "SystemNtpOtaUpdate", 8000, NULL, 1, &Task_SystemMain, 0);                           /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskCaptureAndSendPhoto, "CaptureAndSendPhoto", 10000, NULL, 2, &Task_CapturePhotoAndSend, 0); /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskWifiManagement, "WiFiManagement", 6000, NULL, 3, &Task_WiFiManagement, 0);                 /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskSdCardCheck, "CheckMicroSdCard", 5000, NULL, 4, &Task_SdCardCheck, 0);                     /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskSerialCfg, "CheckSerialConfiguration", 3000, NULL, 5, &Task_SerialCfg, 0);                 /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskStreamTelemetry, "PrintStreamTelemetry", 3000, NULL, 6, &Task_StreamTelemetry, 0);         /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskSysLed, "SystemLed", 3000, NULL, 7, &Task_SysLed, 0);                                      /*function, description, stack size, parameters, priority, task handle, core*/
-  xTaskCreatePinnedToCore(System_TaskWiFiWatchdog, "WiFiWatchdog", 3000, NULL, 8, &Task_WiFiWatchdog, 0);                       /*function, description, stack size, parameters, priority, task handle, core*/
+  xTaskCreatePinnedToCore(System_TaskMain, "SystemNtpOtaUpdate", 8000, NULL, 1, &Task_SystemMain, TASK_CORE_SYSTEM);                           /*function, description, stack size, parameters, priority, task handle, core*/
+  xTaskCreatePinnedToCore(System_TaskCaptureAndSendPhoto, "CaptureAndSendPhoto", 10000, NULL, 2, &Task_CapturePhotoAndSend, TASK_CORE_PHOTO);  /*function, description, stack size, parameters, priority, task handle, core*/
+  xTaskCreatePinnedToCore(System_TaskWifiManagement, "WiFiManagement", 6000, NULL, 3, &Task_WiFiManagement, TASK_CORE_WIFI);                   /*function, description, stack size, parameters, priority, task handle, core*/
+  xTaskCreatePinnedToCore(System_TaskService, "Service", 6000, NULL, 4, &Task_Service, TASK_CORE_SERVICE);                                      /*function, description, stack size, parameters, priority, task handle, core*/
+  xTaskCreatePinnedToCore(System_TaskFrameAnalysis, "FrameAnalysis", ANALYSIS_STACK_SIZE, NULL, ANALYSIS_PRIORITY, &Task_FrameAnalysis, TASK_CORE_ANALYSIS); /*function, description, stack size, parameters, priority, task handle, core*/
 
   /* init wdg */
   SystemLog.AddEvent(LogLevel_Info, "Init WDG");
@@ -128,11 +146,7 @@ void setup() {
   esp_task_wdt_add(Task_CapturePhotoAndSend);
   esp_task_wdt_add(Task_WiFiManagement);
   esp_task_wdt_add(Task_SystemMain);
-  esp_task_wdt_add(Task_SdCardCheck);
-  esp_task_wdt_add(Task_SerialCfg);
-  esp_task_wdt_add(Task_StreamTelemetry);
-  esp_task_wdt_add(Task_SysLed);
-  esp_task_wdt_add(Task_WiFiWatchdog);
+  esp_task_wdt_add(Task_Service);
   esp_task_wdt_reset(); /* reset wdg */
 
   SystemLog.AddEvent(LogLevel_Info, "MCU configuration done");
@@ -141,6 +155,9 @@ void setup() {
 void loop() {
   /* reset wdg */
   esp_task_wdt_reset();
+
+  /* release core 1 for capture and upload task */
+  delay(LOOP_DELAY);
 }
 
 /* EOF */
\ No newline at end of file
@@ -66,7 +66,7 @@ const char index_html[] PROGMEM = R"rawliteral(
 	<section class="container">
 		<div  class="container_left-half">
 			<article>
-				<img src="saved-photo.jpg" id="photo"  width="60%" onclick="openImage()"/>
+				<img src="thumb.jpg" id="photo"  width="60%" onclick="openImage()" onerror="if (this.src.indexOf('saved-photo.jpg') < 0) { this.src = 'saved-photo.jpg'; }"/>
 			</article>
 		</div>
 		<div class="container_right-half">
@@ -298,6 +298,7 @@ const char page_system_html[] PROGMEM = R"rawliteral(
             <tr><td class="ps1">Wi-Fi mode</td><td class="ps2" id="wifi_mode"></td></tr>
 			<tr><td class="ps1">Wi-Fi service AP SSID</td><td class="ps2" id="service_ap_ssid"></td></tr>
             <tr><td class="ps1">Uptime</td><td class="ps2" id="uptime"></td></tr>
+            <tr><td class="ps1">Micro SD card</td><td class="ps2" id="sd_health"></td></tr>
             <tr><td class="ps1">Software version</td><td class="ps2" id="sw_ver"></td></tr>
 			<tr><td class="ps1">Software build</td><td class="ps2" id="sw_build"></td></tr>
 			<tr><td class="ps1">Available software update</td><td class="ps2"><span id="sw_new_ver"></span> <span class="underlined-text" onclick="checkUpdate()">Check update from cloud</span></td></tr>
@@ -932,6 +933,7 @@ function get_data(val) {
 
 			if (val == "system") {
 				$("#uptime").text(obj.uptime);
+				$("#sd_health").text(obj.sd_health);
 				$("#sw_ver").text(obj.sw_ver);
 				$("#sw_build").text(obj.sw_build);
 				$("#last_upload_status").text(obj.last_upload_status);
@@ -984,6 +986,8 @@ var OpenImageclickCount = 0;
 function openImage() {
 	var img = document.getElementById("photo");
 	if (OpenImageclickCount % 2 == 0) {
+		/* preview is the thumbnail, full resolution photo is loaded only for the enlarged view */
+		img.src = "saved-photo.jpg";
 		img.style.position = "fixed";
 		img.style.top = "5%";
 		img.style.left = "5%";
@@ -999,6 +1003,7 @@ function openImage() {
 		img.style.width = "";
 		img.style.height = "";
 		img.style.zIndex = "";
+		img.src = "thumb.jpg";
 	}
 	OpenImageclickCount++;
 }
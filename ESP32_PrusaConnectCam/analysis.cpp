@@ -0,0 +1,475 @@
+/**
+   @file analysis.cpp
+
+   @brief Print failure heuristic. Frame difference and texture analysis of the captured photos
+
+   Captured photo is referenced from the photo store and decoded in the own low priority task to the downscaled grayscale frame.
+   Frame is compared with the rolling background model in the regions of interest:
+   - change: mean absolute difference between frame and background. Detached print, moved object
+   - texture: increase of the mean gradient over background. Spaghetti, stringing
+   Event is raised, when is threshold crossed in ANALYSIS_CONFIRM_FRAMES consecutive frames.
+   When is analysis busy, next photo is skipped. Capture and upload are never blocked.
+   Thumbnail of the photo is created in the same task, also when is analysis disabled.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "analysis.h"
+
+FrameAnalysis SystemFrameAnalysis(&SystemConfig, &SystemLog);
+
+/**
+ * @brief AnalysisDecode struct
+ * context of the JPEG decoder callbacks
+ */
+struct AnalysisDecode {
+  const uint8_t *Data;  ///< JPEG data
+  size_t Length;        ///< length of JPEG data
+  uint8_t *Gray;        ///< output grayscale frame
+  uint16_t Width;       ///< width of the output frame
+  uint16_t Height;      ///< height of the output frame
+};
+
+/**
+ * @brief JPEG decoder input callback
+ *
+ * @param void* - decode context
+ * @param size_t - index of the data
+ * @param uint8_t* - output buffer, NULL = skip data
+ * @param size_t - length of requested data
+ * @return size_t - count of bytes
+ */
+static size_t Analysis_JpegReader(void *arg, size_t index, uint8_t *buf, size_t len) {
+  AnalysisDecode *decode = (AnalysisDecode *)arg;
+
+  if (index >= decode->Length) {
+    return 0;
+  }
+  if ((index + len) > decode->Length) {
+    len = decode->Length - index;
+  }
+  if (NULL != buf) {
+    memcpy(buf, decode->Data + index, len);
+  }
+
+  return len;
+}
+
+/**
+ * @brief JPEG decoder output callback. RGB888 block is converted to grayscale
+ *
+ * @param void* - decode context
+ * @param uint16_t - x position of the block
+ * @param uint16_t - y position of the block
+ * @param uint16_t - width of the block
+ * @param uint16_t - height of the block
+ * @param uint8_t* - RGB888 data, NULL = start or end of the image
+ * @return bool - false stops decoding
+ */
+static bool Analysis_JpegWriter(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  AnalysisDecode *decode = (AnalysisDecode *)arg;
+
+  if (NULL == data) {
+    /* start of the image, size of the output */
+    if ((0 == x) && (0 == y)) {
+      if ((w > ANALYSIS_MAX_WIDTH) || (h > ANALYSIS_MAX_HEIGHT)) {
+        return false;
+      }
+      decode->Width = w;
+      decode->Height = h;
+    }
+    return true;
+  }
+
+  if (((x + w) > decode->Width) || ((y + h) > decode->Height)) {
+    return false;
+  }
+
+  /* luminance approximation, independent of the RGB/BGR order */
+  for (uint16_t iy = 0; iy < h; iy++) {
+    uint8_t *out = &decode->Gray[((y + iy) * decode->Width) + x];
+    for (uint16_t ix = 0; ix < w; ix++) {
+      out[ix] = (data[0] + (2 * data[1]) + data[2]) >> 2;
+      data += 3;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Construct a new FrameAnalysis::FrameAnalysis object
+ *
+ * @param Configuration* - pointer to Configuration class
+ * @param Logs* - pointer to Logs class
+ */
+FrameAnalysis::FrameAnalysis(Configuration *i_conf, Logs *i_log) {
+  config = i_conf;
+  log = i_log;
+  Enable = false;
+  memset(Roi, 0, sizeof(Roi));
+  memset(Result, 0, sizeof(Result));
+  Frame = NULL;
+  Gray = NULL;
+  Background = NULL;
+  Width = 0;
+  Height = 0;
+  BackgroundFrames = 0;
+  Busy = false;
+  Frames = 0;
+  Skipped = 0;
+  Errors = 0;
+  Events = 0;
+  TimeLast = 0;
+  TimeMax = 0;
+  LastEventTime = 0;
+  Lock = xSemaphoreCreateMutex();
+}
+
+/**
+ * @brief Load configuration and allocate frame buffers in PSRAM
+ *
+ */
+void FrameAnalysis::Init() {
+  Enable = config->LoadAnalysisEnable();
+  for (uint8_t i = 0; i < ANALYSIS_MAX_ROI; i++) {
+    Roi[i] = config->LoadAnalysisRoi(i);
+  }
+
+  Gray = (uint8_t *)heap_caps_malloc(ANALYSIS_MAX_WIDTH * ANALYSIS_MAX_HEIGHT, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  Background = (uint16_t *)heap_caps_malloc(ANALYSIS_MAX_WIDTH * ANALYSIS_MAX_HEIGHT * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if ((NULL == Gray) || (NULL == Background)) {
+    log->AddEvent(LogLevel_Error, "Frame analysis: not enough memory");
+    Enable = false;
+  }
+}
+
+/**
+ * @brief Take reference to the photo for thumbnail and analysis and wake up analysis task. Photo is skipped, when is analysis busy
+ *
+ * @param PhotoFrame* - referenced photo from the photo store
+ */
+void FrameAnalysis::Submit(PhotoFrame *i_frame) {
+  if ((NULL == Task_FrameAnalysis) || (NULL == i_frame) || (0 == i_frame->Len)) {
+    return;
+  }
+
+  if (true == Busy) {
+    if (true == Enable) {
+      Skipped++;
+    }
+    return;
+  }
+
+  SystemPhotoStore.Retain(i_frame);
+  Frame = i_frame;
+  Busy = true;
+  xTaskNotifyGive(Task_FrameAnalysis);
+}
+
+/**
+ * @brief Thumbnail and analysis of the submitted photo. Called from the analysis task
+ *
+ */
+void FrameAnalysis::Process() {
+  if (false == Busy) {
+    return;
+  }
+
+  /* thumbnail is created out of the capture and upload path */
+  SystemThumbnail.Create(Frame->Buf, Frame->Len, Frame->Width);
+  if ((false == Enable) || (NULL == Gray)) {
+    SystemPhotoStore.Release(Frame);
+    Frame = NULL;
+    Busy = false;
+    return;
+  }
+
+  int64_t start = esp_timer_get_time();
+
+  /* gray frame is used only by the analysis task, decoding is done without lock. WEB server is not blocked by the decoder */
+  uint16_t width = 0;
+  uint16_t height = 0;
+  bool decoded = Decode(&width, &height);
+  SystemPhotoStore.Release(Frame);
+  Frame = NULL;
+
+  Update(decoded, width, height);
+  TimeLast = (uint32_t)(esp_timer_get_time() - start);
+  TimeMax = max(TimeMax, TimeLast);
+  Busy = false;
+}
+
+/**
+ * @brief Decode photo to the downscaled grayscale frame. Scale is selected by the photo width
+ *
+ * @param uint16_t* - width of the decoded frame [px]
+ * @param uint16_t* - height of the decoded frame [px]
+ * @return bool - true if photo was decoded
+ */
+bool FrameAnalysis::Decode(uint16_t *o_width, uint16_t *o_height) {
+  jpg_scale_t scale = JPG_SCALE_8X;
+  if (Frame->Width <= ANALYSIS_MAX_WIDTH) {
+    scale = JPG_SCALE_NONE;
+  } else if (Frame->Width <= (ANALYSIS_MAX_WIDTH * 2)) {
+    scale = JPG_SCALE_2X;
+  } else if (Frame->Width <= (ANALYSIS_MAX_WIDTH * 4)) {
+    scale = JPG_SCALE_4X;
+  }
+
+  AnalysisDecode decode;
+  decode.Data = Frame->Buf;
+  decode.Length = Frame->Len;
+  decode.Gray = Gray;
+  decode.Width = 0;
+  decode.Height = 0;
+
+  if (ESP_OK != esp_jpg_decode(Frame->Len, scale, Analysis_JpegReader, Analysis_JpegWriter, &decode)) {
+    return false;
+  }
+
+  *o_width = decode.Width;
+  *o_height = decode.Height;
+  return true;
+}
+
+/**
+ * @brief Update metrics and background model by the decoded gray frame. Results are read by WEB server, lock is taken
+ *
+ * @param bool - true if photo was decoded
+ * @param uint16_t - width of the gray frame [px]
+ * @param uint16_t - height of the gray frame [px]
+ */
+void FrameAnalysis::Update(bool i_decoded, uint16_t i_width, uint16_t i_height) {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+
+  if (true == i_decoded) {
+    /* new resolution, background model is not valid */
+    if ((i_width != Width) || (i_height != Height)) {
+      Width = i_width;
+      Height = i_height;
+      BackgroundFrames = 0;
+      memset(Result, 0, sizeof(Result));
+    }
+
+    if (BackgroundFrames >= ANALYSIS_WARMUP_FRAMES) {
+      UpdateMetrics();
+    }
+    UpdateBackground();
+    Frames++;
+  } else {
+    Errors++;
+  }
+
+  xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief Compute change and texture metrics in the regions of interest and raise events
+ *
+ */
+void FrameAnalysis::UpdateMetrics() {
+  for (uint8_t i = 0; i < ANALYSIS_MAX_ROI; i++) {
+    AnalysisRoiResult *result = &Result[i];
+    uint16_t x0 = ((uint32_t)Roi[i].X * Width) / 100;
+    uint16_t y0 = ((uint32_t)Roi[i].Y * Height) / 100;
+    uint16_t x1 = min((uint32_t)Width, ((uint32_t)(Roi[i].X + Roi[i].Width) * Width) / 100);
+    uint16_t y1 = min((uint32_t)Height, ((uint32_t)(Roi[i].Y + Roi[i].Height) * Height) / 100);
+
+    /* gradient needs one pixel on the right and bottom side */
+    if ((x1 < 2) || (y1 < 2) || ((x0 + 2) > x1) || ((y0 + 2) > y1)) {
+      memset(result, 0, sizeof(AnalysisRoiResult));
+      continue;
+    }
+    x1--;
+    y1--;
+
+    uint32_t change = 0;
+    uint32_t texture = 0;
+    uint32_t texture_bg = 0;
+    for (uint16_t y = y0; y < y1; y++) {
+      const uint8_t *g = &Gray[y * Width];
+      const uint16_t *b = &Background[y * Width];
+      for (uint16_t x = x0; x < x1; x++) {
+        change += abs((int)g[x] - (int)(b[x] >> 4));
+        texture += abs((int)g[x + 1] - (int)g[x]) + abs((int)g[x + Width] - (int)g[x]);
+        texture_bg += abs((int)(b[x + 1] >> 4) - (int)(b[x] >> 4)) + abs((int)(b[x + Width] >> 4) - (int)(b[x] >> 4));
+      }
+    }
+
+    uint32_t count = (uint32_t)(x1 - x0) * (y1 - y0);
+    result->Change = min(change / count, (uint32_t)255);
+    result->Texture = min(texture / count, (uint32_t)255);
+    result->TextureBackground = min(texture_bg / count, (uint32_t)255);
+
+    bool over = ((Roi[i].ChangeThreshold > 0) && (result->Change >= Roi[i].ChangeThreshold)) ||
+                ((Roi[i].TextureThreshold > 0) && (result->Texture >= (result->TextureBackground + Roi[i].TextureThreshold)));
+
+    if (false == over) {
+      result->Confirm = 0;
+      result->Alarm = false;
+    } else if (result->Confirm < ANALYSIS_CONFIRM_FRAMES) {
+      result->Confirm++;
+      if (ANALYSIS_CONFIRM_FRAMES == result->Confirm) {
+        result->Alarm = true;
+        Events++;
+        LastEventTime = millis();
+        log->AddEvent(LogLevel_Warning, "Frame analysis: event in ROI " + String(i) + ", change: " + String(result->Change) +
+                                          ", texture: " + String(result->Texture) + "/" + String(result->TextureBackground));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Update rolling background model by the actual frame
+ *
+ */
+void FrameAnalysis::UpdateBackground() {
+  uint32_t count = (uint32_t)Width * Height;
+
+  if (0 == BackgroundFrames) {
+    for (uint32_t i = 0; i < count; i++) {
+      Background[i] = (uint16_t)Gray[i] << 4;
+    }
+  } else {
+    for (uint32_t i = 0; i < count; i++) {
+      int32_t diff = ((int32_t)Gray[i] << 4) - (int32_t)Background[i];
+      Background[i] = (uint16_t)((int32_t)Background[i] + (diff / ANALYSIS_BACKGROUND_WEIGHT));
+    }
+  }
+
+  BackgroundFrames++;
+}
+
+/**
+ * @brief Reset background model. Model is created from the next frames
+ *
+ */
+void FrameAnalysis::ResetBackground() {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  BackgroundFrames = 0;
+  memset(Result, 0, sizeof(Result));
+  xSemaphoreGive(Lock);
+  log->AddEvent(LogLevel_Info, "Frame analysis: background reset");
+}
+
+/**
+ * @brief Enable/disable analysis
+ *
+ * @param bool - status
+ */
+void FrameAnalysis::SetEnable(bool i_data) {
+  if ((true == i_data) && ((NULL == Gray) || (NULL == Background))) {
+    log->AddEvent(LogLevel_Error, "Frame analysis: not enough memory");
+    return;
+  }
+
+  Enable = i_data;
+  config->SaveAnalysisEnable(Enable);
+  if (true == Enable) {
+    ResetBackground();
+  }
+}
+
+/**
+ * @brief Get status of the analysis
+ *
+ * @return bool - status
+ */
+bool FrameAnalysis::GetEnable() {
+  return Enable;
+}
+
+/**
+ * @brief Set region of interest. Position and size are in percent of the frame
+ *
+ * @param uint8_t - index of the region
+ * @param AnalysisRoi_struct - region
+ * @return bool - true if region is valid
+ */
+bool FrameAnalysis::SetRoi(uint8_t i_id, AnalysisRoi_struct i_roi) {
+  if ((i_id >= ANALYSIS_MAX_ROI) || ((i_roi.X + i_roi.Width) > 100) || ((i_roi.Y + i_roi.Height) > 100)) {
+    return false;
+  }
+
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  Roi[i_id] = i_roi;
+  memset(&Result[i_id], 0, sizeof(AnalysisRoiResult));
+  xSemaphoreGive(Lock);
+  config->SaveAnalysisRoi(i_id, i_roi);
+
+  return true;
+}
+
+/**
+ * @brief Get alarm state of the analysis
+ *
+ * @return bool - true if is any region in alarm state
+ */
+bool FrameAnalysis::GetAlarm() {
+  for (uint8_t i = 0; i < ANALYSIS_MAX_ROI; i++) {
+    if (true == Result[i].Alarm) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Get count of raised events
+ *
+ * @return uint32_t - count
+ */
+uint32_t FrameAnalysis::GetEvents() {
+  return Events;
+}
+
+/**
+ * @brief Get configuration, metrics and statistics of the analysis in json format
+ *
+ * @return String - json
+ */
+String FrameAnalysis::GetJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  doc_json["enable"] = Enable;
+  doc_json["alarm"] = GetAlarm();
+  doc_json["events"] = Events;
+  doc_json["last_event_s"] = (Events > 0) ? ((millis() - LastEventTime) / 1000) : 0;
+  doc_json["width"] = Width;
+  doc_json["height"] = Height;
+  doc_json["background_frames"] = BackgroundFrames;
+  doc_json["frames"] = Frames;
+  doc_json["skipped"] = Skipped;
+  doc_json["errors"] = Errors;
+  doc_json["time_last_us"] = TimeLast;
+  doc_json["time_max_us"] = TimeMax;
+
+  JsonArray rois = doc_json["roi"].to<JsonArray>();
+  for (uint8_t i = 0; i < ANALYSIS_MAX_ROI; i++) {
+    JsonObject roi = rois.add<JsonObject>();
+    roi["x"] = Roi[i].X;
+    roi["y"] = Roi[i].Y;
+    roi["w"] = Roi[i].Width;
+    roi["h"] = Roi[i].Height;
+    roi["change_threshold"] = Roi[i].ChangeThreshold;
+    roi["texture_threshold"] = Roi[i].TextureThreshold;
+    roi["change"] = Result[i].Change;
+    roi["texture"] = Result[i].Texture;
+    roi["texture_background"] = Result[i].TextureBackground;
+    roi["alarm"] = Result[i].Alarm;
+  }
+  xSemaphoreGive(Lock);
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/* EOF */
@@ -0,0 +1,94 @@
+/**
+   @file analysis.h
+
+   @brief Print failure heuristic. Frame difference and texture analysis of the captured photos
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _ANALYSIS_H_
+#define _ANALYSIS_H_
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "esp_jpg_decode.h"
+#include <esp_heap_caps.h>
+#include <ArduinoJson.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+#include "cfg.h"
+#include "photo_store.h"
+#include "thumbnail.h"
+
+/**
+ * @brief AnalysisRoiResult struct
+ * metrics of the region of interest from the last analyzed frame
+ */
+struct AnalysisRoiResult {
+  uint8_t Change;             ///< mean absolute difference between frame and background, 0-255
+  uint8_t Texture;            ///< mean absolute gradient of the frame, 0-255
+  uint8_t TextureBackground;  ///< mean absolute gradient of the background, 0-255
+  uint8_t Confirm;            ///< count of consecutive frames over threshold
+  bool Alarm;                 ///< region is in alarm state
+};
+
+class FrameAnalysis {
+private:
+  bool Enable;                                  ///< enable/disable analysis
+  AnalysisRoi_struct Roi[ANALYSIS_MAX_ROI];     ///< regions of interest
+  AnalysisRoiResult Result[ANALYSIS_MAX_ROI];   ///< metrics of the regions of interest
+
+  PhotoFrame *Frame;          ///< referenced photo waiting for analysis
+  uint8_t *Gray;              ///< downscaled grayscale frame, PSRAM
+  uint16_t *Background;       ///< background model, grayscale << 4, PSRAM
+  uint16_t Width;             ///< width of the downscaled frame [px]
+  uint16_t Height;            ///< height of the downscaled frame [px]
+  uint32_t BackgroundFrames;  ///< count of frames in the background model
+  volatile bool Busy;         ///< photo is waiting for analysis or analysis is running
+
+  uint32_t Frames;            ///< count of analyzed frames
+  uint32_t Skipped;           ///< count of frames skipped, because analysis was busy
+  uint32_t Errors;            ///< count of failed decodes
+  uint32_t Events;            ///< count of raised events
+  uint32_t TimeLast;          ///< time of the last analysis [us]
+  uint32_t TimeMax;           ///< maximum time of the analysis [us]
+  uint32_t LastEventTime;     ///< time of the last event [ms]
+
+  SemaphoreHandle_t Lock;     ///< mutex, analysis runs in own task, configuration and results are read by WEB server
+  Configuration *config;      ///< pointer to configuration object
+  Logs *log;                  ///< pointer to logs object
+
+  bool Decode(uint16_t *, uint16_t *);
+  void Update(bool, uint16_t, uint16_t);
+  void UpdateMetrics();
+  void UpdateBackground();
+
+  friend class FrameAnalysisTest;   ///< host test feeds decoded gray frames to Update
+
+public:
+  FrameAnalysis(Configuration *, Logs *);
+  ~FrameAnalysis(){};
+
+  void Init();
+  void Submit(PhotoFrame *);
+  void Process();
+  void ResetBackground();
+
+  void SetEnable(bool);
+  bool GetEnable();
+  bool SetRoi(uint8_t, AnalysisRoi_struct);
+  bool GetAlarm();
+  uint32_t GetEvents();
+  String GetJson();
+};
+
+extern FrameAnalysis SystemFrameAnalysis;  ///< global variable for frame analysis
+
+#endif
+
+/* EOF */
@@ -23,8 +23,14 @@ Camera::Camera(Configuration* i_conf, Logs* i_log, uint8_t i_FlashPin) {
   config = i_conf;
   log = i_log;
   CameraFlashPin = i_FlashPin;
-  StreamOnOff = false;
+  StreamClients = 0;
+  StreamLock = portMUX_INITIALIZER_UNLOCKED;
   frameBufferSemaphore = xSemaphoreCreateMutex();
+#if (true == STREAM_SYNTHETIC_SOURCE)
+  memset(SyntheticFrames, 0, sizeof(SyntheticFrames));
+  SyntheticFrameCount = 0;
+  SyntheticFrameIndex = 0;
+#endif
 }
 
 /**
@@ -36,12 +42,22 @@ void Camera::Init() {
   log->AddEvent(LogLevel_Info, "Init camera lib");
 
   log->AddEvent(LogLevel_Info, "Init GPIO");
-  ledcSetup(FLASH_PWM_CHANNEL, FLASH_PWM_FREQ, FLASH_PWM_RESOLUTION);
-  ledcAttachPin(FLASH_GPIO_NUM, FLASH_PWM_CHANNEL);
-  ledcWrite(FLASH_PWM_CHANNEL, FLASH_OFF_STATUS);
+  if (true == log->GetBus4Bit()) {
+    /* GPIO 4 is data line D1 of the micro SD card */
+    log->AddEvent(LogLevel_Warning, "Micro SD card in 4-bit mode, flash LED is disabled");
+  } else {
+    ledcSetup(FLASH_PWM_CHANNEL, FLASH_PWM_FREQ, FLASH_PWM_RESOLUTION);
+    ledcAttachPin(FLASH_GPIO_NUM, FLASH_PWM_CHANNEL);
+    ledcWrite(FLASH_PWM_CHANNEL, FLASH_OFF_STATUS);
+  }
 
   InitCameraModule();
   ApplyCameraCfg();
+
+#if (true == STREAM_SYNTHETIC_SOURCE)
+  /* frames are loaded before the first stream, file access is not done from the stream response */
+  LoadSyntheticFrames();
+#endif
 }
 
 /**
@@ -138,6 +154,9 @@ void Camera::LoadCameraCfgFromEeprom() {
   exposure_ctrl = config->LoadExposureCtrl();
   CameraFlashEnable = config->LoadCameraFlashEnable();
   CameraFlashTime = config->LoadCameraFlashTime();
+  if (true == log->GetBus4Bit()) {
+    CameraFlashEnable = false;
+  }
 }
 
 /**
@@ -184,6 +203,10 @@ framesize_t Camera::TransformFrameSizeDataType(uint8_t i_data) {
    @return none
 */
 void Camera::SetFlashStatus(bool i_data) {
+  if (true == log->GetBus4Bit()) {
+    return;
+  }
+
   if (true == i_data) {
     ledcWrite(FLASH_PWM_CHANNEL, FLASH_ON_STATUS);
   } else if (false == i_data) {
@@ -255,12 +278,15 @@ void Camera::ReinitCameraModule() {
 }
 
 /**
-   @brief Capture Photo and Save it to string array
+   @brief Capture Photo and publish it to the photo store. Camera frame buffer is returned to the driver
    @param none
-   @return none
+   @return PhotoFrame * - published photo with reference of the caller, NULL if photo was not captured or store is full.
+                          Reference has to be released by SystemPhotoStore.Release
 */
-void Camera::CapturePhoto() {
-  if (false == StreamOnOff) {
+PhotoFrame *Camera::CapturePhoto() {
+  TRACE_SCOPE("Camera::CapturePhoto");
+  PhotoFrame *published = NULL;
+  if (false == GetStreamStatus()) {
     if (xSemaphoreTake(frameBufferSemaphore, portMAX_DELAY)) {
       
       /* check flash, and enable FLASH LED */
@@ -270,39 +296,58 @@ void Camera::CapturePhoto() {
       }
 
       /* get train photo */
-      FrameBuffer = esp_camera_fb_get();
-      esp_camera_fb_return(FrameBuffer);
+      camera_fb_t *photo = esp_camera_fb_get();
+      if (photo) {
+        esp_camera_fb_return(photo);
+      }
 
+      bool valid = false;
       do {
         log->AddEvent(LogLevel_Info, "Taking photo...");
 
         /* capture final photo */
-        FrameBuffer = esp_camera_fb_get();
-        if (!FrameBuffer) {
+        TRACE_BEGIN("esp_camera_fb_get");
+        photo = esp_camera_fb_get();
+        TRACE_END("esp_camera_fb_get");
+        if (!photo) {
           log->AddEvent(LogLevel_Error, "Camera capture failed! photo");
-          return;
+          break;
 
         } else {
-          /* copy photo from buffer to string array */
           char buf[150] = { '\0' };
-          uint8_t ControlFlag = (uint8_t)FrameBuffer->buf[15];
-          sprintf(buf, "The picture has been saved. Size: %d bytes, Photo resolution: %zu x %zu", FrameBuffer->len, FrameBuffer->width, FrameBuffer->height);
+          uint8_t ControlFlag = (uint8_t)photo->buf[15];
+          sprintf(buf, "The picture has been saved. Size: %d bytes, Photo resolution: %zu x %zu", photo->len, photo->width, photo->height);
           log->AddEvent(LogLevel_Info, buf);
 
           /* check corrupted photo */
           if (ControlFlag != 0x00) {
             log->AddEvent(LogLevel_Error, "Camera capture failed! photo " + String(ControlFlag, HEX));
-            FrameBuffer->len = 0;
 
-          } else {
+          } else if (photo->len > 100) {
             log->AddEvent(LogLevel_Info, "Photo OK! " + String(ControlFlag, HEX));
+
+            /* copy photo from camera buffer to the photo store. Readers of the previous photo are not affected.
+               When is the store full, photo is dropped and next capture does not help, photo is not captured again */
+            PhotoFrame *frame = SystemPhotoStore.Allocate(photo->len);
+            if (NULL != frame) {
+              memcpy(frame->Buf, photo->buf, photo->len);
+              frame->Len = photo->len;
+              frame->Width = photo->width;
+              frame->Height = photo->height;
+
+              /* reference from Allocate is passed to the store, caller gets own reference */
+              SystemPhotoStore.Retain(frame);
+              SystemPhotoStore.Publish(frame);
+              published = frame;
+            }
+            valid = true;
           }
 
-          esp_camera_fb_return(FrameBuffer);
+          esp_camera_fb_return(photo);
         }
 
-        /* check if photo is correctly saved */
-      } while (!(FrameBuffer->len > 100));
+        /* check if photo is correctly captured */
+      } while (false == valid);
 
       /* Disable flash */
       if (true == CameraFlashEnable) {
@@ -312,57 +357,194 @@ void Camera::CapturePhoto() {
       xSemaphoreGive(frameBufferSemaphore);
     }
   }
+
+  return published;
 }
 
 /**
-   @brief Capture Stream
-   @param camera_fb_t * - pointer to camera_fb_t
-   @return none
+   @brief Capture Stream. Every stream client holds own frame buffer
+   @param none
+   @return camera_fb_t * - frame buffer, returned by CaptureReturnFrameBuffer. NULL = capture failed
 */
-void Camera::CaptureStream(camera_fb_t* i_buf) {
+camera_fb_t *Camera::CaptureStream() {
+  TRACE_SCOPE("Camera::CaptureStream");
+  camera_fb_t *fb = NULL;
   if (xSemaphoreTake(frameBufferSemaphore, portMAX_DELAY)) {
     do {
+      /* incomplete frame is returned to the driver */
+      CaptureReturnFrameBuffer(fb);
+
       /* capture final photo */
-      FrameBuffer = esp_camera_fb_get();
-      if (!FrameBuffer) {
+      TRACE_BEGIN("esp_camera_fb_get");
+#if (true == STREAM_SYNTHETIC_SOURCE)
+      fb = GetSyntheticFrame();
+#else
+      fb = esp_camera_fb_get();
+#endif
+      TRACE_END("esp_camera_fb_get");
+      if (NULL == fb) {
         log->AddEvent(LogLevel_Error, "Camera capture failed! stream");
-        i_buf = NULL;
-        return;
+        break;
       }
 
       /* check if photo is correctly saved */
-    } while (!(FrameBuffer->len > 100));
-    *i_buf = *FrameBuffer;
+    } while (!(fb->len > 100));
     xSemaphoreGive(frameBufferSemaphore);
   }
+
+  return fb;
 }
 
 /**
    @brief Capture Return Frame Buffer
+   @param camera_fb_t * - frame buffer from CaptureStream, NULL is ignored
+   @return none
+*/
+void Camera::CaptureReturnFrameBuffer(camera_fb_t *i_fb) {
+  if (NULL == i_fb) {
+    return;
+  }
+#if (true == STREAM_SYNTHETIC_SOURCE)
+  /* synthetic frames are owned by camera library */
+  if ((i_fb >= &SyntheticFrames[0]) && (i_fb < &SyntheticFrames[STREAM_SYNTHETIC_MAX_FRAMES])) {
+    return;
+  }
+#endif
+  esp_camera_fb_return(i_fb);
+}
+
+/**
+   @brief Capture sample frame for the motion trigger. Without flash and without change of the last photo.
+          Stale frame from the driver is discarded. Camera is locked until CaptureSampleReturn
    @param none
+   @return camera_fb_t * - frame, NULL if stream is running or capture failed
+*/
+camera_fb_t *Camera::CaptureSample() {
+  if (true == GetStreamStatus()) {
+    return NULL;
+  }
+
+  if (pdTRUE != xSemaphoreTake(frameBufferSemaphore, 0)) {
+    return NULL;
+  }
+
+  /* get train frame. Frame buffer was filled after the last return and can be old, sample must be current */
+  camera_fb_t *fb = esp_camera_fb_get();
+  if (NULL != fb) {
+    esp_camera_fb_return(fb);
+  }
+
+  fb = esp_camera_fb_get();
+  if (NULL == fb) {
+    xSemaphoreGive(frameBufferSemaphore);
+  }
+
+  return fb;
+}
+
+/**
+   @brief Return sample frame and unlock camera
+   @param camera_fb_t * - frame from CaptureSample
    @return none
 */
-void Camera::CaptureReturnFrameBuffer() {
-  esp_camera_fb_return(FrameBuffer);
+void Camera::CaptureSampleReturn(camera_fb_t *i_fb) {
+  esp_camera_fb_return(i_fb);
+  xSemaphoreGive(frameBufferSemaphore);
+}
+
+#if (true == STREAM_SYNTHETIC_SOURCE)
+/**
+   @brief Load JPEG frames from the micro SD card to the PSRAM. Frames are replayed in the stream instead of camera module
+   @param none
+   @return none
+*/
+void Camera::LoadSyntheticFrames() {
+  if (false == log->GetCardDetectedStatus()) {
+    log->AddEvent(LogLevel_Error, "Synthetic source: micro SD card not detected");
+    return;
+  }
+
+  File dir = SD_MMC.open(STREAM_SYNTHETIC_PATH);
+  if ((!dir) || (!dir.isDirectory())) {
+    log->AddEvent(LogLevel_Error, "Synthetic source: directory " + String(STREAM_SYNTHETIC_PATH) + " not found");
+    return;
+  }
+
+  File file = dir.openNextFile();
+  while (file && (SyntheticFrameCount < STREAM_SYNTHETIC_MAX_FRAMES)) {
+    String name = file.name();
+    name.toLowerCase();
+    if ((false == file.isDirectory()) && (name.endsWith(".jpg") || name.endsWith(".jpeg"))) {
+      size_t len = file.size();
+      uint8_t *buf = (uint8_t *)ps_malloc(len);
+      if (NULL == buf) {
+        log->AddEvent(LogLevel_Warning, "Synthetic source: not enough memory for " + name);
+        file.close();
+        break;
+      }
+
+      if (file.read(buf, len) == len) {
+        camera_fb_t *frame = &SyntheticFrames[SyntheticFrameCount];
+        frame->buf = buf;
+        frame->len = len;
+        frame->width = GetFrameSizeWidth();
+        frame->height = GetFrameSizeHeight();
+        frame->format = PIXFORMAT_JPEG;
+        SyntheticFrameCount++;
+      } else {
+        free(buf);
+      }
+    }
+    file.close();
+    file = dir.openNextFile();
+  }
+  dir.close();
+
+  log->AddEvent(LogLevel_Info, "Synthetic source: loaded frames " + String(SyntheticFrameCount));
+}
+
+/**
+   @brief Get next frame from synthetic source. Frames are replayed in the loop
+   @param none
+   @return camera_fb_t* - frame, NULL when no frame is available
+*/
+camera_fb_t *Camera::GetSyntheticFrame() {
+  if (0 == SyntheticFrameCount) {
+    return NULL;
+  }
+
+  camera_fb_t *frame = &SyntheticFrames[SyntheticFrameIndex];
+  SyntheticFrameIndex = (SyntheticFrameIndex + 1) % SyntheticFrameCount;
+  gettimeofday(&frame->timestamp, NULL);
+
+  return frame;
 }
+#endif
 
 /**
-   @brief Set Stream Status
-   @param bool - true = on, false = off
+   @brief Set Stream Status. Every stream client is counted, stream is on until the last client is disconnected
+   @param bool - true = client connected, false = client disconnected
    @return none
 */
 void Camera::SetStreamStatus(bool i_status) {
-  StreamOnOff = i_status;
-  log->AddEvent(LogLevel_Info, "Camera video stream: " + String(StreamOnOff));
+  portENTER_CRITICAL(&StreamLock);
+  if (true == i_status) {
+    StreamClients++;
+  } else if (StreamClients > 0) {
+    StreamClients--;
+  }
+  uint8_t clients = StreamClients;
+  portEXIT_CRITICAL(&StreamLock);
+  log->AddEvent(LogLevel_Info, "Camera video stream clients: " + String(clients));
 }
 
 /**
    @brief Get Stream Status
    @param none
-   @return bool - true = on, false = off
+   @return bool - true = on, at least one stream client is connected
 */
 bool Camera::GetStreamStatus() {
-  return StreamOnOff;
+  return (StreamClients > 0);
 }
 
 /**
@@ -411,74 +593,6 @@ void Camera::StreamClearFrameData() {
   StreamAverageSize = 0;
 }
 
-/**
-   @brief Get Photo
-   @param none
-   @return String - photo
-*/
-String Camera::GetPhoto() {
-  Photo = "";
-  for (size_t i = 0; i < FrameBuffer->len; i++) {
-    Photo += (char)FrameBuffer->buf[i];
-  }
-  return Photo;
-}
-
-/**
-   @brief Get Photo Frame Buffer
-   @param none
-   @return camera_fb_t* - photo frame buffer
-*/
-camera_fb_t* Camera::GetPhotoFb() {
-  return FrameBuffer;
-}
-
-/**
-   @brief Copy Photo
-   @param camera_fb_t* - pointer to camera_fb_t
-   @return none
-*/
-void Camera::CopyPhoto(camera_fb_t* i_data) {
-  *i_data = *FrameBuffer;
-}
-
-/**
-   @brief Copy Photo
-   @param String* - pointer to string
-   @return none
-*/
-void Camera::CopyPhoto(String* i_data) {
-  Photo = "";
-  for (size_t i = 0; i < FrameBuffer->len; i++) {
-    Photo += (char)FrameBuffer->buf[i];
-  }
-  *i_data = Photo;
-}
-
-/**
- * @brief Copy photo from frame buffer to string array with range
- * 
- * @param i_data - pointer to string 
- * @param i_from - start index
- * @param i_to - end index
- */
-void Camera::CopyPhoto(String* i_data, int i_from, int i_to) {
-  Photo = "";
-  for (size_t i = i_from; i < i_to; i++) {
-    Photo += (char)FrameBuffer->buf[i];
-  }
-  *i_data = Photo;
-}
-
-/**
- * @brief Get Photo Size
- * 
- * @return int - photo size
- */
-int Camera::GetPhotoSize() {
-  return FrameBuffer->len;
-}
-
 /**
    @brief Set Photo Quality
    @param uint8_t - photo quality
@@ -707,7 +821,7 @@ void Camera::SetExposureCtrl(bool i_data) {
 */
 void Camera::SetCameraFlashEnable(bool i_data) {
   config->SaveCameraFlashEnable(i_data);
-  CameraFlashEnable = i_data;
+  CameraFlashEnable = (true == log->GetBus4Bit()) ? false : i_data;
 }
 
 /**
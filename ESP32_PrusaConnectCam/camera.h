@@ -24,6 +24,7 @@
 #include "mcu_cfg.h"
 #include "var.h"
 #include "log.h"
+#include "photo_store.h"
 
 class Camera {
 private:
@@ -54,9 +55,8 @@ private:
 
   /* OV2640 camera module pinout and cfg*/
   camera_config_t CameraConfig;             ///< camera configuration
-  camera_fb_t *FrameBuffer;                 ///< frame buffer
-  String Photo;                             ///< photo in string format
-  bool StreamOnOff;                         ///< stream on/off
+  uint8_t StreamClients;                    ///< count of active stream clients
+  portMUX_TYPE StreamLock;                  ///< lock for count of stream clients
   SemaphoreHandle_t frameBufferSemaphore;   ///< semaphore for frame buffer
   float StreamAverageFps;                   ///< stream average fps
   uint16_t StreamAverageSize;               ///< stream average size
@@ -66,6 +66,15 @@ private:
 
   void InitCameraModule();
 
+#if (true == STREAM_SYNTHETIC_SOURCE)
+  camera_fb_t SyntheticFrames[STREAM_SYNTHETIC_MAX_FRAMES];   ///< frames loaded from micro SD card
+  uint8_t SyntheticFrameCount;                                ///< count of loaded frames
+  uint8_t SyntheticFrameIndex;                                ///< next replayed frame
+
+  void LoadSyntheticFrames();
+  camera_fb_t *GetSyntheticFrame();
+#endif
+
 public:
   Camera(Configuration*, Logs*, uint8_t);
   ~Camera(){};
@@ -73,9 +82,11 @@ public:
   void ApplyCameraCfg();
   void LoadCameraCfgFromEeprom();
   void ReinitCameraModule();
-  void CapturePhoto();
-  void CaptureStream(camera_fb_t *);
-  void CaptureReturnFrameBuffer();
+  PhotoFrame *CapturePhoto();
+  camera_fb_t *CaptureStream();
+  void CaptureReturnFrameBuffer(camera_fb_t *);
+  camera_fb_t *CaptureSample();
+  void CaptureSampleReturn(camera_fb_t *);
   void SetStreamStatus(bool);
   bool GetStreamStatus();
 
@@ -84,13 +95,7 @@ public:
   uint16_t StreamGetFrameAverageSize();
   float StreamGetFrameAverageFps();
   void StreamClearFrameData();
-  
-  void CopyPhoto(camera_fb_t *);
-  void CopyPhoto(String*);
-  void CopyPhoto(String*, int, int);
-  int GetPhotoSize();
-  String GetPhoto();
-  camera_fb_t *GetPhotoFb();
+
   framesize_t TransformFrameSizeDataType(uint8_t);
   
   void SetFlashStatus(bool);
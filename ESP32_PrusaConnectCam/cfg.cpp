@@ -40,8 +40,12 @@ void Configuration::Init() {
     Log->SetLogLevel(LoadLogLevel());
   }
 
-  /* set reset pin */
-  pinMode(CFG_RESET_PIN, INPUT_PULLUP);
+  /* set reset pin. GPIO 12 is data line D2 of the micro SD card in 4-bit mode */
+  if (true == Log->GetBus4Bit()) {
+    Log->AddEvent(LogLevel_Warning, "Micro SD card in 4-bit mode, reset cfg pin is disabled");
+  } else {
+    pinMode(CFG_RESET_PIN, INPUT_PULLUP);
+  }
 }
 
 /**
@@ -83,6 +87,14 @@ void Configuration::ReadCfg() {
   LoadGainCtrl();
   LoadAgcGain();
   LoadPrusaConnectHostname();
+  LoadWifiFastConnect();
+  LoadWifiCacheChannel();
+  LoadWifiPowerProfile();
+  LoadSnapshotQueueEnable();
+  LoadSdBus4Bit();
+  LoadAnalysisEnable();
+  LoadMotionEnable();
+  LoadMotionThreshold();
   Log->AddEvent(LogLevel_Info, "Active WiFi client cfg: " + String(CheckActifeWifiCfgFlag() ? "true" : "false"));
   Log->AddEvent(LogLevel_Info, "Load CFG from EEPROM done");
 }
@@ -160,6 +172,23 @@ void Configuration::DefaultCfg() {
   SaveAgcGain(FACTORY_CFG_AGC_GAIN);
   SaveLogLevel(LogLevel_Info);
   SavePrusaConnectHostname(FACTORY_CFG_HOSTNAME);
+  SaveWifiFastConnect(FACTORY_CFG_WIFI_FAST_CONNECT);
+  SaveWifiCacheChannel(0);
+  SaveWifiCacheLease(0);
+  SaveWifiPowerProfile(FACTORY_CFG_WIFI_POWER_PROFILE);
+  SaveSnapshotQueueEnable(FACTORY_CFG_SNAPSHOT_QUEUE);
+  SaveSdBus4Bit(FACTORY_CFG_SD_BUS_4BIT);
+  SaveAnalysisEnable(FACTORY_CFG_ANALYSIS);
+  for (uint8_t i = 0; i < ANALYSIS_MAX_ROI; i++) {
+    /* first region is the full frame, other regions are disabled */
+    AnalysisRoi_struct roi = { 0, 0, 0, 0, 0, 0 };
+    if (0 == i) {
+      roi = { 0, 0, 100, 100, FACTORY_CFG_ANALYSIS_CHANGE, FACTORY_CFG_ANALYSIS_TEXTURE };
+    }
+    SaveAnalysisRoi(i, roi);
+  }
+  SaveMotionEnable(FACTORY_CFG_MOTION);
+  SaveMotionThreshold(FACTORY_CFG_MOTION_THRESHOLD);
   Log->AddEvent(LogLevel_Warning, "+++++++++++++++++++++++++++");
 }
 
@@ -187,6 +216,12 @@ bool Configuration::CheckActifeWifiCfgFlag() {
    @return none
 */
 void Configuration::CheckResetCfg() {
+  /* reset pin is used by the micro SD card in 4-bit mode, card would be detected as grounded pin */
+  if (true == Log->GetBus4Bit()) {
+    Log->AddEvent(LogLevel_Verbose, "Check reset MCU cfg skipped, micro SD card in 4-bit mode");
+    return;
+  }
+
   Log->AddEvent(LogLevel_Verbose, "Check reset MCU cfg");
   bool ResetPinStatus = digitalRead(CFG_RESET_PIN);
 
@@ -311,6 +346,19 @@ void Configuration::SaveString(uint16_t address, uint16_t max_length, String dat
     Log->AddEvent(LogLevel_Verbose, "Skip write string");
   }
 }
+/**
+   @info Function for save IP address to EEPROM
+   @param uint16_t data address
+   @param IPAddress data
+   @return none
+*/
+void Configuration::SaveIpAddress(uint16_t address, IPAddress data) {
+  for (uint8_t i = 0; i < 4; i++) {
+    EEPROM.write(address + i, data[i]);
+  }
+  EEPROM.commit();
+}
+
 /**
    @info Function for read uint16_t data from EEPROM
    @param uint16_t fist byte address
@@ -320,6 +368,16 @@ uint16_t Configuration::LoadUint16(uint16_t address) {
   uint16_t tmp = uint16_t(EEPROM.read(address) << 8) | (EEPROM.read(address + 1));
   return tmp;
 }
+/**
+   @info Function for read IP address from EEPROM
+   @param uint16_t fist byte address
+   @return IPAddress data
+*/
+IPAddress Configuration::LoadIpAddress(uint16_t address) {
+  IPAddress tmp(EEPROM.read(address), EEPROM.read(address + 1), EEPROM.read(address + 2), EEPROM.read(address + 3));
+  return tmp;
+}
+
 /**
    @info Function for load string from EEPROM
    @param uint16_t data address
@@ -692,6 +750,175 @@ void Configuration::SavePrusaConnectHostname(String i_data) {
   SaveString(EEPROM_ADDR_HOSTNAME_START, EEPROM_ADDR_HOSTNAME_LENGTH, i_data);
 }
 
+/**
+ * @info Save enable/disable WiFi fast connect
+ * @param bool - value
+ * @return none
+*/
+void Configuration::SaveWifiFastConnect(bool i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi fast connect: " + String(i_data));
+  SaveBool(EEPROM_ADDR_WIFI_FAST_CONNECT_START, i_data);
+}
+
+/**
+ * @info Save BSSID of the last connected WiFi network
+ * @param const uint8_t * - BSSID, 6 bytes
+ * @return none
+*/
+void Configuration::SaveWifiCacheBssid(const uint8_t *i_data) {
+  char mac[18] = { 0 };
+  sprintf(mac, "%02X:%02X:%02X:%02X:%02X:%02X", i_data[0], i_data[1], i_data[2], i_data[3], i_data[4], i_data[5]);
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache BSSID: " + String(mac));
+  for (uint8_t i = 0; i < EEPROM_ADDR_WIFI_CACHE_BSSID_LENGTH; i++) {
+    EEPROM.write(EEPROM_ADDR_WIFI_CACHE_BSSID_START + i, i_data[i]);
+  }
+  EEPROM.commit();
+}
+
+/**
+ * @info Save channel of the last connected WiFi network. 0 = cache is invalid
+ * @param uint8_t - channel
+ * @return none
+*/
+void Configuration::SaveWifiCacheChannel(uint8_t i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache channel: " + String(i_data));
+  SaveUint8(EEPROM_ADDR_WIFI_CACHE_CHANNEL_START, i_data);
+}
+
+/**
+ * @info Save IP address of the last DHCP lease
+ * @param IPAddress - IP address
+ * @return none
+*/
+void Configuration::SaveWifiCacheIp(IPAddress i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache IP: " + i_data.toString());
+  SaveIpAddress(EEPROM_ADDR_WIFI_CACHE_IP_START, i_data);
+}
+
+/**
+ * @info Save network mask of the last DHCP lease
+ * @param IPAddress - mask
+ * @return none
+*/
+void Configuration::SaveWifiCacheMask(IPAddress i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache mask: " + i_data.toString());
+  SaveIpAddress(EEPROM_ADDR_WIFI_CACHE_MASK_START, i_data);
+}
+
+/**
+ * @info Save gateway of the last DHCP lease
+ * @param IPAddress - gateway
+ * @return none
+*/
+void Configuration::SaveWifiCacheGateway(IPAddress i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache gateway: " + i_data.toString());
+  SaveIpAddress(EEPROM_ADDR_WIFI_CACHE_GATEWAY_START, i_data);
+}
+
+/**
+ * @info Save DNS of the last DHCP lease
+ * @param IPAddress - DNS
+ * @return none
+*/
+void Configuration::SaveWifiCacheDns(IPAddress i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache DNS: " + i_data.toString());
+  SaveIpAddress(EEPROM_ADDR_WIFI_CACHE_DNS_START, i_data);
+}
+
+/**
+ * @info Save expiration of the last DHCP lease
+ * @param uint32_t - expiration time, UTC [s]. 0 = unknown
+ * @return none
+*/
+void Configuration::SaveWifiCacheLease(uint32_t i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi cache lease: " + String(i_data));
+  for (uint8_t i = 0; i < EEPROM_ADDR_WIFI_CACHE_LEASE_LENGTH; i++) {
+    EEPROM.write(EEPROM_ADDR_WIFI_CACHE_LEASE_START + i, (uint8_t)(i_data >> (8 * (EEPROM_ADDR_WIFI_CACHE_LEASE_LENGTH - 1 - i))));
+  }
+  EEPROM.commit();
+}
+
+/**
+ * @info Save WiFi power profile
+ * @param uint8_t - power profile
+ * @return none
+*/
+void Configuration::SaveWifiPowerProfile(uint8_t i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save WiFi power profile: " + String(i_data));
+  SaveUint8(EEPROM_ADDR_WIFI_POWER_PROFILE_START, i_data);
+}
+
+/**
+ * @info Save enable/disable offline snapshot queue
+ * @param bool - value
+ * @return none
+*/
+void Configuration::SaveSnapshotQueueEnable(bool i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save snapshot queue: " + String(i_data));
+  SaveBool(EEPROM_ADDR_SNAPSHOT_QUEUE_START, i_data);
+}
+
+/**
+ * @info Save micro SD card bus width. Change is applied after reboot
+ * @param bool - true = 4-bit mode, false = 1-bit mode
+ * @return none
+*/
+void Configuration::SaveSdBus4Bit(bool i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save SD card 4-bit mode: " + String(i_data));
+  SaveBool(EEPROM_ADDR_SD_BUS_4BIT_START, i_data);
+}
+
+/**
+ * @info Save enable/disable print failure heuristic
+ * @param bool - value
+ * @return none
+*/
+void Configuration::SaveAnalysisEnable(bool i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save frame analysis: " + String(i_data));
+  SaveBool(EEPROM_ADDR_ANALYSIS_ENABLE_START, i_data);
+}
+
+/**
+ * @info Save region of interest of the frame analysis
+ * @param uint8_t - index of the region
+ * @param AnalysisRoi_struct - region
+ * @return none
+*/
+void Configuration::SaveAnalysisRoi(uint8_t i_id, AnalysisRoi_struct i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save frame analysis ROI " + String(i_id) + ": " + String(i_data.X) + "," + String(i_data.Y) + "," +
+                                    String(i_data.Width) + "," + String(i_data.Height) + ", thresholds: " + String(i_data.ChangeThreshold) + "," +
+                                    String(i_data.TextureThreshold));
+  uint16_t address = EEPROM_ADDR_ANALYSIS_ROI_START + (i_id * EEPROM_ADDR_ANALYSIS_ROI_SIZE);
+  EEPROM.write(address, i_data.X);
+  EEPROM.write(address + 1, i_data.Y);
+  EEPROM.write(address + 2, i_data.Width);
+  EEPROM.write(address + 3, i_data.Height);
+  EEPROM.write(address + 4, i_data.ChangeThreshold);
+  EEPROM.write(address + 5, i_data.TextureThreshold);
+  EEPROM.commit();
+}
+
+/**
+ * @info Save enable/disable motion triggered burst capture
+ * @param bool - value
+ * @return none
+*/
+void Configuration::SaveMotionEnable(bool i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save motion trigger: " + String(i_data));
+  SaveBool(EEPROM_ADDR_MOTION_ENABLE_START, i_data);
+}
+
+/**
+ * @info Save threshold of the motion trigger
+ * @param uint8_t - minimum change of the cell luminance
+ * @return none
+*/
+void Configuration::SaveMotionThreshold(uint8_t i_data) {
+  Log->AddEvent(LogLevel_Verbose, "Save motion threshold: " + String(i_data));
+  EEPROM.write(EEPROM_ADDR_MOTION_THRESHOLD_START, i_data);
+  EEPROM.commit();
+}
+
 /**
    @info load refresh interval from eeprom 
    @param none
@@ -1087,4 +1314,209 @@ String Configuration::LoadPrusaConnectHostname() {
   return ret;
 }
 
+/**
+ * @brief Load enable/disable WiFi fast connect from EEPROM
+ * 
+ * @return bool - status
+ */
+bool Configuration::LoadWifiFastConnect() {
+  bool ret = EEPROM.read(EEPROM_ADDR_WIFI_FAST_CONNECT_START);
+  Log->AddEvent(LogLevel_Info, "WiFi fast connect: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load BSSID of the last connected WiFi network from EEPROM
+ * 
+ * @param uint8_t * - output buffer, 6 bytes
+ */
+void Configuration::LoadWifiCacheBssid(uint8_t *o_data) {
+  for (uint8_t i = 0; i < EEPROM_ADDR_WIFI_CACHE_BSSID_LENGTH; i++) {
+    o_data[i] = EEPROM.read(EEPROM_ADDR_WIFI_CACHE_BSSID_START + i);
+  }
+}
+
+/**
+ * @brief Load channel of the last connected WiFi network from EEPROM
+ * 
+ * @return uint8_t - channel
+ */
+uint8_t Configuration::LoadWifiCacheChannel() {
+  uint8_t ret = EEPROM.read(EEPROM_ADDR_WIFI_CACHE_CHANNEL_START);
+  Log->AddEvent(LogLevel_Info, "WiFi cache channel: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load IP address of the last DHCP lease from EEPROM
+ * 
+ * @return IPAddress - IP address
+ */
+IPAddress Configuration::LoadWifiCacheIp() {
+  return LoadIpAddress(EEPROM_ADDR_WIFI_CACHE_IP_START);
+}
+
+/**
+ * @brief Load network mask of the last DHCP lease from EEPROM
+ * 
+ * @return IPAddress - mask
+ */
+IPAddress Configuration::LoadWifiCacheMask() {
+  return LoadIpAddress(EEPROM_ADDR_WIFI_CACHE_MASK_START);
+}
+
+/**
+ * @brief Load gateway of the last DHCP lease from EEPROM
+ * 
+ * @return IPAddress - gateway
+ */
+IPAddress Configuration::LoadWifiCacheGateway() {
+  return LoadIpAddress(EEPROM_ADDR_WIFI_CACHE_GATEWAY_START);
+}
+
+/**
+ * @brief Load DNS of the last DHCP lease from EEPROM
+ * 
+ * @return IPAddress - DNS
+ */
+IPAddress Configuration::LoadWifiCacheDns() {
+  return LoadIpAddress(EEPROM_ADDR_WIFI_CACHE_DNS_START);
+}
+
+/**
+ * @brief Load expiration of the last DHCP lease from EEPROM
+ * 
+ * @return uint32_t - expiration time, UTC [s]. 0 = unknown
+ */
+uint32_t Configuration::LoadWifiCacheLease() {
+  uint32_t ret = 0;
+  for (uint8_t i = 0; i < EEPROM_ADDR_WIFI_CACHE_LEASE_LENGTH; i++) {
+    ret = (ret << 8) | EEPROM.read(EEPROM_ADDR_WIFI_CACHE_LEASE_START + i);
+  }
+
+  /* erased EEPROM after FW update */
+  if (0xFFFFFFFF == ret) {
+    ret = 0;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Load WiFi power profile from EEPROM
+ * 
+ * @return uint8_t - power profile
+ */
+uint8_t Configuration::LoadWifiPowerProfile() {
+  uint8_t ret = EEPROM.read(EEPROM_ADDR_WIFI_POWER_PROFILE_START);
+
+  /* erased EEPROM after FW update */
+  if (ret > 2) {
+    ret = FACTORY_CFG_WIFI_POWER_PROFILE;
+  }
+  Log->AddEvent(LogLevel_Info, "WiFi power profile: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load enable/disable offline snapshot queue from EEPROM
+ * 
+ * @return bool - status
+ */
+bool Configuration::LoadSnapshotQueueEnable() {
+  /* erased EEPROM after FW update is 0xFF, queue is disabled */
+  bool ret = (1 == EEPROM.read(EEPROM_ADDR_SNAPSHOT_QUEUE_START));
+  Log->AddEvent(LogLevel_Info, "Snapshot queue: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load micro SD card bus width from EEPROM
+ * 
+ * @return bool - true = 4-bit mode, false = 1-bit mode
+ */
+bool Configuration::LoadSdBus4Bit() {
+  /* erased EEPROM after FW update is 0xFF, 1-bit mode is used */
+  bool ret = (1 == EEPROM.read(EEPROM_ADDR_SD_BUS_4BIT_START));
+  Log->AddEvent(LogLevel_Info, "SD card 4-bit mode: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load enable/disable print failure heuristic from EEPROM
+ * 
+ * @return bool - status
+ */
+bool Configuration::LoadAnalysisEnable() {
+  /* erased EEPROM after FW update is 0xFF, analysis is disabled */
+  bool ret = (1 == EEPROM.read(EEPROM_ADDR_ANALYSIS_ENABLE_START));
+  Log->AddEvent(LogLevel_Info, "Frame analysis: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load region of interest of the frame analysis from EEPROM
+ * 
+ * @param uint8_t - index of the region
+ * @return AnalysisRoi_struct - region. Invalid region is disabled
+ */
+AnalysisRoi_struct Configuration::LoadAnalysisRoi(uint8_t i_id) {
+  uint16_t address = EEPROM_ADDR_ANALYSIS_ROI_START + (i_id * EEPROM_ADDR_ANALYSIS_ROI_SIZE);
+  AnalysisRoi_struct ret;
+  ret.X = EEPROM.read(address);
+  ret.Y = EEPROM.read(address + 1);
+  ret.Width = EEPROM.read(address + 2);
+  ret.Height = EEPROM.read(address + 3);
+  ret.ChangeThreshold = EEPROM.read(address + 4);
+  ret.TextureThreshold = EEPROM.read(address + 5);
+
+  /* erased EEPROM after FW update is 0xFF. First region is the full frame, other regions are disabled */
+  if (((ret.X + ret.Width) > 100) || ((ret.Y + ret.Height) > 100)) {
+    ret = { 0, 0, 0, 0, 0, 0 };
+    if (0 == i_id) {
+      ret = { 0, 0, 100, 100, FACTORY_CFG_ANALYSIS_CHANGE, FACTORY_CFG_ANALYSIS_TEXTURE };
+    }
+  }
+  Log->AddEvent(LogLevel_Info, "Frame analysis ROI " + String(i_id) + ": " + String(ret.X) + "," + String(ret.Y) + "," + String(ret.Width) + "," +
+                                 String(ret.Height) + ", thresholds: " + String(ret.ChangeThreshold) + "," + String(ret.TextureThreshold));
+
+  return ret;
+}
+
+/**
+ * @brief Load enable/disable motion triggered burst capture from EEPROM
+ * 
+ * @return bool - status
+ */
+bool Configuration::LoadMotionEnable() {
+  /* erased EEPROM after FW update is 0xFF, motion trigger is disabled */
+  bool ret = (1 == EEPROM.read(EEPROM_ADDR_MOTION_ENABLE_START));
+  Log->AddEvent(LogLevel_Info, "Motion trigger: " + String(ret));
+
+  return ret;
+}
+
+/**
+ * @brief Load threshold of the motion trigger from EEPROM
+ * 
+ * @return uint8_t - minimum change of the cell luminance
+ */
+uint8_t Configuration::LoadMotionThreshold() {
+  uint8_t ret = EEPROM.read(EEPROM_ADDR_MOTION_THRESHOLD_START);
+
+  /* erased EEPROM after FW update is 0xFF */
+  if ((0 == ret) || (0xFF == ret)) {
+    ret = FACTORY_CFG_MOTION_THRESHOLD;
+  }
+  Log->AddEvent(LogLevel_Info, "Motion threshold: " + String(ret));
+
+  return ret;
+}
+
 /* EOF */
\ No newline at end of file
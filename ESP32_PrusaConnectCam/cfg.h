@@ -65,6 +65,21 @@ public:
   void SaveAgcGain(uint8_t);
   void SaveLogLevel(LogLevel_enum);
   void SavePrusaConnectHostname(String);
+  void SaveWifiFastConnect(bool);
+  void SaveWifiCacheBssid(const uint8_t *);
+  void SaveWifiCacheChannel(uint8_t);
+  void SaveWifiCacheIp(IPAddress);
+  void SaveWifiCacheMask(IPAddress);
+  void SaveWifiCacheGateway(IPAddress);
+  void SaveWifiCacheDns(IPAddress);
+  void SaveWifiCacheLease(uint32_t);
+  void SaveWifiPowerProfile(uint8_t);
+  void SaveSnapshotQueueEnable(bool);
+  void SaveSdBus4Bit(bool);
+  void SaveAnalysisEnable(bool);
+  void SaveAnalysisRoi(uint8_t, AnalysisRoi_struct);
+  void SaveMotionEnable(bool);
+  void SaveMotionThreshold(uint8_t);
 
   uint8_t LoadRefreshInterval();
   String LoadToken();
@@ -99,6 +114,21 @@ public:
   uint8_t LoadAgcGain();
   LogLevel_enum LoadLogLevel();
   String LoadPrusaConnectHostname();
+  bool LoadWifiFastConnect();
+  void LoadWifiCacheBssid(uint8_t *);
+  uint8_t LoadWifiCacheChannel();
+  IPAddress LoadWifiCacheIp();
+  IPAddress LoadWifiCacheMask();
+  IPAddress LoadWifiCacheGateway();
+  IPAddress LoadWifiCacheDns();
+  uint32_t LoadWifiCacheLease();
+  uint8_t LoadWifiPowerProfile();
+  bool LoadSnapshotQueueEnable();
+  bool LoadSdBus4Bit();
+  bool LoadAnalysisEnable();
+  AnalysisRoi_struct LoadAnalysisRoi(uint8_t);
+  bool LoadMotionEnable();
+  uint8_t LoadMotionThreshold();
 
 private:
   Logs *Log;              ///< Pointer to Logs object
@@ -115,7 +145,9 @@ private:
   void SaveBool(uint16_t, bool);
   void SaveUint16(uint16_t, uint16_t);
   void SaveString(uint16_t, uint16_t, String);
+  void SaveIpAddress(uint16_t, IPAddress);
   uint16_t LoadUint16(uint16_t);
+  IPAddress LoadIpAddress(uint16_t);
   String LoadString(uint16_t, uint16_t, bool);
 };
 
@@ -13,6 +13,9 @@
 
 PrusaConnect Connect(&SystemConfig, &SystemLog, &SystemCamera);
 
+/* upper limits of the upload latency histogram buckets [ms]. Last bucket is for longer uploads */
+static const uint32_t UploadLatencyBuckets[UPLOAD_STATS_HISTOGRAM_SIZE - 1] = { 250, 500, 1000, 2000, 4000, 8000 };
+
 /**
  * @brief Constructor for PrusaConnect class
  *
@@ -26,6 +29,20 @@ PrusaConnect::PrusaConnect(Configuration *i_conf, Logs *i_log, Camera *i_camera)
   camera = i_camera;
   BackendAvailability = WaitForFirstConnection;
   SendDeviceInformationToBackend = true;
+  SendingDeadline = 0;
+  SendingNowRequest = false;
+  SendingJitterLast = 0;
+  SendingJitterMax = 0;
+  memset(&UploadStats, 0, sizeof(UploadStats));
+  RetryErrorClass = UploadErrorNone;
+  RetryAttempt = 0;
+  RetryPending = false;
+  RetryDeadline = 0;
+  RetryDelayLast = 0;
+  ResponseCode = 0;
+  ResponseRetryAfter = 0;
+  QueueDrainDeadline = 0;
+  Photo = NULL;
 }
 
 /**
@@ -36,7 +53,7 @@ PrusaConnect::PrusaConnect(Configuration *i_conf, Logs *i_log, Camera *i_camera)
  */
 void PrusaConnect::Init() {
   log->AddEvent(LogLevel_Info, "Init PrusaConnect lib");
-  TakePicture();
+  SystemPhotoStore.Release(TakePicture());
 }
 
 /**
@@ -57,10 +74,18 @@ void PrusaConnect::LoadCfgFromEeprom() {
  * @brief take picture
  *
  * @param none
- * @return none
+ * @return PhotoFrame * - captured photo with reference of the caller, NULL if photo was not captured.
+ *                        Reference has to be released by SystemPhotoStore.Release
  */
-void PrusaConnect::TakePicture() {
-  camera->CapturePhoto();
+PhotoFrame *PrusaConnect::TakePicture() {
+  PhotoFrame *frame = camera->CapturePhoto();
+  if (NULL == frame) {
+    return NULL;
+  }
+  SystemTimelapse.AddFrame(frame->Buf, frame->Len);
+  SystemFrameAnalysis.Submit(frame);
+
+  return frame;
 }
 
 /**
@@ -75,98 +100,74 @@ void PrusaConnect::TakePicture() {
  * @return false - if data was not sent successfully
  */
 bool PrusaConnect::SendDataToBackend(String *i_data, int i_data_length, String i_content_type, String i_type, String i_url_path, SendDataToBackendType i_data_type) { 
+  TRACE_SCOPE("Connect::SendDataToBackend");
+#if (true == HOST_TLS_ENABLE)
   WiFiClientSecure client;
-  Server_pause();
+#else
+  WiFiClient client;
+#endif
   BackendReceivedStatus = "";
   bool ret = false;
   log->AddEvent(LogLevel_Info, "Sending " + i_type + " to PrusaConnect");
 
+  /* admission control. WEB server is running during upload, TLS connection needs enough internal heap */
+  if (false == System_WaitForHeapBudget(HEAP_BUDGET_TLS_FREE, HEAP_BUDGET_TLS_BLOCK, HEAP_BUDGET_TLS_WAIT)) {
+    BackendReceivedStatus = "Low memory! Upload postponed";
+    log->AddEvent(LogLevel_Warning, BackendReceivedStatus);
+    UploadStats.Postponed++;
+    return false;
+  }
+  SystemWifiMngt.SetUploadProcessing(true);
+  int64_t upload_start = esp_timer_get_time();
+  uint32_t heap_before = ESP.getFreeHeap();
+
   /* check fingerprint and token length */
   if ((Fingerprint.length() > 0) && (Token.length() > 0)) {
+#if (true == HOST_TLS_ENABLE)
     client.setCACert(root_CAs);
+#endif
     client.setTimeout(1000);
     log->AddEvent(LogLevel_Verbose, "Connecting to server...");
 
     /* connecting to server */
-    if (!client.connect(PrusaConnectHostname.c_str(), 443)) {
-      char err_buf[200];
-      int last_error = client.lastError(err_buf, sizeof(err_buf));
+    TRACE_BEGIN("TlsConnect");
+    bool connected = client.connect(PrusaConnectHostname.c_str(), HOST_PORT);
+    TRACE_END("TlsConnect");
+    uint32_t heap_connected = ESP.getFreeHeap();
+    if (!connected) {
+      char err_buf[200] = { '\0' };
+      int last_error = 0;
+#if (true == HOST_TLS_ENABLE)
+      last_error = client.lastError(err_buf, sizeof(err_buf));
+#endif
       int error = client.getWriteError();
-      if (BackendAvailability != WaitForFirstConnection) {
-        BackendAvailability = BackendUnavailable;
-      }
 
       BackendReceivedStatus = "Connetion failed to domain! Error: " + String(last_error) + " - " + String(err_buf) + " : " + String(error);
       log->AddEvent(LogLevel_Info, BackendReceivedStatus + " ,BA:" + CovertBackendAvailabilitStatusToString(BackendAvailability));
+      UpdateUploadStats(false, upload_start, 0, heap_before, heap_connected);
+
+      /* -1 = TCP connection failed, other negative values are mbedtls errors from the handshake */
+      UpdateRetryPolicy((last_error < -1) ? UploadErrorTls : UploadErrorConnect);
+      SystemWifiMngt.SetUploadProcessing(false);
       return false;
 
     } else {
       /* send data to server */
       log->AddEvent(LogLevel_Verbose, "Connected to server!");
-      client.println("PUT https://" + PrusaConnectHostname + i_url_path + " HTTP/1.0");
-      client.println("Host: " + PrusaConnectHostname);
-      client.println("User-Agent: ESP32-CAM");
-      client.println("Connection: close");
-
-      client.println("Content-Type: " + i_content_type);
-      client.println("fingerprint: " + Fingerprint);
-      client.println("token: " + Token);
-      client.print("Content-Length: ");
-      client.println(i_data_length);
-      client.println();
+      SendRequestHeader(client, i_data_length, i_content_type, i_url_path);
 
       esp_task_wdt_reset();
-      if (SendPhoto == i_data_type) {
-        log->AddEvent(LogLevel_Verbose, "Send data photo");
-        int index;
-        /* send data in fragments */
-        for (index = 0; index < i_data_length; index = index + PHOTO_FRAGMENT_SIZE) {
-          camera->CopyPhoto(i_data, index, index + PHOTO_FRAGMENT_SIZE);
-          client.print(*i_data);
-          log->AddEvent(LogLevel_Verbose, String(i_data_length) + "/" + String(index));
-        }
-
-        /* send rest of data */
-        index -= PHOTO_FRAGMENT_SIZE;
-        if((i_data_length > index) && ((i_data_length - index) > 0)) {
-          camera->CopyPhoto(i_data, index, i_data_length);
-          client.print(*i_data);
-          log->AddEvent(LogLevel_Verbose, String(i_data_length) + "/" + String(i_data_length));
-        }
-
-      } else if (SendInfo == i_data_type) {
-        log->AddEvent(LogLevel_Verbose, "Send data info");
-        client.print(*i_data);
-      }
-
+      SendRequestBody(client, i_data, i_data_length, i_data_type);
       log->AddEvent(LogLevel_Info, "Send done: " + String(i_data_length) + " bytes");
       esp_task_wdt_reset();
 
       /* read response from server */
-      String response = "";
-      String fullResponse = "";
-      log->AddEvent(LogLevel_Verbose, "Response:");
-      while (client.connected()) {
-        if (client.available()) {
-          response = client.readStringUntil('\n');
-          fullResponse += response;
-          log->AddEvent(LogLevel_Verbose, response.c_str());
-
-          if (response.startsWith("HTTP/1.1")) {
-            int httpCode = response.substring(9, 12).toInt();
-            BackendReceivedStatus = i_type;
-            BackendReceivedStatus += ": ";
-            BackendReceivedStatus += ProcessHttpResponseCode(httpCode);
-            if (true == ProcessHttpResponseCodeBool(httpCode)) {
-              ret = true;
-            }
-          }
-        }
-      }
-      log->AddEvent(LogLevel_Verbose, "Full response: " + fullResponse); 
+      ret = ReadResponse(client, i_type);
 
       BackendAvailability = BackendAvailable;
       client.stop();
+      UpdateUploadStats(ret, upload_start, i_data_length, heap_before, heap_connected);
+      UpdateRetryPolicy(ClassifyHttpResponse(ResponseCode));
     }
   } else {
     /* err message */
@@ -179,23 +180,352 @@ bool PrusaConnect::SendDataToBackend(String *i_data, int i_data_length, String i
     } else if (Token.length() == 0) {
       BackendReceivedStatus = "Missing token";
     }
+    UpdateRetryPolicy(UploadErrorRejected);
   }
 
   log->AddEvent(LogLevel_Info, "Upload done. Response code: " + BackendReceivedStatus + " ,BA:" + CovertBackendAvailabilitStatusToString(BackendAvailability));
-  Server_resume();
+  SystemWifiMngt.SetUploadProcessing(false);
+  return ret;
+}
+
+/**
+ * @brief Send HTTP request header to the backend.
+ * Only the Arduino Client interface is used, the transport (TLS, plain TCP) is selected by the caller
+ *
+ * @param Client& - connected client
+ * @param int - length of the request body
+ * @param String - content type of the request body
+ * @param String - url path for backend
+ */
+void PrusaConnect::SendRequestHeader(Client &i_client, int i_data_length, String i_content_type, String i_url_path) {
+  TRACE_SCOPE("SendHeaders");
+  i_client.println(String((true == HOST_TLS_ENABLE) ? "PUT https://" : "PUT http://") + PrusaConnectHostname + i_url_path + " HTTP/1.0");
+  i_client.println("Host: " + PrusaConnectHostname);
+  i_client.println("User-Agent: ESP32-CAM");
+  i_client.println("Connection: close");
+
+  i_client.println("Content-Type: " + i_content_type);
+  i_client.println("fingerprint: " + Fingerprint);
+  i_client.println("token: " + Token);
+  i_client.print("Content-Length: ");
+  i_client.println(i_data_length);
+  i_client.println();
+}
+
+/**
+ * @brief Send HTTP request body to the backend. Photo is sent in fragments
+ *
+ * @param Client& - connected client
+ * @param String* - data to send
+ * @param int - length of the data
+ * @param SendDataToBackendType - type of data
+ */
+void PrusaConnect::SendRequestBody(Client &i_client, String *i_data, int i_data_length, SendDataToBackendType i_data_type) {
+  TRACE_SCOPE("SendBody");
+  if (SendPhoto == i_data_type) {
+    log->AddEvent(LogLevel_Verbose, "Send data photo");
+    /* send data in fragments, directly from the referenced photo */
+    for (int index = 0; (NULL != Photo) && (index < i_data_length); index = index + PHOTO_FRAGMENT_SIZE) {
+      size_t len = min(PHOTO_FRAGMENT_SIZE, i_data_length - index);
+      i_client.write(Photo->Buf + index, len);
+      log->AddEvent(LogLevel_Verbose, String(i_data_length) + "/" + String(index + len));
+    }
+
+  } else if (SendInfo == i_data_type) {
+    log->AddEvent(LogLevel_Verbose, "Send data info");
+    i_client.print(*i_data);
+
+  } else if (SendQueuedPhoto == i_data_type) {
+    log->AddEvent(LogLevel_Verbose, "Send data queued photo " + *i_data);
+    File file = SD_MMC.open(i_data->c_str(), FILE_READ);
+    uint8_t *buf = (uint8_t *)malloc(PHOTO_FRAGMENT_SIZE);
+    if ((file) && (NULL != buf)) {
+      int sent = 0;
+      while (sent < i_data_length) {
+        size_t len = file.read(buf, PHOTO_FRAGMENT_SIZE);
+        if (0 == len) {
+          break;
+        }
+        i_client.write(buf, len);
+        sent += len;
+        esp_task_wdt_reset();
+      }
+    } else {
+      log->AddEvent(LogLevel_Error, "Failed to read queued photo " + *i_data);
+    }
+
+    if (NULL != buf) {
+      free(buf);
+    }
+    if (file) {
+      file.close();
+    }
+  }
+}
+
+/**
+ * @brief Read HTTP response from the backend and process status code
+ *
+ * @param Client& - connected client
+ * @param String - type of data for log message
+ * @return true - if backend accepted data
+ * @return false - if backend rejected data
+ */
+bool PrusaConnect::ReadResponse(Client &i_client, String i_type) {
+  TRACE_SCOPE("ReadResponse");
+  bool ret = false;
+  uint8_t buf[HOST_RESPONSE_READ_BUFFER];
+  HttpResponseParser parser;
+  uint32_t start = millis();
+
+  /* read until is response complete. Connection close is not needed, when is body length known.
+     Timeout is checked in every pass, a server which sends the response slowly can not block the upload */
+  while ((false == parser.IsComplete()) && (false == parser.IsError())) {
+    if ((millis() - start) > HOST_RESPONSE_TIMEOUT) {
+      log->AddEvent(LogLevel_Warning, "Response timeout");
+      break;
+    }
+
+    int available = i_client.available();
+    if (available > 0) {
+      int len = i_client.read(buf, (available > (int)sizeof(buf)) ? sizeof(buf) : available);
+      if (len > 0) {
+        parser.Feed(buf, len);
+      }
+    } else if (!i_client.connected()) {
+      parser.Finish();
+    } else {
+      delay(1);
+    }
+  }
+
+  uint16_t httpCode = parser.GetStatusCode();
+  ResponseCode = httpCode;
+  ResponseRetryAfter = parser.GetRetryAfter();
+  log->AddEvent(LogLevel_Verbose, "Response: HTTP/1." + String(parser.GetVersionMinor()) + " " + String(httpCode) + ", Content-Length: " + String(parser.GetContentLength()) +
+                                  ", Retry-After: " + String(parser.GetRetryAfter()) + ", parser state: " + String(parser.GetState()) + ", time: " + String(millis() - start) + " ms");
+
+  if (httpCode > 0) {
+    BackendReceivedStatus = i_type;
+    BackendReceivedStatus += ": ";
+    BackendReceivedStatus += ProcessHttpResponseCode(httpCode);
+    if (true == ProcessHttpResponseCodeBool(httpCode)) {
+      ret = true;
+    }
+  } else {
+    BackendReceivedStatus = i_type + ": invalid response";
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Update statistics of the uploads
+ *
+ * @param bool - upload status
+ * @param int64_t - start time of the upload [us], esp_timer time base
+ * @param int - count of sent bytes
+ * @param uint32_t - free heap before upload [bytes]
+ * @param uint32_t - free heap with open connection [bytes]
+ */
+void PrusaConnect::UpdateUploadStats(bool i_status, int64_t i_start, int i_length, uint32_t i_heap_before, uint32_t i_heap_connected) {
+  uint32_t duration = (uint32_t)((esp_timer_get_time() - i_start) / 1000);
+  uint32_t heap_after = ESP.getFreeHeap();
+
+  UploadStats.Count++;
+  if (false == i_status) {
+    UploadStats.Failed++;
+  }
+
+  UploadStats.LatencyLast = duration;
+  UploadStats.LatencyTotal += duration;
+  if (duration > UploadStats.LatencyMax) {
+    UploadStats.LatencyMax = duration;
+  }
+
+  uint8_t bucket = 0;
+  while ((bucket < (UPLOAD_STATS_HISTOGRAM_SIZE - 1)) && (duration >= UploadLatencyBuckets[bucket])) {
+    bucket++;
+  }
+  UploadStats.LatencyHistogram[bucket]++;
+
+  UploadStats.BytesTotal += i_length;
+  UploadStats.ThroughputLast = (duration > 0) ? (uint32_t)(((uint64_t)i_length * 1000) / duration) : 0;
+
+  UploadStats.HeapConnectionLast = (i_heap_before > i_heap_connected) ? (i_heap_before - i_heap_connected) : 0;
+  if (UploadStats.HeapConnectionLast > UploadStats.HeapConnectionMax) {
+    UploadStats.HeapConnectionMax = UploadStats.HeapConnectionLast;
+  }
+  UploadStats.HeapChurnLast = (int32_t)i_heap_before - (int32_t)heap_after;
+
+  log->AddEvent(LogLevel_Verbose, "Upload stats: " + String(duration) + " ms, " + String(UploadStats.ThroughputLast) + " B/s, connection heap: " + String(UploadStats.HeapConnectionLast) + " bytes");
+}
+
+/**
+ * @brief Classify http response code to the upload error class
+ *
+ * @param uint16_t - http response code, 0 = invalid response
+ * @return UploadErrorClass - error class
+ */
+UploadErrorClass PrusaConnect::ClassifyHttpResponse(uint16_t i_code) {
+  UploadErrorClass ret = UploadErrorServer;
+
+  if (true == ProcessHttpResponseCodeBool(i_code)) {
+    ret = UploadErrorNone;
+  } else if ((429 == i_code) || (503 == i_code)) {
+    ret = UploadErrorThrottle;
+  } else if ((i_code >= 300) && (i_code < 500)) {
+    ret = UploadErrorRejected;
+  }
+
   return ret;
 }
 
+/**
+ * @brief Get base delay of the exponential backoff for error class
+ *
+ * @param UploadErrorClass - error class
+ * @return uint32_t - base delay [ms]
+ */
+uint32_t PrusaConnect::GetRetryBaseDelay(UploadErrorClass i_error) {
+  uint32_t ret = UPLOAD_RETRY_BASE_SERVER;
+
+  switch (i_error) {
+  case UploadErrorConnect:
+    ret = UPLOAD_RETRY_BASE_CONNECT;
+    break;
+  case UploadErrorTls:
+    ret = UPLOAD_RETRY_BASE_TLS;
+    break;
+  case UploadErrorThrottle:
+    ret = UPLOAD_RETRY_BASE_THROTTLE;
+    break;
+  default:
+    ret = UPLOAD_RETRY_BASE_SERVER;
+    break;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Update retry policy after upload. Failed upload is retried with jittered exponential backoff,
+ *        independently on the refresh interval. Backend errors do not trigger WiFi reconnect,
+ *        only repeated failures of the TCP connection can be caused by lost uplink
+ *
+ * @param UploadErrorClass - result of the upload
+ */
+void PrusaConnect::UpdateRetryPolicy(UploadErrorClass i_error) {
+  RetryErrorClass = i_error;
+  UploadStats.Errors[i_error]++;
+
+  /* success, or error which is not solved by retry. Regular interval is used */
+  if ((UploadErrorNone == i_error) || (UploadErrorRejected == i_error)) {
+    RetryAttempt = 0;
+    RetryPending = false;
+    return;
+  }
+
+  uint32_t delay_ms = 0;
+  if ((UploadErrorThrottle == i_error) && (ResponseRetryAfter > 0)) {
+    delay_ms = ((ResponseRetryAfter > UPLOAD_RETRY_AFTER_MAX) ? UPLOAD_RETRY_AFTER_MAX : ResponseRetryAfter) * 1000;
+  } else {
+    /* random delay in the range <backoff / 2, backoff>. Cameras behind the same outage do not retry at the same time */
+    uint8_t shift = (RetryAttempt < 16) ? RetryAttempt : 16;
+    uint64_t backoff = (uint64_t)GetRetryBaseDelay(i_error) << shift;
+    if (backoff > UPLOAD_RETRY_MAX_DELAY) {
+      backoff = UPLOAD_RETRY_MAX_DELAY;
+    }
+    delay_ms = (uint32_t)(backoff / 2) + (esp_random() % (uint32_t)((backoff / 2) + 1));
+  }
+
+  if (RetryAttempt < UINT8_MAX) {
+    RetryAttempt++;
+  }
+  RetryDelayLast = delay_ms;
+  RetryDeadline = esp_timer_get_time() + ((int64_t)delay_ms * 1000LL);
+  RetryPending = true;
+  UploadStats.Retries++;
+  log->AddEvent(LogLevel_Info, "Upload retry " + String(RetryAttempt) + " in " + String(delay_ms) + " ms. Error: " + CovertUploadErrorClassToString(i_error));
+
+  /* repeated failed connections can be caused by lost uplink. Request WiFi reconnect */
+  if ((UploadErrorConnect == i_error) && (RetryAttempt >= UPLOAD_RETRY_WIFI_RECONNECT) && (BackendAvailability != WaitForFirstConnection)) {
+    BackendAvailability = BackendUnavailable;
+  }
+}
+
 /**
  * @brief Send photo to prusa connect backend
  *
- * @param none
+ * @param PhotoFrame * - photo to send. Reference of the caller is used, photo is not released
  * @return none
  */
-void PrusaConnect::SendPhotoToBackend() {
+void PrusaConnect::SendPhotoToBackend(PhotoFrame *i_frame) {
   log->AddEvent(LogLevel_Info, "Start sending photo to prusaconnect");
-  SendDataToBackend(&Photo, camera->GetPhotoSize(), "image/jpg", "Photo", HOST_URL_CAM_PATH, SendPhoto);
+  Photo = i_frame;
+  if (NULL == Photo) {
+    log->AddEvent(LogLevel_Warning, "Photo is not available");
+    return;
+  }
+
+  bool ret = SendDataToBackend(NULL, Photo->Len, "image/jpg", "Photo", HOST_URL_CAM_PATH, SendPhoto);
   SystemLog.AddEvent(LogLevel_Info, "Free RAM: " + String(ESP.getFreeHeap()) + " bytes");
+
+  /* photo from the outage is saved to the offline queue. Rejected photo would be rejected again */
+  if ((false == ret) && (UploadErrorRejected != RetryErrorClass)) {
+    SystemSnapshotQueue.Enqueue(Photo->Buf, Photo->Len);
+  }
+
+  Photo = NULL;
+}
+
+/**
+ * @brief Take picture and save it to the offline queue. Used when is uplink not available
+ *
+ */
+void PrusaConnect::TakePictureAndQueue() {
+  PhotoFrame *frame = TakePicture();
+  if (NULL != frame) {
+    SystemSnapshotQueue.Enqueue(frame->Buf, frame->Len);
+    SystemPhotoStore.Release(frame);
+  }
+}
+
+/**
+ * @brief Check if is allowed upload from the offline queue. Queue is drained only when is backend available
+ *
+ * @return bool - true if can be sent photo from the queue
+ */
+bool PrusaConnect::CheckQueueDrainAllowed() {
+  return ((SystemSnapshotQueue.GetCount() > 0) && (BackendAvailable == BackendAvailability) && (false == RetryPending));
+}
+
+/**
+ * @brief Send the oldest photo from the offline queue. Uploads are rate limited by QUEUE_DRAIN_INTERVAL
+ *
+ */
+void PrusaConnect::SendPhotoFromQueue() {
+  if ((false == CheckQueueDrainAllowed()) || (esp_timer_get_time() < QueueDrainDeadline)) {
+    return;
+  }
+
+  String path = "";
+  uint32_t size = 0;
+  if (false == SystemSnapshotQueue.GetOldest(path, size)) {
+    return;
+  }
+
+  log->AddEvent(LogLevel_Info, "Start sending queued photo " + path + ", in queue: " + String(SystemSnapshotQueue.GetCount()));
+  bool ret = SendDataToBackend(&path, size, "image/jpg", "Queued photo", HOST_URL_CAM_PATH, SendQueuedPhoto);
+  QueueDrainDeadline = esp_timer_get_time() + ((int64_t)QUEUE_DRAIN_INTERVAL * 1000LL);
+
+  /* rejected photo is removed, otherwise it would block the queue */
+  if (true == ret) {
+    SystemSnapshotQueue.RemoveOldest(true);
+  } else if (UploadErrorRejected == RetryErrorClass) {
+    log->AddEvent(LogLevel_Warning, "Queued photo rejected, removed " + path);
+    SystemSnapshotQueue.RemoveOldest(false);
+  }
 }
 
 /**
@@ -241,8 +571,9 @@ void PrusaConnect::SendInfoToBackend() {
  * @return none
  */
 void PrusaConnect::TakePictureAndSendToBackend() {
-  TakePicture();
-  SendPhotoToBackend();
+  PhotoFrame *frame = TakePicture();
+  SendPhotoToBackend(frame);
+  SystemPhotoStore.Release(frame);
 }
 
 /**
@@ -280,6 +611,9 @@ String PrusaConnect::ProcessHttpResponseCode(int code) {
   case 409:
     ret = "409 - Conflict with the state of target resource (user error)";
     break;
+  case 429:
+    ret = "429 - Too many requests. Try again later";
+    break;
   case 503:
     ret += "503 - Service is unavailable at this moment. Try again later";
     break;
@@ -358,6 +692,12 @@ void PrusaConnect::UpdateDeviceInformation() {
 void PrusaConnect::SetRefreshInterval(uint8_t i_data) {
   RefreshInterval = i_data;
   config->SaveRefreshInterval(RefreshInterval);
+
+  /* new interval is counted from now. Wake up task for recalculate sleep time */
+  SendingDeadline = esp_timer_get_time() + ((int64_t) RefreshInterval * 1000000LL);
+  if (NULL != Task_CapturePhotoAndSend) {
+    xTaskNotifyGive(Task_CapturePhotoAndSend);
+  }
 }
 
 /**
@@ -476,51 +816,229 @@ String PrusaConnect::CovertBackendAvailabilitStatusToString(BackendAvailabilitSt
 }
 
 /**
- * @brief Increase sending interval counter
+ * @brief Init sending scheduler. First sending is after refresh interval
  *
  * @param none
  * @return none
  */
-void PrusaConnect::IncreaseSendingIntervalCounter() {
-  SendingIntervalCounter++;
+void PrusaConnect::SendingSchedulerInit() {
+  SendingDeadline = esp_timer_get_time() + ((int64_t) RefreshInterval * 1000000LL);
+  SendingNowRequest = false;
 }
 
 /**
- * @brief Set sending interval counter
+ * @brief Request immediate sending. Task for sending photo is woken up by notification. Schedule of the next deadline is not changed
  *
- * @param uint8_t i_data - counter
+ * @param none
  * @return none
  */
-void PrusaConnect::SetSendingIntervalCounter(uint8_t i_data) { 
-  SendingIntervalCounter = i_data;
+void PrusaConnect::SetSendingIntervalExpired() {
+  SendingNowRequest = true;
+  if (NULL != Task_CapturePhotoAndSend) {
+    xTaskNotifyGive(Task_CapturePhotoAndSend);
+  }
 }
 
-void PrusaConnect::SetSendingIntervalExpired() {
-  SendingIntervalCounter = RefreshInterval;
+/**
+ * @brief Check if sending deadline is expired, and can I send the data to the backend.
+ *        Next deadline is derived from previous deadline, not from actual time, so the interval does not drift by upload duration.
+ *        During retry backoff is regular deadline used only for capture, upload waits for the retry deadline
+ * 
+ * @return SendingEvent - what has to be done
+ */
+SendingEvent PrusaConnect::CheckSendingIntervalExpired() {
+  bool ret = false;
+  SendingEvent event = SendingEventNone;
+  int64_t now = esp_timer_get_time();
+
+  if (now >= SendingDeadline) {
+    int64_t interval = (int64_t) RefreshInterval * 1000000LL;
+    SendingJitterLast = now - SendingDeadline;
+    if (SendingJitterLast > SendingJitterMax) {
+      SendingJitterMax = SendingJitterLast;
+    }
+    log->AddEvent(LogLevel_Verbose, "Sending deadline jitter: " + String((long) SendingJitterLast) + " us, max: " + String((long) SendingJitterMax) + " us");
+
+    /* next deadline. Missed deadlines are skipped (for example long upload) */
+    SendingDeadline += interval;
+    if (SendingDeadline <= now) {
+      SendingDeadline = now + interval - ((now - SendingDeadline) % interval);
+    }
+    ret = true;
+  }
+
+  if (true == ret) {
+    event = SendingEventUpload;
+  }
+
+  /* scheduled retry replaces regular upload during backoff. Photo from the regular deadline is only captured */
+  if (true == RetryPending) {
+    if (now >= RetryDeadline) {
+      RetryPending = false;
+      event = SendingEventUpload;
+    } else if (true == ret) {
+      log->AddEvent(LogLevel_Verbose, "Upload postponed by retry backoff");
+      event = SendingEventCapture;
+    }
+  }
+
+  if (true == SendingNowRequest) {
+    SendingNowRequest = false;
+    event = SendingEventUpload;
+  }
+
+  return event;
 }
 
 /**
- * @brief Get sending interval counter
+ * @brief Get count of ticks to the next sending deadline
  * 
- * @return uint8_t - counter
+ * @param uint32_t - maximum sleep time [ms]
+ * @return TickType_t - ticks to deadline
  */
-uint8_t PrusaConnect::GetSendingIntervalCounter() {
-  return SendingIntervalCounter;
+TickType_t PrusaConnect::GetTicksToSendingDeadline(uint32_t i_max) {
+  int64_t deadline = SendingDeadline;
+  if ((true == RetryPending) && (RetryDeadline < deadline)) {
+    deadline = RetryDeadline;
+  }
+  if ((true == CheckQueueDrainAllowed()) && (QueueDrainDeadline < deadline)) {
+    deadline = QueueDrainDeadline;
+  }
+
+  int64_t remaining = deadline - esp_timer_get_time();
+  if (remaining <= 0) {
+    return 0;
+  }
+
+  /* round up, task must not wake up before deadline */
+  int64_t remaining_ms = (remaining + 999) / 1000;
+  if (remaining_ms > i_max) {
+    remaining_ms = i_max;
+  }
+
+  return pdMS_TO_TICKS((uint32_t) remaining_ms) + 1;
 }
 
 /**
- * @brief Check if sending interval is expired. and can I send the data to the backend. [seconds]
+ * @brief Get delay of the last scheduled sending behind deadline
  * 
- * @return true 
- * @return false 
+ * @return int64_t - delay [us]
  */
-bool PrusaConnect::CheckSendingIntervalExpired() {
-  bool ret = false;
-  if (SendingIntervalCounter >= RefreshInterval) {
-    ret = true;
+int64_t PrusaConnect::GetSendingJitterLast() {
+  return SendingJitterLast;
+}
+
+/**
+ * @brief Get maximum delay of the scheduled sending behind deadline
+ * 
+ * @return int64_t - delay [us]
+ */
+int64_t PrusaConnect::GetSendingJitterMax() {
+  return SendingJitterMax;
+}
+
+/**
+ * @brief Get status of the retry backoff
+ * 
+ * @return bool - true if is retry of the upload scheduled
+ */
+bool PrusaConnect::GetRetryPending() {
+  return RetryPending;
+}
+
+/**
+ * @brief Convert upload error class to string
+ *
+ * @param UploadErrorClass - error class
+ * @return String - name of the error class
+ */
+String PrusaConnect::CovertUploadErrorClassToString(UploadErrorClass i_data) {
+  String ret = "";
+  switch (i_data) {
+  case UploadErrorNone:
+    ret = "none";
+    break;
+  case UploadErrorConnect:
+    ret = "connect";
+    break;
+  case UploadErrorTls:
+    ret = "tls";
+    break;
+  case UploadErrorServer:
+    ret = "server";
+    break;
+  case UploadErrorThrottle:
+    ret = "throttle";
+    break;
+  case UploadErrorRejected:
+    ret = "rejected";
+    break;
+  default:
+    ret = "unknown";
+    break;
   }
 
   return ret;
 }
 
+/**
+ * @brief Get statistics of the uploads in json format
+ *
+ * @return String - json
+ */
+String PrusaConnect::GetUploadStatsJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["count"] = UploadStats.Count;
+  doc_json["failed"] = UploadStats.Failed;
+  doc_json["postponed"] = UploadStats.Postponed;
+  doc_json["latency_last_ms"] = UploadStats.LatencyLast;
+  doc_json["latency_max_ms"] = UploadStats.LatencyMax;
+  doc_json["latency_avg_ms"] = (UploadStats.Count > 0) ? (uint32_t)(UploadStats.LatencyTotal / UploadStats.Count) : 0;
+
+  JsonArray histogram = doc_json["latency_histogram"].to<JsonArray>();
+  for (uint8_t i = 0; i < UPLOAD_STATS_HISTOGRAM_SIZE; i++) {
+    JsonObject bucket = histogram.add<JsonObject>();
+    bucket["le_ms"] = (i < (UPLOAD_STATS_HISTOGRAM_SIZE - 1)) ? UploadLatencyBuckets[i] : 0;
+    bucket["count"] = UploadStats.LatencyHistogram[i];
+  }
+
+  doc_json["bytes_total"] = UploadStats.BytesTotal;
+  doc_json["throughput_last_bps"] = UploadStats.ThroughputLast;
+  doc_json["throughput_avg_bps"] = (UploadStats.LatencyTotal > 0) ? (uint32_t)((UploadStats.BytesTotal * 1000) / UploadStats.LatencyTotal) : 0;
+  doc_json["heap_connection_last"] = UploadStats.HeapConnectionLast;
+  doc_json["heap_connection_max"] = UploadStats.HeapConnectionMax;
+  doc_json["heap_churn_last"] = UploadStats.HeapChurnLast;
+
+  JsonObject errors = doc_json["errors"].to<JsonObject>();
+  for (uint8_t i = 0; i < UploadErrorCount; i++) {
+    errors[CovertUploadErrorClassToString((UploadErrorClass)i)] = UploadStats.Errors[i];
+  }
+  doc_json["retries"] = UploadStats.Retries;
+  doc_json["retry_attempt"] = RetryAttempt;
+  doc_json["retry_error"] = CovertUploadErrorClassToString(RetryErrorClass);
+  doc_json["retry_delay_last_ms"] = RetryDelayLast;
+  doc_json["retry_in_ms"] = (true == RetryPending) ? (int32_t)((RetryDeadline - esp_timer_get_time()) / 1000) : -1;
+
+  JsonObject queue = doc_json["queue"].to<JsonObject>();
+  queue["enable"] = SystemSnapshotQueue.GetEnable();
+  queue["count"] = SystemSnapshotQueue.GetCount();
+  queue["bytes"] = SystemSnapshotQueue.GetBytes();
+  queue["enqueued"] = SystemSnapshotQueue.GetEnqueued();
+  queue["uploaded"] = SystemSnapshotQueue.GetDequeued();
+  queue["evicted"] = SystemSnapshotQueue.GetEvicted();
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/**
+ * @brief Clear statistics of the uploads
+ *
+ */
+void PrusaConnect::ClearUploadStats() {
+  memset(&UploadStats, 0, sizeof(UploadStats));
+}
+
 /* EOF */
\ No newline at end of file
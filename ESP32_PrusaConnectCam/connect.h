@@ -15,6 +15,7 @@
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <esp_task_wdt.h>
+#include "esp_timer.h"
 #include "Arduino.h"
 #include <ArduinoJson.h>
 
@@ -26,6 +27,11 @@
 #include "cfg.h"
 #include "Certificate.h"
 #include "server.h"
+#include "http_response.h"
+#include "thumbnail.h"
+#include "snapshot_queue.h"
+#include "timelapse.h"
+#include "analysis.h"
 
 /**
  * @brief BackendAvailabilitStatus enum
@@ -44,6 +50,52 @@ enum BackendAvailabilitStatus {
 enum SendDataToBackendType {
   SendPhoto = 0,                  ///< send photo to backend
   SendInfo = 1,                   ///< send device information to backend
+  SendQueuedPhoto = 2,            ///< send photo from the offline queue on the micro SD card, data is path of the photo
+};
+
+/**
+ * @brief SendingEvent enum
+ * result of the check of the sending deadline
+ */
+enum SendingEvent {
+  SendingEventNone = 0,           ///< deadline is not expired
+  SendingEventUpload = 1,         ///< photo is captured and uploaded. Regular deadline, retry deadline or WEB request
+  SendingEventCapture = 2,        ///< regular deadline during retry backoff. Photo is captured only, upload waits for retry deadline
+};
+
+/**
+ * @brief UploadErrorClass enum
+ * class of the upload error, selects retry policy
+ */
+enum UploadErrorClass {
+  UploadErrorNone = 0,            ///< upload OK
+  UploadErrorConnect = 1,         ///< TCP connection to the backend failed
+  UploadErrorTls = 2,             ///< TLS handshake failed
+  UploadErrorServer = 3,          ///< 5xx or invalid response
+  UploadErrorThrottle = 4,        ///< 429/503 response, Retry-After header is honored
+  UploadErrorRejected = 5,        ///< 3xx/4xx response or missing token/fingerprint. Retry does not help
+  UploadErrorCount = 6,           ///< count of error classes
+};
+
+/**
+ * @brief UploadStatistics struct
+ * statistics of the uploads to the backend, used for benchmark against local stand-in server
+ */
+struct UploadStatistics {
+  uint32_t Count;                                               ///< count of finished uploads
+  uint32_t Failed;                                              ///< count of failed uploads
+  uint32_t Postponed;                                           ///< count of uploads postponed by low memory
+  uint32_t LatencyLast;                                         ///< duration of the last upload [ms]
+  uint32_t LatencyMax;                                          ///< maximum duration of the upload [ms]
+  uint64_t LatencyTotal;                                        ///< total duration of the uploads [ms]
+  uint32_t LatencyHistogram[UPLOAD_STATS_HISTOGRAM_SIZE];       ///< histogram of the upload durations
+  uint64_t BytesTotal;                                          ///< total count of sent bytes
+  uint32_t ThroughputLast;                                      ///< throughput of the last upload [B/s]
+  uint32_t HeapConnectionLast;                                  ///< heap used by the last connection [bytes]
+  uint32_t HeapConnectionMax;                                   ///< maximum heap used by the connection [bytes]
+  int32_t HeapChurnLast;                                        ///< difference of free heap before and after the last upload [bytes]
+  uint32_t Errors[UploadErrorCount];                            ///< count of uploads per error class
+  uint32_t Retries;                                             ///< count of scheduled retries
 };
 
 class PrusaConnect {
@@ -52,11 +104,23 @@ private:
   String BackendReceivedStatus;                   ///< status of backend response
   BackendAvailabilitStatus BackendAvailability;   ///< status of backend availability
   bool SendDeviceInformationToBackend;           ///< flag for sending device information to backend
-  uint8_t SendingIntervalCounter;                 ///< counter for sending interval, represents seconds
+  int64_t SendingDeadline;                        ///< absolute time of the next sending [us], esp_timer time base
+  bool SendingNowRequest;                         ///< flag about request for immediate sending
+  int64_t SendingJitterLast;                      ///< delay of the last scheduled sending behind deadline [us]
+  int64_t SendingJitterMax;                       ///< maximum delay of the scheduled sending behind deadline [us]
+  UploadStatistics UploadStats;                   ///< statistics of the uploads
+  UploadErrorClass RetryErrorClass;               ///< class of the last upload error
+  uint8_t RetryAttempt;                           ///< count of consecutive failed uploads
+  bool RetryPending;                              ///< flag, retry of the upload is scheduled
+  int64_t RetryDeadline;                          ///< time of the scheduled retry [us], esp_timer time base
+  uint32_t RetryDelayLast;                        ///< last retry delay [ms]
+  uint16_t ResponseCode;                          ///< http code of the last response, 0 = invalid response
+  uint32_t ResponseRetryAfter;                    ///< Retry-After header of the last response [s]
+  int64_t QueueDrainDeadline;                     ///< time of the next upload from the offline queue [us], esp_timer time base
 
   String Token;                                   ///< token for backend communication
   String Fingerprint;                             ///< fingerprint for backend communication
-  String Photo;                                   ///< photo for sending to backend        
+  PhotoFrame *Photo;                              ///< photo for sending to backend, referenced during upload
   String PrusaConnectHostname;                    ///< hostname of prusa connect backend          
 
   Configuration *config;                          ///< pointer to configuration object
@@ -64,6 +128,13 @@ private:
   Camera *camera;                                 ///< pointer to camera object
 
   bool SendDataToBackend(String *,int, String, String, String, SendDataToBackendType);
+  void SendRequestHeader(Client &, int, String, String);
+  void SendRequestBody(Client &, String *, int, SendDataToBackendType);
+  bool ReadResponse(Client &, String);
+  void UpdateUploadStats(bool, int64_t, int, uint32_t, uint32_t);
+  UploadErrorClass ClassifyHttpResponse(uint16_t);
+  uint32_t GetRetryBaseDelay(UploadErrorClass);
+  void UpdateRetryPolicy(UploadErrorClass);
 
 public:
   PrusaConnect(Configuration*, Logs*, Camera*);
@@ -72,8 +143,11 @@ public:
   void Init();
   void LoadCfgFromEeprom();
 
-  void TakePicture();
-  void SendPhotoToBackend();
+  PhotoFrame *TakePicture();
+  void SendPhotoToBackend(PhotoFrame *);
+  void TakePictureAndQueue();
+  void SendPhotoFromQueue();
+  bool CheckQueueDrainAllowed();
   void SendInfoToBackend();
   void TakePictureAndSendToBackend();
   String ProcessHttpResponseCode(int);
@@ -93,11 +167,17 @@ public:
   BackendAvailabilitStatus GetBackendAvailabilitStatus();
   String CovertBackendAvailabilitStatusToString(BackendAvailabilitStatus);
 
-  void IncreaseSendingIntervalCounter();
-  void SetSendingIntervalCounter(uint8_t);
+  void SendingSchedulerInit();
   void SetSendingIntervalExpired();
-  uint8_t GetSendingIntervalCounter();
-  bool CheckSendingIntervalExpired();
+  SendingEvent CheckSendingIntervalExpired();
+  TickType_t GetTicksToSendingDeadline(uint32_t);
+  int64_t GetSendingJitterLast();
+  int64_t GetSendingJitterMax();
+  bool GetRetryPending();
+  String CovertUploadErrorClassToString(UploadErrorClass);
+
+  String GetUploadStatsJson();
+  void ClearUploadStats();
 };
 
 extern PrusaConnect Connect;  ///< PrusaConnect object
@@ -0,0 +1,322 @@
+/**
+   @file http_response.cpp
+
+   @brief Incremental parser of the HTTP/1.x response from the backend
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: Transfer-Encoding chunked is not supported. Backend request is HTTP/1.0, so the response is not chunked
+*/
+
+#include "http_response.h"
+
+/**
+ * @brief Construct a new HttpResponseParser::HttpResponseParser object
+ *
+ */
+HttpResponseParser::HttpResponseParser() {
+  Reset();
+}
+
+/**
+ * @brief Reset parser before new response
+ *
+ */
+void HttpResponseParser::Reset() {
+  State = HttpParserStatusLine;
+  LineLength = 0;
+  HeaderBytes = 0;
+  VersionMinor = 0;
+  StatusCode = 0;
+  ContentLength = -1;
+  BodyRemaining = 0;
+  ConnectionClose = false;
+  RetryAfter = 0;
+}
+
+/**
+ * @brief Process received data
+ *
+ * @param const uint8_t* - received data
+ * @param size_t - length of received data
+ * @return size_t - count of processed bytes. Processing stops, when is response complete or invalid
+ */
+size_t HttpResponseParser::Feed(const uint8_t *i_data, size_t i_len) {
+  size_t i = 0;
+
+  while ((i < i_len) && (HttpParserComplete != State) && (HttpParserError != State)) {
+    /* skip body with known length */
+    if (HttpParserBody == State) {
+      size_t len = i_len - i;
+      if (len > BodyRemaining) {
+        len = BodyRemaining;
+      }
+      BodyRemaining -= len;
+      i += len;
+      if (0 == BodyRemaining) {
+        State = HttpParserComplete;
+      }
+      continue;
+    }
+
+    /* body is ended by connection close */
+    if (HttpParserBodyUntilClose == State) {
+      i = i_len;
+      break;
+    }
+
+    /* status line and headers */
+    char c = (char)i_data[i++];
+    HeaderBytes++;
+    if (HeaderBytes > HTTP_PARSER_MAX_HEADER_SIZE) {
+      State = HttpParserError;
+      break;
+    }
+
+    if ('\n' == c) {
+      Line[LineLength] = '\0';
+      ProcessLine();
+      LineLength = 0;
+    } else if ('\r' != c) {
+      if (LineLength < (sizeof(Line) - 1)) {
+        Line[LineLength++] = c;
+      }
+    }
+  }
+
+  return i;
+}
+
+/**
+ * @brief Connection was closed by server. Response without length is complete, other unfinished responses are invalid
+ *
+ */
+void HttpResponseParser::Finish() {
+  if (HttpParserBodyUntilClose == State) {
+    State = HttpParserComplete;
+  } else if (HttpParserComplete != State) {
+    State = HttpParserError;
+  }
+}
+
+/**
+ * @brief Process one complete line of the status line or headers
+ *
+ */
+void HttpResponseParser::ProcessLine() {
+  if (HttpParserStatusLine == State) {
+    /* empty lines before status line are ignored */
+    if (LineLength > 0) {
+      ProcessStatusLine();
+    }
+  } else if (HttpParserHeaders == State) {
+    if (0 == LineLength) {
+      ProcessEndOfHeaders();
+    } else {
+      ProcessHeaderLine();
+    }
+  }
+}
+
+/**
+ * @brief Process status line. Format: HTTP/1.x SSS reason
+ *
+ */
+void HttpResponseParser::ProcessStatusLine() {
+  if ((LineLength < 12) || (0 != strncmp(Line, "HTTP/1.", 7)) || (Line[7] < '0') || (Line[7] > '9') || (' ' != Line[8])) {
+    State = HttpParserError;
+    return;
+  }
+
+  uint16_t code = 0;
+  for (uint8_t i = 9; i < 12; i++) {
+    if ((Line[i] < '0') || (Line[i] > '9')) {
+      State = HttpParserError;
+      return;
+    }
+    code = (code * 10) + (Line[i] - '0');
+  }
+
+  if ((LineLength > 12) && (' ' != Line[12])) {
+    State = HttpParserError;
+    return;
+  }
+
+  VersionMinor = Line[7] - '0';
+  StatusCode = code;
+  State = HttpParserHeaders;
+}
+
+/**
+ * @brief Process one header line. Only Content-Length, Connection and Retry-After headers are used
+ *
+ */
+void HttpResponseParser::ProcessHeaderLine() {
+  char *colon = strchr(Line, ':');
+  if (NULL == colon) {
+    State = HttpParserError;
+    return;
+  }
+
+  size_t name_len = colon - Line;
+  char *value = colon + 1;
+  while ((' ' == *value) || ('\t' == *value)) {
+    value++;
+  }
+
+  /* remove trailing white spaces */
+  char *end = Line + LineLength;
+  while ((end > value) && ((' ' == *(end - 1)) || ('\t' == *(end - 1)))) {
+    end--;
+  }
+  *end = '\0';
+
+  if ((14 == name_len) && (0 == strncasecmp(Line, "Content-Length", name_len))) {
+    uint32_t length = 0;
+    if ((false == ParseNumber(value, &length)) || (length > INT32_MAX)) {
+      State = HttpParserError;
+      return;
+    }
+    ContentLength = (int32_t)length;
+
+  } else if ((10 == name_len) && (0 == strncasecmp(Line, "Connection", name_len))) {
+    ConnectionClose = (0 == strcasecmp(value, "close"));
+
+  } else if ((11 == name_len) && (0 == strncasecmp(Line, "Retry-After", name_len))) {
+    /* HTTP-date format is not supported */
+    uint32_t seconds = 0;
+    if (true == ParseNumber(value, &seconds)) {
+      RetryAfter = seconds;
+    }
+  }
+}
+
+/**
+ * @brief Process end of the headers and select how is the body ended
+ *
+ */
+void HttpResponseParser::ProcessEndOfHeaders() {
+  if ((StatusCode >= 100) && (StatusCode < 200)) {
+    /* informational response, final response follows */
+    State = HttpParserStatusLine;
+    ContentLength = -1;
+    ConnectionClose = false;
+    RetryAfter = 0;
+
+  } else if ((204 == StatusCode) || (304 == StatusCode) || (0 == ContentLength)) {
+    State = HttpParserComplete;
+
+  } else if (ContentLength > 0) {
+    BodyRemaining = (uint32_t)ContentLength;
+    State = HttpParserBody;
+
+  } else {
+    State = HttpParserBodyUntilClose;
+  }
+}
+
+/**
+ * @brief Parse decimal number. Only digits are allowed
+ *
+ * @param const char* - string
+ * @param uint32_t* - parsed number
+ * @return bool - true if number is valid
+ */
+bool HttpResponseParser::ParseNumber(const char *i_data, uint32_t *o_number) {
+  uint32_t number = 0;
+
+  if ('\0' == *i_data) {
+    return false;
+  }
+
+  while ('\0' != *i_data) {
+    if ((*i_data < '0') || (*i_data > '9')) {
+      return false;
+    }
+
+    uint32_t digit = *i_data - '0';
+    if (number > ((UINT32_MAX - digit) / 10)) {
+      return false;
+    }
+    number = (number * 10) + digit;
+    i_data++;
+  }
+
+  *o_number = number;
+  return true;
+}
+
+/**
+ * @brief Get parser state
+ *
+ * @return HttpParserState - state
+ */
+HttpParserState HttpResponseParser::GetState() {
+  return State;
+}
+
+/**
+ * @brief Check if is response complete
+ *
+ * @return bool - true if is response complete
+ */
+bool HttpResponseParser::IsComplete() {
+  return (HttpParserComplete == State);
+}
+
+/**
+ * @brief Check if is response invalid
+ *
+ * @return bool - true if is response invalid
+ */
+bool HttpResponseParser::IsError() {
+  return (HttpParserError == State);
+}
+
+/**
+ * @brief Get HTTP/1.x minor version
+ *
+ * @return uint8_t - minor version
+ */
+uint8_t HttpResponseParser::GetVersionMinor() {
+  return VersionMinor;
+}
+
+/**
+ * @brief Get HTTP status code
+ *
+ * @return uint16_t - status code, 0 = status line was not received
+ */
+uint16_t HttpResponseParser::GetStatusCode() {
+  return StatusCode;
+}
+
+/**
+ * @brief Get value of Content-Length header
+ *
+ * @return int32_t - content length, -1 = header is missing
+ */
+int32_t HttpResponseParser::GetContentLength() {
+  return ContentLength;
+}
+
+/**
+ * @brief Get status of Connection: close header
+ *
+ * @return bool - true if server closes connection
+ */
+bool HttpResponseParser::GetConnectionClose() {
+  return ConnectionClose;
+}
+
+/**
+ * @brief Get value of Retry-After header
+ *
+ * @return uint32_t - retry after [s], 0 = header is missing
+ */
+uint32_t HttpResponseParser::GetRetryAfter() {
+  return RetryAfter;
+}
+
+/* EOF */
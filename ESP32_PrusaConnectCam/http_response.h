@@ -0,0 +1,78 @@
+/**
+   @file http_response.h
+
+   @brief Incremental parser of the HTTP/1.x response from the backend
+
+   Parser does not allocate memory. Data are processed byte by byte as they come from the client,
+   so the response can be finished as soon as is complete, without waiting for connection close.
+   Library does not depend on the Arduino framework.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HTTP_RESPONSE_H_
+#define _HTTP_RESPONSE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+
+#include "mcu_cfg.h"
+
+/**
+ * @brief HttpParserState enum
+ * state of the response parser
+ */
+enum HttpParserState {
+  HttpParserStatusLine = 0,       ///< waiting for status line
+  HttpParserHeaders = 1,          ///< processing headers
+  HttpParserBody = 2,             ///< skipping body with known length
+  HttpParserBodyUntilClose = 3,   ///< skipping body without length, body ends with connection close
+  HttpParserComplete = 4,         ///< response is complete
+  HttpParserError = 5,            ///< invalid response
+};
+
+class HttpResponseParser {
+private:
+  HttpParserState State;              ///< parser state
+  char Line[HTTP_PARSER_LINE_SIZE];   ///< buffer for the status line or the header line. Longer lines are truncated
+  size_t LineLength;                  ///< length of the line in the buffer
+  size_t HeaderBytes;                 ///< size of the status line and headers
+  uint8_t VersionMinor;               ///< HTTP/1.x minor version
+  uint16_t StatusCode;                ///< HTTP status code
+  int32_t ContentLength;              ///< value of Content-Length header, -1 = header is missing
+  uint32_t BodyRemaining;             ///< remaining bytes of the body
+  bool ConnectionClose;               ///< Connection: close header
+  uint32_t RetryAfter;                ///< value of Retry-After header [s], 0 = header is missing or is not in seconds
+
+  void ProcessLine();
+  void ProcessStatusLine();
+  void ProcessHeaderLine();
+  void ProcessEndOfHeaders();
+  bool ParseNumber(const char *, uint32_t *);
+
+public:
+  HttpResponseParser();
+  ~HttpResponseParser(){};
+
+  void Reset();
+  size_t Feed(const uint8_t *, size_t);
+  void Finish();
+
+  HttpParserState GetState();
+  bool IsComplete();
+  bool IsError();
+  uint8_t GetVersionMinor();
+  uint16_t GetStatusCode();
+  int32_t GetContentLength();
+  bool GetConnectionClose();
+  uint32_t GetRetryAfter();
+};
+
+#endif
+
+/* EOF */
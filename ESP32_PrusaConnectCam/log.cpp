@@ -147,6 +147,7 @@ void Logs::SetLogLevel(LogLevel_enum level) {
    @return none
 */
 void Logs::AddEvent(LogLevel_enum level, String msg, bool newLine, bool date) {
+  TRACE_SCOPE("Logs::AddEvent");
   if (LogLevel >= level) {
     String LogMsg = "";
 
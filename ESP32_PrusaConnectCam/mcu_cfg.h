@@ -22,6 +22,24 @@
 /* ------------ PRUSA BACKEND CFG  --------------*/
 #define HOST_URL_CAM_PATH           "/c/snapshot"           ///< path for sending photo to prusa connect
 #define HOST_URL_INFO_PATH          "/c/info"               ///< path for sending info to prusa connect
+#ifndef HOST_PORT
+#define HOST_PORT                   443                     ///< port of the backend. Other port is usable for local stand-in server, tools/prusa_connect_standin.py
+#endif
+#ifndef HOST_TLS_ENABLE
+#define HOST_TLS_ENABLE             true                    ///< enable/disable TLS for the backend connection. Disable only for local stand-in server
+#endif
+#define HOST_RESPONSE_TIMEOUT       10000                   ///< timeout for complete response from the backend [ms]
+#define HOST_RESPONSE_READ_BUFFER   128                     ///< size of the buffer for reading response from the backend [bytes]
+#define HTTP_PARSER_LINE_SIZE       128                     ///< maximum length of the parsed status/header line. Longer lines are truncated [bytes]
+#define HTTP_PARSER_MAX_HEADER_SIZE 4096                    ///< maximum size of the status line and headers [bytes]
+#define UPLOAD_RETRY_BASE_CONNECT   5000                    ///< base retry delay after failed TCP connection to the backend [ms]
+#define UPLOAD_RETRY_BASE_TLS       10000                   ///< base retry delay after failed TLS handshake [ms]
+#define UPLOAD_RETRY_BASE_SERVER    15000                   ///< base retry delay after 5xx or invalid response [ms]
+#define UPLOAD_RETRY_BASE_THROTTLE  30000                   ///< base retry delay after 429/503 response without Retry-After header [ms]
+#define UPLOAD_RETRY_MAX_DELAY      300000                  ///< maximum retry delay of the exponential backoff [ms]
+#define UPLOAD_RETRY_AFTER_MAX      3600                    ///< maximum honored value of the Retry-After header [s]
+#define UPLOAD_RETRY_WIFI_RECONNECT 4                       ///< count of consecutive failed TCP connections, after which is WiFi reconnected
+#define UPLOAD_STATS_HISTOGRAM_SIZE 7                       ///< count of buckets of the upload latency histogram
 #define REFRESH_INTERVAL_MIN        5                       ///< minimum refresh interval for sending photo to prusa connect [s]
 #define REFRESH_INTERVAL_MAX        240                     ///< maximum refresh interval for sending photo to prusa connect [s]
 
@@ -49,28 +67,133 @@
 #define TASK_SERIAL_CFG             1000                    ///< serial cfg task interval [ms]
 #define TASK_STREAM_TELEMETRY       30000                   ///< stream telemetry task interval [ms]
 #define TASK_WIFI_WATCHDOG          20000                   ///< wifi watchdog task interval [ms]
-#define TASK_PHOTO_SEND             1000                    ///< photo send task interval [ms]
+#define SERVICE_MAX_JOBS            10                      ///< maximum count of jobs in the service task
+#define SERVICE_MAX_SLEEP           1000                    ///< service task maximum sleep between two WDG resets [ms]
+#define TASK_SERVICE_STATS          60000                   ///< service task, print run-time statistics of the jobs interval [ms]
+#define TASK_CORE_LOAD              5000                    ///< service task, per-core load measurement window [ms]
+#define TASK_PHOTO_SEND_MAX_SLEEP   10000                   ///< photo send task maximum sleep between two WDG resets. Task is woken up by deadline or notification [ms]
+
+/* ---------------- TASKS CORES -----------------*/
+/* core 0 runs WiFi/LwIP stack, core 1 runs Arduino loop(). Capture, JPEG handling and TLS upload are moved out of the WiFi core */
+#define TASK_CORE_SYSTEM            1                       ///< core for system task (NTP, OTA version check over TLS)
+#define TASK_CORE_PHOTO             1                       ///< core for capture photo and TLS upload to backend
+#define TASK_CORE_WIFI              0                       ///< core for WiFi management, network-facing work
+#define TASK_CORE_SERVICE           0                       ///< core for service task (LED, serial cfg, SD card check, WiFi watchdog)
+#define TASK_CORE_ANALYSIS          0                       ///< core for frame analysis. Low priority, capture and upload on the other core are not blocked
 
 /* --------------- WEB SERVER CFG  --------------*/
 #define WEB_SERVER_PORT             80                      ///< WEB server port 
 #define SERIAL_PORT_SPEED           115200                  ///< baud rate 
 #define WDG_TIMEOUT                 40                      ///< wdg timeout [second]
 #define PHOTO_FRAGMENT_SIZE         5000                    ///< photo fragmentation size [bytes]
+#define PHOTO_STORE_FRAMES          4                       ///< count of the photo buffers. Published photo, photos referenced by readers and new photo
+#define PHOTO_STORE_ALIGN           16384                   ///< size of the photo buffer is rounded up, buffer is not reallocated for every photo [bytes]
 #define LOOP_DELAY                  100                     ///< loop delay [ms]
 #define WIFI_CLIENT_WAIT_CON        false                   ///< wait for connecting to WiFi network
 #define DYNMIC_JSON_SIZE            1024                    ///< maximum size for dynamic json [bytes]
 #define WEB_CACHE_INTERVAL          86400                   ///< cache interval for browser [s] 86400s = 24h
 
+/* ---------------- HEAP BUDGET  ----------------*/
+#define HEAP_BUDGET_TLS_FREE        40000                   ///< minimum free internal heap for open TLS connection [bytes]
+#define HEAP_BUDGET_TLS_BLOCK       20000                   ///< minimum largest free internal heap block for open TLS connection [bytes]
+#define HEAP_BUDGET_TLS_WAIT        3000                    ///< maximum waiting time for free heap before TLS connection [ms]
+#define HEAP_BUDGET_WEB_FREE        20000                   ///< minimum free internal heap for accept heavy WEB request (photo, stream, logs, json) [bytes]
+#define HEAP_BUDGET_WEB_BLOCK       8000                    ///< minimum largest free internal heap block for accept heavy WEB request [bytes]
+#define HEAP_BUDGET_RETRY_AFTER     "2"                     ///< Retry-After value for refused WEB request [s]
+
 /* --------------- OTA UPDATE CFG  --------------*/
 #define OTA_UPDATE_API_SERVER       "api.github.com"        ///< OTA update server URL
 #define OTA_UPDATE_API_URL          "/repos/prusa3d/Prusa-Firmware-ESP32-Cam/releases/latest"  ///< path to file with OTA update
 #define OTA_UPDATE_FW_FILE          "ESP32_PrusaConnectCam.ino.bin" ///< OTA update firmware file name
 
 /* ---------- RESET CFG CONFIGURATION  ----------*/
-#define CFG_RESET_PIN               12                      ///< GPIO 16 is for reset CFG to default
+#define CFG_RESET_PIN               12                      ///< GPIO 12 is for reset CFG to default. Not available in the micro SD card 4-bit mode
 #define CFG_RESET_TIME_WAIT         10000                   ///< wait to 10 000 ms = 10s for reset cfg during grounded CFG_RESET_PIN 
 #define CFG_RESET_LOOP_DELAY        100                     ///< delay in the loop for reset cfg
 
+/* ---------------- SPAN TRACING ----------------*/
+#define TRACE_ENABLE                false                   ///< enable/disable span tracing. When is disabled, tracing is compiled out
+#define TRACE_BUFFER_SIZE           512                     ///< count of begin/end events in the ring buffer
+#define TRACE_MAX_THREADS           16                      ///< maximum count of tasks in the trace export
+
+/* ------------ OFFLINE SNAPSHOT QUEUE ----------*/
+#define QUEUE_DIR                   "/queue"                ///< directory on the micro SD card for snapshots, which were not uploaded
+#define QUEUE_MAX_COUNT             500                     ///< maximum count of snapshots in the queue
+#define QUEUE_MAX_BYTES             (100 * 1024 * 1024)     ///< maximum size of snapshots in the queue [bytes]
+#define QUEUE_DRAIN_INTERVAL        3000                    ///< minimum interval between uploads of the queued snapshots [ms]
+
+/* ------------------ TIMELAPSE -----------------*/
+#define TIMELAPSE_DIR               "/timelapse"            ///< directory on the micro SD card for timelapse sessions
+#define TIMELAPSE_FPS               25                      ///< frame rate of the timelapse video [fps]
+#define TIMELAPSE_MAX_FRAMES        7200                    ///< maximum count of frames in one AVI file. Next frames are saved to the new file
+#define TIMELAPSE_MAX_SEGMENT_SIZE  1073741824UL            ///< maximum size of the frame chunks in one AVI file, AVI 1.0 RIFF limit and FAT32 4 GB limit [bytes]
+#define TIMELAPSE_HEADER_PATCH      10                      ///< AVI header is updated every N frames
+#define TIMELAPSE_NAME_LENGTH       32                      ///< maximum length of the session name
+
+/* --------------- FRAME ANALYSIS ---------------*/
+#define ANALYSIS_MAX_ROI            4                       ///< maximum count of the regions of interest
+#define ANALYSIS_MAX_WIDTH          256                     ///< maximum width of the downscaled frame. Scale 1/2, 1/4 or 1/8 is selected by the photo width [px]
+#define ANALYSIS_MAX_HEIGHT         256                     ///< maximum height of the downscaled frame [px]
+#define ANALYSIS_WARMUP_FRAMES      3                       ///< count of frames for the background model before first analysis
+#define ANALYSIS_BACKGROUND_WEIGHT  16                      ///< weight of the background model. New frame has weight 1/N
+#define ANALYSIS_CONFIRM_FRAMES     2                       ///< count of consecutive frames over threshold for event
+#define ANALYSIS_STACK_SIZE         8000                    ///< stack size of the analysis task, thumbnail JPEG encoder runs in this task
+#define ANALYSIS_PRIORITY           1                       ///< priority of the analysis task
+
+/* --------------- MOTION TRIGGER ---------------*/
+#define MOTION_SAMPLE_INTERVAL      1000                    ///< interval of the camera sampling for motion detection [ms]
+#define MOTION_GRID_WIDTH           16                      ///< width of the luminance grid [cells]
+#define MOTION_GRID_HEIGHT          12                      ///< height of the luminance grid [cells]
+#define MOTION_MIN_CELLS            2                       ///< minimum count of changed cells for motion
+#define MOTION_BURST_PHOTOS         3                       ///< count of full resolution photos after detected motion
+#define MOTION_BURST_INTERVAL       5000                    ///< interval between burst photos [ms]
+#define MOTION_COOLDOWN             30000                   ///< pause of the motion detection after burst [ms]
+
+/* ----------------- THUMBNAIL ------------------*/
+#define THUMB_MAX_WIDTH             320                     ///< maximum width of the thumbnail. Scale 1/2, 1/4 or 1/8 is selected by the photo width [px]
+#define THUMB_MAX_HEIGHT            320                     ///< maximum height of the thumbnail [px]
+#define THUMB_QUALITY               60                      ///< JPEG quality of the thumbnail, 1-100
+#define THUMB_JPEG_MAX_SIZE         32768                   ///< size of the thumbnail buffer [bytes]
+
+/* ---------------- SD FILE CACHE ---------------*/
+#define SD_FILE_CACHE_COUNT         2                       ///< count of files kept open for appending. Log file and one more
+#define SD_FILE_CACHE_BUFFER        1024                    ///< size of the write buffer of the open file [bytes]
+#define SD_FILE_CACHE_FLUSH         5000                    ///< interval of the write buffers flush and sync to the card [ms]
+
+/* ---------------- SD CARD HEALTH --------------*/
+#define SD_REINIT_DELAY_MIN         TASK_SDCARD             ///< first delay of the card reinit after failure [ms]
+#define SD_REINIT_DELAY_MAX         (30 * 60 * 1000)        ///< maximum delay of the card reinit, delay is doubled after every failed reinit [ms]
+#define SD_HEALTH_SLOW_WRITE        100000                  ///< write latency for the slow card state [us]
+#define SD_HEALTH_LATENCY_WEIGHT    8                       ///< weight of the moving average of the write latency
+#define SD_HEALTH_MIN_FREE          (32ULL * 1024 * 1024)   ///< minimum free space for the media files [bytes]
+#define SD_HEALTH_SPACE_INTERVAL    (5 * 60 * 1000)         ///< interval of the free space check [ms]
+#define SD_RAM_LOG_SIZE             8192                    ///< size of the RAM log in the degraded mode [bytes]
+
+/* ----------------- SD BENCHMARK ---------------*/
+#define SD_BENCHMARK_FILE           "/sd_benchmark.tmp"     ///< temporary file for the micro SD card benchmark
+#define SD_BENCHMARK_SIZE           (1024 * 1024)           ///< size of the sequential write/read test [bytes]
+#define SD_BENCHMARK_BLOCK          4096                    ///< size of one block of the sequential write/read test [bytes]
+#define SD_BENCHMARK_APPENDS        50                      ///< count of small appends in the append latency test
+#define SD_BENCHMARK_APPEND_SIZE    100                     ///< size of one small append, approximately one log line [bytes]
+#define SD_BENCHMARK_STACK_SIZE     4096                    ///< stack size of the benchmark task
+#define SD_BENCHMARK_PRIORITY       1                       ///< priority of the benchmark task
+
+/* ------------------ MEDIA FILES ---------------*/
+#define MEDIA_READ_CHUNK            4096                    ///< maximum size of one read from the micro SD card during download. Short reads on the 1-bit SD bus [bytes]
+#define MEDIA_MAX_DOWNLOADS         2                       ///< maximum count of parallel downloads of the media files
+#define MEDIA_CACHE_MAX_ENTRIES     512                     ///< maximum count of items in the cached directory listing
+#define MEDIA_CACHE_TIMEOUT         10000                   ///< validity of the cached directory listing [ms]
+#define MEDIA_NAME_LENGTH           48                      ///< maximum length of the file name in the directory listing
+#define MEDIA_LIST_PAGE_SIZE        50                      ///< default count of items on one page of the directory listing
+#define MEDIA_LIST_PAGE_MAX         200                     ///< maximum count of items on one page of the directory listing
+
+/* --------------- STREAM BENCHMARK -------------*/
+#ifndef STREAM_SYNTHETIC_SOURCE
+#define STREAM_SYNTHETIC_SOURCE     false                   ///< enable/disable replay of JPEG frames from micro SD card instead of camera module in the stream. Only for benchmark
+#endif
+#define STREAM_SYNTHETIC_PATH       "/synthetic"            ///< directory on the micro SD card with JPEG frames for synthetic source
+#define STREAM_SYNTHETIC_MAX_FRAMES 16                      ///< maximum count of frames loaded to the PSRAM for synthetic source
+
 /* ---------------- MicroSD Logs ----------------*/
 #define LOGS_FILE_NAME              "SysLog.log"            ///< syslog file name
 #define LOGS_FILE_PATH              "/"                     ///< directory for log files
@@ -89,6 +212,17 @@
 
 /* ----------------- WiFi CFG -------------------*/
 #define WIFI_STA_WDG_TIMEOUT        60000                   ///< STA watchdog timeout [ms]
+#define WIFI_SCAN_MIN_INTERVAL      15000                   ///< minimum interval between two WiFi scans [ms]
+#define WIFI_FAST_CONNECT_TIMEOUT   10000                   ///< maximum time for fast connect with cached BSSID, channel and IP [ms]
+#define WIFI_FAST_CONNECT_LEASE     3600                    ///< lifetime of the cached DHCP lease, shorter than lease time of common DHCP servers [s]
+#define WIFI_ROAMING_ENABLE         true                    ///< enable/disable roaming between APs with the same SSID
+#define WIFI_ROAMING_RSSI_THRESHOLD -75                     ///< averaged RSSI, below this value is started roaming scan [dBm]
+#define WIFI_ROAMING_HYSTERESIS     8                       ///< candidate AP must be better than current AP at least about this value [dB]
+#define WIFI_ROAMING_RSSI_SAMPLES   3                       ///< weight of the RSSI moving average, in samples
+#define WIFI_ROAMING_SCAN_INTERVAL  60000                   ///< minimum interval between two roaming scans [ms]
+#define WIFI_ROAMING_SCAN_DWELL     120                     ///< roaming scan time per channel [ms]
+#define WIFI_ROAMING_MIN_INTERVAL   120000                  ///< minimum interval between two roamings [ms]
+#define WIFI_SCAN_DWELL             300                     ///< standard scan time per channel [ms]
 
 /* ---------------- FACTORY CFG  ----------------*/
 #define FACTORY_CFG_PHOTO_REFRESH_INTERVAL    30                ///< in the second
@@ -119,6 +253,18 @@
 #define FACTORY_CFG_GAIN_CTRL                 1                 ///< enable automatic gain
 #define FACTORY_CFG_AGC_GAIN                  0                 ///< automatic gain controll gain
 #define FACTORY_CFG_HOSTNAME                  "connect.prusa3d.com"  ///< hostname for Prusa Connect
+#define FACTORY_CFG_WIFI_FAST_CONNECT         true              ///< fast connect to WiFi with cached BSSID, channel and IP address
+#define FACTORY_CFG_WIFI_POWER_PROFILE        1                 ///< WiFi power profile. 0 = performance, 1 = balanced, 2 = low-power
+#define FACTORY_CFG_SNAPSHOT_QUEUE            false             ///< save snapshots to the micro SD card, when is upload not possible
+#define FACTORY_CFG_ANALYSIS                  false             ///< enable print failure heuristic
+#define FACTORY_CFG_ANALYSIS_CHANGE           40                ///< default change threshold of the full frame region
+#define FACTORY_CFG_ANALYSIS_TEXTURE          12                ///< default texture threshold of the full frame region
+#define FACTORY_CFG_MOTION                    false             ///< enable motion triggered burst capture
+#define FACTORY_CFG_MOTION_THRESHOLD          20                ///< minimum change of the cell luminance for motion
+/* 4-bit mode uses GPIO 4 (D1, flash LED) and GPIO 12 (D2, reset cfg pin). GPIO 12 is strapping pin MTDI, which selects the flash voltage.
+   Pull-up of the D2 line holds it HIGH during reset, the flash is then powered by 1.8V and ESP32-CAM with 3.3V flash does not boot.
+   Before the 4-bit mode is enabled, the flash voltage must be fixed in eFuse: espefuse.py set_flash_voltage 3.3V (irreversible) */
+#define FACTORY_CFG_SD_BUS_4BIT               false             ///< micro SD card in 4-bit mode. Flash LED and reset cfg pin are not available in 4-bit mode
 
 /* ---------------- CFG FLAGS  ------------------*/
 #define CFG_WIFI_SETTINGS_SAVED               0x0A              ///< flag saved config
@@ -233,6 +379,52 @@
 #define EEPROM_ADDR_HOSTNAME_START                (EEPROM_ADDR_LOG_LEVEL + EEPROM_ADDR_LOG_LEVEL_LENGTH)
 #define EEPROM_ADDR_HOSTNAME_LENGTH               51
 
+#define EEPROM_ADDR_WIFI_FAST_CONNECT_START       (EEPROM_ADDR_HOSTNAME_START + EEPROM_ADDR_HOSTNAME_LENGTH)
+#define EEPROM_ADDR_WIFI_FAST_CONNECT_LENGTH      1
+
+#define EEPROM_ADDR_WIFI_CACHE_BSSID_START        (EEPROM_ADDR_WIFI_FAST_CONNECT_START + EEPROM_ADDR_WIFI_FAST_CONNECT_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_BSSID_LENGTH       6
+
+#define EEPROM_ADDR_WIFI_CACHE_CHANNEL_START      (EEPROM_ADDR_WIFI_CACHE_BSSID_START + EEPROM_ADDR_WIFI_CACHE_BSSID_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_CHANNEL_LENGTH     1
+
+#define EEPROM_ADDR_WIFI_CACHE_IP_START           (EEPROM_ADDR_WIFI_CACHE_CHANNEL_START + EEPROM_ADDR_WIFI_CACHE_CHANNEL_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_IP_LENGTH          4
+
+#define EEPROM_ADDR_WIFI_CACHE_MASK_START         (EEPROM_ADDR_WIFI_CACHE_IP_START + EEPROM_ADDR_WIFI_CACHE_IP_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_MASK_LENGTH        4
+
+#define EEPROM_ADDR_WIFI_CACHE_GATEWAY_START      (EEPROM_ADDR_WIFI_CACHE_MASK_START + EEPROM_ADDR_WIFI_CACHE_MASK_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_GATEWAY_LENGTH     4
+
+#define EEPROM_ADDR_WIFI_CACHE_DNS_START          (EEPROM_ADDR_WIFI_CACHE_GATEWAY_START + EEPROM_ADDR_WIFI_CACHE_GATEWAY_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_DNS_LENGTH         4
+
+#define EEPROM_ADDR_WIFI_POWER_PROFILE_START      (EEPROM_ADDR_WIFI_CACHE_DNS_START + EEPROM_ADDR_WIFI_CACHE_DNS_LENGTH)
+#define EEPROM_ADDR_WIFI_POWER_PROFILE_LENGTH     1
+
+#define EEPROM_ADDR_SNAPSHOT_QUEUE_START          (EEPROM_ADDR_WIFI_POWER_PROFILE_START + EEPROM_ADDR_WIFI_POWER_PROFILE_LENGTH)
+#define EEPROM_ADDR_SNAPSHOT_QUEUE_LENGTH         1
+
+#define EEPROM_ADDR_SD_BUS_4BIT_START             (EEPROM_ADDR_SNAPSHOT_QUEUE_START + EEPROM_ADDR_SNAPSHOT_QUEUE_LENGTH)
+#define EEPROM_ADDR_SD_BUS_4BIT_LENGTH            1
+
+#define EEPROM_ADDR_ANALYSIS_ENABLE_START         (EEPROM_ADDR_SD_BUS_4BIT_START + EEPROM_ADDR_SD_BUS_4BIT_LENGTH)
+#define EEPROM_ADDR_ANALYSIS_ENABLE_LENGTH        1
+
+#define EEPROM_ADDR_ANALYSIS_ROI_START            (EEPROM_ADDR_ANALYSIS_ENABLE_START + EEPROM_ADDR_ANALYSIS_ENABLE_LENGTH)
+#define EEPROM_ADDR_ANALYSIS_ROI_SIZE             6                                                                                       ///< x, y, width, height, change threshold, texture threshold
+#define EEPROM_ADDR_ANALYSIS_ROI_LENGTH           (ANALYSIS_MAX_ROI * EEPROM_ADDR_ANALYSIS_ROI_SIZE)
+
+#define EEPROM_ADDR_MOTION_ENABLE_START           (EEPROM_ADDR_ANALYSIS_ROI_START + EEPROM_ADDR_ANALYSIS_ROI_LENGTH)
+#define EEPROM_ADDR_MOTION_ENABLE_LENGTH          1
+
+#define EEPROM_ADDR_MOTION_THRESHOLD_START        (EEPROM_ADDR_MOTION_ENABLE_START + EEPROM_ADDR_MOTION_ENABLE_LENGTH)
+#define EEPROM_ADDR_MOTION_THRESHOLD_LENGTH       1
+
+#define EEPROM_ADDR_WIFI_CACHE_LEASE_START        (EEPROM_ADDR_MOTION_THRESHOLD_START + EEPROM_ADDR_MOTION_THRESHOLD_LENGTH)
+#define EEPROM_ADDR_WIFI_CACHE_LEASE_LENGTH       4
+
 #define EEPROM_SIZE (EEPROM_ADDR_REFRESH_INTERVAL_LENGTH + EEPROM_ADDR_FINGERPRINT_LENGTH + EEPROM_ADDR_TOKEN_LENGTH + \
                      EEPROM_ADDR_FRAMESIZE_LENGTH + EEPROM_ADDR_BRIGHTNESS_LENGTH + EEPROM_ADDR_CONTRAST_LENGTH + \
                      EEPROM_ADDR_SATURATION_LENGTH + EEPROM_ADDR_HMIRROR_LENGTH + EEPROM_ADDR_VFLIP_LENGTH + \
@@ -245,7 +437,12 @@
                      EEPROM_ADDR_AWB_MODE_ENABLE_LENGTH + EEPROM_ADDR_BPC_ENABLE_LENGTH + EEPROM_ADDR_WPC_ENABLE_LENGTH + \
                      EEPROM_ADDR_RAW_GAMA_ENABLE_LENGTH + EEPROM_ADDR_AEC2_LENGTH + EEPROM_ADDR_AE_LEVEL_LENGTH + \
                      EEPROM_ADDR_AEC_VALUE_LENGTH + EEPROM_ADDR_GAIN_CTRL_LENGTH + EEPROM_ADDR_AGC_GAIN_LENGTH + EEPROM_ADDR_LOG_LEVEL_LENGTH + \
-                     EEPROM_ADDR_HOSTNAME_LENGTH )    ///< how many bits do we need for eeprom memory
+                     EEPROM_ADDR_HOSTNAME_LENGTH + EEPROM_ADDR_WIFI_FAST_CONNECT_LENGTH + EEPROM_ADDR_WIFI_CACHE_BSSID_LENGTH + \
+                     EEPROM_ADDR_WIFI_CACHE_CHANNEL_LENGTH + EEPROM_ADDR_WIFI_CACHE_IP_LENGTH + EEPROM_ADDR_WIFI_CACHE_MASK_LENGTH + \
+                     EEPROM_ADDR_WIFI_CACHE_GATEWAY_LENGTH + EEPROM_ADDR_WIFI_CACHE_DNS_LENGTH + \
+                     EEPROM_ADDR_WIFI_POWER_PROFILE_LENGTH + EEPROM_ADDR_SNAPSHOT_QUEUE_LENGTH + EEPROM_ADDR_SD_BUS_4BIT_LENGTH + \
+                     EEPROM_ADDR_ANALYSIS_ENABLE_LENGTH + EEPROM_ADDR_ANALYSIS_ROI_LENGTH + EEPROM_ADDR_MOTION_ENABLE_LENGTH + \
+                     EEPROM_ADDR_MOTION_THRESHOLD_LENGTH + EEPROM_ADDR_WIFI_CACHE_LEASE_LENGTH )    ///< how many bits do we need for eeprom memory
 
 #endif
 
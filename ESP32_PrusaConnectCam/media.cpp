@@ -0,0 +1,364 @@
+/**
+   @file media.cpp
+
+   @brief Access to the media files on the micro SD card from the WEB server. Timelapse videos and queued snapshots
+
+   Directory listing is cached, so the FAT is not walked for every page of the listing.
+   Files are sent in chunks of MEDIA_READ_CHUNK bytes. One chunk is read by one call of the response filler,
+   so async_tcp task and the photo task (shared SD card) are blocked only for one short read.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "media.h"
+
+MediaLibrary SystemMediaLibrary(&SystemLog);
+
+/**
+ * @brief Construct a new MediaLibrary::MediaLibrary object
+ *
+ * @param Logs* - pointer to Logs class
+ */
+MediaLibrary::MediaLibrary(Logs *i_log) {
+  log = i_log;
+  Cache = NULL;
+  CacheCount = 0;
+  CacheTruncated = false;
+  CacheDir = "";
+  CacheTime = 0;
+  CacheGeneration = 0;
+  Generation = 1;
+  Downloads = 0;
+}
+
+/**
+ * @brief Check if path is inside of the media directories
+ *
+ * @param String - path
+ * @return bool - true if path is allowed
+ */
+bool MediaLibrary::CheckPath(String i_path) {
+  if ((i_path.indexOf("..") >= 0) || (i_path.indexOf("//") >= 0) || (i_path.indexOf('\\') >= 0)) {
+    return false;
+  }
+
+  const char *dirs[] = { TIMELAPSE_DIR, QUEUE_DIR };
+  for (uint8_t i = 0; i < (sizeof(dirs) / sizeof(dirs[0])); i++) {
+    String dir = String(dirs[i]);
+    if ((i_path == dir) || i_path.startsWith(dir + "/")) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Media content was changed. Cached listing is not valid
+ *
+ */
+void MediaLibrary::Invalidate() {
+  Generation++;
+}
+
+/**
+ * @brief Check if is cached listing valid for the directory
+ *
+ * @param String - directory
+ * @return bool - true if cache is valid
+ */
+bool MediaLibrary::CheckCache(String i_dir) {
+  return ((NULL != Cache) && (CacheDir == i_dir) && (CacheGeneration == Generation) && ((millis() - CacheTime) < MEDIA_CACHE_TIMEOUT));
+}
+
+/**
+ * @brief Walk directory and save items to the cache
+ *
+ * @param String - directory
+ * @return bool - true if directory was loaded
+ */
+bool MediaLibrary::LoadDir(String i_dir) {
+  if (NULL == Cache) {
+    Cache = (MediaEntry *)heap_caps_malloc(MEDIA_CACHE_MAX_ENTRIES * sizeof(MediaEntry), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (NULL == Cache) {
+      log->AddEvent(LogLevel_Error, "Media: not enough memory for directory cache");
+      return false;
+    }
+  }
+
+  /* changes during the walk invalidate the cache */
+  uint32_t generation = Generation;
+  CacheDir = "";
+  CacheCount = 0;
+  CacheTruncated = false;
+
+  File dir = SD_MMC.open(i_dir);
+  if ((!dir) || (!dir.isDirectory())) {
+    return false;
+  }
+
+  File file = dir.openNextFile();
+  while (file) {
+    const char *name = file.name();
+    if (CacheCount >= MEDIA_CACHE_MAX_ENTRIES) {
+      CacheTruncated = true;
+    } else if (strlen(name) < MEDIA_NAME_LENGTH) {
+      MediaEntry *entry = &Cache[CacheCount++];
+      strcpy(entry->Name, name);
+      entry->Directory = file.isDirectory();
+      entry->Size = (true == entry->Directory) ? 0 : file.size();
+    }
+    file.close();
+    file = dir.openNextFile();
+  }
+  dir.close();
+
+  CacheDir = i_dir;
+  CacheTime = millis();
+  CacheGeneration = generation;
+  log->AddEvent(LogLevel_Verbose, "Media: loaded " + i_dir + ", items: " + String(CacheCount));
+
+  return true;
+}
+
+/**
+ * @brief Get one page of the directory listing in json format
+ *
+ * @param String - directory
+ * @param uint16_t - page, from 0
+ * @param uint16_t - items per page
+ * @return String - json, empty string if directory is not available
+ */
+String MediaLibrary::GetListJson(String i_dir, uint16_t i_page, uint16_t i_per_page) {
+  if ((false == log->GetCardDetectedStatus()) || (false == CheckPath(i_dir))) {
+    return "";
+  }
+
+  bool cached = CheckCache(i_dir);
+  if ((false == cached) && (false == LoadDir(i_dir))) {
+    return "";
+  }
+
+  if (0 == i_per_page) {
+    i_per_page = MEDIA_LIST_PAGE_SIZE;
+  } else if (i_per_page > MEDIA_LIST_PAGE_MAX) {
+    i_per_page = MEDIA_LIST_PAGE_MAX;
+  }
+
+  JsonDocument doc_json;
+  String string_json = "";
+  doc_json["dir"] = i_dir;
+  doc_json["page"] = i_page;
+  doc_json["per_page"] = i_per_page;
+  doc_json["total"] = CacheCount;
+  doc_json["pages"] = (CacheCount + i_per_page - 1) / i_per_page;
+  doc_json["truncated"] = CacheTruncated;
+  doc_json["cached"] = cached;
+
+  JsonArray entries = doc_json["entries"].to<JsonArray>();
+  uint32_t first = (uint32_t)i_page * i_per_page;
+  for (uint32_t i = first; (i < CacheCount) && (i < (first + i_per_page)); i++) {
+    JsonObject entry = entries.add<JsonObject>();
+    entry["name"] = (const char *)Cache[i].Name;
+    entry["size"] = Cache[i].Size;
+    entry["dir"] = Cache[i].Directory;
+  }
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/**
+ * @brief Parse single range of the Range header. Format: bytes=start-end, bytes=start- or bytes=-suffix
+ *
+ * @param String - value of the Range header
+ * @param uint32_t - size of the file
+ * @param uint32_t& - first byte of the range
+ * @param uint32_t& - last byte of the range
+ * @return MediaRangeStatus - status. Invalid and multiple ranges are ignored
+ */
+MediaRangeStatus MediaLibrary::ParseRange(String i_range, uint32_t i_size, uint32_t &o_start, uint32_t &o_end) {
+  i_range.trim();
+  if ((false == i_range.startsWith("bytes=")) || (i_range.indexOf(',') >= 0)) {
+    return MediaRangeNone;
+  }
+
+  String range = i_range.substring(6);
+  int dash = range.indexOf('-');
+  if (dash < 0) {
+    return MediaRangeNone;
+  }
+
+  String first = range.substring(0, dash);
+  String last = range.substring(dash + 1);
+  first.trim();
+  last.trim();
+  char *end = NULL;
+
+  if (0 == first.length()) {
+    /* suffix range, last N bytes */
+    if (0 == last.length()) {
+      return MediaRangeNone;
+    }
+    uint32_t suffix = strtoul(last.c_str(), &end, 10);
+    if ('\0' != *end) {
+      return MediaRangeNone;
+    }
+    if ((0 == suffix) || (0 == i_size)) {
+      return MediaRangeUnsatisfiable;
+    }
+    o_start = (suffix >= i_size) ? 0 : (i_size - suffix);
+    o_end = i_size - 1;
+    return MediaRangeValid;
+  }
+
+  uint32_t start = strtoul(first.c_str(), &end, 10);
+  if ('\0' != *end) {
+    return MediaRangeNone;
+  }
+  uint32_t stop = i_size - 1;
+  if (last.length() > 0) {
+    stop = strtoul(last.c_str(), &end, 10);
+    if (('\0' != *end) || (stop < start)) {
+      return MediaRangeNone;
+    }
+  }
+
+  if (start >= i_size) {
+    return MediaRangeUnsatisfiable;
+  }
+
+  o_start = start;
+  o_end = (stop >= i_size) ? (i_size - 1) : stop;
+  return MediaRangeValid;
+}
+
+/**
+ * @brief Get content type by file extension
+ *
+ * @param String - path
+ * @return String - content type
+ */
+String MediaLibrary::GetContentType(String i_path) {
+  String ret = "application/octet-stream";
+
+  if (i_path.endsWith(".avi")) {
+    ret = "video/x-msvideo";
+  } else if (i_path.endsWith(".jpg")) {
+    ret = "image/jpeg";
+  } else if (i_path.endsWith(".json")) {
+    ret = "application/json";
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Register new download. Count of parallel downloads is limited
+ *
+ * @return bool - true if download is allowed
+ */
+bool MediaLibrary::DownloadBegin() {
+  if (Downloads >= MEDIA_MAX_DOWNLOADS) {
+    return false;
+  }
+
+  Downloads++;
+  return true;
+}
+
+/**
+ * @brief Download was finished or aborted
+ *
+ */
+void MediaLibrary::DownloadEnd() {
+  if (Downloads > 0) {
+    Downloads--;
+  }
+}
+
+/**
+ * @brief Get count of active downloads
+ *
+ * @return uint8_t - count
+ */
+uint8_t MediaLibrary::GetDownloads() {
+  return Downloads;
+}
+
+/**
+ * @brief Construct a new Async Media File Response:: Async Media File Response object
+ *
+ * @param File - opened media file
+ * @param uint32_t - first byte of the range
+ * @param uint32_t - length of the range
+ * @param bool - true for partial content response
+ * @param String - content type
+ */
+AsyncMediaFileResponse::AsyncMediaFileResponse(File i_file, uint32_t i_start, uint32_t i_length, bool i_partial, String i_contentType) {
+  _file = i_file;
+  _remaining = i_length;
+  _callback = nullptr;
+  _code = (true == i_partial) ? 206 : 200;
+  _contentLength = i_length;
+  _contentType = i_contentType;
+
+  addHeader("Accept-Ranges", "bytes");
+  if (true == i_partial) {
+    uint32_t end = (i_length > 0) ? (i_start + i_length - 1) : i_start;
+    addHeader("Content-Range", "bytes " + String(i_start) + "-" + String(end) + "/" + String((uint32_t)_file.size()));
+  }
+
+  if (i_start > 0) {
+    _file.seek(i_start);
+  }
+}
+
+/**
+ * @brief Destroy the Async Media File Response:: Async Media File Response object
+ *
+ */
+AsyncMediaFileResponse::~AsyncMediaFileResponse() {
+  if (_file) {
+    _file.close();
+  }
+  SystemMediaLibrary.DownloadEnd();
+}
+
+/**
+ * @brief Check if source is valid
+ *
+ * @return bool
+ */
+bool AsyncMediaFileResponse::_sourceValid() const {
+  return (bool)_file;
+}
+
+/**
+ * @brief Fill buffer. One call reads maximum MEDIA_READ_CHUNK bytes from the micro SD card
+ *
+ * @param uint8_t* - buffer
+ * @param size_t - size of buffer
+ * @return size_t - count of bytes
+ */
+size_t AsyncMediaFileResponse::_fillBuffer(uint8_t *buf, size_t maxLen) {
+  size_t len = min(min(maxLen, _remaining), (size_t)MEDIA_READ_CHUNK);
+  if ((0 == len) || (!_file)) {
+    return 0;
+  }
+
+  size_t ret = _file.read(buf, len);
+  _remaining -= ret;
+
+  /* file handle is released before the end of the TCP transfer */
+  if ((0 == _remaining) || (0 == ret)) {
+    _file.close();
+  }
+
+  return ret;
+}
+
+/* EOF */
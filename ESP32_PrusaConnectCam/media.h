@@ -0,0 +1,93 @@
+/**
+   @file media.h
+
+   @brief Access to the media files on the micro SD card from the WEB server. Timelapse videos and queued snapshots
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _MEDIA_H_
+#define _MEDIA_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#include "Arduino.h"
+#include "FS.h"
+#include "SD_MMC.h"
+#include <ArduinoJson.h>
+#include <esp_heap_caps.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+
+/**
+ * @brief MediaRangeStatus enum
+ * result of the Range header parsing
+ */
+enum MediaRangeStatus {
+  MediaRangeNone = 0,           ///< range is missing or invalid, whole file is sent
+  MediaRangeValid = 1,          ///< range is valid, part of the file is sent
+  MediaRangeUnsatisfiable = 2,  ///< range is outside of the file
+};
+
+/**
+ * @brief MediaEntry struct
+ * one item of the cached directory listing
+ */
+struct MediaEntry {
+  char Name[MEDIA_NAME_LENGTH];   ///< name of the file or directory
+  uint32_t Size;                  ///< size of the file [bytes]
+  bool Directory;                 ///< item is directory
+};
+
+class MediaLibrary {
+private:
+  MediaEntry *Cache;              ///< cached directory listing, allocated in PSRAM
+  uint16_t CacheCount;            ///< count of items in the cache
+  bool CacheTruncated;            ///< directory has more items than cache
+  String CacheDir;                ///< cached directory
+  uint32_t CacheTime;             ///< time of the directory walk [ms]
+  uint32_t CacheGeneration;       ///< generation of the media content at the time of the directory walk
+  volatile uint32_t Generation;   ///< generation of the media content, incremented by every change
+  uint8_t Downloads;              ///< count of active downloads
+  Logs *log;                      ///< pointer to logs object
+
+  bool CheckCache(String);
+  bool LoadDir(String);
+
+public:
+  MediaLibrary(Logs *);
+  ~MediaLibrary(){};
+
+  bool CheckPath(String);
+  String GetListJson(String, uint16_t, uint16_t);
+  void Invalidate();
+  MediaRangeStatus ParseRange(String, uint32_t, uint32_t &, uint32_t &);
+  String GetContentType(String);
+
+  bool DownloadBegin();
+  void DownloadEnd();
+  uint8_t GetDownloads();
+};
+
+class AsyncMediaFileResponse : public AsyncAbstractResponse {
+private:
+  File _file;           ///< media file
+  size_t _remaining;    ///< count of bytes to send
+
+public:
+  AsyncMediaFileResponse(File, uint32_t, uint32_t, bool, String);
+  ~AsyncMediaFileResponse();
+  bool _sourceValid() const;
+  virtual size_t _fillBuffer(uint8_t *, size_t) override;
+};
+
+extern MediaLibrary SystemMediaLibrary;  ///< global variable for media library
+
+#endif
+
+/* EOF */
@@ -20,6 +20,51 @@ MicroSd::MicroSd() {
   CardDetected = false;
   CardSize = 0;
   DetectAfterBoot = false;
+  Bus4Bit = false;
+  memset(&Benchmark, 0, sizeof(Benchmark));
+  memset(&Health, 0, sizeof(Health));
+  Health.ReinitDelay = SD_REINIT_DELAY_MIN;
+  RamLog = NULL;
+  RamLogUsed = 0;
+  RamLogPath = "";
+  for (uint8_t i = 0; i < SD_FILE_CACHE_COUNT; i++) {
+    FileCache[i].Path = "";
+    FileCache[i].Buffer = NULL;
+    FileCache[i].Used = 0;
+    FileCache[i].Size = 0;
+    FileCache[i].LastUse = 0;
+    FileCache[i].Dirty = false;
+  }
+  FileCacheLock = xSemaphoreCreateMutex();
+}
+
+/**
+   @brief Task for the micro SD card benchmark. Task is deleted after the benchmark
+   @param void* - pointer to MicroSd class
+   @return none
+*/
+static void MicroSd_TaskBenchmark(void *pvParameters) {
+  MicroSd *card = (MicroSd *)pvParameters;
+  card->RunBenchmark();
+  vTaskDelete(NULL);
+}
+
+/**
+   @brief Set micro SD card bus width. Must be set before InitSdCard
+   @param bool - true = 4-bit mode, false = 1-bit mode
+   @return none
+*/
+void MicroSd::SetBus4Bit(bool i_data) {
+  Bus4Bit = i_data;
+}
+
+/**
+   @brief Get used micro SD card bus width
+   @param none
+   @return bool - true = 4-bit mode, false = 1-bit mode
+*/
+bool MicroSd::GetBus4Bit() {
+  return Bus4Bit;
 }
 
 /**
@@ -29,6 +74,7 @@ MicroSd::MicroSd() {
 */
 void MicroSd::ReinitCard() {
   Serial.println("Reinit micro SD card!");
+  CloseFiles();
   Serial.println("Deinit micro SD card");
   SD_MMC.end();
   delay(50);
@@ -46,8 +92,18 @@ void MicroSd::InitSdCard() {
   Serial.println("Start init micro-SD Card");
 
   /* set SD card to 1-line/1-bit mode. GPIO 4 is used for LED and for microSD card. But communication is slower. */
+  /* 4-bit mode is faster, but flash LED on the GPIO 4 can't be used */
   /* https://github.com/espressif/arduino-esp32/blob/master/libraries/SD_MMC/src/SD_MMC.h */
-  if (!SD_MMC.begin("/sdcard", true)) {
+  bool mounted = SD_MMC.begin("/sdcard", !Bus4Bit);
+  if ((false == mounted) && (true == Bus4Bit)) {
+    /* board without D1-D3 lines wiring, fallback to 1-bit mode */
+    Serial.println("SD Card Mount Failed in 4-bit mode, try 1-bit mode");
+    Bus4Bit = false;
+    SD_MMC.end();
+    mounted = SD_MMC.begin("/sdcard", true);
+  }
+
+  if (false == mounted) {
     Serial.println("SD Card Mount Failed");
     CardDetected = false;
     CardSize = 0;
@@ -79,7 +135,7 @@ void MicroSd::InitSdCard() {
 
   /* calculation card size */
   CardSize = SD_MMC.cardSize() / (1024 * 1024);
-  Serial.printf(", Card Size: %d MB\n", CardSize);
+  Serial.printf(", Card Size: %d MB, bus: %s\n", CardSize, (true == Bus4Bit) ? "4-bit" : "1-bit");
   CardDetected = true;
   DetectAfterBoot = true;
 }
@@ -209,6 +265,7 @@ bool MicroSd::WriteFile(fs::FS &fs, String path, String message) {
     Serial.printf("Writing file: %s... ", path.c_str());
 #endif
 
+    CloseCachedFile(path);
     File file = fs.open(path.c_str(), FILE_WRITE);
     if (!file) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
@@ -228,7 +285,8 @@ bool MicroSd::WriteFile(fs::FS &fs, String path, String message) {
 }
 
 /**
-   @brief Added text to end of file
+   @brief Added text to end of file. File is kept open and data are buffered.
+          Buffer is written when is full, data are synced to the card by FlushFiles
    @param fs::FS - card
    @param String - file name
    @param String - message
@@ -241,26 +299,217 @@ bool MicroSd::AppendFile(fs::FS &fs, String path, String message) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
     Serial.printf("Appending to file: %s... ", path.c_str());
 #endif
+    xSemaphoreTake(FileCacheLock, portMAX_DELAY);
 
-    File file = fs.open(path.c_str(), FILE_APPEND);
-    if (!file) {
+    int8_t slot = OpenCachedFile(fs, path);
+    if (slot < 0) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
       Serial.println("Failed to open file for appending");
 #endif
-      CardDetected = false;
+      RecordWrite(false, 0);
+      SetDegraded();
+      RamLogAppend(path, message);
     } else {
-      if (file.print(message.c_str())) {
-        status = true;
-      } 
+      MicroSdCachedFile *entry = &FileCache[slot];
+      size_t len = message.length();
+      status = true;
+
+      /* buffer is full */
+      if ((entry->Used + len) > SD_FILE_CACHE_BUFFER) {
+        status = FlushCachedFile(slot, false);
+      }
+
+      if (true == status) {
+        if ((NULL == entry->Buffer) || (len > SD_FILE_CACHE_BUFFER)) {
+          int64_t start = esp_timer_get_time();
+          status = (entry->Handle.write((const uint8_t *)message.c_str(), len) == len);
+          RecordWrite(status, (uint32_t)(esp_timer_get_time() - start));
+        } else {
+          memcpy(&entry->Buffer[entry->Used], message.c_str(), len);
+          entry->Used += len;
+        }
+      }
+
+      if (true == status) {
+        entry->Size += len;
+        entry->Dirty = true;
+        entry->LastUse = millis();
+      } else {
+        /* card was removed or is damaged, card is reinitialized by the SD card check */
+        CloseCachedFile((uint8_t)slot);
+        SetDegraded();
+        RamLogAppend(path, message);
+      }
 
 #if (true == CONSOLE_VERBOSE_DEBUG)
       Serial.println((status == true) ? "Message appended" : "Append Failed");
 #endif
     }
+
+    xSemaphoreGive(FileCacheLock);
+  } else {
+    /* degraded mode, messages are kept in RAM */
+    xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+    RamLogAppend(path, message);
+    xSemaphoreGive(FileCacheLock);
+  }
+  return status;
+}
+
+/**
+   @brief Find open file in the cache. Mutex must be taken
+   @param String - file name
+   @return int8_t - index of the cache slot, -1 = file is not open
+*/
+int8_t MicroSd::FindCachedFile(String path) {
+  for (uint8_t i = 0; i < SD_FILE_CACHE_COUNT; i++) {
+    if ((FileCache[i].Path == path) && (FileCache[i].Handle)) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+   @brief Get open file from the cache or open file for appending. The least recently used file is closed,
+          when is cache full. Mutex must be taken
+   @param fs::FS - card
+   @param String - file name
+   @return int8_t - index of the cache slot, -1 = file can't be opened
+*/
+int8_t MicroSd::OpenCachedFile(fs::FS &fs, String path) {
+  int8_t slot = FindCachedFile(path);
+  if (slot >= 0) {
+    return slot;
+  }
+
+  /* free slot or the least recently used file */
+  slot = 0;
+  for (uint8_t i = 0; i < SD_FILE_CACHE_COUNT; i++) {
+    if (!FileCache[i].Handle) {
+      slot = i;
+      break;
+    }
+    if (FileCache[i].LastUse < FileCache[slot].LastUse) {
+      slot = i;
+    }
+  }
+  CloseCachedFile((uint8_t)slot);
+
+  MicroSdCachedFile *entry = &FileCache[slot];
+  entry->Handle = fs.open(path.c_str(), FILE_APPEND);
+  if (!entry->Handle) {
+    return -1;
+  }
+
+  /* without buffer is data written directly */
+  if (NULL == entry->Buffer) {
+    entry->Buffer = (uint8_t *)malloc(SD_FILE_CACHE_BUFFER);
+  }
+  entry->Path = path;
+  entry->Used = 0;
+  entry->Size = entry->Handle.size();
+  entry->Dirty = false;
+
+  return slot;
+}
+
+/**
+   @brief Write buffer to the file. Mutex must be taken
+   @param uint8_t - index of the cache slot
+   @param bool - sync data to the card
+   @return bool - status
+*/
+bool MicroSd::FlushCachedFile(uint8_t slot, bool sync) {
+  MicroSdCachedFile *entry = &FileCache[slot];
+  bool status = true;
+
+  if (!entry->Handle) {
+    return false;
+  }
+
+  int64_t start = esp_timer_get_time();
+  bool access = false;
+  if (entry->Used > 0) {
+    status = (entry->Handle.write(entry->Buffer, entry->Used) == entry->Used);
+    entry->Used = 0;
+    access = true;
   }
+
+  if ((true == sync) && (true == entry->Dirty)) {
+    entry->Handle.flush();
+    entry->Dirty = false;
+    access = true;
+  }
+
+  if (true == access) {
+    RecordWrite(status, (uint32_t)(esp_timer_get_time() - start));
+  }
+
   return status;
 }
 
+/**
+   @brief Write buffer and close the file. Mutex must be taken
+   @param uint8_t - index of the cache slot
+   @return none
+*/
+void MicroSd::CloseCachedFile(uint8_t slot) {
+  MicroSdCachedFile *entry = &FileCache[slot];
+
+  if (entry->Handle) {
+    FlushCachedFile(slot, false);
+    entry->Handle.close();
+  }
+  entry->Path = "";
+  entry->Used = 0;
+  entry->Dirty = false;
+}
+
+/**
+   @brief Close file before rename, delete or rewrite
+   @param String - file name
+   @return none
+*/
+void MicroSd::CloseCachedFile(String path) {
+  xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+  int8_t slot = FindCachedFile(path);
+  if (slot >= 0) {
+    CloseCachedFile((uint8_t)slot);
+  }
+  xSemaphoreGive(FileCacheLock);
+}
+
+/**
+   @brief Write buffers and sync all open files to the card. Called periodically and before the file download
+   @param none
+   @return none
+*/
+void MicroSd::FlushFiles() {
+  xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+  for (uint8_t i = 0; i < SD_FILE_CACHE_COUNT; i++) {
+    if ((FileCache[i].Handle) && (false == FlushCachedFile(i, true))) {
+      CloseCachedFile(i);
+      SetDegraded();
+    }
+  }
+  xSemaphoreGive(FileCacheLock);
+}
+
+/**
+   @brief Write buffers and close all open files. Before reboot or card reinit
+   @param none
+   @return none
+*/
+void MicroSd::CloseFiles() {
+  xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+  for (uint8_t i = 0; i < SD_FILE_CACHE_COUNT; i++) {
+    CloseCachedFile(i);
+  }
+  xSemaphoreGive(FileCacheLock);
+}
+
 /**
    @brief Rename file on the SD card
    @param fs::FS - card
@@ -274,6 +523,7 @@ bool MicroSd::RenameFile(fs::FS &fs, String path1, String path2) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
     Serial.printf("Renaming file %s to %s... ", path1.c_str(), path2.c_str());
 #endif
+    CloseCachedFile(path1);
     if (fs.rename(path1.c_str(), path2.c_str())) {
       status = true;
     }
@@ -298,6 +548,7 @@ bool MicroSd::DeleteFile(fs::FS &fs, String path) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
     Serial.printf("Deleting file: %s... ", path.c_str());
 #endif
+    CloseCachedFile(path);
     if (fs.remove(path.c_str())) {
       status = true;
     }
@@ -317,26 +568,40 @@ bool MicroSd::DeleteFile(fs::FS &fs, String path) {
    @return uint32_t - size
 */
 uint32_t MicroSd::GetFileSize(fs::FS &fs, String path) {
+  return GetFileSizeBytes(fs, path) / 1024; /* convert from bytes to kb */
+}
+
+/**
+   @brief Get file size in the bytes. Size of the open file is known without access to the card
+   @param fs::FS - card
+   @param String - file name
+   @return uint32_t - size, 0 = file does not exist
+*/
+uint32_t MicroSd::GetFileSizeBytes(fs::FS &fs, String path) {
   uint32_t ret = 0;
   if (true == CardDetected) {
 #if (true == CONSOLE_VERBOSE_DEBUG)
     Serial.printf("Getting file size: %s... ", path.c_str());
 #endif
-    File file = fs.open(path.c_str(), FILE_APPEND);
-    if (!file) {
-#if (true == CONSOLE_VERBOSE_DEBUG)
-      Serial.println("Failed to open file for appending");
-#endif
-      return 0;
+    xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+    int8_t slot = FindCachedFile(path);
+    if (slot >= 0) {
+      ret = FileCache[slot].Size;
     }
+    xSemaphoreGive(FileCacheLock);
 
-    ret = file.size() / 1024; /* convert from bytes to kb */
+    if ((slot < 0) && (true == fs.exists(path.c_str()))) {
+      File file = fs.open(path.c_str(), FILE_READ);
+      if (file) {
+        ret = file.size();
+      }
+    }
 #if (true == CONSOLE_VERBOSE_DEBUG)
     Serial.printf(" File size: %d\n ", ret);
 #endif
   }
 
-  return ret; /* kb*/
+  return ret;
 }
 
 /**
@@ -416,4 +681,398 @@ bool MicroSd::GetCardDetectAfterBoot() {
   return DetectAfterBoot;
 }
 
+/**
+   @brief Record result and latency of the write to the card
+   @param bool - status of the write
+   @param uint32_t - latency [us]
+   @return none
+*/
+void MicroSd::RecordWrite(bool status, uint32_t latency) {
+  if (false == status) {
+    Health.WriteErrors++;
+    return;
+  }
+
+  Health.LatencyLast = latency;
+  if (0 == Health.LatencyAvg) {
+    Health.LatencyAvg = latency;
+  } else {
+    Health.LatencyAvg = Health.LatencyAvg - (Health.LatencyAvg / SD_HEALTH_LATENCY_WEIGHT) + (latency / SD_HEALTH_LATENCY_WEIGHT);
+  }
+  Health.LatencyMax = max(Health.LatencyMax, latency);
+  if (latency >= SD_HEALTH_SLOW_WRITE) {
+    Health.SlowWrites++;
+  }
+}
+
+/**
+   @brief Record result and latency of the write of the media file (timelapse, snapshot queue).
+          Failed write switches the card to the degraded mode, same as failed write of the log
+   @param bool - status of the write
+   @param uint32_t - latency [us]
+   @return none
+*/
+void MicroSd::RecordMediaWrite(bool status, uint32_t latency) {
+  xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+  RecordWrite(status, latency);
+  if (false == status) {
+    SetDegraded();
+  }
+  xSemaphoreGive(FileCacheLock);
+}
+
+/**
+   @brief Card failed. Logs are kept in RAM until the card is reinitialized
+   @param none
+   @return none
+*/
+void MicroSd::SetDegraded() {
+  if (true == CardDetected) {
+    Serial.println("Micro SD card failed, degraded mode");
+    CardDetected = false;
+    Health.DegradedSince = millis();
+  }
+}
+
+/**
+   @brief Save message to the RAM log. The oldest messages are removed when is RAM log full. Mutex must be taken
+   @param String - file name
+   @param String - message
+   @return none
+*/
+void MicroSd::RamLogAppend(String path, String message) {
+  if (NULL == RamLog) {
+    RamLog = (char *)heap_caps_malloc(SD_RAM_LOG_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (NULL == RamLog) {
+      return;
+    }
+  }
+
+  const char *data = message.c_str();
+  size_t len = message.length();
+  if (len > SD_RAM_LOG_SIZE) {
+    data += len - SD_RAM_LOG_SIZE;
+    len = SD_RAM_LOG_SIZE;
+  }
+
+  /* remove the oldest messages */
+  if ((RamLogUsed + len) > SD_RAM_LOG_SIZE) {
+    size_t drop = (RamLogUsed + len) - SD_RAM_LOG_SIZE;
+    while ((drop < RamLogUsed) && ('\n' != RamLog[drop - 1])) {
+      drop++;
+    }
+    memmove(RamLog, &RamLog[drop], RamLogUsed - drop);
+    RamLogUsed -= drop;
+  }
+
+  memcpy(&RamLog[RamLogUsed], data, len);
+  RamLogUsed += len;
+  RamLogPath = path;
+}
+
+/**
+   @brief Write RAM log to the card after recovery. Mutex must be taken
+   @param none
+   @return none
+*/
+void MicroSd::RamLogRestore() {
+  if ((0 == RamLogUsed) || (RamLogPath == "")) {
+    return;
+  }
+
+  int8_t slot = OpenCachedFile(SD_MMC, RamLogPath);
+  if (slot < 0) {
+    return;
+  }
+
+  String header = "---- " + String(RamLogUsed) + " bytes of log from degraded mode ----\n";
+  FileCache[slot].Handle.print(header);
+  FileCache[slot].Handle.write((const uint8_t *)RamLog, RamLogUsed);
+  FileCache[slot].Size += header.length() + RamLogUsed;
+  FileCache[slot].Dirty = true;
+  FlushCachedFile((uint8_t)slot, true);
+  RamLogUsed = 0;
+}
+
+/**
+   @brief Update used and total space of the card. FAT free cluster count is cached by the FatFs
+   @param none
+   @return none
+*/
+void MicroSd::UpdateSpace() {
+  Health.TotalBytes = SD_MMC.totalBytes();
+  Health.UsedBytes = SD_MMC.usedBytes();
+  Health.SpaceCheck = millis();
+}
+
+/**
+   @brief Periodic check of the card health. Failed card is reinitialized with exponential delay
+   @param none
+   @return uint32_t - delay to the next check [ms]
+*/
+uint32_t MicroSd::CheckHealth() {
+  if (false == DetectAfterBoot) {
+    return TASK_SDCARD;
+  }
+
+  if (false == CardDetected) {
+    ReinitCard();
+    if (false == CardDetected) {
+      uint32_t delay = Health.ReinitDelay;
+      Health.ReinitFailures++;
+      Health.ReinitDelay = min(Health.ReinitDelay * 2, (uint32_t)SD_REINIT_DELAY_MAX);
+      return delay;
+    }
+
+    Health.Reinits++;
+    Health.ReinitDelay = SD_REINIT_DELAY_MIN;
+    Health.DegradedSince = 0;
+    Health.SpaceCheck = 0;
+    xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+    RamLogRestore();
+    xSemaphoreGive(FileCacheLock);
+  }
+
+  if ((0 == Health.SpaceCheck) || ((millis() - Health.SpaceCheck) >= SD_HEALTH_SPACE_INTERVAL)) {
+    UpdateSpace();
+  }
+
+  return TASK_SDCARD;
+}
+
+/**
+   @brief Get health state of the card
+   @param none
+   @return SdHealthState - state
+*/
+SdHealthState MicroSd::GetHealthState() {
+  SdHealthState ret = SdHealth_Ok;
+
+  if (false == CardDetected) {
+    ret = (true == DetectAfterBoot) ? SdHealth_Degraded : SdHealth_NotPresent;
+  } else if ((Health.TotalBytes > 0) && ((Health.TotalBytes - Health.UsedBytes) < SD_HEALTH_MIN_FREE)) {
+    ret = SdHealth_LowSpace;
+  } else if (Health.LatencyAvg >= SD_HEALTH_SLOW_WRITE) {
+    ret = SdHealth_Slow;
+  }
+
+  return ret;
+}
+
+/**
+   @brief Get health state of the card as string
+   @param none
+   @return String - state
+*/
+String MicroSd::GetHealthStateString() {
+  String ret = "";
+
+  switch (GetHealthState()) {
+    case SdHealth_Ok:
+      ret = "ok";
+      break;
+    case SdHealth_Slow:
+      ret = "slow";
+      break;
+    case SdHealth_LowSpace:
+      ret = "low_space";
+      break;
+    case SdHealth_Degraded:
+      ret = "degraded";
+      break;
+    case SdHealth_NotPresent:
+      ret = "not_present";
+      break;
+    default:
+      ret = "unknown";
+      break;
+  }
+
+  return ret;
+}
+
+/**
+   @brief Check if is writing of the media files allowed. Logs are written in all states
+   @param none
+   @return bool - true if timelapse and snapshot queue can write to the card
+*/
+bool MicroSd::GetWriteAllowed() {
+  SdHealthState state = GetHealthState();
+  return ((SdHealth_Ok == state) || (SdHealth_Slow == state));
+}
+
+/**
+   @brief Get health of the card in json format
+   @param none
+   @return String - json
+*/
+String MicroSd::GetHealthJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["state"] = GetHealthStateString();
+  doc_json["card_detected"] = CardDetected;
+  doc_json["bus"] = (true == Bus4Bit) ? "4-bit" : "1-bit";
+  doc_json["card_size_mb"] = CardSize;
+  doc_json["total_bytes"] = Health.TotalBytes;
+  doc_json["used_bytes"] = Health.UsedBytes;
+  doc_json["free_bytes"] = (Health.TotalBytes >= Health.UsedBytes) ? (Health.TotalBytes - Health.UsedBytes) : 0;
+  doc_json["write_errors"] = Health.WriteErrors;
+  doc_json["slow_writes"] = Health.SlowWrites;
+  doc_json["latency_last_us"] = Health.LatencyLast;
+  doc_json["latency_avg_us"] = Health.LatencyAvg;
+  doc_json["latency_max_us"] = Health.LatencyMax;
+  doc_json["reinits"] = Health.Reinits;
+  doc_json["reinit_failures"] = Health.ReinitFailures;
+  doc_json["reinit_delay_s"] = Health.ReinitDelay / 1000;
+  doc_json["degraded_s"] = (SdHealth_Degraded == GetHealthState()) ? ((millis() - Health.DegradedSince) / 1000) : 0;
+  doc_json["ram_log_bytes"] = RamLogUsed;
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/**
+   @brief Get messages from the RAM log
+   @param none
+   @return String - log messages
+*/
+String MicroSd::GetRamLog() {
+  xSemaphoreTake(FileCacheLock, portMAX_DELAY);
+  String ret = (RamLogUsed > 0) ? String(RamLog, RamLogUsed) : String("");
+  xSemaphoreGive(FileCacheLock);
+
+  return ret;
+}
+
+/**
+   @brief Start micro SD card benchmark in the separate task. WEB server is not blocked
+   @param none
+   @return bool - true if benchmark was started
+*/
+bool MicroSd::StartBenchmark() {
+  if ((false == CardDetected) || (true == Benchmark.Running)) {
+    return false;
+  }
+
+  Benchmark.Running = true;
+  if (pdPASS != xTaskCreatePinnedToCore(MicroSd_TaskBenchmark, "SdBenchmark", SD_BENCHMARK_STACK_SIZE, this, SD_BENCHMARK_PRIORITY, NULL, TASK_CORE_SYSTEM)) {
+    Benchmark.Running = false;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+   @brief Micro SD card benchmark. Sequential write and read of SD_BENCHMARK_SIZE bytes
+          and latency of the small appends with open/close, same as the log writes
+   @param none
+   @return none
+*/
+void MicroSd::RunBenchmark() {
+  SdBenchmarkResult result;
+  memset(&result, 0, sizeof(result));
+  result.Bus4Bit = Bus4Bit;
+
+  /* DMA capable buffer in the internal RAM */
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(SD_BENCHMARK_BLOCK, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+  if (NULL == buf) {
+    Serial.println("SD benchmark: not enough memory");
+    Benchmark.Running = false;
+    return;
+  }
+  for (uint16_t i = 0; i < SD_BENCHMARK_BLOCK; i++) {
+    buf[i] = (uint8_t)i;
+  }
+
+  bool status = true;
+  uint32_t blocks = SD_BENCHMARK_SIZE / SD_BENCHMARK_BLOCK;
+
+  /* sequential write */
+  File file = SD_MMC.open(SD_BENCHMARK_FILE, FILE_WRITE);
+  if (!file) {
+    status = false;
+  } else {
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; (i < blocks) && (true == status); i++) {
+      status = (file.write(buf, SD_BENCHMARK_BLOCK) == SD_BENCHMARK_BLOCK);
+    }
+    file.close();
+    int64_t elapsed = esp_timer_get_time() - start;
+    result.WriteSpeed = (elapsed > 0) ? (uint32_t)(((uint64_t)blocks * SD_BENCHMARK_BLOCK * 1000000) / elapsed) : 0;
+  }
+
+  /* sequential read */
+  if (true == status) {
+    file = SD_MMC.open(SD_BENCHMARK_FILE, FILE_READ);
+    if (!file) {
+      status = false;
+    } else {
+      int64_t start = esp_timer_get_time();
+      for (uint32_t i = 0; (i < blocks) && (true == status); i++) {
+        status = (file.read(buf, SD_BENCHMARK_BLOCK) == SD_BENCHMARK_BLOCK);
+      }
+      file.close();
+      int64_t elapsed = esp_timer_get_time() - start;
+      result.ReadSpeed = (elapsed > 0) ? (uint32_t)(((uint64_t)blocks * SD_BENCHMARK_BLOCK * 1000000) / elapsed) : 0;
+    }
+  }
+
+  /* small appends */
+  uint64_t total = 0;
+  for (uint16_t i = 0; (i < SD_BENCHMARK_APPENDS) && (true == status); i++) {
+    int64_t start = esp_timer_get_time();
+    file = SD_MMC.open(SD_BENCHMARK_FILE, FILE_APPEND);
+    if (!file) {
+      status = false;
+      break;
+    }
+    status = (file.write(buf, SD_BENCHMARK_APPEND_SIZE) == SD_BENCHMARK_APPEND_SIZE);
+    file.close();
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - start);
+    total += latency;
+    result.AppendMax = max(result.AppendMax, latency);
+  }
+  result.AppendAvg = (uint32_t)(total / SD_BENCHMARK_APPENDS);
+
+  SD_MMC.remove(SD_BENCHMARK_FILE);
+  free(buf);
+
+  result.Valid = status;
+  result.Timestamp = millis();
+  Benchmark = result;
+  Serial.printf("SD benchmark: %s, write %u B/s, read %u B/s, append avg %u us, max %u us\n", (true == status) ? "done" : "failed",
+                result.WriteSpeed, result.ReadSpeed, result.AppendAvg, result.AppendMax);
+}
+
+/**
+   @brief Get result of the micro SD card benchmark in json format
+   @param none
+   @return String - json
+*/
+String MicroSd::GetBenchmarkJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["running"] = Benchmark.Running;
+  doc_json["valid"] = Benchmark.Valid;
+  doc_json["bus"] = (true == Bus4Bit) ? "4-bit" : "1-bit";
+  doc_json["card_size_mb"] = CardSize;
+  if (true == Benchmark.Valid) {
+    doc_json["benchmark_bus"] = (true == Benchmark.Bus4Bit) ? "4-bit" : "1-bit";
+    doc_json["size"] = SD_BENCHMARK_SIZE;
+    doc_json["block"] = SD_BENCHMARK_BLOCK;
+    doc_json["write_bytes_per_s"] = Benchmark.WriteSpeed;
+    doc_json["read_bytes_per_s"] = Benchmark.ReadSpeed;
+    doc_json["append_size"] = SD_BENCHMARK_APPEND_SIZE;
+    doc_json["append_avg_us"] = Benchmark.AppendAvg;
+    doc_json["append_max_us"] = Benchmark.AppendMax;
+    doc_json["age_s"] = (millis() - Benchmark.Timestamp) / 1000;
+  }
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
 /* EOF */
\ No newline at end of file
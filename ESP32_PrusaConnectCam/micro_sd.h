@@ -27,15 +27,97 @@
 #include "Arduino.h"
 #include "FS.h"
 #include "SD_MMC.h"
+#include "esp_timer.h"
+#include <esp_heap_caps.h>
+#include <ArduinoJson.h>
 
 #include "mcu_cfg.h"
 #include "var.h"
 
+/**
+ * @brief SdBenchmarkResult struct
+ * result of the micro SD card benchmark
+ */
+struct SdBenchmarkResult {
+  bool Running;             ///< benchmark is running
+  bool Valid;               ///< result is valid
+  bool Bus4Bit;             ///< bus width during the benchmark
+  uint32_t WriteSpeed;      ///< sequential write throughput [B/s]
+  uint32_t ReadSpeed;       ///< sequential read throughput [B/s]
+  uint32_t AppendAvg;       ///< average latency of the small append, open + write + close [us]
+  uint32_t AppendMax;       ///< maximum latency of the small append [us]
+  uint32_t Timestamp;       ///< time of the benchmark [ms]
+};
+
+/**
+ * @brief SdHealthState enum
+ * health state of the micro SD card
+ */
+enum SdHealthState {
+  SdHealth_Ok = 0,          ///< card is working
+  SdHealth_Slow = 1,        ///< average write latency is high
+  SdHealth_LowSpace = 2,    ///< free space is low, media files are not written
+  SdHealth_Degraded = 3,    ///< card failed after boot, logs are kept in RAM, reinit with exponential delay
+  SdHealth_NotPresent = 4,  ///< card was not detected after boot
+};
+
+/**
+ * @brief SdHealthStatistics struct
+ * statistics of the micro SD card health monitor
+ */
+struct SdHealthStatistics {
+  uint32_t WriteErrors;     ///< count of failed opens and writes
+  uint32_t SlowWrites;      ///< count of writes slower than SD_HEALTH_SLOW_WRITE
+  uint32_t LatencyLast;     ///< latency of the last write [us]
+  uint32_t LatencyAvg;      ///< exponential moving average of the write latency [us]
+  uint32_t LatencyMax;      ///< maximum write latency [us]
+  uint32_t Reinits;         ///< count of successful reinits after failure
+  uint32_t ReinitFailures;  ///< count of failed reinits
+  uint32_t ReinitDelay;     ///< delay to the next reinit [ms]
+  uint32_t DegradedSince;   ///< time of the card failure [ms], 0 = card is working
+  uint32_t SpaceCheck;      ///< time of the last free space check [ms]
+  uint64_t TotalBytes;      ///< size of the FAT partition [bytes]
+  uint64_t UsedBytes;       ///< used space of the FAT partition [bytes]
+};
+
+/**
+ * @brief MicroSdCachedFile struct
+ * open file with the write buffer. Hot files are not opened and closed for every write
+ */
+struct MicroSdCachedFile {
+  String Path;              ///< path of the file, empty = free slot
+  File Handle;              ///< open file
+  uint8_t *Buffer;          ///< write buffer
+  uint16_t Used;            ///< count of bytes in the write buffer
+  uint32_t Size;            ///< size of the file including write buffer [bytes]
+  uint32_t LastUse;         ///< time of the last write [ms]
+  bool Dirty;               ///< file has data, which are not synced to the card
+};
+
 class MicroSd {
 private:
   bool CardDetected;      ///< Card detected status
   uint16_t CardSize;      ///< Card size
   bool DetectAfterBoot;   ///< Card detect after boot
+  bool Bus4Bit;           ///< Card is used in 4-bit mode
+  SdBenchmarkResult Benchmark;  ///< result of the last benchmark
+  MicroSdCachedFile FileCache[SD_FILE_CACHE_COUNT];  ///< cache of the open files
+  SemaphoreHandle_t FileCacheLock;                   ///< mutex, files are written from more tasks
+  SdHealthStatistics Health;                         ///< health monitor statistics
+  char *RamLog;                                      ///< log messages, which were not written to the card in degraded mode
+  uint16_t RamLogUsed;                               ///< count of bytes in the RAM log
+  String RamLogPath;                                 ///< file for the RAM log after card recovery
+
+  int8_t OpenCachedFile(fs::FS &, String);
+  int8_t FindCachedFile(String);
+  bool FlushCachedFile(uint8_t, bool);
+  void CloseCachedFile(uint8_t);
+  void CloseCachedFile(String);
+  void RecordWrite(bool, uint32_t);
+  void SetDegraded();
+  void RamLogAppend(String, String);
+  void RamLogRestore();
+  void UpdateSpace();
 
 public:
   MicroSd();
@@ -43,6 +125,12 @@ public:
 
   void InitSdCard();
   void ReinitCard();
+  void SetBus4Bit(bool);
+  bool GetBus4Bit();
+
+  bool StartBenchmark();
+  void RunBenchmark();
+  String GetBenchmarkJson();
 
   void ListDir(fs::FS &, String, uint8_t);
   bool CreateDir(fs::FS &, String);
@@ -53,11 +141,22 @@ public:
   bool RenameFile(fs::FS &, String, String);
   bool DeleteFile(fs::FS &, String);
   uint32_t GetFileSize(fs::FS &, String);
+  uint32_t GetFileSizeBytes(fs::FS &, String);
   uint16_t FileCount(fs::FS &, String, String);
+  void FlushFiles();
+  void CloseFiles();
 
   bool GetCardDetectedStatus();
   uint16_t GetCardSize();
   bool GetCardDetectAfterBoot();
+
+  uint32_t CheckHealth();
+  SdHealthState GetHealthState();
+  String GetHealthStateString();
+  String GetHealthJson();
+  bool GetWriteAllowed();
+  void RecordMediaWrite(bool, uint32_t);
+  String GetRamLog();
 };
 
 #endif
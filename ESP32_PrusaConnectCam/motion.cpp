@@ -0,0 +1,382 @@
+/**
+   @file motion.cpp
+
+   @brief Motion trigger. Low cost sampling of the camera between photos and burst capture after detected motion
+
+   Photo task samples the camera every MOTION_SAMPLE_INTERVAL. Sample is decoded at scale 1/8 (DC coefficients only)
+   and reduced to the MOTION_GRID_WIDTH x MOTION_GRID_HEIGHT grid of the mean luminance.
+   Global change of the luminance (auto exposure) is subtracted, motion is detected, when at least MOTION_MIN_CELLS
+   cells are changed more than threshold. Detected motion starts burst of MOTION_BURST_PHOTOS full resolution photos,
+   which are uploaded or recorded immediately. Sampling continues after MOTION_COOLDOWN, regular interval is not changed.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "motion.h"
+
+MotionTrigger SystemMotion(&SystemConfig, &SystemLog, &SystemCamera);
+
+/**
+ * @brief MotionDecode struct
+ * context of the JPEG decoder callbacks
+ */
+struct MotionDecode {
+  const uint8_t *Data;  ///< JPEG data
+  size_t Length;        ///< length of JPEG data
+  uint32_t *Sum;        ///< output sum of the luminance in the cells
+  uint16_t *Count;      ///< output count of pixels in the cells
+  uint16_t Width;       ///< width of the decoded frame
+  uint16_t Height;      ///< height of the decoded frame
+};
+
+/**
+ * @brief JPEG decoder input callback
+ *
+ * @param void* - decode context
+ * @param size_t - index of the data
+ * @param uint8_t* - output buffer, NULL = skip data
+ * @param size_t - length of requested data
+ * @return size_t - count of bytes
+ */
+static size_t Motion_JpegReader(void *arg, size_t index, uint8_t *buf, size_t len) {
+  MotionDecode *decode = (MotionDecode *)arg;
+
+  if (index >= decode->Length) {
+    return 0;
+  }
+  if ((index + len) > decode->Length) {
+    len = decode->Length - index;
+  }
+  if (NULL != buf) {
+    memcpy(buf, decode->Data + index, len);
+  }
+
+  return len;
+}
+
+/**
+ * @brief JPEG decoder output callback. Luminance of the RGB888 block is added to the grid cells
+ *
+ * @param void* - decode context
+ * @param uint16_t - x position of the block
+ * @param uint16_t - y position of the block
+ * @param uint16_t - width of the block
+ * @param uint16_t - height of the block
+ * @param uint8_t* - RGB888 data, NULL = start or end of the image
+ * @return bool - false stops decoding
+ */
+static bool Motion_JpegWriter(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  MotionDecode *decode = (MotionDecode *)arg;
+
+  if (NULL == data) {
+    /* start of the image, size of the output */
+    if ((0 == x) && (0 == y)) {
+      decode->Width = w;
+      decode->Height = h;
+    }
+    return true;
+  }
+
+  if ((0 == decode->Width) || (0 == decode->Height) || ((x + w) > decode->Width) || ((y + h) > decode->Height)) {
+    return false;
+  }
+
+  for (uint16_t iy = 0; iy < h; iy++) {
+    uint16_t row = (((uint32_t)(y + iy) * MOTION_GRID_HEIGHT) / decode->Height) * MOTION_GRID_WIDTH;
+    for (uint16_t ix = 0; ix < w; ix++) {
+      uint16_t cell = row + (((uint32_t)(x + ix) * MOTION_GRID_WIDTH) / decode->Width);
+      decode->Sum[cell] += (data[0] + (2 * data[1]) + data[2]) >> 2;
+      decode->Count[cell]++;
+      data += 3;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Construct a new MotionTrigger::MotionTrigger object
+ *
+ * @param Configuration* - pointer to Configuration class
+ * @param Logs* - pointer to Logs class
+ * @param Camera* - pointer to Camera class
+ */
+MotionTrigger::MotionTrigger(Configuration *i_conf, Logs *i_log, Camera *i_camera) {
+  config = i_conf;
+  log = i_log;
+  camera = i_camera;
+  Enable = false;
+  Threshold = FACTORY_CFG_MOTION_THRESHOLD;
+  memset(Grid, 0, sizeof(Grid));
+  GridValid = false;
+  DecodeWidth = 0;
+  DecodeHeight = 0;
+  SampleDeadline = 0;
+  BurstDeadline = 0;
+  BurstRemaining = 0;
+  Samples = 0;
+  Errors = 0;
+  Events = 0;
+  BurstPhotos = 0;
+  CellsLast = 0;
+  TimeLast = 0;
+  TimeMax = 0;
+}
+
+/**
+ * @brief Load configuration from EEPROM
+ *
+ */
+void MotionTrigger::Init() {
+  Enable = config->LoadMotionEnable();
+  Threshold = config->LoadMotionThreshold();
+}
+
+/**
+ * @brief Check if is required photo by the motion trigger. Called from the photo task.
+ *        Sample is taken, when is sampling deadline expired
+ *
+ * @return bool - true if photo has to be taken now
+ */
+bool MotionTrigger::CheckCaptureRequired() {
+  if (false == Enable) {
+    BurstRemaining = 0;
+    GridValid = false;
+    return false;
+  }
+
+  int64_t now = esp_timer_get_time();
+
+  if (0 == BurstRemaining) {
+    if (now < SampleDeadline) {
+      return false;
+    }
+    SampleDeadline = now + ((int64_t)MOTION_SAMPLE_INTERVAL * 1000LL);
+
+    /* camera is used by the stream */
+    if (true == camera->GetStreamStatus()) {
+      GridValid = false;
+      return false;
+    }
+
+    if (false == Sample()) {
+      return false;
+    }
+
+    Events++;
+    BurstRemaining = MOTION_BURST_PHOTOS;
+    BurstDeadline = now;
+    log->AddEvent(LogLevel_Info, "Motion trigger: motion detected, changed cells: " + String(CellsLast));
+  }
+
+  if (now < BurstDeadline) {
+    return false;
+  }
+
+  BurstRemaining--;
+  BurstPhotos++;
+  BurstDeadline = now + ((int64_t)MOTION_BURST_INTERVAL * 1000LL);
+
+  if (0 == BurstRemaining) {
+    /* next sample is new reference, scene was changed by the motion */
+    GridValid = false;
+    SampleDeadline = now + ((int64_t)MOTION_COOLDOWN * 1000LL);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Take sample and compare it with the previous sample
+ *
+ * @return bool - true if motion was detected
+ */
+bool MotionTrigger::Sample() {
+  int64_t start = esp_timer_get_time();
+
+  camera_fb_t *fb = camera->CaptureSample();
+  if (NULL == fb) {
+    Errors++;
+    return false;
+  }
+  bool decoded = Decode(fb);
+  camera->CaptureSampleReturn(fb);
+  Samples++;
+
+  if (false == decoded) {
+    Errors++;
+    GridValid = false;
+    return false;
+  }
+
+  /* mean luminance of the cells and global change of the luminance */
+  uint8_t grid[MOTION_GRID_CELLS];
+  int32_t offset = 0;
+  uint16_t cells = 0;
+  for (uint16_t i = 0; i < MOTION_GRID_CELLS; i++) {
+    grid[i] = (CellCount[i] > 0) ? (CellSum[i] / CellCount[i]) : 0;
+    if (CellCount[i] > 0) {
+      offset += (int32_t)grid[i] - (int32_t)Grid[i];
+      cells++;
+    }
+  }
+  if (cells > 0) {
+    offset /= cells;
+  }
+
+  uint16_t changed = 0;
+  for (uint16_t i = 0; i < MOTION_GRID_CELLS; i++) {
+    if ((CellCount[i] > 0) && (abs((int32_t)grid[i] - (int32_t)Grid[i] - offset) >= Threshold)) {
+      changed++;
+    }
+  }
+
+  bool motion = (true == GridValid) && (changed >= MOTION_MIN_CELLS);
+  CellsLast = (true == GridValid) ? changed : 0;
+  memcpy(Grid, grid, sizeof(Grid));
+  GridValid = true;
+
+  TimeLast = (uint32_t)(esp_timer_get_time() - start);
+  TimeMax = max(TimeMax, TimeLast);
+
+  return motion;
+}
+
+/**
+ * @brief Decode sample to the luminance grid. Scale 1/8 is used, only DC coefficients are needed
+ *
+ * @param camera_fb_t* - sample frame
+ * @return bool - true if sample was decoded
+ */
+bool MotionTrigger::Decode(camera_fb_t *i_fb) {
+  memset(CellSum, 0, sizeof(CellSum));
+  memset(CellCount, 0, sizeof(CellCount));
+
+  MotionDecode decode;
+  decode.Data = i_fb->buf;
+  decode.Length = i_fb->len;
+  decode.Sum = CellSum;
+  decode.Count = CellCount;
+  decode.Width = 0;
+  decode.Height = 0;
+
+  if (ESP_OK != esp_jpg_decode(i_fb->len, JPG_SCALE_8X, Motion_JpegReader, Motion_JpegWriter, &decode)) {
+    return false;
+  }
+
+  /* new resolution, previous sample is not valid reference */
+  if ((decode.Width != DecodeWidth) || (decode.Height != DecodeHeight)) {
+    DecodeWidth = decode.Width;
+    DecodeHeight = decode.Height;
+    GridValid = false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Get count of ticks to the next sample or burst photo
+ *
+ * @param TickType_t - maximum count of ticks
+ * @return TickType_t - ticks to deadline
+ */
+TickType_t MotionTrigger::GetTicksToDeadline(TickType_t i_max) {
+  if (false == Enable) {
+    return i_max;
+  }
+
+  int64_t deadline = (BurstRemaining > 0) ? BurstDeadline : SampleDeadline;
+  int64_t remaining = deadline - esp_timer_get_time();
+  if (remaining <= 0) {
+    return 0;
+  }
+
+  /* round up, task must not wake up before deadline */
+  TickType_t ticks = pdMS_TO_TICKS((uint32_t)((remaining + 999) / 1000)) + 1;
+  return min(ticks, i_max);
+}
+
+/**
+ * @brief Enable/disable motion trigger
+ *
+ * @param bool - status
+ */
+void MotionTrigger::SetEnable(bool i_data) {
+  Enable = i_data;
+  config->SaveMotionEnable(Enable);
+
+  /* photo task recalculates the sleep time */
+  if (NULL != Task_CapturePhotoAndSend) {
+    xTaskNotifyGive(Task_CapturePhotoAndSend);
+  }
+}
+
+/**
+ * @brief Get status of the motion trigger
+ *
+ * @return bool - status
+ */
+bool MotionTrigger::GetEnable() {
+  return Enable;
+}
+
+/**
+ * @brief Set minimum change of the cell luminance for motion
+ *
+ * @param uint8_t - threshold, 1-255
+ */
+void MotionTrigger::SetThreshold(uint8_t i_data) {
+  Threshold = i_data;
+  config->SaveMotionThreshold(Threshold);
+}
+
+/**
+ * @brief Get minimum change of the cell luminance for motion
+ *
+ * @return uint8_t - threshold
+ */
+uint8_t MotionTrigger::GetThreshold() {
+  return Threshold;
+}
+
+/**
+ * @brief Get status of the burst capture
+ *
+ * @return bool - true if burst is running
+ */
+bool MotionTrigger::GetBurstActive() {
+  return (BurstRemaining > 0);
+}
+
+/**
+ * @brief Get configuration and statistics of the motion trigger in json format
+ *
+ * @return String - json
+ */
+String MotionTrigger::GetJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["enable"] = Enable;
+  doc_json["threshold"] = Threshold;
+  doc_json["burst_active"] = GetBurstActive();
+  doc_json["grid_width"] = MOTION_GRID_WIDTH;
+  doc_json["grid_height"] = MOTION_GRID_HEIGHT;
+  doc_json["sample_width"] = DecodeWidth;
+  doc_json["sample_height"] = DecodeHeight;
+  doc_json["samples"] = Samples;
+  doc_json["errors"] = Errors;
+  doc_json["events"] = Events;
+  doc_json["burst_photos"] = BurstPhotos;
+  doc_json["changed_cells"] = CellsLast;
+  doc_json["time_last_us"] = TimeLast;
+  doc_json["time_max_us"] = TimeMax;
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/* EOF */
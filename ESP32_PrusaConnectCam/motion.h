@@ -0,0 +1,79 @@
+/**
+   @file motion.h
+
+   @brief Motion trigger. Low cost sampling of the camera between photos and burst capture after detected motion
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _MOTION_H_
+#define _MOTION_H_
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "esp_jpg_decode.h"
+#include <ArduinoJson.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+#include "cfg.h"
+#include "camera.h"
+
+#define MOTION_GRID_CELLS   (MOTION_GRID_WIDTH * MOTION_GRID_HEIGHT)  ///< count of cells of the luminance grid
+
+class MotionTrigger {
+private:
+  bool Enable;                            ///< enable/disable motion trigger
+  uint8_t Threshold;                      ///< minimum change of the cell luminance for motion, 0-255
+
+  uint32_t CellSum[MOTION_GRID_CELLS];    ///< sum of the luminance in the cell, filled by JPEG decoder
+  uint16_t CellCount[MOTION_GRID_CELLS];  ///< count of pixels in the cell, filled by JPEG decoder
+  uint8_t Grid[MOTION_GRID_CELLS];        ///< mean luminance of the cells from the last sample
+  bool GridValid;                         ///< last sample is valid reference
+  uint16_t DecodeWidth;                   ///< width of the decoded sample [px]
+  uint16_t DecodeHeight;                  ///< height of the decoded sample [px]
+
+  int64_t SampleDeadline;                 ///< time of the next sample [us]
+  int64_t BurstDeadline;                  ///< time of the next burst photo [us]
+  uint8_t BurstRemaining;                 ///< count of remaining burst photos
+
+  uint32_t Samples;                       ///< count of samples
+  uint32_t Errors;                        ///< count of failed samples
+  uint32_t Events;                        ///< count of detected motions
+  uint32_t BurstPhotos;                   ///< count of burst photos
+  uint16_t CellsLast;                     ///< count of changed cells in the last sample
+  uint32_t TimeLast;                      ///< time of the last sample [us]
+  uint32_t TimeMax;                       ///< maximum time of the sample [us]
+
+  Configuration *config;                  ///< pointer to configuration object
+  Logs *log;                              ///< pointer to logs object
+  Camera *camera;                         ///< pointer to camera object
+
+  bool Sample();
+  bool Decode(camera_fb_t *);
+
+public:
+  MotionTrigger(Configuration *, Logs *, Camera *);
+  ~MotionTrigger(){};
+
+  void Init();
+  bool CheckCaptureRequired();
+  TickType_t GetTicksToDeadline(TickType_t);
+
+  void SetEnable(bool);
+  bool GetEnable();
+  void SetThreshold(uint8_t);
+  uint8_t GetThreshold();
+  bool GetBurstActive();
+  String GetJson();
+};
+
+extern MotionTrigger SystemMotion;  ///< global variable for motion trigger
+
+#endif
+
+/* EOF */
@@ -0,0 +1,219 @@
+/**
+   @file photo_store.cpp
+
+   @brief Store of the last photo. Reference counted JPEG buffers in PSRAM shared by uploader, recorder and WEB server
+
+   Camera frame buffer is returned to the driver right after capture, so the photo is copied once to the free buffer
+   of the store and published. Published photo is never changed. Every consumer (upload, offline queue, timelapse,
+   frame analysis, WEB server response) takes a reference and releases it after reading, so one photo is shared
+   without next copies. New photo is written to the buffer without references, readers of the older photo are not affected.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "photo_store.h"
+
+PhotoStore SystemPhotoStore(&SystemLog);
+
+/**
+ * @brief Construct a new PhotoStore::PhotoStore object
+ *
+ * @param Logs* - pointer to Logs class
+ */
+PhotoStore::PhotoStore(Logs *i_log) {
+  log = i_log;
+  memset(Frames, 0, sizeof(Frames));
+  Current = NULL;
+  Generation = 0;
+  Dropped = 0;
+  Lock = xSemaphoreCreateMutex();
+}
+
+/**
+ * @brief Get free buffer for the new photo. Buffer is reserved for the caller until Publish or Release
+ *
+ * @param size_t - length of the photo [bytes]
+ * @return PhotoFrame* - buffer, NULL if all buffers are referenced or memory is not available
+ */
+PhotoFrame *PhotoStore::Allocate(size_t i_len) {
+  PhotoFrame *frame = NULL;
+
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < PHOTO_STORE_FRAMES; i++) {
+    if ((0 == Frames[i].Refs) && (&Frames[i] != Current)) {
+      /* buffer with enough size is preferred, it is not reallocated */
+      if ((NULL == frame) || ((frame->Size < i_len) && (Frames[i].Size >= i_len))) {
+        frame = &Frames[i];
+      }
+    }
+  }
+  if (NULL != frame) {
+    frame->Refs = 1;
+  }
+  xSemaphoreGive(Lock);
+
+  if (NULL == frame) {
+    Dropped++;
+    log->AddEvent(LogLevel_Warning, "Photo store: all buffers are used, photo dropped");
+    return NULL;
+  }
+
+  if (frame->Size < i_len) {
+    size_t size = ((i_len + PHOTO_STORE_ALIGN - 1) / PHOTO_STORE_ALIGN) * PHOTO_STORE_ALIGN;
+    uint8_t *buf = (uint8_t *)heap_caps_realloc(frame->Buf, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (NULL == buf) {
+      Dropped++;
+      log->AddEvent(LogLevel_Error, "Photo store: not enough memory, photo dropped");
+      Release(frame);
+      return NULL;
+    }
+    frame->Buf = buf;
+    frame->Size = size;
+  }
+  frame->Len = 0;
+
+  return frame;
+}
+
+/**
+ * @brief Publish new photo. Reference of the caller is passed to the store, previous photo is released
+ *
+ * @param PhotoFrame* - photo from Allocate
+ */
+void PhotoStore::Publish(PhotoFrame *i_frame) {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  i_frame->Generation = ++Generation;
+  PhotoFrame *previous = Current;
+  Current = i_frame;
+  if ((NULL != previous) && (previous->Refs > 0)) {
+    previous->Refs--;
+  }
+  xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief Get reference to the last photo. Reference has to be released by Release
+ *
+ * @return PhotoFrame* - photo, NULL if photo is not available
+ */
+PhotoFrame *PhotoStore::Acquire() {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  PhotoFrame *frame = Current;
+  if (NULL != frame) {
+    frame->Refs++;
+  }
+  xSemaphoreGive(Lock);
+
+  return frame;
+}
+
+/**
+ * @brief Get next reference to the photo. Used, when is photo passed to the next consumer
+ *
+ * @param PhotoFrame* - referenced photo
+ */
+void PhotoStore::Retain(PhotoFrame *i_frame) {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  i_frame->Refs++;
+  xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief Release reference to the photo. Buffer without references is reused for the next photo
+ *
+ * @param PhotoFrame* - referenced photo
+ */
+void PhotoStore::Release(PhotoFrame *i_frame) {
+  if (NULL == i_frame) {
+    return;
+  }
+
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  if (i_frame->Refs > 0) {
+    i_frame->Refs--;
+  }
+  xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief Get count of published photos
+ *
+ * @return uint32_t - count
+ */
+uint32_t PhotoStore::GetGeneration() {
+  return Generation;
+}
+
+/**
+ * @brief Get count of dropped photos
+ *
+ * @return uint32_t - count
+ */
+uint32_t PhotoStore::GetDropped() {
+  return Dropped;
+}
+
+/**
+ * @brief Construct a new Async Photo Response:: Async Photo Response object
+ *
+ * @param PhotoStore* - store of the photo
+ * @param PhotoFrame* - referenced photo. Reference is released by the response
+ * @param String - content type
+ */
+AsyncPhotoResponse::AsyncPhotoResponse(PhotoStore *i_store, PhotoFrame *i_frame, String i_contentType) {
+  _store = i_store;
+  _frame = i_frame;
+  _index = 0;
+  _callback = nullptr;
+  _code = 200;
+  _contentLength = i_frame->Len;
+  _contentType = i_contentType;
+  addHeader("Cache-Control", "no-cache");
+}
+
+/**
+ * @brief Destroy the Async Photo Response:: Async Photo Response object
+ *
+ */
+AsyncPhotoResponse::~AsyncPhotoResponse() {
+  _store->Release(_frame);
+}
+
+/**
+ * @brief Check if source is valid
+ *
+ * @return bool
+ */
+bool AsyncPhotoResponse::_sourceValid() const {
+  return (NULL != _frame);
+}
+
+/**
+ * @brief Fill buffer directly from the referenced photo
+ *
+ * @param uint8_t* - buffer
+ * @param size_t - size of buffer
+ * @return size_t - count of bytes
+ */
+size_t AsyncPhotoResponse::_fillBuffer(uint8_t *buf, size_t maxLen) {
+  if (NULL == _frame) {
+    return 0;
+  }
+
+  size_t len = min(maxLen, _frame->Len - _index);
+  memcpy(buf, _frame->Buf + _index, len);
+  _index += len;
+
+  /* photo is released before the end of the TCP transfer */
+  if (_index >= _frame->Len) {
+    _store->Release(_frame);
+    _frame = NULL;
+  }
+
+  return len;
+}
+
+/* EOF */
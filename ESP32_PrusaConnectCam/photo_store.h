@@ -0,0 +1,78 @@
+/**
+   @file photo_store.h
+
+   @brief Store of the last photo. Reference counted JPEG buffers in PSRAM shared by uploader, recorder and WEB server
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _PHOTO_STORE_H_
+#define _PHOTO_STORE_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#include "Arduino.h"
+#include <esp_heap_caps.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+
+/**
+ * @brief PhotoFrame struct
+ * one JPEG buffer of the store. Data are not changed, while is reference count non-zero
+ */
+struct PhotoFrame {
+  uint8_t *Buf;           ///< JPEG data, PSRAM
+  size_t Len;             ///< length of JPEG data [bytes]
+  size_t Size;            ///< size of the allocated buffer [bytes]
+  uint16_t Width;         ///< width of the photo [px]
+  uint16_t Height;        ///< height of the photo [px]
+  uint32_t Generation;    ///< sequence number of the published photo
+  uint8_t Refs;           ///< count of references. Published photo has one reference owned by the store
+};
+
+class PhotoStore {
+private:
+  PhotoFrame Frames[PHOTO_STORE_FRAMES];  ///< pool of the JPEG buffers
+  PhotoFrame *Current;                    ///< published photo, NULL before first photo
+  uint32_t Generation;                    ///< count of published photos
+  uint32_t Dropped;                       ///< count of photos dropped, because all buffers were referenced
+  SemaphoreHandle_t Lock;                 ///< mutex, photos are published by photo task and read by WEB server and other tasks
+  Logs *log;                              ///< pointer to logs object
+
+public:
+  PhotoStore(Logs *);
+  ~PhotoStore(){};
+
+  PhotoFrame *Allocate(size_t);
+  void Publish(PhotoFrame *);
+  PhotoFrame *Acquire();
+  void Retain(PhotoFrame *);
+  void Release(PhotoFrame *);
+
+  uint32_t GetGeneration();
+  uint32_t GetDropped();
+};
+
+class AsyncPhotoResponse : public AsyncAbstractResponse {
+private:
+  PhotoStore *_store;     ///< store of the referenced photo
+  PhotoFrame *_frame;     ///< referenced photo
+  size_t _index;          ///< count of sent bytes
+
+public:
+  AsyncPhotoResponse(PhotoStore *, PhotoFrame *, String);
+  ~AsyncPhotoResponse();
+  bool _sourceValid() const;
+  virtual size_t _fillBuffer(uint8_t *, size_t) override;
+};
+
+extern PhotoStore SystemPhotoStore;  ///< global variable for store of the last photo
+
+#endif
+
+/* EOF */
@@ -109,6 +109,10 @@ String lastTwoChars = command.substring(command.length() - 2);
     log->AddEvent(LogLevel_Info, "--> Console print service WiFi AP SSID...");
     Serial.print("getserviceapssid:" + wifim->GetServiceApSsid() + ";");
 
+  } else if (command.startsWith("getprofiler") && command.endsWith(";")) {
+    log->AddEvent(LogLevel_Info, "--> Console print profiling data...");
+    Serial.print("profiler:" + System_GetProfilerJson() + ";");
+
   } else if (command.startsWith("mcureboot") && command.endsWith(";")) {
     log->AddEvent(LogLevel_Warning, "--> Reboot MCU!");
     ESP.restart();
@@ -139,6 +143,7 @@ void SerialCfg::PrintAvailableCommands() {
   Serial.println("getwifistastatus; - get STA status (connected/disconnected)");
   Serial.println("getwifistaip; - get STA IP address");
   Serial.println("getserviceapssid;- get service WiFi AP SSID");
+  Serial.println("getprofiler; - get profiling data (tasks, stacks, heap) in json");
   Serial.println("mcureboot; - reboot MCU");
   Serial.println("commandslist; - print available commands");
 }
@@ -39,8 +39,40 @@ void Server_InitWebServer() {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get photo");
     if (Server_CheckBasicAuth(request) == false)
       return;
+    if (Server_CheckHeapBudget(request) == false)
+      return;
+
+    /* response holds reference to the photo, new photo does not overwrite sent data */
+    PhotoFrame* frame = SystemPhotoStore.Acquire();
+    if (NULL == frame) {
+      request->send_P(404, "text/plain", "Photo not available");
+      return;
+    }
+    request->send(new AsyncPhotoResponse(&SystemPhotoStore, frame, "image/jpg"));
+  });
+
+  /* route for thumbnail of the last photo. Client revalidates by ETag */
+  server.on("/thumb.jpg", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get thumbnail");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    if (false == SystemThumbnail.GetAvailable()) {
+      request->send_P(404, "text/plain", "Thumbnail not available");
+      return;
+    }
+
+    if (request->hasHeader("If-None-Match") && (request->header("If-None-Match") == SystemThumbnail.GetEtag())) {
+      AsyncWebServerResponse* response = request->beginResponse(304);
+      response->addHeader("ETag", SystemThumbnail.GetEtag());
+      request->send(response);
+      return;
+    }
 
-    request->send_P(200, "image/jpg", SystemCamera.GetPhotoFb()->buf, SystemCamera.GetPhotoFb()->len);
+    if (Server_CheckHeapBudget(request) == false)
+      return;
+
+    request->send(SystemThumbnail.CreateResponse(request));
   });
 
   /* route to jquery */
@@ -59,6 +91,8 @@ void Server_InitWebServer() {
   Server_InitWebServer_Sets();
   Server_InitWebServer_Update();
   Server_InitWebServer_Stream();
+  Server_InitWebServer_Trace();
+  Server_InitWebServer_Media();
 
   /* route for not found page */
   server.onNotFound(Server_handleNotFound);
@@ -78,9 +112,83 @@ void Server_InitWebServer_JsonData() {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_input");
     if (Server_CheckBasicAuth(request) == false)
       return;
+    if (Server_CheckHeapBudget(request) == false)
+      return;
     request->send_P(200, F("text/plain"), Server_GetJsonData().c_str());
   });
 
+  /* route for json with run-time statistics of the service jobs */
+  server.on("/json_service", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_service");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), SystemService.GetJobStatsJson().c_str());
+  });
+
+  /* route for json with statistics of the uploads to the backend. Parameter clear=1 resets statistics */
+  server.on("/json_upload_stats", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_upload_stats");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    String stats = Connect.GetUploadStatsJson();
+    if (request->hasParam("clear")) {
+      Connect.ClearUploadStats();
+    }
+    request->send_P(200, F("text/plain"), stats.c_str());
+  });
+
+  /* route for json with print failure heuristic. Configuration, metrics and statistics */
+  server.on("/json_analysis", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_analysis");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), SystemFrameAnalysis.GetJson().c_str());
+  });
+
+  /* route for json with motion trigger configuration and statistics */
+  server.on("/json_motion", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_motion");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), SystemMotion.GetJson().c_str());
+  });
+
+  /* route for json with micro SD card health */
+  server.on("/json_sd_health", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_sd_health");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), SystemLog.GetHealthJson().c_str());
+  });
+
+  /* route for json with result of the micro SD card benchmark */
+  server.on("/json_sd_benchmark", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_sd_benchmark");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), SystemLog.GetBenchmarkJson().c_str());
+  });
+
+  /* route for json with stream throughput statistics. Parameter clear=1 resets statistics */
+  server.on("/json_stream_stats", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_stream_stats");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    String stats = Stream_GetStatsJson();
+    if (request->hasParam("clear")) {
+      Stream_ClearStats();
+    }
+    request->send_P(200, F("text/plain"), stats.c_str());
+  });
+
+  /* route for json with profiling data. Tasks, stacks, heap and core load */
+  server.on("/json_profiler", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_profiler");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    request->send_P(200, F("text/plain"), System_GetProfilerJson().c_str());
+  });
+
   /* route for json with wifi networks */
   server.on("/json_wifi", HTTP_GET, [](AsyncWebServerRequest* request) {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_wifi");
@@ -225,9 +333,15 @@ void Server_InitWebServer_WebPages() {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: Get get_logs.html");
     if (Server_CheckBasicAuth(request) == false)
       return;
+    if (Server_CheckHeapBudget(request) == false)
+      return;
 
     if (true == SystemLog.GetCardDetectedStatus()) {
+      SystemLog.FlushFiles();
       request->send(SD_MMC, SystemLog.GetFilePath() + SystemLog.GetFileName(), "text/plain");
+    } else if (SdHealth_Degraded == SystemLog.GetHealthState()) {
+      /* logs from the degraded mode are in RAM */
+      request->send(200, "text/plain", SystemLog.GetRamLog());
     } else {
       request->send_P(404, "text/plain", "Micro SD card not found with FAT32 partition!");
     }
@@ -378,7 +492,7 @@ void Server_InitWebServer_Actions() {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_capture Take photo");
     if (Server_CheckBasicAuth(request) == false)
       return;
-    SystemCamera.CapturePhoto();
+    SystemPhotoStore.Release(SystemCamera.CapturePhoto());
     request->send_P(200, "text/plain", "Take Photo");
   });
 
@@ -391,6 +505,58 @@ void Server_InitWebServer_Actions() {
     request->send_P(200, "text/plain", "Send Photo");
   });
 
+  /* route for start timelapse session. Parameter name is name of the session folder */
+  server.on("/action_timelapse_start", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_timelapse_start");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    String name = "";
+    if (request->hasParam("name")) {
+      name = request->getParam("name")->value();
+    }
+
+    if (true == SystemTimelapse.Start(name)) {
+      request->send_P(200, "text/plain", "Timelapse started");
+    } else {
+      request->send_P(500, "text/plain", "Timelapse start failed");
+    }
+  });
+
+  /* route for stop timelapse session */
+  server.on("/action_timelapse_stop", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_timelapse_stop");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    SystemTimelapse.RequestStop();
+    request->send_P(200, "text/plain", "Timelapse stop requested");
+  });
+
+  /* route for start of the micro SD card benchmark. Result is available in /json_sd_benchmark */
+  server.on("/action_sd_benchmark", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_sd_benchmark");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    if (true == SystemLog.StartBenchmark()) {
+      SystemLog.AddEvent(LogLevel_Info, "Micro SD card benchmark started");
+      request->send_P(200, "text/plain", "SD card benchmark started");
+    } else {
+      request->send_P(409, "text/plain", "SD card not detected or benchmark is running");
+    }
+  });
+
+  /* route for reset of the frame analysis background model */
+  server.on("/action_analysis_reset", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_analysis_reset");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    SystemFrameAnalysis.ResetBackground();
+    request->send_P(200, "text/plain", "Background reset");
+  });
+
   /* route for change LED status */
   server.on("/action_led", HTTP_GET, [](AsyncWebServerRequest* request) {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_led Change LED status");
@@ -446,6 +612,32 @@ void Server_InitWebServer_Sets() {
       response = true;
     }
 
+    /* set WiFi power profile */
+    if (request->hasParam("wifi_power_profile")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set WiFi power profile");
+      uint8_t value = request->getParam("wifi_power_profile")->value().toInt();
+      if (value <= WiFiPowerProfile_LowPower) {
+        SystemWifiMngt.SetPowerProfile((WiFiPowerProfile) value);
+        response_msg = MSG_SAVE_OK;
+      } else {
+        response_msg = "ERROR! Bad value. 0 = performance, 1 = balanced, 2 = low-power";
+      }
+      response = true;
+    }
+
+    /* set threshold of the motion trigger */
+    if (request->hasParam("motion_threshold")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set motion threshold");
+      uint16_t value = request->getParam("motion_threshold")->value().toInt();
+      if ((value >= 1) && (value <= 254)) {
+        SystemMotion.SetThreshold(value);
+        response_msg = MSG_SAVE_OK;
+      } else {
+        response_msg = "ERROR! Bad value. Minimum is 1, maximum 254";
+      }
+      response = true;
+    }
+
     /* set saturation */
     if (request->hasParam("saturation")) {
       SystemLog.AddEvent(LogLevel_Verbose, "set saturation");
@@ -610,6 +802,48 @@ void Server_InitWebServer_Sets() {
       response = true;
     }
 
+    /* set WiFi fast connect */
+    if (request->hasParam("wifi_fast_connect")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set wifi_fast_connect");
+      SystemWifiMngt.SetFastConnect(Server_TransfeStringToBool(request->getParam("wifi_fast_connect")->value()));
+      response = true;
+    }
+
+    /* enable/disable offline snapshot queue */
+    if (request->hasParam("snapshot_queue")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set snapshot_queue");
+      SystemSnapshotQueue.SetEnable(Server_TransfeStringToBool(request->getParam("snapshot_queue")->value()));
+      response = true;
+    }
+
+    /* enable/disable print failure heuristic */
+    if (request->hasParam("analysis")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set analysis");
+      SystemFrameAnalysis.SetEnable(Server_TransfeStringToBool(request->getParam("analysis")->value()));
+      response = true;
+    }
+
+    /* enable/disable motion triggered burst capture */
+    if (request->hasParam("motion")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set motion");
+      SystemMotion.SetEnable(Server_TransfeStringToBool(request->getParam("motion")->value()));
+      response = true;
+    }
+
+    /* micro SD card bus width, applied after reboot */
+    if (request->hasParam("sd_bus_4bit")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set sd_bus_4bit");
+      SystemConfig.SaveSdBus4Bit(Server_TransfeStringToBool(request->getParam("sd_bus_4bit")->value()));
+      response = true;
+    }
+
+    /* enable/disable per-core load benchmark */
+    if (request->hasParam("core_benchmark")) {
+      SystemLog.AddEvent(LogLevel_Verbose, "Set core_benchmark");
+      System_SetCoreLoadBenchmark(Server_TransfeStringToBool(request->getParam("core_benchmark")->value()));
+      response = true;
+    }
+
     /* set raw gama correction */
     if (request->hasParam("raw_gama")) {
       SystemLog.AddEvent(LogLevel_Verbose, "Set raw_gama");
@@ -656,6 +890,34 @@ void Server_InitWebServer_Sets() {
     }
   });
 
+  /* route for set region of interest of the frame analysis. Parameters: id, x, y, w, h [%], change, texture */
+  server.on("/set_analysis_roi", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /set_analysis_roi");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    const char *params[] = { "id", "x", "y", "w", "h", "change", "texture" };
+    int values[7] = { 0 };
+    for (uint8_t i = 0; i < 7; i++) {
+      if (false == request->hasParam(params[i])) {
+        request->send_P(400, "text/plain", "Missing parameter!");
+        return;
+      }
+      values[i] = request->getParam(params[i])->value().toInt();
+      if ((values[i] < 0) || (values[i] > 255)) {
+        request->send_P(400, "text/plain", "Invalid parameter!");
+        return;
+      }
+    }
+
+    AnalysisRoi_struct roi = { (uint8_t)values[1], (uint8_t)values[2], (uint8_t)values[3], (uint8_t)values[4], (uint8_t)values[5], (uint8_t)values[6] };
+    if (true == SystemFrameAnalysis.SetRoi((uint8_t)values[0], roi)) {
+      request->send_P(200, F("text/html"), MSG_SAVE_OK);
+    } else {
+      request->send_P(400, "text/plain", "Invalid region!");
+    }
+  });
+
   /* route for set prusa connect hostname */
   server.on("/set_hostname", HTTP_GET, [](AsyncWebServerRequest* request) {
     SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /set_hostname");
@@ -892,23 +1154,132 @@ void Server_InitWebServer_Stream() {
 }
 
 /**
-   @brief Pause WEB server
+   @brief Init WEB server access to the media files on the micro SD card. Timelapse videos and queued snapshots
    @param none
    @return none
 */
-void Server_pause() {
-  server.end();
-  SystemLog.AddEvent(LogLevel_Verbose, "WEB server: pause");
+void Server_InitWebServer_Media() {
+  /* route for directory listing. Parameters: dir, page, per_page */
+  server.on("/json_media", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get json_media");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    String dir = TIMELAPSE_DIR;
+    uint16_t page = 0;
+    uint16_t per_page = 0;
+    if (request->hasParam("dir")) {
+      dir = request->getParam("dir")->value();
+    }
+    if (request->hasParam("page")) {
+      page = request->getParam("page")->value().toInt();
+    }
+    if (request->hasParam("per_page")) {
+      per_page = request->getParam("per_page")->value().toInt();
+    }
+
+    String list = SystemMediaLibrary.GetListJson(dir, page, per_page);
+    if (list == "") {
+      request->send_P(404, "text/plain", "Directory not found!");
+    } else {
+      request->send(200, "application/json", list);
+    }
+  });
+
+  /* route for download of the media file. Parameter: path. Range header is supported */
+  server.on("/get_media", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get get_media");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+    if (Server_CheckHeapBudget(request) == false)
+      return;
+
+    if (false == SystemLog.GetCardDetectedStatus()) {
+      request->send_P(404, "text/plain", "Micro SD card not found with FAT32 partition!");
+      return;
+    }
+
+    String path = "";
+    if (request->hasParam("path")) {
+      path = request->getParam("path")->value();
+    }
+    if (false == SystemMediaLibrary.CheckPath(path)) {
+      request->send_P(403, "text/plain", "Access denied!");
+      return;
+    }
+
+    File file = SD_MMC.open(path, FILE_READ);
+    if ((!file) || (true == file.isDirectory())) {
+      request->send_P(404, "text/plain", "File not found!");
+      return;
+    }
+
+    uint32_t size = file.size();
+    uint32_t start = 0;
+    uint32_t end = (size > 0) ? (size - 1) : 0;
+    MediaRangeStatus range = MediaRangeNone;
+    if (request->hasHeader("Range")) {
+      range = SystemMediaLibrary.ParseRange(request->header("Range"), size, start, end);
+    }
+
+    if (MediaRangeUnsatisfiable == range) {
+      file.close();
+      AsyncWebServerResponse *response = request->beginResponse(416, "text/plain", "Range Not Satisfiable");
+      response->addHeader("Content-Range", "bytes */" + String(size));
+      request->send(response);
+      return;
+    }
+
+    if (false == SystemMediaLibrary.DownloadBegin()) {
+      file.close();
+      AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Too many downloads! Try again later");
+      response->addHeader("Retry-After", HEAP_BUDGET_RETRY_AFTER);
+      request->send(response);
+      return;
+    }
+
+    uint32_t length = (size > 0) ? (end - start + 1) : 0;
+    AsyncMediaFileResponse *response = new AsyncMediaFileResponse(file, start, length, (MediaRangeValid == range), SystemMediaLibrary.GetContentType(path));
+    request->send(response);
+  });
 }
 
 /**
-   @brief Resume WEB server
+   @brief Init WEB server span tracing. Routes are available only when is TRACE_ENABLE true
    @param none
    @return none
 */
-void Server_resume() {
-  server.begin();
-  SystemLog.AddEvent(LogLevel_Verbose, "WEB server: resume");
+void Server_InitWebServer_Trace() {
+#if (true == TRACE_ENABLE)
+  /* route for export of the trace buffer in the Chrome trace json format */
+  server.on("/trace.json", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: get trace.json");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    std::shared_ptr<TraceDump> dump = SystemTrace.CreateDump();
+    if (nullptr == dump) {
+      request->send(503, "text/plain", "Not enough memory for trace export");
+      return;
+    }
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", [dump](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return SystemTrace.ReadDump(dump.get(), buffer, maxLen);
+    });
+    response->addHeader("Content-Disposition", "attachment; filename=trace.json");
+    request->send(response);
+  });
+
+  /* route for clear trace buffer */
+  server.on("/action_trace_clear", HTTP_GET, [](AsyncWebServerRequest* request) {
+    SystemLog.AddEvent(LogLevel_Verbose, "WEB server: /action_trace_clear");
+    if (Server_CheckBasicAuth(request) == false)
+      return;
+
+    SystemTrace.Clear();
+    request->send_P(200, "text/plain", "Trace cleared");
+  });
+#endif
 }
 
 /**
@@ -961,6 +1332,19 @@ String Server_GetJsonData() {
   doc_json["token"] = Connect.GetToken();
   doc_json["fingerprint"] = Connect.GetFingerprint();
   doc_json["refreshInterval"] = String(Connect.GetRefreshInterval());
+  doc_json["send_jitter_last_us"] = String((long) Connect.GetSendingJitterLast());
+  doc_json["send_jitter_max_us"] = String((long) Connect.GetSendingJitterMax());
+  /* null = load is unknown, FreeRTOS run-time stats are not available */
+  for (uint8_t i = 0; i < 2; i++) {
+    int16_t load = System_GetCoreLoad(i);
+    String key = "core" + String(i) + "_load";
+    if (load >= 0) {
+      doc_json[key] = String(load);
+    } else {
+      doc_json[key] = nullptr;
+    }
+  }
+  doc_json["core_benchmark"] = (System_GetCoreLoadBenchmark() == true) ? "true" : "";
   doc_json["photoquality"] = String(73 - SystemCamera.GetPhotoQuality());
   doc_json["framesize"] = String(SystemCamera.GetFrameSize());
   doc_json["brightness"] = String(SystemCamera.GetBrightness());
@@ -993,6 +1377,21 @@ String Server_GetJsonData() {
   doc_json["wifi_mode"] = SystemWifiMngt.GetWiFiMode();
   doc_json["mdns"] = SystemWifiMngt.GetMdns();
   doc_json["service_ap_ssid"] = SystemWifiMngt.GetServiceApSsid();
+  doc_json["wifi_fast_connect"] = (SystemWifiMngt.GetFastConnect() == true) ? "true" : "";
+  doc_json["wifi_power_profile"] = String(SystemWifiMngt.GetPowerProfile());
+  doc_json["snapshot_queue"] = (SystemSnapshotQueue.GetEnable() == true) ? "true" : "";
+  doc_json["snapshot_queue_count"] = SystemSnapshotQueue.GetCount();
+  doc_json["sd_bus_4bit"] = (SystemLog.GetBus4Bit() == true) ? "true" : "";
+  doc_json["sd_health"] = SystemLog.GetHealthStateString();
+  doc_json["analysis"] = (SystemFrameAnalysis.GetEnable() == true) ? "true" : "";
+  doc_json["analysis_alarm"] = (SystemFrameAnalysis.GetAlarm() == true) ? "true" : "";
+  doc_json["motion"] = (SystemMotion.GetEnable() == true) ? "true" : "";
+  doc_json["motion_threshold"] = SystemMotion.GetThreshold();
+  doc_json["motion_burst"] = (SystemMotion.GetBurstActive() == true) ? "true" : "";
+  doc_json["timelapse_active"] = (SystemTimelapse.GetActive() == true) ? "true" : "";
+  doc_json["timelapse_suspended"] = (SystemTimelapse.GetSuspended() == true) ? "true" : "";
+  doc_json["timelapse_session"] = SystemTimelapse.GetSessionName();
+  doc_json["timelapse_frames"] = SystemTimelapse.GetSessionFrames();
   doc_json["auth"] = (WebBasicAuth.EnableAuth == true) ? "true" : "";
   doc_json["auth_username"] = WebBasicAuth.UserName;
   doc_json["last_upload_status"] = Connect.GetBackendReceivedStatus();
@@ -1025,12 +1424,32 @@ bool Server_CheckBasicAuth(AsyncWebServerRequest* request) {
   return true;
 }
 
+/**
+   @brief Admission control for heavy WEB requests. When is not available enough internal heap, then request is refused with 503
+   @param AsyncWebServerRequest - request
+   @return bool - status
+*/
+bool Server_CheckHeapBudget(AsyncWebServerRequest* request) {
+  if (false == System_CheckHeapBudget(HEAP_BUDGET_WEB_FREE, HEAP_BUDGET_WEB_BLOCK)) {
+    SystemLog.AddEvent(LogLevel_Warning, "WEB server: low memory, request refused: " + request->url());
+    AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Low memory! Try again later");
+    response->addHeader("Retry-After", HEAP_BUDGET_RETRY_AFTER);
+    request->send(response);
+    return false;
+  }
+
+  return true;
+}
+
 /**
    @brief Stream JPG image from camera
    @param AsyncWebServerRequest - request
    @return void
 */
 void Server_streamJpg(AsyncWebServerRequest *request) {
+  if (Server_CheckHeapBudget(request) == false)
+    return;
+
   AsyncJpegStreamResponse *response = new AsyncJpegStreamResponse(&SystemCamera, &SystemLog);
   if (!response) {
     request->send(501);
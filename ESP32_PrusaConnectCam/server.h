@@ -37,6 +37,7 @@
 #include "connect.h"
 #include "wifi_mngt.h"
 #include "stream.h"
+#include "media.h"
 
 extern AsyncWebServer server;  ///< global variable for web server
 
@@ -49,14 +50,14 @@ void Server_InitWebServer_Actions();
 void Server_InitWebServer_Sets();
 void Server_InitWebServer_Update();
 void Server_InitWebServer_Stream();
-
-void Server_pause();
-void Server_resume();
+void Server_InitWebServer_Trace();
+void Server_InitWebServer_Media();
 
 void Server_handleCacheRequest(AsyncWebServerRequest*, const char*, const char*);
 void Server_handleNotFound(AsyncWebServerRequest *);
 String Server_GetJsonData();
 bool Server_CheckBasicAuth(AsyncWebServerRequest *);
+bool Server_CheckHeapBudget(AsyncWebServerRequest *);
 
 void Server_streamJpg(AsyncWebServerRequest *);
 
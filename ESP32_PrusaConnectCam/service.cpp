@@ -0,0 +1,147 @@
+/**
+   @file service.cpp
+
+   @brief Library for run light periodic jobs from one service task
+
+   Each job has own deadline. Task sleeps to the nearest deadline, runs all expired jobs,
+   and measures run time of each job.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "service.h"
+
+Service SystemService(&SystemLog);
+
+/**
+ * @brief Construct a new Service::Service object
+ *
+ * @param Logs* - pointer to Logs class
+ */
+Service::Service(Logs *i_log) {
+  log = i_log;
+  JobCount = 0;
+  Wakeups = 0;
+  memset(Jobs, 0, sizeof(Jobs));
+}
+
+/**
+ * @brief Register new periodic job
+ *
+ * @param const char* - job name
+ * @param ServiceJobFunction - job function
+ * @param uint32_t - delay before first run [ms]
+ * @return bool - true if job was registered
+ */
+bool Service::AddJob(const char *i_name, ServiceJobFunction i_function, uint32_t i_first_run) {
+  if (JobCount >= SERVICE_MAX_JOBS) {
+    log->AddEvent(LogLevel_Error, "Service: too many jobs, " + String(i_name) + " not added");
+    return false;
+  }
+
+  ServiceJob *job = &Jobs[JobCount];
+  job->Name = i_name;
+  job->Function = i_function;
+  job->NextRun = millis() + i_first_run;
+  job->RunCount = 0;
+  job->RunTimeTotal = 0;
+  job->RunTimeMax = 0;
+  job->RunTimeLast = 0;
+  JobCount++;
+  log->AddEvent(LogLevel_Info, "Service: add job " + String(i_name));
+
+  return true;
+}
+
+/**
+ * @brief Run all expired jobs and calculate time to the nearest deadline
+ *
+ * @return uint32_t - time to the next job [ms]
+ */
+uint32_t Service::RunDueJobs() {
+  Wakeups++;
+
+  for (uint8_t i = 0; i < JobCount; i++) {
+    ServiceJob *job = &Jobs[i];
+
+    /* wrap-safe compare of the deadline */
+    if ((int32_t)(millis() - job->NextRun) >= 0) {
+      esp_task_wdt_reset();
+      int64_t start = esp_timer_get_time();
+      uint32_t period = job->Function();
+      uint32_t duration = (uint32_t)(esp_timer_get_time() - start);
+
+      job->RunCount++;
+      job->RunTimeLast = duration;
+      job->RunTimeTotal += duration;
+      if (duration > job->RunTimeMax) {
+        job->RunTimeMax = duration;
+      }
+
+      /* deadline is derived from the previous deadline. When is job late about more than one period, then is counted from now */
+      job->NextRun += period;
+      if ((int32_t)(millis() - job->NextRun) >= 0) {
+        job->NextRun = millis() + period;
+      }
+    }
+  }
+
+  /* find nearest deadline */
+  uint32_t sleep = SERVICE_MAX_SLEEP;
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < JobCount; i++) {
+    int32_t remaining = (int32_t)(Jobs[i].NextRun - now);
+    if (remaining <= 0) {
+      sleep = 0;
+      break;
+    }
+    if ((uint32_t)remaining < sleep) {
+      sleep = remaining;
+    }
+  }
+
+  return sleep;
+}
+
+/**
+ * @brief Print run-time statistics of the jobs to the log
+ *
+ */
+void Service::PrintJobStats() {
+  log->AddEvent(LogLevel_Verbose, "Service: wake-ups " + String(Wakeups) + ", stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
+  for (uint8_t i = 0; i < JobCount; i++) {
+    char buf[120] = { '\0' };
+    uint32_t avg = (Jobs[i].RunCount > 0) ? (uint32_t)(Jobs[i].RunTimeTotal / Jobs[i].RunCount) : 0;
+    sprintf(buf, "Service job %-16s runs: %6u, avg: %6u us, max: %6u us, last: %6u us", Jobs[i].Name, Jobs[i].RunCount, avg, Jobs[i].RunTimeMax, Jobs[i].RunTimeLast);
+    log->AddEvent(LogLevel_Verbose, buf);
+  }
+}
+
+/**
+ * @brief Get run-time statistics of the jobs in json format
+ *
+ * @return String - json
+ */
+String Service::GetJobStatsJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["wakeups"] = Wakeups;
+  JsonArray jobs = doc_json["jobs"].to<JsonArray>();
+  for (uint8_t i = 0; i < JobCount; i++) {
+    JsonObject job = jobs.add<JsonObject>();
+    job["name"] = Jobs[i].Name;
+    job["runs"] = Jobs[i].RunCount;
+    job["total_us"] = Jobs[i].RunTimeTotal;
+    job["max_us"] = Jobs[i].RunTimeMax;
+    job["last_us"] = Jobs[i].RunTimeLast;
+  }
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/* EOF */
@@ -0,0 +1,64 @@
+/**
+   @file service.h
+
+   @brief Library for run light periodic jobs from one service task
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _SERVICE_H_
+#define _SERVICE_H_
+
+#include "Arduino.h"
+#include <esp_task_wdt.h>
+#include "esp_timer.h"
+#include <ArduinoJson.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+
+/**
+ * @brief Job function. Return value is period to the next run of the job [ms]
+ */
+typedef uint32_t (*ServiceJobFunction)(void);
+
+/**
+ * @brief ServiceJob struct
+ * one periodic job with run-time accounting
+ */
+struct ServiceJob {
+  const char *Name;               ///< job name
+  ServiceJobFunction Function;    ///< job function
+  uint32_t NextRun;               ///< time of the next run [ms], millis() time base
+  uint32_t RunCount;              ///< count of job runs
+  uint64_t RunTimeTotal;          ///< total run time of the job [us]
+  uint32_t RunTimeMax;            ///< maximum run time of the job [us]
+  uint32_t RunTimeLast;           ///< last run time of the job [us]
+};
+
+class Service {
+private:
+  ServiceJob Jobs[SERVICE_MAX_JOBS];  ///< table of the periodic jobs
+  uint8_t JobCount;                   ///< count of registered jobs
+  uint32_t Wakeups;                   ///< count of service task wake-ups
+  Logs *log;                          ///< pointer to log class
+
+public:
+  Service(Logs *);
+  ~Service(){};
+
+  bool AddJob(const char *, ServiceJobFunction, uint32_t);
+  uint32_t RunDueJobs();
+  void PrintJobStats();
+  String GetJobStatsJson();
+};
+
+extern Service SystemService;  ///< global variable for service task
+
+#endif
+
+/* EOF */
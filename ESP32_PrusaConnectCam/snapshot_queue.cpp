@@ -0,0 +1,297 @@
+/**
+   @file snapshot_queue.cpp
+
+   @brief Store-and-forward queue of the snapshots on the micro SD card
+
+   Each snapshot is saved as /queue/<seq>.jpg with metadata /queue/<seq>.json.
+   Sequence number gives the order of the upload. Queue is bounded by count and size of the snapshots,
+   the oldest snapshot is removed when is queue full.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "snapshot_queue.h"
+
+SnapshotQueue SystemSnapshotQueue(&SystemConfig, &SystemLog);
+
+/**
+ * @brief Construct a new SnapshotQueue::SnapshotQueue object
+ *
+ * @param Configuration* - pointer to Configuration class
+ * @param Logs* - pointer to Logs class
+ */
+SnapshotQueue::SnapshotQueue(Configuration *i_conf, Logs *i_log) {
+  config = i_conf;
+  log = i_log;
+  Enable = false;
+  HeadSeq = 0;
+  TailSeq = 0;
+  Count = 0;
+  Bytes = 0;
+  Enqueued = 0;
+  Dequeued = 0;
+  Evicted = 0;
+}
+
+/**
+ * @brief Load configuration and scan queue directory. Snapshots from the previous run are kept
+ *
+ */
+void SnapshotQueue::Init() {
+  Enable = config->LoadSnapshotQueueEnable();
+
+  if (false == log->GetCardDetectedStatus()) {
+    log->AddEvent(LogLevel_Warning, "Snapshot queue: micro SD card not detected");
+    return;
+  }
+
+  log->CreateDir(SD_MMC, QUEUE_DIR);
+  Scan();
+  log->AddEvent(LogLevel_Info, "Snapshot queue: " + String(Count) + " snapshots, " + String(Bytes) + " bytes");
+}
+
+/**
+ * @brief Find the oldest and the newest snapshot in the queue directory
+ *
+ */
+void SnapshotQueue::Scan() {
+  bool found = false;
+  HeadSeq = 0;
+  TailSeq = 0;
+  Count = 0;
+  Bytes = 0;
+
+  File dir = SD_MMC.open(QUEUE_DIR);
+  if ((!dir) || (!dir.isDirectory())) {
+    return;
+  }
+
+  File file = dir.openNextFile();
+  while (file) {
+    String name = file.name();
+    if ((false == file.isDirectory()) && name.endsWith(".jpg")) {
+      uint32_t seq = strtoul(name.c_str(), NULL, 10);
+      if ((false == found) || (seq < HeadSeq)) {
+        HeadSeq = seq;
+      }
+      if ((false == found) || (seq >= TailSeq)) {
+        TailSeq = seq + 1;
+      }
+      found = true;
+      Count++;
+      Bytes += file.size();
+    }
+    file.close();
+    file = dir.openNextFile();
+  }
+  dir.close();
+}
+
+/**
+ * @brief Get path of the snapshot
+ *
+ * @param uint32_t - sequence number
+ * @return String - path
+ */
+String SnapshotQueue::GetPhotoPath(uint32_t i_seq) {
+  char buf[32] = { '\0' };
+  sprintf(buf, "%s/%08u.jpg", QUEUE_DIR, i_seq);
+  return String(buf);
+}
+
+/**
+ * @brief Get path of the snapshot metadata
+ *
+ * @param uint32_t - sequence number
+ * @return String - path
+ */
+String SnapshotQueue::GetMetaPath(uint32_t i_seq) {
+  char buf[32] = { '\0' };
+  sprintf(buf, "%s/%08u.json", QUEUE_DIR, i_seq);
+  return String(buf);
+}
+
+/**
+ * @brief Save snapshot to the queue. The oldest snapshots are removed, when is queue full
+ *
+ * @param const uint8_t* - JPEG data
+ * @param size_t - length of JPEG data
+ * @return bool - true if snapshot was saved
+ */
+bool SnapshotQueue::Enqueue(const uint8_t *i_data, size_t i_len) {
+  if ((false == Enable) || (false == log->GetWriteAllowed()) || (0 == i_len) || (i_len > QUEUE_MAX_BYTES)) {
+    return false;
+  }
+
+  /* eviction of the oldest snapshots */
+  while ((Count > 0) && ((Count >= QUEUE_MAX_COUNT) || ((Bytes + i_len) > QUEUE_MAX_BYTES))) {
+    log->AddEvent(LogLevel_Warning, "Snapshot queue: full, remove " + GetPhotoPath(HeadSeq));
+    RemoveOldest(false);
+    Evicted++;
+  }
+
+  /* failed write switches the card to the degraded mode */
+  uint32_t seq = TailSeq;
+  File file = SD_MMC.open(GetPhotoPath(seq).c_str(), FILE_WRITE);
+  if (!file) {
+    log->RecordMediaWrite(false, 0);
+    log->AddEvent(LogLevel_Error, "Snapshot queue: failed to create " + GetPhotoPath(seq));
+    return false;
+  }
+  int64_t start = esp_timer_get_time();
+  size_t written = file.write(i_data, i_len);
+  file.close();
+
+  if (written != i_len) {
+    log->DeleteFile(SD_MMC, GetPhotoPath(seq));
+    log->RecordMediaWrite(false, 0);
+    log->AddEvent(LogLevel_Error, "Snapshot queue: failed to write " + GetPhotoPath(seq));
+    return false;
+  }
+  log->RecordMediaWrite(true, (uint32_t)(esp_timer_get_time() - start));
+
+  /* metadata for forensic analysis. Time is valid after NTP sync */
+  char meta[120] = { '\0' };
+  sprintf(meta, "{\"seq\":%u,\"size\":%u,\"time\":%ld,\"ntp\":%s,\"uptime_ms\":%u}", seq, (uint32_t)i_len, (long)time(NULL),
+          (true == log->GetNtpTimeSynced()) ? "true" : "false", (uint32_t)millis());
+  log->WriteFile(SD_MMC, GetMetaPath(seq), String(meta));
+
+  if (0 == Count) {
+    HeadSeq = seq;
+  }
+  TailSeq = seq + 1;
+  Count++;
+  Bytes += i_len;
+  Enqueued++;
+  SystemMediaLibrary.Invalidate();
+  log->AddEvent(LogLevel_Info, "Snapshot queue: saved " + GetPhotoPath(seq) + ", queue: " + String(Count));
+
+  return true;
+}
+
+/**
+ * @brief Get the oldest snapshot in the queue
+ *
+ * @param String& - path of the snapshot
+ * @param uint32_t& - size of the snapshot
+ * @return bool - true if queue is not empty
+ */
+bool SnapshotQueue::GetOldest(String &o_path, uint32_t &o_size) {
+  if ((0 == Count) || (false == log->GetCardDetectedStatus())) {
+    return false;
+  }
+
+  /* skip missing snapshots */
+  while (HeadSeq < TailSeq) {
+    o_path = GetPhotoPath(HeadSeq);
+    o_size = log->GetFileSizeBytes(SD_MMC, o_path);
+    if (o_size > 0) {
+      return true;
+    }
+    RemoveSnapshot(HeadSeq);
+    HeadSeq++;
+  }
+
+  /* queue is inconsistent with card content */
+  Scan();
+  return false;
+}
+
+/**
+ * @brief Remove the oldest snapshot from the queue, after upload or by eviction
+ *
+ * @param bool - true if snapshot was uploaded
+ */
+void SnapshotQueue::RemoveOldest(bool i_uploaded) {
+  if ((0 == Count) || (HeadSeq >= TailSeq)) {
+    return;
+  }
+
+  Bytes -= min(Bytes, log->GetFileSizeBytes(SD_MMC, GetPhotoPath(HeadSeq)));
+  RemoveSnapshot(HeadSeq);
+  HeadSeq++;
+  Count--;
+  if (true == i_uploaded) {
+    Dequeued++;
+  }
+}
+
+/**
+ * @brief Delete snapshot and metadata files
+ *
+ * @param uint32_t - sequence number
+ */
+void SnapshotQueue::RemoveSnapshot(uint32_t i_seq) {
+  log->DeleteFile(SD_MMC, GetPhotoPath(i_seq));
+  log->DeleteFile(SD_MMC, GetMetaPath(i_seq));
+  SystemMediaLibrary.Invalidate();
+}
+
+/**
+ * @brief Enable/disable offline queue
+ *
+ * @param bool - status
+ */
+void SnapshotQueue::SetEnable(bool i_data) {
+  Enable = i_data;
+  config->SaveSnapshotQueueEnable(Enable);
+}
+
+/**
+ * @brief Get status of the offline queue
+ *
+ * @return bool - status
+ */
+bool SnapshotQueue::GetEnable() {
+  return Enable;
+}
+
+/**
+ * @brief Get count of snapshots in the queue
+ *
+ * @return uint16_t - count
+ */
+uint16_t SnapshotQueue::GetCount() {
+  return Count;
+}
+
+/**
+ * @brief Get size of snapshots in the queue
+ *
+ * @return uint32_t - size [bytes]
+ */
+uint32_t SnapshotQueue::GetBytes() {
+  return Bytes;
+}
+
+/**
+ * @brief Get count of saved snapshots
+ *
+ * @return uint32_t - count
+ */
+uint32_t SnapshotQueue::GetEnqueued() {
+  return Enqueued;
+}
+
+/**
+ * @brief Get count of uploaded snapshots from the queue
+ *
+ * @return uint32_t - count
+ */
+uint32_t SnapshotQueue::GetDequeued() {
+  return Dequeued;
+}
+
+/**
+ * @brief Get count of snapshots removed by queue limits
+ *
+ * @return uint32_t - count
+ */
+uint32_t SnapshotQueue::GetEvicted() {
+  return Evicted;
+}
+
+/* EOF */
@@ -0,0 +1,70 @@
+/**
+   @file snapshot_queue.h
+
+   @brief Store-and-forward queue of the snapshots on the micro SD card
+
+   When is upload to the backend not possible, snapshot is saved to the micro SD card.
+   Snapshots are uploaded in order, when is backend available again.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _SNAPSHOT_QUEUE_H_
+#define _SNAPSHOT_QUEUE_H_
+
+#include "Arduino.h"
+#include "FS.h"
+#include "SD_MMC.h"
+#include <time.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+#include "cfg.h"
+#include "media.h"
+
+class SnapshotQueue {
+private:
+  bool Enable;            ///< enable/disable offline queue
+  uint32_t HeadSeq;       ///< sequence number of the oldest snapshot
+  uint32_t TailSeq;       ///< sequence number for the next snapshot
+  uint16_t Count;         ///< count of snapshots in the queue
+  uint32_t Bytes;         ///< size of snapshots in the queue [bytes]
+  uint32_t Enqueued;      ///< count of saved snapshots
+  uint32_t Dequeued;      ///< count of uploaded snapshots from the queue
+  uint32_t Evicted;       ///< count of snapshots removed by queue limits
+
+  Configuration *config;  ///< pointer to configuration object
+  Logs *log;              ///< pointer to logs object
+
+  String GetPhotoPath(uint32_t);
+  String GetMetaPath(uint32_t);
+  void Scan();
+  void RemoveSnapshot(uint32_t);
+
+public:
+  SnapshotQueue(Configuration *, Logs *);
+  ~SnapshotQueue(){};
+
+  void Init();
+  bool Enqueue(const uint8_t *, size_t);
+  bool GetOldest(String &, uint32_t &);
+  void RemoveOldest(bool);
+
+  void SetEnable(bool);
+  bool GetEnable();
+  uint16_t GetCount();
+  uint32_t GetBytes();
+  uint32_t GetEnqueued();
+  uint32_t GetDequeued();
+  uint32_t GetEvicted();
+};
+
+extern SnapshotQueue SystemSnapshotQueue;  ///< global variable for offline snapshot queue
+
+#endif
+
+/* EOF */
@@ -11,6 +11,7 @@
    @bug: no know bug
 */
 #include "stream.h"
+#include "wifi_mngt.h"
 
 #define PART_BOUNDARY "123456789000000000000987654321"                                          ///< Must be unique for each stream
 static const char *STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;   ///< content type for stream
@@ -18,6 +19,55 @@ static const char *STREAM_BOUNDARY = "\r\n--" PART_BOUNDARY "\r\n";
 static const char *STREAM_PART = "Content-Type: %s\r\nContent-Length: %u\r\n\r\n";              ///< part for stream
 static const char *JPG_CONTENT_TYPE = "image/jpeg";                                           ///< content type for jpg
 
+static StreamStatistics StreamStats = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };                            ///< stream throughput statistics
+
+/**
+ * @brief Get stream throughput statistics in json format
+ *
+ * @return String - json
+ */
+String Stream_GetStatsJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+  int64_t elapsed = esp_timer_get_time() - StreamStats.StartTime;
+
+  doc_json["clients"] = StreamStats.Clients;
+  doc_json["frames"] = StreamStats.Frames;
+  doc_json["payload_bytes"] = StreamStats.PayloadBytes;
+  doc_json["sent_bytes"] = StreamStats.SentBytes;
+  doc_json["elapsed_ms"] = (uint32_t)(elapsed / 1000);
+  doc_json["fps"] = (elapsed > 0) ? ((float)StreamStats.Frames * 1000000.0 / elapsed) : 0;
+  doc_json["bytes_per_s"] = (elapsed > 0) ? (uint32_t)((StreamStats.SentBytes * 1000000) / elapsed) : 0;
+  doc_json["fill_us_per_frame"] = (StreamStats.Frames > 0) ? (uint32_t)(StreamStats.FillTime / StreamStats.Frames) : 0;
+  doc_json["capture_wait_us_per_frame"] = (StreamStats.Frames > 0) ? (uint32_t)(StreamStats.CaptureTime / StreamStats.Frames) : 0;
+  doc_json["yield_us_per_frame"] = (StreamStats.Frames > 0) ? (uint32_t)(StreamStats.YieldTime / StreamStats.Frames) : 0;
+  doc_json["copies_per_byte"] = (StreamStats.PayloadBytes > 0) ? ((float)StreamStats.CopiedBytes / StreamStats.PayloadBytes) : 0;
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
+/**
+ * @brief Yield delay of the response filler. Time is counted separately, it is not work of the filler
+ *
+ */
+static void Stream_Yield() {
+  int64_t start = esp_timer_get_time();
+  delay(1);
+  StreamStats.YieldTime += esp_timer_get_time() - start;
+}
+
+/**
+ * @brief Clear stream throughput statistics. Count of active clients is kept
+ *
+ */
+void Stream_ClearStats() {
+  uint8_t clients = StreamStats.Clients;
+  memset(&StreamStats, 0, sizeof(StreamStats));
+  StreamStats.Clients = clients;
+  StreamStats.StartTime = esp_timer_get_time();
+}
+
 /**
  * @brief Construct a new Async Buffer Response:: Async Buffer Response object
  * 
@@ -171,6 +221,13 @@ AsyncJpegStreamResponse::AsyncJpegStreamResponse(Camera *i_cam, Logs *i_log) {
   camera = i_cam;
   log = i_log;
   camera->SetStreamStatus(true);
+  SystemWifiMngt.UpdatePowerSave();
+
+  /* measurement starts with the first client */
+  if (0 == StreamStats.Clients) {
+    Stream_ClearStats();
+  }
+  StreamStats.Clients++;
 }
 
 /**
@@ -179,7 +236,12 @@ AsyncJpegStreamResponse::AsyncJpegStreamResponse(Camera *i_cam, Logs *i_log) {
  */
 AsyncJpegStreamResponse::~AsyncJpegStreamResponse() {
   camera->SetStreamStatus(false);
-  camera->CaptureReturnFrameBuffer();
+  camera->CaptureReturnFrameBuffer(_frame.fb);
+  SystemWifiMngt.UpdatePowerSave();
+
+  if (StreamStats.Clients > 0) {
+    StreamStats.Clients--;
+  }
 }
 
 /**
@@ -199,10 +261,16 @@ bool AsyncJpegStreamResponse::_sourceValid() const {
  * @return size_t 
  */
 size_t AsyncJpegStreamResponse::_fillBuffer(uint8_t *buf, size_t maxLen) {
+  int64_t start = esp_timer_get_time();
+  uint64_t wait = StreamStats.YieldTime + StreamStats.CaptureTime;
   size_t ret = _content(buf, maxLen, _index);
   if (ret != RESPONSE_TRY_AGAIN) {
     _index += ret;
+    StreamStats.SentBytes += ret;
   }
+  /* yield delays and waiting for the camera frame are not work of the filler */
+  wait = (StreamStats.YieldTime + StreamStats.CaptureTime) - wait;
+  StreamStats.FillTime += (esp_timer_get_time() - start) - wait;
   return ret;
 }
 
@@ -215,9 +283,10 @@ size_t AsyncJpegStreamResponse::_fillBuffer(uint8_t *buf, size_t maxLen) {
  * @return size_t 
  */
 size_t AsyncJpegStreamResponse::_content(uint8_t *buffer, size_t maxLen, size_t index) {
+  TRACE_SCOPE("Stream::_content");
 
   if (!_frame.fb || _frame.index == _frame.fb->len) {
-    delay(1);
+    Stream_Yield();
 
     if (index && _frame.fb) {
       uint64_t end = (uint64_t)micros();
@@ -230,7 +299,7 @@ size_t AsyncJpegStreamResponse::_content(uint8_t *buffer, size_t maxLen, size_t
       sprintf(buf, "Size: %uKB, FPS: %.1f", _frame.fb->len / 1024, fps);
       Serial.println(buf);
       lastAsyncRequest = end;
-      camera->CaptureReturnFrameBuffer();
+      camera->CaptureReturnFrameBuffer(_frame.fb);
       _frame.fb = NULL;
     }
 
@@ -242,8 +311,9 @@ size_t AsyncJpegStreamResponse::_content(uint8_t *buffer, size_t maxLen, size_t
 
     /* get frame */
     _frame.index = 0;
-    camera->CaptureStream(&_dframe);
-    _frame.fb = &_dframe;
+    int64_t capture_start = esp_timer_get_time();
+    _frame.fb = camera->CaptureStream();
+    StreamStats.CaptureTime += esp_timer_get_time() - capture_start;
 
     if (_frame.fb == NULL) {
       log->AddEvent(LogLevel_Error, "Stream capture frame failed");
@@ -271,7 +341,10 @@ size_t AsyncJpegStreamResponse::_content(uint8_t *buffer, size_t maxLen, size_t
 
     memcpy(buffer, _frame.fb->buf, hlen);
     _frame.index += hlen;
-    delay(1);
+    StreamStats.Frames++;
+    StreamStats.PayloadBytes += _frame.fb->len;
+    StreamStats.CopiedBytes += maxLen;
+    Stream_Yield();
     return maxLen;
   }
 
@@ -281,9 +354,10 @@ size_t AsyncJpegStreamResponse::_content(uint8_t *buffer, size_t maxLen, size_t
     maxLen = available;
   }
 
-  delay(1);
+  Stream_Yield();
   memcpy(buffer, _frame.fb->buf + _frame.index, maxLen);
   _frame.index += maxLen;
+  StreamStats.CopiedBytes += maxLen;
   return maxLen;
 }
 
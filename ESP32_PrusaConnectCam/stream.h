@@ -17,6 +17,8 @@
 #include "ESPAsyncWebSrv.h"
 
 #include "Arduino.h"
+#include "esp_timer.h"
+#include <ArduinoJson.h>
 #include "mcu_cfg.h"
 #include "var.h"
 #include "log.h"
@@ -27,6 +29,25 @@ typedef struct {
   size_t index;     ///< index of frame
 } camera_frame_t;   ///< camera frame structure
 
+/**
+ * @brief StreamStatistics struct
+ * throughput statistics of the stream, summary of all stream clients
+ */
+struct StreamStatistics {
+  uint8_t Clients;          ///< count of active stream clients
+  uint32_t Frames;          ///< count of sent frames
+  uint64_t PayloadBytes;    ///< count of sent JPEG bytes
+  uint64_t SentBytes;       ///< count of all sent bytes, JPEG + boundary + headers
+  uint64_t CopiedBytes;     ///< count of bytes copied by memcpy/sprintf to the response buffer
+  uint64_t FillTime;        ///< time in the response filler without the yield delays and the frame capture [us]
+  uint64_t CaptureTime;     ///< time in the frame capture, waiting for the frame included [us]
+  uint64_t YieldTime;       ///< time in the yield delays of the response filler [us]
+  int64_t StartTime;        ///< start of the measurement [us], esp_timer time base
+};
+
+String Stream_GetStatsJson();
+void Stream_ClearStats();
+
 class AsyncBufferResponse : public AsyncAbstractResponse {
 private:
   uint8_t *_buf;    ///< pointer to frame buffer
@@ -61,7 +82,6 @@ private:
   uint64_t lastAsyncRequest;  ///< last async request
   Camera *camera;             ///< pointer to camera
   Logs *log;                  ///< pointer to logs
-  camera_fb_t _dframe;        ///< camera frame
 
 public:
   AsyncJpegStreamResponse(Camera *, Logs *);
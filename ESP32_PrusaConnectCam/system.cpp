@@ -11,6 +11,45 @@
 
 #include "system.h"
 
+static uint32_t CoreLoadLastIdle[portNUM_PROCESSORS] = { 0 };           ///< run-time counter of the idle task at start of the measurement window
+static uint32_t CoreLoadLastTime = 0;                                   ///< run-time counter value at start of the measurement window
+static uint8_t CoreLoad[portNUM_PROCESSORS] = { 0 };                    ///< load of the core in the last window [%]
+static bool CoreLoadAvailable = false;                                  ///< flag about available FreeRTOS run-time stats. Without them is load unknown
+static bool CoreLoadBenchmark = false;                                  ///< flag about benchmark mode, print per-core load to the log
+
+/**
+   @brief Read run-time counters of the idle tasks IDLE0/IDLE1. Idle task runs only when is core free,
+          so its run-time is the idle time of the core
+   @param uint32_t* - output, run-time counter of the idle task for each core
+   @param uint32_t* - output, actual value of the run-time counter
+   @return bool - true if counters are available
+*/
+static bool System_CoreLoadRead(uint32_t *o_idle, uint32_t *o_time) {
+#if (configUSE_TRACE_FACILITY == 1) && (configGENERATE_RUN_TIME_STATS == 1)
+  UBaseType_t count = uxTaskGetNumberOfTasks() + 2;
+  TaskStatus_t *status = (TaskStatus_t *)malloc(count * sizeof(TaskStatus_t));
+  if (NULL == status) {
+    return false;
+  }
+
+  count = uxTaskGetSystemState(status, count, o_time);
+  for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+    TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+    for (UBaseType_t i = 0; i < count; i++) {
+      if (status[i].xHandle == idle) {
+        o_idle[core] = status[i].ulRunTimeCounter;
+        break;
+      }
+    }
+  }
+  free(status);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
 /**
    @brief Function for init system library
    @param none
@@ -33,6 +72,18 @@ void System_Init() {
   SystemLog.AddEvent(LogLevel_Info, "ChipRevision: " + String(ESP.getChipRevision()) + " ,Cpu Freq: " + String(ESP.getCpuFreqMHz()) + " ,SDK Version: " + String(ESP.getSdkVersion()));
   SystemLog.AddEvent(LogLevel_Info, "Flash Size: " + String(ESP.getFlashChipSize()) + " ,Flash Speed " + String(ESP.getFlashChipSpeed()));
   System_CheckIfPsramIsUsed();
+
+  /* open log files are closed before software reset */
+  esp_register_shutdown_handler(System_ShutdownHandler);
+}
+
+/**
+   @brief Shutdown handler, called by esp_restart. Buffered data are written to the micro SD card
+   @param none
+   @return none
+*/
+void System_ShutdownHandler() {
+  SystemLog.CloseFiles();
 }
 
 /**
@@ -94,16 +145,220 @@ void System_UpdateInit() {
 */
 void System_Main() {
   /* check new FW version */
-  if (false == FirmwareUpdate.CheckNewVersionAfterBoot) {
-    Server_pause();
+  if ((false == FirmwareUpdate.CheckNewVersionAfterBoot) && (true == System_WaitForHeapBudget(HEAP_BUDGET_TLS_FREE, HEAP_BUDGET_TLS_BLOCK, HEAP_BUDGET_TLS_WAIT))) {
     System_CheckNewVersion();
-    Server_resume();
   }
 
   /* task for download and flash FW from server */
   System_OtaCloudUpdate();
 }
 
+/**
+   @brief Function for check available internal heap. Heap budget is used instead of pause WEB server during TLS connection
+   @param uint32_t - minimum free internal heap [bytes]
+   @param uint32_t - minimum largest free internal heap block [bytes]
+   @return bool - true if heap budget is available
+*/
+bool System_CheckHeapBudget(uint32_t i_free, uint32_t i_block) {
+  uint32_t free_heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  uint32_t largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+  return ((free_heap >= i_free) && (largest_block >= i_block));
+}
+
+/**
+   @brief Function for wait for available internal heap. Running WEB requests release memory after finish
+   @param uint32_t - minimum free internal heap [bytes]
+   @param uint32_t - minimum largest free internal heap block [bytes]
+   @param uint32_t - timeout [ms]
+   @return bool - true if heap budget is available
+*/
+bool System_WaitForHeapBudget(uint32_t i_free, uint32_t i_block, uint32_t i_timeout) {
+  unsigned long start = millis();
+
+  while (false == System_CheckHeapBudget(i_free, i_block)) {
+    if (millis() - start >= i_timeout) {
+      SystemLog.AddEvent(LogLevel_Warning, "Heap budget not available. Free: " + String(heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)) +
+                                             " bytes, largest block: " + String(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)) + " bytes");
+      return false;
+    }
+    esp_task_wdt_reset();
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+  }
+
+  return true;
+}
+
+/**
+   @brief Function for init per-core load measurement from run-time counters of the idle tasks
+   @param none
+   @return none
+*/
+void System_CoreLoadInit() {
+  CoreLoadAvailable = System_CoreLoadRead(CoreLoadLastIdle, &CoreLoadLastTime);
+  if (false == CoreLoadAvailable) {
+    SystemLog.AddEvent(LogLevel_Warning, "Core load: FreeRTOS run-time stats are not available, load is reported as unknown");
+  }
+  SystemLog.AddEvent(LogLevel_Info, "Task cores. System: " + String(TASK_CORE_SYSTEM) + ", photo: " + String(TASK_CORE_PHOTO) + ", WiFi: " + String(TASK_CORE_WIFI) +
+                                      ", service: " + String(TASK_CORE_SERVICE) + ", loop: " + String(xPortGetCoreID()));
+}
+
+/**
+   @brief Function for calculate per-core load in the last measurement window
+   @param none
+   @return none
+*/
+void System_CoreLoadUpdate() {
+  uint32_t idle[portNUM_PROCESSORS];
+  uint32_t now = 0;
+  memcpy(idle, CoreLoadLastIdle, sizeof(idle));
+  if ((false == CoreLoadAvailable) || (false == System_CoreLoadRead(idle, &now))) {
+    if (true == CoreLoadBenchmark) {
+      SystemLog.AddEvent(LogLevel_Info, "Core load. Core 0: n/a, core 1: n/a, stream: " + String(SystemCamera.GetStreamStatus()) + ", free RAM: " + String(ESP.getFreeHeap()) + " bytes");
+    }
+    return;
+  }
+
+  /* 32-bit run-time counters overflow, differences are computed in unsigned arithmetic */
+  uint32_t window = now - CoreLoadLastTime;
+  if (0 == window) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < portNUM_PROCESSORS; i++) {
+    uint32_t idle_delta = idle[i] - CoreLoadLastIdle[i];
+    CoreLoadLastIdle[i] = idle[i];
+
+    if (idle_delta > window) {
+      idle_delta = window;
+    }
+    CoreLoad[i] = 100 - (uint8_t)(((uint64_t)idle_delta * 100) / window);
+  }
+  CoreLoadLastTime = now;
+
+  if (true == CoreLoadBenchmark) {
+    SystemLog.AddEvent(LogLevel_Info, "Core load. Core 0: " + String(CoreLoad[0]) + " %, core 1: " + String(CoreLoad[1]) + " %, stream: " + String(SystemCamera.GetStreamStatus()) +
+                                        ", free RAM: " + String(ESP.getFreeHeap()) + " bytes");
+  }
+}
+
+/**
+   @brief Function for get load of the core in the last measurement window
+   @param uint8_t - core
+   @return int16_t - load [%], -1 = load is unknown. FreeRTOS run-time stats are not available
+*/
+int16_t System_GetCoreLoad(uint8_t i_core) {
+  if ((i_core >= portNUM_PROCESSORS) || (false == CoreLoadAvailable)) {
+    return -1;
+  }
+
+  return CoreLoad[i_core];
+}
+
+/**
+   @brief Function for enable/disable benchmark mode. Per-core load is printed to the log after every measurement window
+   @param bool - status
+   @return none
+*/
+void System_SetCoreLoadBenchmark(bool i_data) {
+  CoreLoadBenchmark = i_data;
+  SystemLog.AddEvent(LogLevel_Info, "Core load benchmark: " + String(CoreLoadBenchmark));
+}
+
+/**
+   @brief Function for get status of the benchmark mode
+   @param none
+   @return bool - status
+*/
+bool System_GetCoreLoadBenchmark() {
+  return CoreLoadBenchmark;
+}
+
+/**
+   @brief Function for add heap statistics for memory with capabilities to the json
+   @param JsonObject - output json object
+   @param uint32_t - memory capabilities
+   @return none
+*/
+void System_ProfilerHeapCaps(JsonObject i_json, uint32_t i_caps) {
+  i_json["total"] = heap_caps_get_total_size(i_caps);
+  i_json["free"] = heap_caps_get_free_size(i_caps);
+  i_json["min_free"] = heap_caps_get_minimum_free_size(i_caps);
+  i_json["largest_block"] = heap_caps_get_largest_free_block(i_caps);
+}
+
+/**
+   @brief Function for sample profiling data. FreeRTOS tasks (run-time, stack high-water mark, core), heap and core load
+   @param none
+   @return String - json with profiling data
+*/
+String System_GetProfilerJson() {
+  JsonDocument doc_json;
+  String string_json = "";
+
+  doc_json["uptime_ms"] = millis();
+
+  /* heap statistics, internal RAM vs PSRAM */
+  JsonObject heap = doc_json["heap"].to<JsonObject>();
+  System_ProfilerHeapCaps(heap["internal"].to<JsonObject>(), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  System_ProfilerHeapCaps(heap["psram"].to<JsonObject>(), MALLOC_CAP_SPIRAM);
+
+  /* core load from run-time of the idle tasks. null = load is unknown */
+  JsonArray cores = doc_json["core_load"].to<JsonArray>();
+  for (uint8_t i = 0; i < portNUM_PROCESSORS; i++) {
+    int16_t load = System_GetCoreLoad(i);
+    if (load >= 0) {
+      cores.add(load);
+    } else {
+      cores.add(nullptr);
+    }
+  }
+
+  /* tasks */
+  JsonArray tasks = doc_json["tasks"].to<JsonArray>();
+#if (configUSE_TRACE_FACILITY == 1)
+  UBaseType_t count = uxTaskGetNumberOfTasks() + 2;
+  TaskStatus_t *status = (TaskStatus_t *)malloc(count * sizeof(TaskStatus_t));
+  if (NULL != status) {
+    uint32_t total_runtime = 0;
+    count = uxTaskGetSystemState(status, count, &total_runtime);
+
+    for (UBaseType_t i = 0; i < count; i++) {
+      JsonObject task = tasks.add<JsonObject>();
+      task["name"] = status[i].pcTaskName;
+      task["priority"] = status[i].uxCurrentPriority;
+      task["state"] = (uint8_t)status[i].eCurrentState;
+      task["stack_free"] = status[i].usStackHighWaterMark;
+#if (configTASKLIST_INCLUDE_COREID == 1)
+      task["core"] = (tskNO_AFFINITY == status[i].xCoreID) ? -1 : (int)status[i].xCoreID;
+#endif
+#if (configGENERATE_RUN_TIME_STATS == 1)
+      /* run-time in percent of one core */
+      task["runtime"] = status[i].ulRunTimeCounter;
+      task["cpu_percent"] = (total_runtime > 0) ? (uint32_t)(((uint64_t)status[i].ulRunTimeCounter * 100ULL) / total_runtime) : 0;
+#endif
+    }
+    free(status);
+  } else {
+    doc_json["error"] = "Not enough memory for task list";
+  }
+#else
+  /* without trace facility is available only stack high-water mark of the application tasks */
+  TaskHandle_t handles[] = { Task_SystemMain, Task_CapturePhotoAndSend, Task_WiFiManagement, Task_Service };
+  for (uint8_t i = 0; i < (sizeof(handles) / sizeof(handles[0])); i++) {
+    if (NULL != handles[i]) {
+      JsonObject task = tasks.add<JsonObject>();
+      task["name"] = pcTaskGetTaskName(handles[i]);
+      task["priority"] = uxTaskPriorityGet(handles[i]);
+      task["stack_free"] = uxTaskGetStackHighWaterMark(handles[i]);
+    }
+  }
+#endif
+
+  serializeJson(doc_json, string_json);
+  return string_json;
+}
+
 /**
    @brief Function for check FW version on the WEB server
 
@@ -454,7 +709,6 @@ void System_TaskWifiManagement(void *pvParameters) {
     SystemLog.AddEvent(LogLevel_Info, "Free RAM: " + String(ESP.getFreeHeap()) + " bytes");
     SystemLog.AddEvent(LogLevel_Info, "Free SPIRAM: " + String(ESP.getFreePsram()) + " bytes");
     SystemLog.AddEvent(LogLevel_Info, "Temperature: " + String(temperatureRead()) + " *C");
-    SystemLog.AddEvent(LogLevel_Verbose, "WiFiManagement task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
 
     /* reset wdg */
     esp_task_wdt_reset();
@@ -478,7 +732,6 @@ void System_TaskMain(void *pvParameters) {
     /* for ota update */
     esp_task_wdt_reset();
     System_Main();
-    SystemLog.AddEvent(LogLevel_Verbose, "System task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
 
     /* reset wdg */
     esp_task_wdt_reset();
@@ -496,11 +749,15 @@ void System_TaskMain(void *pvParameters) {
  */
 void System_TaskCaptureAndSendPhoto(void *pvParameters) {
   SystemLog.AddEvent(LogLevel_Info, "Task photo processing. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+  Connect.SendingSchedulerInit();
 
   while (1) {
-    if (Connect.CheckSendingIntervalExpired()) {
-      Connect.SetSendingIntervalCounter(0);
+    /* timelapse stop requested from WEB server */
+    esp_task_wdt_reset();
+    SystemTimelapse.ProcessStopRequest();
+
+    SendingEvent sending = Connect.CheckSendingIntervalExpired();
+    if (SendingEventUpload == sending) {
       /* send network information to backend */
       if ((WL_CONNECTED == WiFi.status()) && (false == FirmwareUpdate.Processing)) {
         esp_task_wdt_reset();
@@ -511,136 +768,198 @@ void System_TaskCaptureAndSendPhoto(void *pvParameters) {
       if ((WL_CONNECTED == WiFi.status()) && (false == FirmwareUpdate.Processing)) {
         esp_task_wdt_reset();
         Connect.TakePictureAndSendToBackend();
+
+      } else if ((false == FirmwareUpdate.Processing) && (true == SystemSnapshotQueue.GetEnable())) {
+        /* uplink is not available, photo is saved to the offline queue */
+        esp_task_wdt_reset();
+        Connect.TakePictureAndQueue();
+
+      } else if ((false == FirmwareUpdate.Processing) && (true == SystemTimelapse.GetActive())) {
+        /* uplink is not available, photo is saved only to the timelapse */
+        esp_task_wdt_reset();
+        SystemPhotoStore.Release(Connect.TakePicture());
+      }
+
+    } else if ((SendingEventCapture == sending) && (false == FirmwareUpdate.Processing)) {
+      /* retry backoff, photo from the outage is saved to the offline queue or to the timelapse. Upload waits for the retry deadline */
+      esp_task_wdt_reset();
+      if (true == SystemSnapshotQueue.GetEnable()) {
+        Connect.TakePictureAndQueue();
+      } else if (true == SystemTimelapse.GetActive()) {
+        SystemPhotoStore.Release(Connect.TakePicture());
+      }
+    }
+
+    /* motion trigger. Burst photos are uploaded immediately, during retry backoff are saved to the offline queue */
+    if ((false == FirmwareUpdate.Processing) && (true == SystemMotion.CheckCaptureRequired())) {
+      esp_task_wdt_reset();
+      if ((WL_CONNECTED == WiFi.status()) && (false == Connect.GetRetryPending())) {
+        Connect.TakePictureAndSendToBackend();
+      } else if (true == SystemSnapshotQueue.GetEnable()) {
+        Connect.TakePictureAndQueue();
+      } else {
+        /* photo is saved only to the timelapse */
+        SystemPhotoStore.Release(Connect.TakePicture());
       }
+    }
 
-    } else {
-      /* update counter */
-      Connect.IncreaseSendingIntervalCounter();
+    /* send photos from the offline queue, when is backend available again */
+    if ((WL_CONNECTED == WiFi.status()) && (false == FirmwareUpdate.Processing)) {
+      esp_task_wdt_reset();
+      Connect.SendPhotoFromQueue();
     }
-    
-    SystemLog.AddEvent(LogLevel_Verbose, "Photo processing task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
 
     /* reset wdg */
     esp_task_wdt_reset();
 
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, TASK_PHOTO_SEND / portTICK_PERIOD_MS);
+    /* sleep to the next deadline, or to the notification from WEB action */
+    ulTaskNotifyTake(pdTRUE, SystemMotion.GetTicksToDeadline(Connect.GetTicksToSendingDeadline(TASK_PHOTO_SEND_MAX_SLEEP)));
   }
 }
 
 /**
- * @brief Function for micro SD card check task
+ * @brief Function for frame analysis task. Task is woken up by the submitted photo
  * 
  * @param void *pvParameters
  * @return none
  */
-void System_TaskSdCardCheck(void *pvParameters) {
-  SystemLog.AddEvent(LogLevel_Info, "MicroSdCard check task. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+void System_TaskFrameAnalysis(void *pvParameters) {
+  SystemLog.AddEvent(LogLevel_Info, "Frame analysis task. core: " + String(xPortGetCoreID()));
 
   while (1) {
-    esp_task_wdt_reset();
-    /* check micro SD card */
-    if ((true == SystemLog.GetCardDetectAfterBoot()) && (false == SystemLog.GetCardDetectedStatus())) {
-      SystemLog.ReinitCard();
-      SystemLog.AddEvent(LogLevel_Warning, "Reinit micro SD card done!");
-    }
-    SystemLog.AddEvent(LogLevel_Verbose, "MicroSdCard task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
-
-    /* reset wdg */
-    esp_task_wdt_reset();
-
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, TASK_SDCARD / portTICK_PERIOD_MS);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    SystemFrameAnalysis.Process();
   }
 }
 
 /**
- * @brief Function for serial configuration task
+ * @brief Function for service task. Runs light periodic jobs registered in the SystemService
  * 
  * @param void *pvParameters
  * @return none
  */
-void System_TaskSerialCfg(void *pvParameters) {
-  SystemLog.AddEvent(LogLevel_Info, "SerialCg task. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+void System_TaskService(void *pvParameters) {
+  SystemLog.AddEvent(LogLevel_Info, "Service task. core: " + String(xPortGetCoreID()));
+  SystemService.AddJob("SysLed", System_JobSysLed, 0);
+  SystemService.AddJob("SerialCfg", System_JobSerialCfg, TASK_SERIAL_CFG);
+  SystemService.AddJob("WiFiWatchdog", System_JobWiFiWatchdog, TASK_WIFI_WATCHDOG);
+  SystemService.AddJob("SdCardCheck", System_JobSdCardCheck, TASK_SDCARD);
+  SystemService.AddJob("SdFileFlush", System_JobSdFileFlush, SD_FILE_CACHE_FLUSH);
+  SystemService.AddJob("StreamTelemetry", System_JobStreamTelemetry, TASK_STREAM_TELEMETRY);
+  SystemService.AddJob("ServiceStats", System_JobServiceStats, TASK_SERVICE_STATS);
+  SystemService.AddJob("CoreLoad", System_JobCoreLoad, TASK_CORE_LOAD);
 
   while (1) {
     esp_task_wdt_reset();
-    SystemSerialCfg.ProcessIncommingData();
-    SystemLog.AddEvent(LogLevel_Verbose, "SerialCfg task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
+    uint32_t sleep = SystemService.RunDueJobs();
 
     /* reset wdg */
     esp_task_wdt_reset();
 
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, TASK_SERIAL_CFG / portTICK_PERIOD_MS);
+    /* sleep to the nearest job */
+    vTaskDelay(sleep / portTICK_PERIOD_MS);
   }
 }
 
 /**
- * @brief Function for stream telemetry task
+ * @brief Service job for micro SD card check
  * 
- * @param void *pvParameters
- * @return none
+ * @return uint32_t - period to the next run [ms]
  */
-void System_TaskStreamTelemetry(void *pvParameters) {
-  SystemLog.AddEvent(LogLevel_Info, "StreamTelemetry task. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+uint32_t System_JobSdCardCheck() {
+  /* check micro SD card. Failed card is reinitialized with exponential delay */
+  bool degraded = (SdHealth_Degraded == SystemLog.GetHealthState());
+  uint32_t period = SystemLog.CheckHealth();
+
+  if ((true == degraded) && (true == SystemLog.GetCardDetectedStatus())) {
+    SystemLog.AddEvent(LogLevel_Warning, "Reinit micro SD card done!");
+  } else if (true == degraded) {
+    SystemLog.AddEvent(LogLevel_Warning, "Reinit micro SD card failed, next attempt in " + String(period / 1000) + " s");
+  }
 
-  while (1) {
-    esp_task_wdt_reset();
-    SystemLog.AddEvent(LogLevel_Verbose, "StreamTelemetry task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
-    if (SystemCamera.GetStreamStatus()) {
-      char buf[80] = { '\0' };
-      sprintf(buf, "Stream, average data in %dsec. FPS: %.1f, Size: %uKB", (TASK_STREAM_TELEMETRY / SECOND_TO_MILISECOND), SystemCamera.StreamGetFrameAverageFps(), SystemCamera.StreamGetFrameAverageSize());
-      SystemLog.AddEvent(LogLevel_Info, buf);
-      SystemCamera.StreamClearFrameData();
-    }
+  return period;
+}
 
-    /* reset wdg */
-    esp_task_wdt_reset();
+/**
+ * @brief Service job for sync of the open files to the micro SD card
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobSdFileFlush() {
+  SystemLog.FlushFiles();
 
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, TASK_STREAM_TELEMETRY / portTICK_PERIOD_MS);
-  }
+  return SD_FILE_CACHE_FLUSH;
 }
 
 /**
- * @brief Function for system led task
+ * @brief Service job for serial configuration
  * 
- * @param void *pvParameters
- * @return none
+ * @return uint32_t - period to the next run [ms]
  */
-void System_TaskSysLed(void *pvParameters) {
-  SystemLog.AddEvent(LogLevel_Info, "SystemLed task. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+uint32_t System_JobSerialCfg() {
+  SystemSerialCfg.ProcessIncommingData();
 
-  while (1) {
-    system_led.toggle();
-    /* reset wdg */
-    esp_task_wdt_reset();
+  return TASK_SERIAL_CFG;
+}
 
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, system_led.getTimer() / portTICK_PERIOD_MS);
+/**
+ * @brief Service job for stream telemetry
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobStreamTelemetry() {
+  if (SystemCamera.GetStreamStatus()) {
+    char buf[80] = { '\0' };
+    sprintf(buf, "Stream, average data in %dsec. FPS: %.1f, Size: %uKB", (TASK_STREAM_TELEMETRY / SECOND_TO_MILISECOND), SystemCamera.StreamGetFrameAverageFps(), SystemCamera.StreamGetFrameAverageSize());
+    SystemLog.AddEvent(LogLevel_Info, buf);
+    SystemCamera.StreamClearFrameData();
   }
-} 
 
-void System_TaskWiFiWatchdog(void *pvParameters) {
-  SystemLog.AddEvent(LogLevel_Info, "WiFiWatchdog task. core: " + String(xPortGetCoreID()));
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+  return TASK_STREAM_TELEMETRY;
+}
 
-  while (1) {
-    esp_task_wdt_reset();
-    SystemWifiMngt.WiFiWatchdog();
-    SystemLog.AddEvent(LogLevel_Verbose, "WiFiWatchdog task. Stack free size: " + String(uxTaskGetStackHighWaterMark(NULL)) + " bytes");
+/**
+ * @brief Service job for system led
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobSysLed() {
+  system_led.toggle();
 
-    /* reset wdg */
-    esp_task_wdt_reset();
+  return system_led.getTimer();
+}
 
-    /* next start task */
-    vTaskDelayUntil(&xLastWakeTime, TASK_WIFI_WATCHDOG / portTICK_PERIOD_MS);
-  }
+/**
+ * @brief Service job for WiFi watchdog
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobWiFiWatchdog() {
+  SystemWifiMngt.WiFiWatchdog();
+
+  return TASK_WIFI_WATCHDOG;
+}
+
+/**
+ * @brief Service job for print run-time statistics of the service jobs
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobServiceStats() {
+  SystemService.PrintJobStats();
+
+  return TASK_SERVICE_STATS;
+}
+
+/**
+ * @brief Service job for per-core load measurement
+ * 
+ * @return uint32_t - period to the next run [ms]
+ */
+uint32_t System_JobCoreLoad() {
+  System_CoreLoadUpdate();
+
+  return TASK_CORE_LOAD;
 }
 
 /* EOF */
\ No newline at end of file
@@ -22,6 +22,9 @@
 #include <esp_wifi.h>
 #include "esp32/rom/rtc.h"
 #include <esp_task_wdt.h>
+#include <esp_system.h>
+#include <esp_heap_caps.h>
+#include "esp_timer.h"
 
 #include "mcu_cfg.h"
 #include "var.h"
@@ -32,6 +35,9 @@
 #include "connect.h"
 #include "serial_cfg.h"
 #include "sys_led.h"
+#include "service.h"
+#include "analysis.h"
+#include "motion.h"
 
 #define SYSTEM_MSG_UPDATE_DONE    "FW update successfully done! Please reboot the MCU."
 #define SYSTEM_MSG_UPDATE_FAIL    "FW update failed! Please reboot MCU, and try again."
@@ -39,10 +45,22 @@
 #define SYSTEM_MSG_UPDATE_NO_FW   "No new FW version available!"
 
 void System_Init();
+void System_ShutdownHandler();
 void System_LoadCfg();
 void System_CheckIfPsramIsUsed();
 void System_Main();
 void System_UpdateInit();
+bool System_CheckHeapBudget(uint32_t, uint32_t);
+bool System_WaitForHeapBudget(uint32_t, uint32_t, uint32_t);
+
+void System_CoreLoadInit();
+void System_CoreLoadUpdate();
+int16_t System_GetCoreLoad(uint8_t);
+void System_SetCoreLoadBenchmark(bool);
+bool System_GetCoreLoadBenchmark();
+
+void System_ProfilerHeapCaps(JsonObject, uint32_t);
+String System_GetProfilerJson();
 
 void System_CheckNewVersion();
 void System_OtaCloudUpdate();
@@ -58,11 +76,17 @@ String System_printMcuResetReasonSimple();
 void System_TaskWifiManagement(void *);
 void System_TaskMain(void *);
 void System_TaskCaptureAndSendPhoto(void *);
-void System_TaskSdCardCheck(void *);
-void System_TaskSerialCfg(void *);
-void System_TaskStreamTelemetry(void *);
-void System_TaskSysLed(void *);
-void System_TaskWiFiWatchdog(void *);
+void System_TaskService(void *);
+void System_TaskFrameAnalysis(void *);
+
+uint32_t System_JobSdCardCheck();
+uint32_t System_JobSdFileFlush();
+uint32_t System_JobSerialCfg();
+uint32_t System_JobStreamTelemetry();
+uint32_t System_JobSysLed();
+uint32_t System_JobWiFiWatchdog();
+uint32_t System_JobServiceStats();
+uint32_t System_JobCoreLoad();
 
 #endif
 /* EOF */
\ No newline at end of file
@@ -0,0 +1,260 @@
+/**
+   @file thumbnail.cpp
+
+   @brief Thumbnail of the last photo. Photo is decoded at reduced scale and encoded to the small JPEG in PSRAM
+
+   Scale 1/2, 1/4 or 1/8 is selected by the photo width, so the thumbnail is not wider than THUMB_MAX_WIDTH.
+   JPEG decoder computes only the needed part of the DCT for reduced scale, full resolution image is never created.
+   New thumbnail is encoded to the free buffer of the own photo store and published. WEB server response holds
+   a reference to the thumbnail and sends it without copy, it is not blocked by encoding.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "thumbnail.h"
+
+Thumbnail SystemThumbnail(&SystemLog);
+
+/**
+ * @brief ThumbnailDecode struct
+ * context of the JPEG decoder callbacks
+ */
+struct ThumbnailDecode {
+  const uint8_t *Data;  ///< JPEG data
+  size_t Length;        ///< length of JPEG data
+  uint8_t *Rgb;         ///< output RGB888 frame
+  uint16_t Width;       ///< width of the output frame
+  uint16_t Height;      ///< height of the output frame
+};
+
+/**
+ * @brief ThumbnailEncode struct
+ * context of the JPEG encoder callback
+ */
+struct ThumbnailEncode {
+  uint8_t *Data;        ///< output buffer
+  size_t Length;        ///< length of the encoded data
+};
+
+/**
+ * @brief JPEG decoder input callback
+ *
+ * @param void* - decode context
+ * @param size_t - index of the data
+ * @param uint8_t* - output buffer, NULL = skip data
+ * @param size_t - length of requested data
+ * @return size_t - count of bytes
+ */
+static size_t Thumbnail_JpegReader(void *arg, size_t index, uint8_t *buf, size_t len) {
+  ThumbnailDecode *decode = (ThumbnailDecode *)arg;
+
+  if (index >= decode->Length) {
+    return 0;
+  }
+  if ((index + len) > decode->Length) {
+    len = decode->Length - index;
+  }
+  if (NULL != buf) {
+    memcpy(buf, decode->Data + index, len);
+  }
+
+  return len;
+}
+
+/**
+ * @brief JPEG decoder output callback. Decoder output is R,G,B, block is copied to the frame in the B,G,R order of the camera RGB888 format,
+ *        which is expected by the JPEG encoder
+ *
+ * @param void* - decode context
+ * @param uint16_t - x position of the block
+ * @param uint16_t - y position of the block
+ * @param uint16_t - width of the block
+ * @param uint16_t - height of the block
+ * @param uint8_t* - RGB888 data, NULL = start or end of the image
+ * @return bool - false stops decoding
+ */
+static bool Thumbnail_JpegWriter(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  ThumbnailDecode *decode = (ThumbnailDecode *)arg;
+
+  if (NULL == data) {
+    /* start of the image, size of the output */
+    if ((0 == x) && (0 == y)) {
+      if ((w > THUMB_MAX_WIDTH) || (h > THUMB_MAX_HEIGHT)) {
+        return false;
+      }
+      decode->Width = w;
+      decode->Height = h;
+    }
+    return true;
+  }
+
+  if (((x + w) > decode->Width) || ((y + h) > decode->Height)) {
+    return false;
+  }
+
+  for (uint16_t iy = 0; iy < h; iy++) {
+    uint8_t *out = &decode->Rgb[(((y + iy) * decode->Width) + x) * 3];
+    for (uint16_t ix = 0; ix < w; ix++) {
+      out[0] = data[2];
+      out[1] = data[1];
+      out[2] = data[0];
+      out += 3;
+      data += 3;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief JPEG encoder output callback
+ *
+ * @param void* - encode context
+ * @param size_t - index of the data
+ * @param const void* - data
+ * @param size_t - length of data
+ * @return size_t - count of saved bytes, 0 stops encoding
+ */
+static size_t Thumbnail_JpegOutput(void *arg, size_t index, const void *data, size_t len) {
+  ThumbnailEncode *encode = (ThumbnailEncode *)arg;
+
+  if ((index + len) > THUMB_JPEG_MAX_SIZE) {
+    return 0;
+  }
+  memcpy(encode->Data + index, data, len);
+  encode->Length = index + len;
+
+  return len;
+}
+
+/**
+ * @brief Construct a new Thumbnail::Thumbnail object
+ *
+ * @param Logs* - pointer to Logs class
+ */
+Thumbnail::Thumbnail(Logs *i_log) : Store(i_log) {
+  log = i_log;
+  Rgb = NULL;
+  BootId = 0;
+  TimeLast = 0;
+}
+
+/**
+ * @brief Allocate decoder buffer in PSRAM. JPEG buffers are allocated by the store
+ *
+ */
+void Thumbnail::Init() {
+  /* generation starts from 1 after every boot, ETag of the previous boot must not match */
+  BootId = esp_random();
+  Rgb = (uint8_t *)heap_caps_malloc(THUMB_MAX_WIDTH * THUMB_MAX_HEIGHT * 3, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (NULL == Rgb) {
+    log->AddEvent(LogLevel_Error, "Thumbnail: not enough memory");
+  }
+}
+
+/**
+ * @brief Create thumbnail of the photo. Called from the photo task after capture
+ *
+ * @param const uint8_t* - JPEG data
+ * @param size_t - length of JPEG data
+ * @param uint16_t - width of the photo [px]
+ */
+void Thumbnail::Create(const uint8_t *i_data, size_t i_len, uint16_t i_width) {
+  if ((NULL == Rgb) || (NULL == i_data) || (0 == i_len)) {
+    return;
+  }
+
+  int64_t start = esp_timer_get_time();
+  jpg_scale_t scale = JPG_SCALE_8X;
+  if (i_width <= (THUMB_MAX_WIDTH * 2)) {
+    scale = JPG_SCALE_2X;
+  } else if (i_width <= (THUMB_MAX_WIDTH * 4)) {
+    scale = JPG_SCALE_4X;
+  }
+
+  ThumbnailDecode decode;
+  decode.Data = i_data;
+  decode.Length = i_len;
+  decode.Rgb = Rgb;
+  decode.Width = 0;
+  decode.Height = 0;
+
+  if (ESP_OK != esp_jpg_decode(i_len, scale, Thumbnail_JpegReader, Thumbnail_JpegWriter, &decode)) {
+    log->AddEvent(LogLevel_Warning, "Thumbnail: decode failed");
+    return;
+  }
+
+  /* buffer without references. Thumbnails sent by WEB server are not affected */
+  PhotoFrame *frame = Store.Allocate(THUMB_JPEG_MAX_SIZE);
+  if (NULL == frame) {
+    return;
+  }
+
+  ThumbnailEncode encode;
+  encode.Data = frame->Buf;
+  encode.Length = 0;
+  if (false == fmt2jpg_cb(Rgb, decode.Width * decode.Height * 3, decode.Width, decode.Height, PIXFORMAT_RGB888, THUMB_QUALITY, Thumbnail_JpegOutput, &encode)) {
+    log->AddEvent(LogLevel_Warning, "Thumbnail: encode failed");
+    Store.Release(frame);
+    return;
+  }
+  frame->Len = encode.Length;
+  frame->Width = decode.Width;
+  frame->Height = decode.Height;
+  Store.Publish(frame);
+
+  TimeLast = (uint32_t)(esp_timer_get_time() - start);
+  log->AddEvent(LogLevel_Verbose, "Thumbnail: " + String(decode.Width) + "x" + String(decode.Height) + ", " + String(encode.Length) + " bytes, " + String(TimeLast) + " us");
+}
+
+/**
+ * @brief Check if is thumbnail available
+ *
+ * @return bool - true if thumbnail was created
+ */
+bool Thumbnail::GetAvailable() {
+  return (Store.GetGeneration() > 0);
+}
+
+/**
+ * @brief Create ETag of the thumbnail. ETag is unique across boots
+ *
+ * @param uint32_t - generation of the thumbnail
+ * @return String - ETag, with quotes
+ */
+String Thumbnail::CreateEtag(uint32_t i_generation) {
+  return "\"thumb-" + String(BootId, HEX) + "-" + String(i_generation) + "\"";
+}
+
+/**
+ * @brief Get ETag of the actual thumbnail
+ *
+ * @return String - ETag, with quotes
+ */
+String Thumbnail::GetEtag() {
+  return CreateEtag(Store.GetGeneration());
+}
+
+/**
+ * @brief Create response with the actual thumbnail. Response holds a reference, thumbnail is sent without copy
+ *        and new thumbnail does not overwrite sent data
+ *
+ * @param AsyncWebServerRequest* - request
+ * @return AsyncWebServerResponse* - response
+ */
+AsyncWebServerResponse *Thumbnail::CreateResponse(AsyncWebServerRequest *request) {
+  PhotoFrame *frame = Store.Acquire();
+  if (NULL == frame) {
+    return request->beginResponse(404, "text/plain", "Thumbnail not available");
+  }
+
+  AsyncPhotoResponse *response = new AsyncPhotoResponse(&Store, frame, "image/jpeg");
+  response->addHeader("ETag", CreateEtag(frame->Generation));
+
+  return response;
+}
+
+/* EOF */
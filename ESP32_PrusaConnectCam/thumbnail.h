@@ -0,0 +1,53 @@
+/**
+   @file thumbnail.h
+
+   @brief Thumbnail of the last photo. Photo is decoded at reduced scale and encoded to the small JPEG in PSRAM
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _THUMBNAIL_H_
+#define _THUMBNAIL_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "esp_jpg_decode.h"
+#include "img_converters.h"
+#include <esp_heap_caps.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+#include "photo_store.h"
+
+class Thumbnail {
+private:
+  uint8_t *Rgb;               ///< decoded photo at reduced scale, RGB888 in B,G,R order, PSRAM
+  PhotoStore Store;           ///< reference counted thumbnails. WEB server sends the thumbnail without copy
+  uint32_t BootId;            ///< random ID of the boot, used for ETag
+  uint32_t TimeLast;          ///< time of the last thumbnail creation [us]
+  Logs *log;                  ///< pointer to logs object
+
+  String CreateEtag(uint32_t);
+
+public:
+  Thumbnail(Logs *);
+  ~Thumbnail(){};
+
+  void Init();
+  void Create(const uint8_t *, size_t, uint16_t);
+  bool GetAvailable();
+  String GetEtag();
+  AsyncWebServerResponse *CreateResponse(AsyncWebServerRequest *);
+};
+
+extern Thumbnail SystemThumbnail;  ///< global variable for thumbnail of the last photo
+
+#endif
+
+/* EOF */
@@ -0,0 +1,495 @@
+/**
+   @file timelapse.cpp
+
+   @brief Timelapse recorder. Captured photos are saved to the micro SD card to the MJPEG AVI file
+
+   Each session has own folder /timelapse/<name>/ with AVI files. Frames are appended to the movi list
+   as large sequential writes. Header is patched every TIMELAPSE_HEADER_PATCH frames, so the file is playable
+   after power cut. idx1 index is pre-allocated in the PSRAM and is written when is the file closed.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "timelapse.h"
+
+Timelapse SystemTimelapse(&SystemLog, &SystemCamera);
+
+/**
+ * @brief Write uint32_t in little endian format to the buffer
+ *
+ * @param uint8_t* - buffer
+ * @param uint32_t - value
+ */
+static void Timelapse_WriteLe32(uint8_t *o_buf, uint32_t i_data) {
+  o_buf[0] = i_data & 0xFF;
+  o_buf[1] = (i_data >> 8) & 0xFF;
+  o_buf[2] = (i_data >> 16) & 0xFF;
+  o_buf[3] = (i_data >> 24) & 0xFF;
+}
+
+/**
+ * @brief Construct a new Timelapse::Timelapse object
+ *
+ * @param Logs* - pointer to Logs class
+ * @param Camera* - pointer to Camera class
+ */
+Timelapse::Timelapse(Logs *i_log, Camera *i_camera) {
+  log = i_log;
+  camera = i_camera;
+  Active = false;
+  Suspended = false;
+  StopRequest = false;
+  SessionName = "";
+  FilePath = "";
+  Segment = 0;
+  FrameCount = 0;
+  SessionFrames = 0;
+  MoviSize = 0;
+  MaxFrameSize = 0;
+  Index = NULL;
+  Lock = xSemaphoreCreateMutex();
+}
+
+/**
+ * @brief Start new recording session
+ *
+ * @param String - session name. Only letters, numbers, '-' and '_' are used. Empty name = name from actual time
+ * @return bool - true if session was started
+ */
+bool Timelapse::Start(String i_name) {
+  bool ret = false;
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  StopRequest = false;
+  StopSession();
+
+  if (false == log->GetWriteAllowed()) {
+    log->AddEvent(LogLevel_Error, "Timelapse: micro SD card is not available: " + log->GetHealthStateString());
+    xSemaphoreGive(Lock);
+    return false;
+  }
+
+  /* pre-allocated index for whole AVI file */
+  Index = (uint32_t *)heap_caps_malloc(TIMELAPSE_MAX_FRAMES * 2 * sizeof(uint32_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (NULL == Index) {
+    log->AddEvent(LogLevel_Error, "Timelapse: not enough memory for index");
+    xSemaphoreGive(Lock);
+    return false;
+  }
+
+  SessionName = CreateSessionName(i_name);
+  log->CreateDir(SD_MMC, TIMELAPSE_DIR);
+  log->CreateDir(SD_MMC, String(TIMELAPSE_DIR) + "/" + SessionName);
+  Segment = 0;
+  SessionFrames = 0;
+  Suspended = false;
+
+  if (true == OpenSegment()) {
+    Active = true;
+    ret = true;
+    log->AddEvent(LogLevel_Info, "Timelapse: session " + SessionName + " started");
+  } else {
+    heap_caps_free(Index);
+    Index = NULL;
+  }
+  xSemaphoreGive(Lock);
+
+  return ret;
+}
+
+/**
+ * @brief Stop recording session and finish the AVI file
+ *
+ */
+void Timelapse::Stop() {
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  StopSession();
+  xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief Request stop of the recording session. Writing of the idx1 index can take seconds,
+ *        so the session is stopped by photo task, not by WEB server
+ *
+ */
+void Timelapse::RequestStop() {
+  StopRequest = true;
+  if (NULL != Task_CapturePhotoAndSend) {
+    xTaskNotifyGive(Task_CapturePhotoAndSend);
+  }
+}
+
+/**
+ * @brief Stop recording session, when is stop requested. Called from photo task
+ *
+ */
+void Timelapse::ProcessStopRequest() {
+  if (true == StopRequest) {
+    StopRequest = false;
+    Stop();
+  }
+}
+
+/**
+ * @brief Stop recording session. Lock must be taken by caller
+ *
+ */
+void Timelapse::StopSession() {
+  if (false == Active) {
+    return;
+  }
+
+  CloseSegment();
+  Active = false;
+  if (NULL != Index) {
+    heap_caps_free(Index);
+    Index = NULL;
+  }
+  log->AddEvent(LogLevel_Info, "Timelapse: session " + SessionName + " stopped, frames: " + String(SessionFrames));
+}
+
+/**
+ * @brief Append frame to the AVI file. New file is opened, when is the actual file full
+ *
+ * @param const uint8_t* - JPEG data
+ * @param size_t - length of JPEG data
+ */
+void Timelapse::AddFrame(const uint8_t *i_data, size_t i_len) {
+  if ((false == Active) || (NULL == i_data) || (0 == i_len)) {
+    return;
+  }
+
+  xSemaphoreTake(Lock, portMAX_DELAY);
+  if (false == Active) {
+    xSemaphoreGive(Lock);
+    return;
+  }
+
+  /* card failed or is full. Recording continues to the new file, when is card available again */
+  if (false == log->GetWriteAllowed()) {
+    if (false == Suspended) {
+      Suspended = true;
+      if (true == log->GetCardDetectedStatus()) {
+        CloseSegment();
+      } else {
+        AviFile.close();
+      }
+      log->AddEvent(LogLevel_Warning, "Timelapse: micro SD card " + log->GetHealthStateString() + ", recording suspended");
+    }
+    xSemaphoreGive(Lock);
+    return;
+  }
+
+  if (true == Suspended) {
+    Segment++;
+    if (false == OpenSegment()) {
+      xSemaphoreGive(Lock);
+      return;
+    }
+    Suspended = false;
+    log->AddEvent(LogLevel_Info, "Timelapse: recording resumed");
+  }
+
+  /* new file after maximum count of frames or maximum size. Size is checked with the next frame, chunk header and padding */
+  if ((FrameCount >= TIMELAPSE_MAX_FRAMES) || (((uint64_t)MoviSize + 8 + i_len + 1) > TIMELAPSE_MAX_SEGMENT_SIZE)) {
+    CloseSegment();
+    Segment++;
+    if (false == OpenSegment()) {
+      Active = false;
+      heap_caps_free(Index);
+      Index = NULL;
+      xSemaphoreGive(Lock);
+      return;
+    }
+  }
+
+  /* chunk header, data and padding to even size */
+  uint8_t chunk[8];
+  memcpy(chunk, "00dc", 4);
+  Timelapse_WriteLe32(&chunk[4], i_len);
+  uint32_t offset = MoviSize + 4;
+  int64_t start = esp_timer_get_time();
+  size_t written = AviFile.write(chunk, sizeof(chunk));
+  written += AviFile.write(i_data, i_len);
+  uint32_t chunk_size = sizeof(chunk) + i_len;
+  if (i_len & 1) {
+    uint8_t pad = 0;
+    written += AviFile.write(&pad, 1);
+    chunk_size++;
+  }
+
+  /* failed write switches the card to the degraded mode. Recording continues to the new file, when is card available again */
+  log->RecordMediaWrite(written == chunk_size, (uint32_t)(esp_timer_get_time() - start));
+  if (written != chunk_size) {
+    Suspended = true;
+    AviFile.close();
+    xSemaphoreGive(Lock);
+    log->AddEvent(LogLevel_Error, "Timelapse: write failed, recording suspended");
+    return;
+  }
+
+  Index[FrameCount * 2] = offset;
+  Index[(FrameCount * 2) + 1] = i_len;
+  FrameCount++;
+  SessionFrames++;
+  MoviSize += chunk_size;
+  if (i_len > MaxFrameSize) {
+    MaxFrameSize = i_len;
+  }
+
+  /* file is playable after power cut */
+  if (0 == (FrameCount % TIMELAPSE_HEADER_PATCH)) {
+    PatchHeader();
+  }
+  xSemaphoreGive(Lock);
+  log->AddEvent(LogLevel_Verbose, "Timelapse: frame " + String(FrameCount) + ", " + String(i_len) + " bytes");
+}
+
+/**
+ * @brief Open new AVI file in the session folder
+ *
+ * @return bool - true if file was opened
+ */
+bool Timelapse::OpenSegment() {
+  char name[20] = { '\0' };
+
+  /* do not overwrite files from the previous session with the same name */
+  do {
+    sprintf(name, "/tl_%03u.avi", Segment);
+    FilePath = String(TIMELAPSE_DIR) + "/" + SessionName + String(name);
+    if (false == SD_MMC.exists(FilePath)) {
+      break;
+    }
+    Segment++;
+  } while (Segment < 1000);
+
+  AviFile = SD_MMC.open(FilePath.c_str(), FILE_WRITE);
+  if (!AviFile) {
+    log->AddEvent(LogLevel_Error, "Timelapse: failed to create " + FilePath);
+    return false;
+  }
+
+  FrameCount = 0;
+  MoviSize = 0;
+  MaxFrameSize = 0;
+  WriteHeader();
+  SystemMediaLibrary.Invalidate();
+  log->AddEvent(LogLevel_Info, "Timelapse: recording to " + FilePath);
+
+  return true;
+}
+
+/**
+ * @brief Write idx1 index, patch header and close AVI file
+ *
+ */
+void Timelapse::CloseSegment() {
+  if (!AviFile) {
+    return;
+  }
+
+  uint8_t entries[AVI_INDEX_ENTRY_SIZE * 32];
+  uint8_t header[8];
+  memcpy(header, "idx1", 4);
+  Timelapse_WriteLe32(&header[4], FrameCount * AVI_INDEX_ENTRY_SIZE);
+  AviFile.write(header, sizeof(header));
+
+  /* index is written in blocks */
+  uint32_t i = 0;
+  while (i < FrameCount) {
+    uint32_t count = 0;
+    while ((count < 32) && (i < FrameCount)) {
+      uint8_t *entry = &entries[count * AVI_INDEX_ENTRY_SIZE];
+      memcpy(entry, "00dc", 4);
+      Timelapse_WriteLe32(&entry[4], 0x10);  /* AVIIF_KEYFRAME */
+      Timelapse_WriteLe32(&entry[8], Index[i * 2]);
+      Timelapse_WriteLe32(&entry[12], Index[(i * 2) + 1]);
+      count++;
+      i++;
+    }
+    AviFile.write(entries, count * AVI_INDEX_ENTRY_SIZE);
+  }
+
+  PatchHeader();
+  PatchUint32(AVI_OFFSET_RIFF_SIZE, AVI_HEADER_SIZE - 8 + MoviSize + sizeof(header) + (FrameCount * AVI_INDEX_ENTRY_SIZE));
+  AviFile.close();
+  SystemMediaLibrary.Invalidate();
+  log->AddEvent(LogLevel_Info, "Timelapse: closed " + FilePath + ", frames: " + String(FrameCount));
+}
+
+/**
+ * @brief Write AVI header. Count of frames and sizes are patched later
+ *
+ */
+void Timelapse::WriteHeader() {
+  uint8_t header[AVI_HEADER_SIZE];
+  uint16_t width = camera->GetFrameSizeWidth();
+  uint16_t height = camera->GetFrameSizeHeight();
+  memset(header, 0, sizeof(header));
+
+  /* RIFF AVI */
+  memcpy(&header[0], "RIFF", 4);
+  memcpy(&header[8], "AVI ", 4);
+
+  /* LIST hdrl */
+  memcpy(&header[12], "LIST", 4);
+  Timelapse_WriteLe32(&header[16], 192);
+  memcpy(&header[20], "hdrl", 4);
+
+  /* avih, main AVI header */
+  memcpy(&header[24], "avih", 4);
+  Timelapse_WriteLe32(&header[28], 56);
+  Timelapse_WriteLe32(&header[32], 1000000 / TIMELAPSE_FPS);   /* dwMicroSecPerFrame */
+  Timelapse_WriteLe32(&header[44], 0x10);                      /* dwFlags, AVIF_HASINDEX */
+  Timelapse_WriteLe32(&header[56], 1);                         /* dwStreams */
+  Timelapse_WriteLe32(&header[64], width);
+  Timelapse_WriteLe32(&header[68], height);
+
+  /* LIST strl */
+  memcpy(&header[88], "LIST", 4);
+  Timelapse_WriteLe32(&header[92], 116);
+  memcpy(&header[96], "strl", 4);
+
+  /* strh, stream header */
+  memcpy(&header[100], "strh", 4);
+  Timelapse_WriteLe32(&header[104], 56);
+  memcpy(&header[108], "vids", 4);
+  memcpy(&header[112], "MJPG", 4);
+  Timelapse_WriteLe32(&header[128], 1);                        /* dwScale */
+  Timelapse_WriteLe32(&header[132], TIMELAPSE_FPS);            /* dwRate */
+  Timelapse_WriteLe32(&header[148], 0xFFFFFFFF);               /* dwQuality, default */
+  header[160] = width & 0xFF;                                  /* rcFrame right, bottom */
+  header[161] = (width >> 8) & 0xFF;
+  header[162] = height & 0xFF;
+  header[163] = (height >> 8) & 0xFF;
+
+  /* strf, BITMAPINFOHEADER */
+  memcpy(&header[164], "strf", 4);
+  Timelapse_WriteLe32(&header[168], 40);
+  Timelapse_WriteLe32(&header[172], 40);                       /* biSize */
+  Timelapse_WriteLe32(&header[176], width);
+  Timelapse_WriteLe32(&header[180], height);
+  header[184] = 1;                                             /* biPlanes */
+  header[186] = 24;                                            /* biBitCount */
+  memcpy(&header[188], "MJPG", 4);
+  Timelapse_WriteLe32(&header[192], (uint32_t)width * height * 3);
+
+  /* LIST movi */
+  memcpy(&header[212], "LIST", 4);
+  memcpy(&header[220], "movi", 4);
+
+  AviFile.write(header, sizeof(header));
+  PatchHeader();
+}
+
+/**
+ * @brief Patch count of frames and sizes in the header. Header describes file without idx1 index
+ *
+ */
+void Timelapse::PatchHeader() {
+  size_t position = AviFile.position();
+
+  PatchUint32(AVI_OFFSET_RIFF_SIZE, AVI_HEADER_SIZE - 8 + MoviSize);
+  PatchUint32(AVI_OFFSET_AVIH_FRAMES, FrameCount);
+  PatchUint32(AVI_OFFSET_AVIH_BUFFER, MaxFrameSize);
+  PatchUint32(AVI_OFFSET_STRH_LENGTH, FrameCount);
+  PatchUint32(AVI_OFFSET_STRH_BUFFER, MaxFrameSize);
+  PatchUint32(AVI_OFFSET_MOVI_SIZE, MoviSize + 4);
+
+  AviFile.seek(position, SeekSet);
+  AviFile.flush();
+}
+
+/**
+ * @brief Write uint32_t value to the AVI file
+ *
+ * @param uint32_t - offset in the file
+ * @param uint32_t - value
+ */
+void Timelapse::PatchUint32(uint32_t i_offset, uint32_t i_data) {
+  uint8_t buf[4];
+  Timelapse_WriteLe32(buf, i_data);
+  AviFile.seek(i_offset, SeekSet);
+  AviFile.write(buf, sizeof(buf));
+}
+
+/**
+ * @brief Create valid session name. Name is used as folder name
+ *
+ * @param String - requested name
+ * @return String - session name
+ */
+String Timelapse::CreateSessionName(String i_name) {
+  String ret = "";
+
+  for (uint16_t i = 0; (i < i_name.length()) && (ret.length() < TIMELAPSE_NAME_LENGTH); i++) {
+    char c = i_name.charAt(i);
+    if (isalnum(c) || ('-' == c) || ('_' == c)) {
+      ret += c;
+    }
+  }
+
+  if (0 == ret.length()) {
+    char buf[32] = { '\0' };
+    if (true == log->GetNtpTimeSynced()) {
+      time_t now = time(NULL);
+      struct tm timeinfo;
+      localtime_r(&now, &timeinfo);
+      strftime(buf, sizeof(buf), "print_%Y%m%d_%H%M%S", &timeinfo);
+    } else {
+      sprintf(buf, "print_%u", (uint32_t)millis());
+    }
+    ret = String(buf);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Get status of the recording session
+ *
+ * @return bool - true if session is active
+ */
+bool Timelapse::GetActive() {
+  return Active;
+}
+
+/**
+ * @brief Get status of the recording suspension
+ *
+ * @return bool - true if is recording suspended by the micro SD card state
+ */
+bool Timelapse::GetSuspended() {
+  return Suspended;
+}
+
+/**
+ * @brief Get name of the recording session
+ *
+ * @return String - session name
+ */
+String Timelapse::GetSessionName() {
+  return SessionName;
+}
+
+/**
+ * @brief Get path of the actual AVI file
+ *
+ * @return String - path
+ */
+String Timelapse::GetFilePath() {
+  return FilePath;
+}
+
+/**
+ * @brief Get count of frames in the recording session
+ *
+ * @return uint32_t - count of frames
+ */
+uint32_t Timelapse::GetSessionFrames() {
+  return SessionFrames;
+}
+
+/* EOF */
@@ -0,0 +1,83 @@
+/**
+   @file timelapse.h
+
+   @brief Timelapse recorder. Captured photos are saved to the micro SD card to the MJPEG AVI file
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _TIMELAPSE_H_
+#define _TIMELAPSE_H_
+
+#include "Arduino.h"
+#include "FS.h"
+#include "SD_MMC.h"
+#include <time.h>
+#include <esp_heap_caps.h>
+
+#include "mcu_cfg.h"
+#include "var.h"
+#include "log.h"
+#include "camera.h"
+#include "media.h"
+
+#define AVI_HEADER_SIZE             224     ///< size of the AVI header, RIFF + hdrl list + movi list header [bytes]
+#define AVI_OFFSET_RIFF_SIZE        4       ///< offset of the RIFF size
+#define AVI_OFFSET_AVIH_FRAMES      48      ///< offset of the avih dwTotalFrames
+#define AVI_OFFSET_AVIH_BUFFER      60      ///< offset of the avih dwSuggestedBufferSize
+#define AVI_OFFSET_STRH_LENGTH      140     ///< offset of the strh dwLength
+#define AVI_OFFSET_STRH_BUFFER      144     ///< offset of the strh dwSuggestedBufferSize
+#define AVI_OFFSET_MOVI_SIZE        216     ///< offset of the movi list size
+#define AVI_INDEX_ENTRY_SIZE        16      ///< size of one idx1 entry [bytes]
+
+class Timelapse {
+private:
+  bool Active;                ///< recording session is active
+  bool Suspended;             ///< recording is suspended, micro SD card failed or is full
+  bool StopRequest;           ///< stop is requested from WEB server, session is stopped by photo task
+  String SessionName;         ///< name of the session, folder for the AVI files
+  String FilePath;            ///< path of the actual AVI file
+  File AviFile;               ///< actual AVI file
+  uint16_t Segment;           ///< index of the AVI file in the session
+  uint32_t FrameCount;        ///< count of frames in the actual AVI file
+  uint32_t SessionFrames;     ///< count of frames in the session
+  uint32_t MoviSize;          ///< size of the frame chunks in the actual AVI file [bytes]
+  uint32_t MaxFrameSize;      ///< maximum frame size in the actual AVI file [bytes]
+  uint32_t *Index;            ///< pre-allocated idx1 index. Offset and size of each frame
+  Logs *log;                  ///< pointer to logs object
+  Camera *camera;             ///< pointer to camera object
+  SemaphoreHandle_t Lock;     ///< mutex, session is controlled from WEB server and frames are added from photo task
+
+  void StopSession();
+  bool OpenSegment();
+  void CloseSegment();
+  void WriteHeader();
+  void PatchHeader();
+  void PatchUint32(uint32_t, uint32_t);
+  String CreateSessionName(String);
+
+public:
+  Timelapse(Logs *, Camera *);
+  ~Timelapse(){};
+
+  bool Start(String);
+  void Stop();
+  void RequestStop();
+  void ProcessStopRequest();
+  void AddFrame(const uint8_t *, size_t);
+
+  bool GetActive();
+  bool GetSuspended();
+  String GetSessionName();
+  String GetFilePath();
+  uint32_t GetSessionFrames();
+};
+
+extern Timelapse SystemTimelapse;  ///< global variable for timelapse recorder
+
+#endif
+
+/* EOF */
@@ -0,0 +1,297 @@
+/**
+   @file trace.cpp
+
+   @brief Library for lightweight span tracing. Begin/end markers are saved to the ring buffer,
+          and buffer is exported in the Chrome trace json format (chrome://tracing, https://ui.perfetto.dev)
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "trace.h"
+
+#if (true == TRACE_ENABLE)
+
+Trace SystemTrace;
+
+/**
+ * @brief Construct a new TraceDump::TraceDump object
+ *
+ */
+TraceDump::TraceDump() {
+  Events = NULL;
+  Count = 0;
+  Position = 0;
+  ThreadCount = 0;
+  Stage = 0;
+  LineLength = 0;
+  LinePosition = 0;
+}
+
+/**
+ * @brief Destroy the TraceDump::TraceDump object. Release snapshot of the ring buffer
+ *
+ */
+TraceDump::~TraceDump() {
+  if (NULL != Events) {
+    heap_caps_free(Events);
+  }
+}
+
+/**
+ * @brief Construct a new Trace::Trace object
+ *
+ */
+Trace::Trace() {
+  Buffer = NULL;
+  Size = 0;
+  Head = 0;
+  Count = 0;
+  Enabled = true;
+  Lock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+/**
+ * @brief Allocate ring buffer. PSRAM is preferred. Must be called after PSRAM init (from setup)
+ *
+ */
+void Trace::Init() {
+  Buffer = (TraceEvent *)heap_caps_malloc(TRACE_BUFFER_SIZE * sizeof(TraceEvent), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (NULL == Buffer) {
+    Buffer = (TraceEvent *)heap_caps_malloc(TRACE_BUFFER_SIZE * sizeof(TraceEvent), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+
+  if (NULL != Buffer) {
+    Size = TRACE_BUFFER_SIZE;
+  }
+}
+
+/**
+ * @brief Save event to the ring buffer. The oldest event is overwritten, when is buffer full
+ *
+ * @param const char* - span name, must be string literal
+ * @param char - 'B' = begin, 'E' = end
+ */
+void Trace::AddEvent(const char *i_name, char i_phase) {
+  if ((NULL == Buffer) || (false == Enabled)) {
+    return;
+  }
+
+  int64_t now = esp_timer_get_time();
+  uint32_t tid = (uint32_t)xTaskGetCurrentTaskHandle();
+  uint8_t core = xPortGetCoreID();
+
+  portENTER_CRITICAL(&Lock);
+  TraceEvent *event = &Buffer[Head];
+  event->Name = i_name;
+  event->Timestamp = now;
+  event->Tid = tid;
+  event->Phase = i_phase;
+  event->Core = core;
+  Head = (Head + 1) % Size;
+  if (Count < Size) {
+    Count++;
+  }
+  portEXIT_CRITICAL(&Lock);
+}
+
+/**
+ * @brief Clear ring buffer
+ *
+ */
+void Trace::Clear() {
+  portENTER_CRITICAL(&Lock);
+  Head = 0;
+  Count = 0;
+  portEXIT_CRITICAL(&Lock);
+}
+
+/**
+ * @brief Enable/disable recording of the events
+ *
+ * @param bool - status
+ */
+void Trace::SetEnable(bool i_data) {
+  Enabled = i_data;
+}
+
+/**
+ * @brief Get status of the recording
+ *
+ * @return bool - status
+ */
+bool Trace::GetEnable() {
+  return Enabled;
+}
+
+/**
+ * @brief Get count of events in the ring buffer
+ *
+ * @return uint16_t - count
+ */
+uint16_t Trace::GetCount() {
+  return Count;
+}
+
+/**
+ * @brief Create snapshot of the ring buffer for export. Recording is not blocked during export
+ *
+ * @return std::shared_ptr<TraceDump> - snapshot, NULL when is not available memory
+ */
+std::shared_ptr<TraceDump> Trace::CreateDump() {
+  std::shared_ptr<TraceDump> dump = std::make_shared<TraceDump>();
+  if ((NULL == Buffer) || (0 == Count)) {
+    return dump;
+  }
+
+  dump->Events = (TraceEvent *)heap_caps_malloc(Size * sizeof(TraceEvent), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (NULL == dump->Events) {
+    return nullptr;
+  }
+
+  /* copy events from the oldest to the newest */
+  portENTER_CRITICAL(&Lock);
+  uint16_t start = (Head + Size - Count) % Size;
+  for (uint16_t i = 0; i < Count; i++) {
+    dump->Events[i] = Buffer[(start + i) % Size];
+  }
+  dump->Count = Count;
+  portEXIT_CRITICAL(&Lock);
+
+  /* list of tasks. Application tasks are not deleted, so the task handle is valid */
+  for (uint16_t i = 0; i < dump->Count; i++) {
+    bool found = false;
+    for (uint8_t j = 0; j < dump->ThreadCount; j++) {
+      if (dump->Threads[j].Tid == dump->Events[i].Tid) {
+        found = true;
+        break;
+      }
+    }
+
+    if ((false == found) && (dump->ThreadCount < TRACE_MAX_THREADS)) {
+      TraceThread *thread = &dump->Threads[dump->ThreadCount];
+      thread->Tid = dump->Events[i].Tid;
+      strncpy(thread->Name, pcTaskGetTaskName((TaskHandle_t)thread->Tid), sizeof(thread->Name) - 1);
+      thread->Name[sizeof(thread->Name) - 1] = '\0';
+      dump->ThreadCount++;
+    }
+  }
+
+  return dump;
+}
+
+/**
+ * @brief Format next json line of the export
+ *
+ * @param TraceDump* - export state
+ * @return bool - false, when is export done
+ */
+bool Trace::FormatNextLine(TraceDump *i_dump) {
+  bool ret = false;
+  i_dump->LinePosition = 0;
+  i_dump->LineLength = 0;
+
+  /* header */
+  if (0 == i_dump->Stage) {
+    i_dump->LineLength = snprintf(i_dump->Line, sizeof(i_dump->Line), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    i_dump->Stage = 1;
+    i_dump->Position = 0;
+    ret = true;
+  }
+
+  /* metadata with task names */
+  if ((false == ret) && (1 == i_dump->Stage)) {
+    if (i_dump->Position < i_dump->ThreadCount) {
+      TraceThread *thread = &i_dump->Threads[i_dump->Position];
+      i_dump->LineLength = snprintf(i_dump->Line, sizeof(i_dump->Line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                                    (i_dump->Position > 0) ? "," : "", thread->Tid, thread->Name);
+      i_dump->Position++;
+      ret = true;
+    } else {
+      i_dump->Stage = 2;
+      i_dump->Position = 0;
+    }
+  }
+
+  /* events */
+  if ((false == ret) && (2 == i_dump->Stage)) {
+    if (i_dump->Position < i_dump->Count) {
+      TraceEvent *event = &i_dump->Events[i_dump->Position];
+      bool comma = (i_dump->Position > 0) || (i_dump->ThreadCount > 0);
+      i_dump->LineLength = snprintf(i_dump->Line, sizeof(i_dump->Line), "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1,\"tid\":%u,\"args\":{\"core\":%u}}",
+                                    comma ? "," : "", event->Name, event->Phase, event->Timestamp, event->Tid, event->Core);
+      i_dump->Position++;
+      ret = true;
+    } else {
+      i_dump->Stage = 3;
+    }
+  }
+
+  /* footer */
+  if ((false == ret) && (3 == i_dump->Stage)) {
+    i_dump->LineLength = snprintf(i_dump->Line, sizeof(i_dump->Line), "]}");
+    i_dump->Stage = 4;
+    ret = true;
+  }
+
+  /* snprintf returns length of the full string, line can be truncated */
+  if (i_dump->LineLength >= sizeof(i_dump->Line)) {
+    i_dump->LineLength = sizeof(i_dump->Line) - 1;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Read next part of the export. It is used as the filler of the chunked HTTP response
+ *
+ * @param TraceDump* - export state
+ * @param uint8_t* - output buffer
+ * @param size_t - size of the output buffer
+ * @return size_t - count of written bytes, 0 = export done
+ */
+size_t Trace::ReadDump(TraceDump *i_dump, uint8_t *o_buffer, size_t i_max_len) {
+  size_t written = 0;
+
+  while (written < i_max_len) {
+    if (i_dump->LinePosition >= i_dump->LineLength) {
+      if (false == FormatNextLine(i_dump)) {
+        break;
+      }
+    }
+
+    size_t len = i_dump->LineLength - i_dump->LinePosition;
+    if (len > (i_max_len - written)) {
+      len = i_max_len - written;
+    }
+    memcpy(o_buffer + written, i_dump->Line + i_dump->LinePosition, len);
+    i_dump->LinePosition += len;
+    written += len;
+  }
+
+  return written;
+}
+
+/**
+ * @brief Construct a new TraceScope::TraceScope object. Begin span
+ *
+ * @param const char* - span name
+ */
+TraceScope::TraceScope(const char *i_name) {
+  Name = i_name;
+  SystemTrace.AddEvent(Name, 'B');
+}
+
+/**
+ * @brief Destroy the TraceScope::TraceScope object. End span
+ *
+ */
+TraceScope::~TraceScope() {
+  SystemTrace.AddEvent(Name, 'E');
+}
+
+#endif
+
+/* EOF */
@@ -0,0 +1,121 @@
+/**
+   @file trace.h
+
+   @brief Library for lightweight span tracing. Begin/end markers are saved to the ring buffer,
+          and buffer is exported in the Chrome trace json format (chrome://tracing, https://ui.perfetto.dev)
+
+   Tracing is compiled out, when is TRACE_ENABLE false
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include "Arduino.h"
+#include "mcu_cfg.h"
+
+#if (true == TRACE_ENABLE)
+#include "esp_timer.h"
+#include <esp_heap_caps.h>
+#include <memory>
+
+/**
+ * @brief TraceEvent struct
+ * one begin/end marker in the ring buffer
+ */
+struct TraceEvent {
+  const char *Name;       ///< span name, must be string literal
+  int64_t Timestamp;      ///< time of the event [us], esp_timer time base
+  uint32_t Tid;           ///< task handle of the task, which created event
+  char Phase;             ///< 'B' = begin, 'E' = end
+  uint8_t Core;           ///< core, where was event created
+};
+
+/**
+ * @brief TraceThread struct
+ * task name for the Chrome trace metadata
+ */
+struct TraceThread {
+  uint32_t Tid;                           ///< task handle
+  char Name[configMAX_TASK_NAME_LEN];     ///< task name
+};
+
+/**
+ * @brief TraceDump struct
+ * state of the chunked export of the trace buffer
+ */
+struct TraceDump {
+  TraceEvent *Events;                     ///< snapshot of the ring buffer
+  uint16_t Count;                         ///< count of events in the snapshot
+  uint16_t Position;                      ///< next exported event
+  TraceThread Threads[TRACE_MAX_THREADS]; ///< tasks in the snapshot
+  uint8_t ThreadCount;                    ///< count of tasks in the snapshot
+  uint8_t Stage;                          ///< export stage, header/threads/events/footer/done
+  char Line[160];                         ///< formatted json line
+  size_t LineLength;                      ///< length of the formatted json line
+  size_t LinePosition;                    ///< already exported part of the json line
+
+  TraceDump();
+  ~TraceDump();
+};
+
+class Trace {
+private:
+  TraceEvent *Buffer;             ///< ring buffer
+  uint16_t Size;                  ///< size of the ring buffer
+  uint16_t Head;                  ///< next write position
+  uint16_t Count;                 ///< count of valid events in the ring buffer
+  bool Enabled;                   ///< runtime enable/disable recording
+  portMUX_TYPE Lock;              ///< spinlock for access to the ring buffer from multiple cores
+
+  bool FormatNextLine(TraceDump *);
+
+public:
+  Trace();
+  ~Trace(){};
+
+  void Init();
+  void AddEvent(const char *, char);
+  void Clear();
+  void SetEnable(bool);
+  bool GetEnable();
+  uint16_t GetCount();
+
+  std::shared_ptr<TraceDump> CreateDump();
+  size_t ReadDump(TraceDump *, uint8_t *, size_t);
+};
+
+/**
+ * @brief TraceScope class
+ * RAII helper, span is ended when object goes out of the scope
+ */
+class TraceScope {
+private:
+  const char *Name;   ///< span name
+
+public:
+  TraceScope(const char *);
+  ~TraceScope();
+};
+
+extern Trace SystemTrace;  ///< global variable for span tracing
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_BEGIN(name) SystemTrace.AddEvent(name, 'B')                           ///< begin span
+#define TRACE_END(name) SystemTrace.AddEvent(name, 'E')                             ///< end span
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)    ///< span to the end of the scope
+
+#else
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_SCOPE(name)
+#endif
+
+#endif
+
+/* EOF */
@@ -17,10 +17,7 @@ struct FirmwareUpdate_struct FirmwareUpdate = { "Ready", false, 0, 0, 0, false,
 TaskHandle_t Task_CapturePhotoAndSend;
 TaskHandle_t Task_WiFiManagement;
 TaskHandle_t Task_SystemMain;
-TaskHandle_t Task_SdCardCheck;
-TaskHandle_t Task_SerialCfg;
-TaskHandle_t Task_StreamTelemetry;
-TaskHandle_t Task_SysLed;
-TaskHandle_t Task_WiFiWatchdog;
+TaskHandle_t Task_Service;
+TaskHandle_t Task_FrameAnalysis = NULL;
 
 /* EOF */
\ No newline at end of file
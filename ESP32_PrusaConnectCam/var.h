@@ -37,17 +37,23 @@ struct FirmwareUpdate_struct {
   bool OtaUpdateFwAvailable;              ///< flag for available new FW version
 };
 
+struct AnalysisRoi_struct {
+  uint8_t X;                              ///< left side of the region [% of frame width]
+  uint8_t Y;                              ///< top side of the region [% of frame height]
+  uint8_t Width;                          ///< width of the region [% of frame width], 0 = region is disabled
+  uint8_t Height;                         ///< height of the region [% of frame height], 0 = region is disabled
+  uint8_t ChangeThreshold;                ///< threshold of the mean difference from background, 0 = disabled
+  uint8_t TextureThreshold;               ///< threshold of the texture increase over background, 0 = disabled
+};
+
 extern struct WebBasicAuth_struct WebBasicAuth;      ///< structure with configuration for basic auth
 extern struct FirmwareUpdate_struct FirmwareUpdate;  ///< firmware update status and process
 
 extern TaskHandle_t Task_CapturePhotoAndSend;        ///< task handle for capture photo and send
 extern TaskHandle_t Task_WiFiManagement;             ///< task handle for wifi management
 extern TaskHandle_t Task_SystemMain;                 ///< task handle for system main
-extern TaskHandle_t Task_SdCardCheck;                ///< task handle for sd card check  
-extern TaskHandle_t Task_SerialCfg;                  ///< task handle for serial configuration
-extern TaskHandle_t Task_StreamTelemetry;            ///< task handle for stream telemetry
-extern TaskHandle_t Task_SysLed;                     ///< task handle for system led
-extern TaskHandle_t Task_WiFiWatchdog;               ///< task handle for wifi watchdog
+extern TaskHandle_t Task_Service;
+extern TaskHandle_t Task_FrameAnalysis;              ///< task handle for frame analysis                    ///< task handle for service task (sd card check, serial cfg, stream telemetry, system led, wifi watchdog)
 
 #endif
 
@@ -32,6 +32,37 @@ WiFiMngt::WiFiMngt(Configuration *i_conf, Logs *i_log, Camera *i_cam) {
 
   NtpFirstSync = false;
   StartStaWdg = false;
+  WiFiStaMultipleNetwork = false;
+  WiFiStaNetworkChannel = 0;
+
+  WifiScanJson = "[]";
+  WiFiScanSemaphore = xSemaphoreCreateMutex();
+  PowerSaveSemaphore = xSemaphoreCreateMutex();
+  WiFiScanRunning = false;
+  WiFiScanStartTime = 0;
+  WiFiScanTimestamp = 0;
+  WiFiScanStaCount = 0;
+
+  FastConnectEnable = false;
+  FastConnectActive = false;
+  FastConnectFailed = false;
+  FastConnectStaticIp = false;
+  FastConnectStartTime = 0;
+  FastConnectTimer = NULL;
+  CacheChannel = 0;
+  CacheLease = 0;
+  CacheLeasePending = false;
+
+  RoamingRssiAvg = 0;
+  RoamingCandidateValid = false;
+  RoamingCandidateChannel = 0;
+  RoamingCandidateRssi = -100;
+  RoamingScanTime = 0;
+  RoamingTime = 0;
+
+  PowerProfile = WiFiPowerProfile_Performance;
+  PowerSaveMode = WIFI_PS_NONE;
+  UploadProcessing = false;
 }
 
 /**
@@ -43,6 +74,16 @@ void WiFiMngt::LoadCfgFromEeprom() {
   WifiSsid = config->LoadWifiSsid();
   WifiPassword = config->LoadWifiPassowrd();
   mDNS_record = config->LoadMdnsRecord();
+
+  FastConnectEnable = config->LoadWifiFastConnect();
+  config->LoadWifiCacheBssid(CacheBssid);
+  CacheChannel = config->LoadWifiCacheChannel();
+  CacheIp = config->LoadWifiCacheIp();
+  CacheMask = config->LoadWifiCacheMask();
+  CacheGateway = config->LoadWifiCacheGateway();
+  CacheDns = config->LoadWifiCacheDns();
+  CacheLease = config->LoadWifiCacheLease();
+  PowerProfile = (WiFiPowerProfile) config->LoadWifiPowerProfile();
 }
 
 /**
@@ -56,12 +97,23 @@ void WiFiMngt::Init() {
   ServiceMode = true;
   log->AddEvent(LogLevel_Info, "WiFi MAC: " + WiFi.macAddress());
 
+  /* timer for fast connect timeout, started with each fast connect attempt */
+  esp_timer_create_args_t timer_args = {};
+  timer_args.callback = &WiFiMngt_FastConnectTimeout;
+  timer_args.name = "fast_connect";
+  if (ESP_OK != esp_timer_create(&timer_args, &FastConnectTimer)) {
+    FastConnectTimer = NULL;
+    log->AddEvent(LogLevel_Error, "WiFi fast connect timer create failed");
+  }
+
   /* Set Wi-Fi networks */
   SetWifiEvents();
   CreateApSsid();
   log->AddEvent(LogLevel_Warning, "Set WiFi AP mode");
   WiFi.mode(WIFI_AP_STA);
-  esp_wifi_set_ps(WIFI_PS_NONE);
+  /* without power save during service AP mode */
+  PowerSaveMode = WIFI_PS_NONE;
+  esp_wifi_set_ps(PowerSaveMode);
   WiFi.softAPConfig(Service_LocalIp, Service_Gateway, Service_Subnet);
   WiFi.softAP(SericeApSsid.c_str(), SERVICE_WIFI_PASS, SERVICE_WIFI_CHANNEL);
   WiFi.setHostname(DEVICE_HOSTNAME);
@@ -71,23 +123,20 @@ void WiFiMngt::Init() {
   //WiFi.setTxPower(WIFI_POWER_18_5dBm);
 
   if (config->CheckActifeWifiCfgFlag() == true) {
-    if (true == CheckAvailableWifiNetwork(WifiSsid)) {
-      WiFiStaConnect();
-      log->AddEvent(LogLevel_Warning, "Connecting to WiFi: " + WifiSsid);
+    /* connect directly, without blocking scan. Result of the background scan is used for next reconnect */
+    WiFiStaConnect();
+    log->AddEvent(LogLevel_Warning, "Connecting to WiFi: " + WifiSsid);
 
 #if (WIFI_CLIENT_WAIT_CON == true)
-      while (WiFi.status() != WL_CONNECTED) {
-        delay(1000);
-        log->AddEvent(LogLevel_Verbose, ".");
-      }
-      WifiCfg.FirstConnected = true;
+    while (WiFi.status() != WL_CONNECTED) {
+      delay(1000);
+      log->AddEvent(LogLevel_Verbose, ".");
+    }
+    WifiCfg.FirstConnected = true;
 
-      /* Print ESP32 Local IP Address */
-      log->AddEvent(LogLevel_Info, "WiFi network IP Address: http://" + WiFi.localIP().toString());
+    /* Print ESP32 Local IP Address */
+    log->AddEvent(LogLevel_Info, "WiFi network IP Address: http://" + WiFi.localIP().toString());
 #endif
-    } else {
-      log->AddEvent(LogLevel_Warning, "Wifi unavailable. Skip connecting to WiFi: " + WifiSsid);
-    }
   } else {
     ScanWiFiNetwork();
   }
@@ -118,7 +167,7 @@ void WiFiMngt::WifiManagement() {
       if (WiFi.softAPgetStationNum() == 0) {
         log->AddEvent(LogLevel_Info, "Disable service AP mode");
         WiFi.mode(WIFI_STA);
-        esp_wifi_set_ps(WIFI_PS_NONE);
+        UpdatePowerSave();
         WiFiStaConnect();
         //WiFi.begin(WifiSsid, WifiPassword);
         WiFiMode = "Client";
@@ -142,6 +191,14 @@ void WiFiMngt::WifiManagement() {
   if ((true == config->CheckActifeWifiCfgFlag()) && (false == NtpFirstSync) && (WL_CONNECTED == WiFi.status())) {
     SyncNtpTime();
   }
+
+  /* check power save mode */
+  UpdatePowerSave();
+
+  /* fill list of wifi networks after boot, when is module connected */
+  if ((0 == WiFiScanTimestamp) && (WL_CONNECTED == WiFi.status())) {
+    StartWiFiScan(false);
+  }
 }
 
 /**
@@ -154,7 +211,8 @@ void WiFiMngt::WiFiReconnect() {
     log->AddEvent(LogLevel_Warning, "Reconnecting to WiFi. STA");
     WiFi.disconnect();
     log->AddEvent(LogLevel_Warning, "Disconnect from WiFi");
-    WiFi.reconnect();
+    /* connect with cached BSSID and channel, when is available. Without full scan of all channels */
+    WiFiStaConnect();
     log->AddEvent(LogLevel_Warning, "Reconnecting to WiFi. STA");
   } else if (WiFi.status() == WL_CONNECTED) {
     char cstr[150];
@@ -164,8 +222,12 @@ void WiFiMngt::WiFiReconnect() {
 
   if (Connect.GetBackendAvailabilitStatus() == BackendUnavailable) {
     log->AddEvent(LogLevel_Warning, "Reconnecting to WiFi. STA. Problem with connecting to backend!");
+    /* cached IP address can be invalid (expired lease, IP conflict). Next connect via DHCP */
+    if (true == FastConnectStaticIp) {
+      InvalidateFastConnectLease();
+    }
     WiFi.disconnect();
-    WiFi.reconnect();
+    WiFiStaConnect();
     Connect.SetBackendAvailabilitStatus(WaitForFirstConnection);
   }
 }
@@ -200,17 +262,224 @@ void WiFiMngt::SetWifiEvents() {
 void WiFiMngt::WiFiStaConnect() {
   if (config->CheckActifeWifiCfgFlag() == true) {
     system_led.setTimer(STATUS_LED_STA_CONNECTING);
-    if (false == WiFiStaMultipleNetwork) {
-      WiFi.begin(WifiSsid, WifiPassword);
-      log->AddEvent(LogLevel_Info, "Connecting to STA SSID");
-    } else if (true == WiFiStaMultipleNetwork) {
-      WiFi.begin(WifiSsid, WifiPassword, 0, WiFiStaNetworkBssid);
-      log->AddEvent(LogLevel_Info, "Connecting to STA BSSID");
+    if (true == CheckFastConnectCache()) {
+      /* fast connect. Without scan of all channels. Cached IP address is used only with valid lease, otherwise DHCP */
+      FastConnectActive = true;
+      FastConnectStartTime = millis();
+      if (NULL != FastConnectTimer) {
+        esp_timer_stop(FastConnectTimer);
+        esp_timer_start_once(FastConnectTimer, (uint64_t)WIFI_FAST_CONNECT_TIMEOUT * 1000);
+      }
+
+      bool static_ip = CheckFastConnectLease();
+      if (true == static_ip) {
+        WiFi.config(CacheIp, CacheGateway, CacheMask, CacheDns);
+      } else if (true == FastConnectStaticIp) {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+      }
+      FastConnectStaticIp = static_ip;
+
+      WiFi.begin(WifiSsid, WifiPassword, CacheChannel, CacheBssid);
+      log->AddEvent(LogLevel_Info, "Fast connecting to STA BSSID, channel " + String(CacheChannel) + ", IP " + ((true == FastConnectStaticIp) ? CacheIp.toString() : String("DHCP")));
+    } else {
+      FastConnectActive = false;
+      if (true == FastConnectStaticIp) {
+        /* back to DHCP */
+        FastConnectStaticIp = false;
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+      }
+
+      if (false == WiFiStaMultipleNetwork) {
+        WiFi.begin(WifiSsid, WifiPassword);
+        log->AddEvent(LogLevel_Info, "Connecting to STA SSID");
+      } else if (true == WiFiStaMultipleNetwork) {
+        WiFi.begin(WifiSsid, WifiPassword, WiFiStaNetworkChannel, WiFiStaNetworkBssid);
+        log->AddEvent(LogLevel_Info, "Connecting to STA BSSID");
+      }
     }
     WiFi.setAutoReconnect(true);
   }
 }
 
+/**
+   @brief Function for check valid BSSID and channel cache for fast connect. Valid time is not required
+   @param none
+   @return bool - true if fast connect can be used
+*/
+bool WiFiMngt::CheckFastConnectCache() {
+  if ((false == FastConnectEnable) || (true == FastConnectFailed)) {
+    return false;
+  }
+
+  /* 0 = invalid cache, 255 = erased EEPROM */
+  if ((CacheChannel < 1) || (CacheChannel > 14)) {
+    return false;
+  }
+
+  bool bssid_valid = false;
+  for (uint8_t i = 0; i < 6; i++) {
+    if ((CacheBssid[i] != 0x00) && (CacheBssid[i] != 0xFF)) {
+      bssid_valid = true;
+      break;
+    }
+  }
+
+  return bssid_valid;
+}
+
+/**
+   @brief Function for check valid cached IP address and its lease. Without valid time (power-on before NTP sync)
+          lease can not be checked and DHCP is used
+   @param none
+   @return bool - true if cached IP address can be used as static IP
+*/
+bool WiFiMngt::CheckFastConnectLease() {
+  if (((uint32_t)CacheIp == 0) || ((uint32_t)CacheIp == 0xFFFFFFFF) || ((uint32_t)CacheMask == 0)) {
+    return false;
+  }
+
+  struct tm timeinfo;
+  if ((0 == CacheLease) || (false == getLocalTime(&timeinfo, 0))) {
+    return false;
+  }
+
+  uint32_t now = (uint32_t)time(NULL);
+  if ((now >= CacheLease) || ((CacheLease - now) > WIFI_FAST_CONNECT_LEASE)) {
+    log->AddEvent(LogLevel_Info, "WiFi cached DHCP lease expired");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+   @brief Function for fallback from fast connect to the standard connect with DHCP
+   @param none
+   @return none
+*/
+void WiFiMngt::FastConnectFallback() {
+  if (false == FastConnectActive) {
+    return;
+  }
+
+  log->AddEvent(LogLevel_Warning, "WiFi fast connect failed after " + String(millis() - FastConnectStartTime) + " ms. Connecting via standard way");
+  FastConnectActive = false;
+  if (NULL != FastConnectTimer) {
+    esp_timer_stop(FastConnectTimer);
+  }
+  FastConnectFailed = true;
+  WiFi.disconnect();
+  WiFiStaConnect();
+}
+
+/**
+   @brief Function for update cache for fast connect after successful connection. Save to EEPROM only changed values
+   @param none
+   @return none
+*/
+void WiFiMngt::UpdateFastConnectCache() {
+  if (true == FastConnectActive) {
+    log->AddEvent(LogLevel_Info, "WiFi fast connect done in " + String(millis() - FastConnectStartTime) + " ms");
+  }
+  FastConnectActive = false;
+  FastConnectFailed = false;
+  if (NULL != FastConnectTimer) {
+    esp_timer_stop(FastConnectTimer);
+  }
+
+  if (false == FastConnectEnable) {
+    return;
+  }
+
+  uint8_t *bssid = WiFi.BSSID();
+  if ((NULL != bssid) && (0 != memcmp(CacheBssid, bssid, 6))) {
+    memcpy(CacheBssid, bssid, 6);
+    config->SaveWifiCacheBssid(CacheBssid);
+  }
+
+  /* lease is stored only when was obtained from DHCP server */
+  if (false == FastConnectStaticIp) {
+    if ((uint32_t)CacheIp != (uint32_t)WiFi.localIP()) {
+      CacheIp = WiFi.localIP();
+      config->SaveWifiCacheIp(CacheIp);
+    }
+
+    if ((uint32_t)CacheMask != (uint32_t)WiFi.subnetMask()) {
+      CacheMask = WiFi.subnetMask();
+      config->SaveWifiCacheMask(CacheMask);
+    }
+
+    if ((uint32_t)CacheGateway != (uint32_t)WiFi.gatewayIP()) {
+      CacheGateway = WiFi.gatewayIP();
+      config->SaveWifiCacheGateway(CacheGateway);
+    }
+
+    if ((uint32_t)CacheDns != (uint32_t)WiFi.dnsIP(0)) {
+      CacheDns = WiFi.dnsIP(0);
+      config->SaveWifiCacheDns(CacheDns);
+    }
+
+    UpdateFastConnectLease();
+  }
+
+  /* channel is saved as last, it is a flag about valid cache */
+  uint8_t channel = WiFi.channel();
+  if (CacheChannel != channel) {
+    CacheChannel = channel;
+    config->SaveWifiCacheChannel(CacheChannel);
+  }
+}
+
+/**
+   @brief Function for invalidate cache for fast connect. Next connect is done via scan and DHCP
+   @param none
+   @return none
+*/
+void WiFiMngt::InvalidateFastConnectCache() {
+  log->AddEvent(LogLevel_Info, "WiFi fast connect cache invalidated");
+  FastConnectActive = false;
+  if (0 != CacheChannel) {
+    CacheChannel = 0;
+    config->SaveWifiCacheChannel(CacheChannel);
+  }
+}
+
+/**
+   @brief Function for invalidate cached DHCP lease. BSSID and channel are kept, next connect is done via DHCP
+   @param none
+   @return none
+*/
+void WiFiMngt::InvalidateFastConnectLease() {
+  log->AddEvent(LogLevel_Info, "WiFi cached DHCP lease invalidated");
+  CacheLeasePending = false;
+  if (0 != CacheLease) {
+    CacheLease = 0;
+    config->SaveWifiCacheLease(CacheLease);
+  }
+}
+
+/**
+   @brief Function for update expiration of the cached DHCP lease. Lease obtained before time sync
+          is saved after NTP sync. Stored lease is kept until then, it expires earlier than the new one.
+          EEPROM is written only when is lease moved by more than half of its lifetime
+   @param none
+   @return none
+*/
+void WiFiMngt::UpdateFastConnectLease() {
+  struct tm timeinfo;
+
+  CacheLeasePending = !getLocalTime(&timeinfo, 0);
+  if (true == CacheLeasePending) {
+    return;
+  }
+
+  uint32_t lease = (uint32_t)time(NULL) + WIFI_FAST_CONNECT_LEASE;
+  if ((lease < CacheLease) || ((lease - CacheLease) > (WIFI_FAST_CONNECT_LEASE / 2))) {
+    CacheLease = lease;
+    config->SaveWifiCacheLease(CacheLease);
+  }
+}
+
 /**
    @brief Function for set time from NTP server
    @param none
@@ -239,6 +508,10 @@ void WiFiMngt::SyncNtpTime() {
     if (true == log->GetNtpTimeSynced()) {
       log->AddEvent(LogLevel_Info, "Sync NTP time done. Set UTC timezone");
       NtpFirstSync = true;
+
+      if ((true == CacheLeasePending) && (true == FastConnectEnable)) {
+        UpdateFastConnectLease();
+      }
     } else {
       log->AddEvent(LogLevel_Info, "Sync NTP time fail");
     }
@@ -246,32 +519,72 @@ void WiFiMngt::SyncNtpTime() {
 }
 
 /**
-   @brief Function for scan wifi network
+   @brief Function for scan wifi network. Scan is asynchronous, result is processed in the scan done event
    @param none
    @return none
 */
 void WiFiMngt::ScanWiFiNetwork() {
-  ScanWifiNetwork("");
+  StartWiFiScan(false);
 }
 
 /**
-   @brief Function for scan wifi network and check available wifi network
-   @param String - searched wifi network
-   @return uint8_t - count of found wifi networks with same SSID
+   @brief Function for start asynchronous scan of wifi networks
+   @param bool - true = ignore minimum interval between scans
+   @param uint32_t - scan time per channel [ms]
+   @return bool - true if scan was started
 */
-uint8_t WiFiMngt::ScanWifiNetwork(String ssid) {
+bool WiFiMngt::StartWiFiScan(bool i_force, uint32_t i_dwell) {
+  if (true == WiFiScanRunning) {
+    if ((millis() - WiFiScanStartTime) < WIFI_SCAN_MIN_INTERVAL) {
+      log->AddEvent(LogLevel_Verbose, "WiFi scan already running");
+      return false;
+    }
+
+    /* scan done event never came. For example, scan was aborted by connecting to STA */
+    log->AddEvent(LogLevel_Warning, "WiFi scan timeout. Restart scan");
+    WiFi.scanDelete();
+  }
+
+  if ((false == i_force) && (0 != WiFiScanTimestamp) && (GetWiFiScanAge() < WIFI_SCAN_MIN_INTERVAL)) {
+    log->AddEvent(LogLevel_Verbose, "WiFi scan skipped. Last scan age: " + String(GetWiFiScanAge()) + " ms");
+    return false;
+  }
+
   log->AddEvent(LogLevel_Info, "Scan WI-FI networks");
-  log->AddEvent(LogLevel_Info, "Check available WI-FI network: " + ssid);
-  uint8_t ret = 0;        ///< total wifi network count
+  WiFiScanRunning = true;
+  WiFiScanStartTime = millis();
+  int16_t ret = WiFi.scanNetworks(true, false, false, i_dwell);
+  if (WIFI_SCAN_FAILED == ret) {
+    log->AddEvent(LogLevel_Warning, "Start WiFi scan failed");
+    WiFiScanRunning = false;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+   @brief Function for process result of the asynchronous scan. Make json with networks and check available STA network
+   @param none
+   @return none
+*/
+void WiFiMngt::ProcessWiFiScanResult() {
+  uint8_t ret = 0;        ///< total wifi network count with STA SSID
   int bestSignal = -100;  ///< wifi network with best signal (when is available multiple networks with same SSID)
   uint8_t bssid[6] = { 0 };
+  uint8_t channel = 0;
+  String ScanJson = "";
+
+  int16_t n = WiFi.scanComplete();
+  if (n < 0) {
+    log->AddEvent(LogLevel_Warning, "WiFi scan result not available: " + String(n));
+    WiFiScanRunning = false;
+    return;
+  }
 
-  /* scan WI-FI networks */
-  int n = WiFi.scanNetworks();
-  log->AddEvent(LogLevel_Verbose, "Scan done");
+  log->AddEvent(LogLevel_Info, "Check available WI-FI network: " + WifiSsid);
   JsonDocument doc_json;
   JsonArray wifiArray = doc_json.to<JsonArray>();
-  WifiScanJson = "";
 
   /* make json with each found WI-FI networks */
   if (n == 0) {
@@ -282,13 +595,14 @@ uint8_t WiFiMngt::ScanWifiNetwork(String ssid) {
 
     for (int i = 0; i < n; ++i) {
       /* check available wifi network */
-      if (WiFi.SSID(i) == ssid) {
+      if ((WifiSsid.length() > 0) && (WiFi.SSID(i) == WifiSsid)) {
         ret++;
 
         if (WiFi.RSSI(i) > bestSignal) {
           bestSignal = WiFi.RSSI(i);
           uint8_t *tmp = WiFi.BSSID(i);
           memcpy(bssid, tmp, 6);
+          channel = WiFi.channel(i);
         }
       }
 
@@ -308,38 +622,53 @@ uint8_t WiFiMngt::ScanWifiNetwork(String ssid) {
       log->AddEvent(LogLevel_Info, formattedString);
     }
   }
-  serializeJson(doc_json, WifiScanJson);
+  serializeJson(doc_json, ScanJson);
 
   // Delete the scan result to free memory for code below.
   WiFi.scanDelete();
-  log->AddEvent(LogLevel_Verbose, WifiScanJson);
+  log->AddEvent(LogLevel_Verbose, ScanJson);
+
+  /* update cached result */
+  if (xSemaphoreTake(WiFiScanSemaphore, portMAX_DELAY)) {
+    WifiScanJson = ScanJson;
+    WiFiScanStaCount = ret;
+    WiFiScanTimestamp = millis();
+    xSemaphoreGive(WiFiScanSemaphore);
+  }
+  WiFiScanRunning = false;
+
+  /* store roaming candidate. It is evaluated in the WiFi watchdog task */
+  if ((1 <= ret) && (WL_CONNECTED == WiFi.status())) {
+    memcpy(RoamingCandidateBssid, bssid, 6);
+    RoamingCandidateChannel = channel;
+    RoamingCandidateRssi = bestSignal;
+    RoamingCandidateValid = true;
+  }
 
   /* print status */
   if (1 <= ret) {
-    log->AddEvent(LogLevel_Info, "SSID: " + ssid + " found, " + String(ret) + "x");
+    log->AddEvent(LogLevel_Info, "SSID: " + WifiSsid + " found, " + String(ret) + "x");
     if (1 < ret) {
       memcpy(WiFiStaNetworkBssid, bssid, 6);
+      WiFiStaNetworkChannel = channel;
       WiFiStaMultipleNetwork = true;
       char mac[18] = { 0 };
       sprintf(mac, "%02X:%02X:%02X:%02X:%02X:%02X", WiFiStaNetworkBssid[0], WiFiStaNetworkBssid[1], WiFiStaNetworkBssid[2], WiFiStaNetworkBssid[3], WiFiStaNetworkBssid[4], WiFiStaNetworkBssid[5]);
-      log->AddEvent(LogLevel_Info, "WiFi roaming found! Connecting to " + String(mac) + " -> " + String(bestSignal) + "dBm, " + String(WiFiStaMultipleNetwork));
+      log->AddEvent(LogLevel_Info, "WiFi roaming found! Next connecting to " + String(mac) + " -> " + String(bestSignal) + "dBm, " + String(WiFiStaMultipleNetwork));
     }
   } else {
-    log->AddEvent(LogLevel_Info, "SSID: " + ssid + " not found");
+    log->AddEvent(LogLevel_Info, "SSID: " + WifiSsid + " not found");
   }
-
-  return ret;
 }
 
 /**
-   @brief Function for check available wifi network
-   @param String - ssid
-   @return bool - true if wifi network is available
+   @brief Function for check available STA wifi network from cached scan result
+   @param unsigned long - maximum age of the scan result [ms]
+   @return bool - true if STA wifi network was found in the fresh scan result
 */
-bool WiFiMngt::CheckAvailableWifiNetwork(String i_data) {
-  uint8_t tmp = ScanWifiNetwork(i_data);
+bool WiFiMngt::CheckAvailableWifiNetwork(unsigned long i_max_age) {
   bool ret = false;
-  if (tmp >= 1) {
+  if ((0 != WiFiScanTimestamp) && (GetWiFiScanAge() <= i_max_age) && (WiFiScanStaCount >= 1)) {
     ret = true;
   }
 
@@ -372,17 +701,19 @@ void WiFiMngt::CreateApSsid() {
  * 
  */
 void WiFiMngt::WiFiWatchdog() {
-
   /* when is enabled wifi configuration, and is not connected to wifi network, and is available at least one wifi network */
   if ((true == config->CheckActifeWifiCfgFlag()) && (WL_CONNECTED != WiFi.status()) && (true == GetFirstConnection())) {
     log->AddEvent(LogLevel_Warning, "WiFi WDG. STA connection lost.");
     unsigned long currentMillis = millis();
     
     if (false == StartStaWdg) {
-      if (ScanWifiNetwork(WifiSsid) >= 1) {
+      /* check result from previous background scan, or start new scan. Result is checked in the next task run */
+      if (true == CheckAvailableWifiNetwork(TASK_WIFI_WATCHDOG)) {
         StartStaWdg = true;
         TaskWdg_previousMillis = currentMillis;
         log->AddEvent(LogLevel_Warning, "WiFi STA connection lost. Start watchdog timer!");
+      } else {
+        StartWiFiScan(false);
       }
     }
 
@@ -396,6 +727,136 @@ void WiFiMngt::WiFiWatchdog() {
     StartStaWdg = false;
     TaskWdg_previousMillis = millis();
   }
+
+  WiFiRoaming();
+}
+
+/**
+ * @brief Roaming manager. Sample RSSI of the connected AP, start background scan when is signal weak,
+ *        and move to the better AP with the same SSID. Hysteresis and minimum interval prevent ping-pong between APs
+ * 
+ */
+void WiFiMngt::WiFiRoaming() {
+#if (true == WIFI_ROAMING_ENABLE)
+  if ((WL_CONNECTED != WiFi.status()) || (true == FastConnectActive) || (true == FirmwareUpdate.Processing)) {
+    RoamingRssiAvg = 0;
+    RoamingCandidateValid = false;
+    return;
+  }
+
+  /* moving average of the RSSI */
+  int rssi = WiFi.RSSI();
+  if (0 == RoamingRssiAvg) {
+    RoamingRssiAvg = rssi;
+  } else {
+    RoamingRssiAvg = ((RoamingRssiAvg * (WIFI_ROAMING_RSSI_SAMPLES - 1)) + rssi) / WIFI_ROAMING_RSSI_SAMPLES;
+  }
+  log->AddEvent(LogLevel_Verbose, "WiFi roaming. RSSI: " + String(rssi) + " dBm, average: " + String(RoamingRssiAvg) + " dBm");
+
+  /* evaluate candidate from the last scan */
+  if (true == RoamingCandidateValid) {
+    RoamingCandidateValid = false;
+    uint8_t *current = WiFi.BSSID();
+
+    if ((NULL != current) && (0 != memcmp(current, RoamingCandidateBssid, 6)) && (RoamingCandidateRssi >= (RoamingRssiAvg + WIFI_ROAMING_HYSTERESIS)) &&
+        ((0 == RoamingTime) || (millis() - RoamingTime >= WIFI_ROAMING_MIN_INTERVAL))) {
+      log->AddEvent(LogLevel_Warning, "WiFi roaming. Current AP: " + String(RoamingRssiAvg) + " dBm, candidate: " + String(RoamingCandidateRssi) + " dBm");
+      RoamToBssid(RoamingCandidateBssid, RoamingCandidateChannel);
+      return;
+    }
+  }
+
+  /* weak signal, look for the better AP */
+  if ((RoamingRssiAvg < WIFI_ROAMING_RSSI_THRESHOLD) && ((0 == RoamingScanTime) || (millis() - RoamingScanTime >= WIFI_ROAMING_SCAN_INTERVAL))) {
+    log->AddEvent(LogLevel_Info, "WiFi roaming. Weak signal " + String(RoamingRssiAvg) + " dBm, start roaming scan");
+    RoamingScanTime = millis();
+    StartWiFiScan(true, WIFI_ROAMING_SCAN_DWELL);
+  }
+#endif
+}
+
+/**
+ * @brief Function for move STA connection to the another AP with the same SSID
+ * 
+ * @param const uint8_t * - BSSID of the new AP
+ * @param uint8_t - channel of the new AP
+ */
+void WiFiMngt::RoamToBssid(const uint8_t *i_bssid, uint8_t i_channel) {
+  char mac[18] = { 0 };
+  sprintf(mac, "%02X:%02X:%02X:%02X:%02X:%02X", i_bssid[0], i_bssid[1], i_bssid[2], i_bssid[3], i_bssid[4], i_bssid[5]);
+  log->AddEvent(LogLevel_Warning, "WiFi roaming to " + String(mac) + ", channel " + String(i_channel));
+
+  memcpy(WiFiStaNetworkBssid, i_bssid, 6);
+  WiFiStaNetworkChannel = i_channel;
+  WiFiStaMultipleNetwork = true;
+
+  /* fast connect goes to the new AP. EEPROM is updated after got IP */
+  if (true == CheckFastConnectCache()) {
+    memcpy(CacheBssid, i_bssid, 6);
+    CacheChannel = i_channel;
+  }
+
+  RoamingTime = millis();
+  RoamingRssiAvg = 0;
+  WiFiStaConnect();
+}
+
+/**
+ * @brief Function for set modem sleep mode by power profile and actual load.
+ *        Power save is disabled during service AP mode, video stream and upload data to backend.
+ *        Called from WEB server, photo and management task, the state is read and applied under the lock
+ * 
+ */
+void WiFiMngt::UpdatePowerSave() {
+  wifi_ps_type_t mode = WIFI_PS_NONE;
+  bool changed = false;
+
+  if (xSemaphoreTake(PowerSaveSemaphore, portMAX_DELAY)) {
+    if ((WIFI_STA == WiFi.getMode()) && (false == cam->GetStreamStatus()) && (false == UploadProcessing) && (false == FirmwareUpdate.Processing)) {
+      if (WiFiPowerProfile_Balanced == PowerProfile) {
+        mode = WIFI_PS_MIN_MODEM;
+      } else if (WiFiPowerProfile_LowPower == PowerProfile) {
+        mode = WIFI_PS_MAX_MODEM;
+      }
+    }
+
+    if (mode != PowerSaveMode) {
+      PowerSaveMode = mode;
+      esp_wifi_set_ps(PowerSaveMode);
+      changed = true;
+    }
+    xSemaphoreGive(PowerSaveSemaphore);
+  }
+
+  if (true == changed) {
+    log->AddEvent(LogLevel_Verbose, "WiFi power save mode: " + String(mode));
+  }
+}
+
+/**
+ * @brief Translate WiFi power profile to string
+ * 
+ * @param WiFiPowerProfile - power profile
+ * @return String - power profile name
+ */
+String WiFiMngt::TranslatePowerProfile(WiFiPowerProfile i_data) {
+  String ret = "";
+  switch (i_data) {
+    case WiFiPowerProfile_Performance:
+      ret = "performance";
+      break;
+    case WiFiPowerProfile_Balanced:
+      ret = "balanced";
+      break;
+    case WiFiPowerProfile_LowPower:
+      ret = "low-power";
+      break;
+    default:
+      ret = "unknown";
+      break;
+  }
+
+  return ret;
 }
 
 /**
@@ -609,7 +1070,22 @@ String WiFiMngt::GetStaIp() {
    @return String - value
 */
 String WiFiMngt::GetAvailableWifiNetworks() {
-  return WifiScanJson;
+  String ret = "[]";
+  if (xSemaphoreTake(WiFiScanSemaphore, portMAX_DELAY)) {
+    ret = WifiScanJson;
+    xSemaphoreGive(WiFiScanSemaphore);
+  }
+
+  return ret;
+}
+
+/**
+   @brief function for get age of the cached scan result
+   @param none
+   @return unsigned long - age [ms]
+*/
+unsigned long WiFiMngt::GetWiFiScanAge() {
+  return millis() - WiFiScanTimestamp;
 }
 
 /**
@@ -657,6 +1133,33 @@ bool WiFiMngt::GetFirstConnection() {
   return FirstConnected;
 }
 
+/**
+ * @brief get fast connect enable status
+ * 
+ * @return bool - status
+ */
+bool WiFiMngt::GetFastConnect() {
+  return FastConnectEnable;
+}
+
+/**
+ * @brief get status about running fast connect attempt
+ * 
+ * @return bool - status
+ */
+bool WiFiMngt::GetFastConnectActive() {
+  return FastConnectActive;
+}
+
+/**
+ * @brief get WiFi power profile
+ * 
+ * @return WiFiPowerProfile - power profile
+ */
+WiFiPowerProfile WiFiMngt::GetPowerProfile() {
+  return PowerProfile;
+}
+
 /**
    @brief function for set STA credentials
    @param String - ssid
@@ -671,6 +1174,9 @@ void WiFiMngt::SetStaCredentials(String i_ssid, String i_pass) {
   config->SaveWifiPassword(WifiPassword);
 
   config->SaveWifiCfgFlag(CFG_WIFI_SETTINGS_SAVED);
+
+  /* cache belongs to the previous network */
+  InvalidateFastConnectCache();
 }
 
 /**
@@ -730,6 +1236,41 @@ void WiFiMngt::SetFirstConnection(bool i_data) {
   FirstConnected = i_data;
 }
 
+/**
+   @brief function for enable/disable fast connect
+   @param bool - data
+   @return none
+*/
+void WiFiMngt::SetFastConnect(bool i_data) {
+  FastConnectEnable = i_data;
+  config->SaveWifiFastConnect(FastConnectEnable);
+  if (false == FastConnectEnable) {
+    InvalidateFastConnectCache();
+  }
+}
+
+/**
+   @brief function for set WiFi power profile
+   @param WiFiPowerProfile - power profile
+   @return none
+*/
+void WiFiMngt::SetPowerProfile(WiFiPowerProfile i_data) {
+  PowerProfile = i_data;
+  log->AddEvent(LogLevel_Info, "WiFi power profile: " + TranslatePowerProfile(PowerProfile));
+  config->SaveWifiPowerProfile(PowerProfile);
+  UpdatePowerSave();
+}
+
+/**
+   @brief function for set flag about upload data to backend. Power save is disabled during upload
+   @param bool - data
+   @return none
+*/
+void WiFiMngt::SetUploadProcessing(bool i_data) {
+  UploadProcessing = i_data;
+  UpdatePowerSave();
+}
+
 /* ----------------------- Static function ----------------------- */
 
 /**
@@ -740,6 +1281,7 @@ void WiFiMngt::SetFirstConnection(bool i_data) {
 */
 void WiFiMngt_WiFiEventScanDone(WiFiEvent_t event, WiFiEventInfo_t info) {
   SystemLog.AddEvent(LogLevel_Info, "WiFi networks scan done");
+  SystemWifiMngt.ProcessWiFiScanResult();
 }
 
 /**
@@ -786,6 +1328,7 @@ void WiFiMngt_WiFiEventGotIP(WiFiEvent_t event, WiFiEventInfo_t info) {
   SystemLog.AddEvent(LogLevel_Info, "WiFi Got DNS 1: " + WiFi.dnsIP(0).toString());
   SystemLog.AddEvent(LogLevel_Info, "WiFi Got DNS 2: " + WiFi.dnsIP(1).toString());
   SystemWifiMngt.SetFirstConnection(true);
+  SystemWifiMngt.UpdateFastConnectCache();
 
   /* update device information */
   Connect.UpdateDeviceInformation();
@@ -846,6 +1389,11 @@ void WiFiMngt_WiFiEventLostIP(WiFiEvent_t event, WiFiEventInfo_t info) {
 void WiFiMngt_WiFiEventStationDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
   SystemLog.AddEvent(LogLevel_Warning, String("WiFi disconnected from access point. Reason: ") + String(info.wifi_sta_disconnected.reason));
   system_led.setTimer(STATUS_LED_ERROR);
+
+  /* fast connect with cached BSSID failed. Disconnect requested by MCU (ASSOC_LEAVE) is ignored */
+  if ((true == SystemWifiMngt.GetFastConnectActive()) && (WIFI_REASON_ASSOC_LEAVE != info.wifi_sta_disconnected.reason)) {
+    SystemWifiMngt.FastConnectFallback();
+  }
 }
 
 /**
@@ -918,4 +1466,13 @@ void WiFiMngt_WiFiEventApStaProbeReqRecved(WiFiEvent_t event, WiFiEventInfo_t in
   SystemLog.AddEvent(LogLevel_Info, "WiFi AP STA receive probe request packet in soft-AP interface");
 }
 
+/**
+   @brief CB function of the fast connect timer. Fast connect attempt takes too long
+   @param void* - unused
+   @return none
+*/
+void WiFiMngt_FastConnectTimeout(void *arg) {
+  SystemWifiMngt.FastConnectFallback();
+}
+
 /* EOF */
\ No newline at end of file
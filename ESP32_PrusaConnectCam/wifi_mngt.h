@@ -17,6 +17,7 @@
 #include <esp_task_wdt.h>
 #include <ESPmDNS.h>
 #include <esp_wifi.h>
+#include "esp_timer.h"
 #include "esp32-hal-cpu.h"
 
 #include "mcu_cfg.h"
@@ -38,10 +39,21 @@ void WiFiMngt_WiFiEventLostIP(WiFiEvent_t, WiFiEventInfo_t);
 void WiFiMngt_WiFiEventApStart(WiFiEvent_t , WiFiEventInfo_t);
 void WiFiMngt_WiFiEventApStop(WiFiEvent_t , WiFiEventInfo_t);
 void WiFiMngt_WiFiEventApStaConnected(WiFiEvent_t , WiFiEventInfo_t);
+void WiFiMngt_FastConnectTimeout(void *);
 void WiFiMngt_WiFiEventApStaDisconnected(WiFiEvent_t , WiFiEventInfo_t);
 void WiFiMngt_WiFiEventApStaIpAssigned(WiFiEvent_t , WiFiEventInfo_t);
 void WiFiMngt_WiFiEventApStaProbeReqRecved(WiFiEvent_t , WiFiEventInfo_t);
 
+/**
+ * @brief WiFiPowerProfile enum
+ * modem sleep mode used when is WiFi idle. Without power save during stream and upload
+ */
+enum WiFiPowerProfile {
+  WiFiPowerProfile_Performance = 0,   ///< power save is disabled
+  WiFiPowerProfile_Balanced = 1,      ///< minimum modem sleep, wake up every DTIM
+  WiFiPowerProfile_LowPower = 2,      ///< maximum modem sleep, wake up every listen interval
+};
+
 class WiFiMngt {
 private:
   String WifiSsid;                    ///< WI-FI SSID
@@ -53,6 +65,7 @@ private:
   bool NtpFirstSync;                  ///< flag about first NTP sync status
 
   uint8_t WiFiStaNetworkBssid[6];     ///< BSSID of the network
+  uint8_t WiFiStaNetworkChannel;      ///< channel of the network with BSSID
 
   bool WiFiStaMultipleNetwork;        ///< flag about multiple STA networks
   bool StartStaWdg;                   ///< flag about start STA watchdog
@@ -66,7 +79,40 @@ private:
   unsigned long TaskWdg_previousMillis; ///< previous time for task STA watchdog
 
   String mDNS_record;                 ///< mDNS record
-  String WifiScanJson;                ///< global variable with wifi networks
+  String WifiScanJson;                ///< cached json with wifi networks from last scan
+  SemaphoreHandle_t WiFiScanSemaphore;  ///< semaphore for cached scan results
+  bool WiFiScanRunning;               ///< flag about running asynchronous scan
+  unsigned long WiFiScanStartTime;    ///< time of start asynchronous scan [ms]
+  unsigned long WiFiScanTimestamp;    ///< time of last finished scan [ms], 0 = no scan yet
+  uint8_t WiFiScanStaCount;           ///< count of networks with STA SSID found in last scan
+
+  bool FastConnectEnable;             ///< flag about enable fast connect with cached BSSID, channel and IP
+  bool FastConnectActive;             ///< flag about running fast connect attempt
+  bool FastConnectFailed;             ///< flag about failed fast connect. Next connect is done via standard way
+  bool FastConnectStaticIp;           ///< flag about using cached IP address as static IP. Only with valid lease
+  unsigned long FastConnectStartTime; ///< time of start fast connect attempt [ms]
+  esp_timer_handle_t FastConnectTimer; ///< one-shot timer, fallback to standard connect after WIFI_FAST_CONNECT_TIMEOUT
+  uint8_t CacheBssid[6];              ///< cached BSSID of the last connected network
+  uint8_t CacheChannel;               ///< cached channel of the last connected network. 0 = invalid cache
+  IPAddress CacheIp;                  ///< cached IP address from last DHCP lease
+  IPAddress CacheMask;                ///< cached mask from last DHCP lease
+  IPAddress CacheGateway;             ///< cached gateway from last DHCP lease
+  IPAddress CacheDns;                 ///< cached DNS from last DHCP lease
+  uint32_t CacheLease;                ///< expiration of the cached DHCP lease, UTC [s]. 0 = unknown
+  bool CacheLeasePending;             ///< DHCP lease was obtained before time sync, expiration is saved after NTP sync
+
+  int RoamingRssiAvg;                 ///< moving average of the STA RSSI, 0 = no sample [dBm]
+  bool RoamingCandidateValid;         ///< flag about valid roaming candidate from last scan
+  uint8_t RoamingCandidateBssid[6];   ///< BSSID of the best AP with STA SSID from last scan
+  uint8_t RoamingCandidateChannel;    ///< channel of the best AP with STA SSID from last scan
+  int RoamingCandidateRssi;           ///< RSSI of the best AP with STA SSID from last scan [dBm]
+  unsigned long RoamingScanTime;      ///< time of last roaming scan [ms]
+  unsigned long RoamingTime;          ///< time of last roaming [ms]
+
+  WiFiPowerProfile PowerProfile;      ///< selected WiFi power profile
+  wifi_ps_type_t PowerSaveMode;       ///< active modem sleep mode
+  SemaphoreHandle_t PowerSaveSemaphore;  ///< semaphore for update of modem sleep mode, called from more tasks
+  bool UploadProcessing;              ///< flag about upload data to backend in progress
 
   Configuration *config;              ///< pointer to configuration class
   Logs *log;                          ///< pointer to log class
@@ -83,16 +129,28 @@ public:
   void SetWifiEvents();
   void WiFiStaConnect();
   void SyncNtpTime();
+  bool CheckFastConnectCache();
+  bool CheckFastConnectLease();
+  void FastConnectFallback();
+  void UpdateFastConnectCache();
+  void InvalidateFastConnectCache();
+  void InvalidateFastConnectLease();
+  void UpdateFastConnectLease();
 
   void ScanWiFiNetwork();
-  uint8_t ScanWifiNetwork(String);
-  bool CheckAvailableWifiNetwork(String);
+  bool StartWiFiScan(bool, uint32_t i_dwell = WIFI_SCAN_DWELL);
+  void ProcessWiFiScanResult();
+  bool CheckAvailableWifiNetwork(unsigned long);
   int Rssi2Percent(int);
   String TranslateTxPower(wifi_power_t);
   String TranslateWiFiStatus(wl_status_t);
   String TranslateWiFiEncrypion(wifi_auth_mode_t );
   void CreateApSsid();
   void WiFiWatchdog();
+  void WiFiRoaming();
+  void RoamToBssid(const uint8_t *, uint8_t);
+  void UpdatePowerSave();
+  String TranslatePowerProfile(WiFiPowerProfile);
 
   String GetServiceApSsid();
   String GetStaSsid();
@@ -101,12 +159,16 @@ public:
   String GetStaStatus();
   String GetStaIp();
   String GetAvailableWifiNetworks();
+  unsigned long GetWiFiScanAge();
   String GetWiFiMode();
   String GetWifiMac();
   String GetMdns();
   bool GetkActifeWifiCfgFlag();
   bool GetNtpFirstTimeSync();
   bool GetFirstConnection();
+  bool GetFastConnect();
+  bool GetFastConnectActive();
+  WiFiPowerProfile GetPowerProfile();
 
   void SetStaCredentials(String, String);
   void SetStaSsid(String);
@@ -114,6 +176,9 @@ public:
   void ConnectToSta();
   void SetMdns(String);
   void SetFirstConnection(bool);
+  void SetFastConnect(bool);
+  void SetPowerProfile(WiFiPowerProfile);
+  void SetUploadProcessing(bool);
 };
 
 extern WiFiMngt SystemWifiMngt;   ///< global variable for wifi management
@@ -0,0 +1,160 @@
+/**
+   @file stream_bench.cpp
+
+   @brief Replay benchmark of the MJPEG stream with the simulated clients. Camera frames are JPEG files from the directory
+          HOST_CAMERA_DIR, stream responses are read by one loop like by the async_tcp task of the MCU.
+          Client N is served in every N-th round, so fast and slow viewers are mixed. Every part of the stream is checked
+          (Content-Length, JPEG SOI/EOI), result is printed as JSON with /json_stream_stats of the firmware
+
+          stream_bench [count of clients] [frames per client] [TCP buffer size]
+
+   Exit code is non-zero when a part of the stream is broken or the statistics of the firmware do not agree with the clients
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "mcu_cfg.h"
+#include "log.h"
+#include "cfg.h"
+#include "camera.h"
+#include "server.h"
+#include "stream.h"
+
+/**
+ * @brief Simulated viewer of the stream
+ */
+struct BenchClient {
+  AsyncJpegStreamResponse *Response;   ///< stream response of the firmware
+  std::string Data;                    ///< received data, not parsed yet
+  uint32_t Frames;                     ///< count of received frames
+  uint32_t Invalid;                    ///< count of broken parts
+  uint64_t Bytes;                      ///< count of received bytes
+};
+
+/**
+ * @brief CPU time of the calling thread
+ *
+ * @return int64_t - time [us]
+ */
+static int64_t Bench_ThreadCpuTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ((int64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/**
+ * @brief Parse complete parts of the multipart stream
+ *
+ * @param BenchClient& - client
+ */
+static void Bench_ParseParts(BenchClient &io_client) {
+  while (true) {
+    size_t header = io_client.Data.find("Content-Length: ");
+    size_t body = io_client.Data.find("\r\n\r\n", header);
+    if ((std::string::npos == header) || (std::string::npos == body)) {
+      return;
+    }
+    size_t len = strtoul(io_client.Data.c_str() + header + 16, NULL, 10);
+    body += 4;
+    if (io_client.Data.size() < (body + len)) {
+      return;
+    }
+
+    const uint8_t *jpeg = (const uint8_t *)io_client.Data.data() + body;
+    if ((len < 4) || (0xFF != jpeg[0]) || (0xD8 != jpeg[1]) || (0xFF != jpeg[len - 2]) || (0xD9 != jpeg[len - 1])) {
+      io_client.Invalid++;
+    } else {
+      io_client.Frames++;
+    }
+    io_client.Data.erase(0, body + len);
+  }
+}
+
+int main(int argc, char **argv) {
+  int clients = (argc > 1) ? atoi(argv[1]) : 3;
+  uint32_t frames = (argc > 2) ? atoi(argv[2]) : 20;
+  size_t chunk = (argc > 3) ? atoi(argv[3]) : 1436;
+
+  EEPROM.begin(EEPROM_SIZE);
+  SystemLog.SetLogLevel(LogLevel_Error);
+  SystemLog.Init();
+  SystemConfig.Init();
+  SystemCamera.LoadCameraCfgFromEeprom();
+  SystemCamera.Init();
+  Server_InitWebServer();
+
+  std::vector<BenchClient> client(clients);
+  for (BenchClient &c : client) {
+    c = { new AsyncJpegStreamResponse(&SystemCamera, &SystemLog), "", 0, 0, 0 };
+  }
+
+  /* all clients are served by this thread, CPU time of the filler is measured around the calls */
+  std::vector<uint8_t> buf(chunk);
+  int64_t cpu = 0;
+  int64_t start = esp_timer_get_time();
+  bool done = false;
+  for (uint32_t round = 1; false == done; round++) {
+    done = true;
+    for (int i = 0; i < clients; i++) {
+      BenchClient &c = client[i];
+      if (c.Frames < frames) {
+        done = false;
+      }
+      if (0 != (round % (i + 1))) {
+        continue;
+      }
+
+      int64_t cpu_start = Bench_ThreadCpuTime();
+      size_t len = c.Response->_fillBuffer(buf.data(), chunk);
+      cpu += Bench_ThreadCpuTime() - cpu_start;
+      if ((RESPONSE_TRY_AGAIN == len) || (0 == len)) {
+        continue;
+      }
+      c.Data.append((const char *)buf.data(), len);
+      c.Bytes += len;
+      Bench_ParseParts(c);
+    }
+  }
+  uint32_t duration = (uint32_t)((esp_timer_get_time() - start) / 1000);
+
+  /* statistics of the firmware are read by the same route as from the WEB page, before the clients are closed */
+  AsyncWebServerRequest request("/json_stream_stats");
+  String firmware_stats = "{}";
+  if ((true == server.HostDispatch(&request)) && (NULL != request.GetResponse())) {
+    firmware_stats = String(request.GetResponse()->HostRead());
+  }
+
+  uint32_t received = 0;
+  uint32_t invalid = 0;
+  std::string per_client;
+  for (BenchClient &c : client) {
+    received += c.Frames;
+    invalid += c.Invalid;
+    per_client += (per_client.empty() ? "" : ",") + std::to_string(c.Frames);
+    delete c.Response;
+  }
+
+  /* frame in progress is counted by the firmware, but it is not received by the client yet */
+  JsonDocument doc;
+  bool ok = (!deserializeJson(doc, firmware_stats.c_str())) && (0 == invalid);
+  uint32_t fw_frames = (uint32_t)doc["frames"].as<long>();
+  ok = ok && (fw_frames >= received) && (fw_frames <= (received + clients));
+  /* yield delays of 1 ms per TCP buffer are not counted as work of the filler */
+  long fill = doc["fill_us_per_frame"].as<long>();
+  ok = ok && (fill > 0) && (fill < doc["yield_us_per_frame"].as<long>());
+
+  printf("{\"clients\":%d,\"frames\":[%s],\"invalid\":%u,\"duration_ms\":%u,\"host_cpu_us_per_frame\":%u,\"firmware\":%s}\n",
+         clients, per_client.c_str(), invalid, duration, (unsigned)((fw_frames > 0) ? (cpu / fw_frames) : 0), firmware_stats.c_str());
+
+  return (true == ok) ? 0 : 1;
+}
+
+/* EOF */
@@ -0,0 +1,116 @@
+/**
+   @file upload_bench.cpp
+
+   @brief Benchmark of the uploads to the backend. PrusaConnect class sends photos and device information
+          to the local stand-in server (tools/prusa_connect_standin.py), result is printed as JSON
+
+          upload_bench [hostname] [token] [count of photos] [info every N photos]
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "mcu_cfg.h"
+#include "log.h"
+#include "cfg.h"
+#include "camera.h"
+#include "connect.h"
+#include "photo_store.h"
+#include "server.h"
+#include "snapshot_queue.h"
+
+/**
+ * @brief Nearest-rank percentile
+ *
+ * @param std::vector<uint32_t>& - sorted values
+ * @param uint8_t - percentile
+ * @return uint32_t - value
+ */
+static uint32_t Bench_Percentile(const std::vector<uint32_t> &i_values, uint8_t i_pct) {
+  if (i_values.empty()) {
+    return 0;
+  }
+  size_t index = ((i_values.size() * i_pct) + 99) / 100;
+  return i_values[(index > 0) ? (index - 1) : 0];
+}
+
+int main(int argc, char **argv) {
+  const char *hostname = (argc > 1) ? argv[1] : "127.0.0.1";
+  const char *token = (argc > 2) ? argv[2] : "standin-token";
+  int count = (argc > 3) ? atoi(argv[3]) : 20;
+  int info_every = (argc > 4) ? atoi(argv[4]) : 10;
+
+  EEPROM.begin(EEPROM_SIZE);
+  SystemLog.SetLogLevel(LogLevel_Error);
+  SystemLog.Init();
+  SystemConfig.Init();
+  SystemCamera.LoadCameraCfgFromEeprom();
+  SystemCamera.Init();
+  SystemSnapshotQueue.Init();
+  Server_InitWebServer();
+
+  Connect.LoadCfgFromEeprom();
+  Connect.SetPrusaConnectHostname(hostname);
+  Connect.SetToken(token);
+
+  std::vector<uint32_t> latency;
+  std::vector<int64_t> heap_delta;
+  uint64_t bytes = 0;
+  int ok = 0;
+  int64_t bench_start = esp_timer_get_time();
+
+  for (int i = 0; i < count; i++) {
+    PhotoFrame *frame = SystemCamera.CapturePhoto();
+    size_t len = (NULL != frame) ? frame->Len : 0;
+
+    /* heap of the host process, allocations of the upload path which are not freed */
+    size_t heap_before = mallinfo2().uordblks;
+    int64_t start = esp_timer_get_time();
+    Connect.SendPhotoToBackend(frame);
+    SystemPhotoStore.Release(frame);
+    latency.push_back((uint32_t)((esp_timer_get_time() - start) / 1000));
+    heap_delta.push_back((int64_t)mallinfo2().uordblks - (int64_t)heap_before);
+
+    if (Connect.GetBackendReceivedStatus().startsWith("Photo: 2")) {
+      ok++;
+      bytes += len;
+    }
+
+    if ((info_every > 0) && (0 == ((i + 1) % info_every))) {
+      Connect.UpdateDeviceInformation();
+      Connect.SendInfoToBackend();
+    }
+  }
+
+  uint32_t duration = (uint32_t)((esp_timer_get_time() - bench_start) / 1000);
+  std::vector<uint32_t> sorted = latency;
+  std::sort(sorted.begin(), sorted.end());
+  int64_t heap_max = heap_delta.empty() ? 0 : *std::max_element(heap_delta.begin(), heap_delta.end());
+  int64_t heap_total = 0;
+  for (int64_t delta : heap_delta) {
+    heap_total += delta;
+  }
+
+  /* statistics of the firmware are read by the same route as from the WEB page */
+  AsyncWebServerRequest request("/json_upload_stats");
+  String firmware_stats = "{}";
+  if ((true == server.HostDispatch(&request)) && (NULL != request.GetResponse())) {
+    firmware_stats = String(request.GetResponse()->HostRead());
+  }
+
+  printf("{\"photos\":%d,\"photos_ok\":%d,\"duration_ms\":%u,\"latency_ms\":{\"p50\":%u,\"p90\":%u,\"p99\":%u,\"max\":%u},"
+         "\"throughput_bps\":%llu,\"host_heap_delta\":{\"max\":%lld,\"total\":%lld},\"firmware\":%s}\n",
+         count, ok, duration, Bench_Percentile(sorted, 50), Bench_Percentile(sorted, 90), Bench_Percentile(sorted, 99), Bench_Percentile(sorted, 100),
+         (unsigned long long)((duration > 0) ? (bytes * 1000 / duration) : 0), (long long)heap_max, (long long)heap_total, firmware_stats.c_str());
+
+  return 0;
+}
+
+/* EOF */
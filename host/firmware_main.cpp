@@ -0,0 +1,23 @@
+/**
+   @file firmware_main.cpp
+
+   @brief Host runner of the whole firmware. Sketch is compiled as is, setup() and loop() are called from main()
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "ESP32_PrusaConnectCam.ino"
+
+int main() {
+  setbuf(stdout, NULL);
+  setup();
+  while (true) {
+    loop();
+  }
+  return 0;
+}
+
+/* EOF */
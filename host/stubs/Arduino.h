@@ -0,0 +1,110 @@
+/**
+   @file Arduino.h
+
+   @brief Host stub of the Arduino-ESP32 core. Time, GPIO, serial port and ESP class for the host build
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <type_traits>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp32-hal-cpu.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+
+#define PROGMEM
+#define HIGH          0x1
+#define LOW           0x0
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+#define PI            3.1415926535897932384626433832795
+
+#define highByte(w)   ((uint8_t)((w) >> 8))
+#define lowByte(w)    ((uint8_t)((w) & 0xff))
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+template <typename T, typename U> inline typename std::common_type<T, U>::type min(T a, U b) { return (a < b) ? a : b; }
+template <typename T, typename U> inline typename std::common_type<T, U>::type max(T a, U b) { return (a > b) ? a : b; }
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t);
+void delayMicroseconds(uint32_t);
+void yield();
+long random(long);
+long random(long, long);
+
+void pinMode(uint8_t, uint8_t);
+void digitalWrite(uint8_t, uint8_t);
+int digitalRead(uint8_t);
+void analogWrite(uint8_t, int);
+uint32_t ledcSetup(uint8_t, uint32_t, uint8_t);
+void ledcAttachPin(uint8_t, uint8_t);
+void ledcWrite(uint8_t, uint32_t);
+uint32_t ledcRead(uint8_t);
+float temperatureRead();
+
+void configTime(long, int, const char *, const char *server2 = NULL, const char *server3 = NULL);
+bool getLocalTime(struct tm *, uint32_t ms = 5000);
+
+/**
+ * @brief Serial port of the host is stdin/stdout
+ */
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  void setDebugOutput(bool) {}
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override;
+  size_t write(const uint8_t *, size_t) override;
+  using Print::write;
+};
+
+/**
+ * @brief ESP class with information about the chip. Values of the ESP32-CAM are reported
+ */
+class EspClass {
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getPsramSize();
+  uint32_t getFreePsram();
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint8_t getChipRevision() { return 3; }
+  const char *getSdkVersion() { return "host"; }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  uint32_t getFlashChipSpeed() { return 80000000; }
+  void restart();
+};
+
+extern HardwareSerial Serial;
+extern EspClass ESP;
+
+#endif
+
+/* EOF */
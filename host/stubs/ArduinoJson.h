@@ -0,0 +1,210 @@
+/**
+   @file ArduinoJson.h
+
+   @brief Host stub of the ArduinoJson 7 subset used by the firmware. Document is a tree of the nodes,
+          serializer writes compact JSON and parser reads standard JSON
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ARDUINOJSON_H_
+#define _HOST_ARDUINOJSON_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "WString.h"
+
+/**
+ * @brief JsonNode struct
+ * one value of the document
+ */
+struct JsonNode {
+  enum Type { Null, Bool, Signed, Unsigned, Float, Text, Array, Object };
+
+  Type Kind = Null;
+  bool BoolValue = false;
+  int64_t SignedValue = 0;
+  uint64_t UnsignedValue = 0;
+  double FloatValue = 0;
+  bool Float32 = false;                                                     ///< value was float, printed with float precision
+  std::string TextValue;
+  std::vector<std::shared_ptr<JsonNode>> Items;                             ///< array items
+  std::vector<std::pair<std::string, std::shared_ptr<JsonNode>>> Members;   ///< object members, in insertion order
+
+  void Clear();
+  void CopyFrom(const JsonNode &);
+  JsonNode *Find(const std::string &) const;
+  JsonNode *Member(const std::string &);
+  JsonNode *Append();
+};
+
+class JsonArray;
+class JsonObject;
+
+/**
+ * @brief Reference to the value. Missing object member is created only by write access
+ */
+class JsonVariant {
+protected:
+  JsonNode *Parent;   ///< object with the member, NULL = direct reference
+  std::string Key;    ///< key of the member
+  JsonNode *Node;     ///< direct reference
+
+  JsonNode *Get() const { return (NULL != Parent) ? Parent->Find(Key) : Node; }
+  JsonNode *GetOrCreate() { return (NULL != Parent) ? Parent->Member(Key) : Node; }
+
+public:
+  JsonVariant() : Parent(NULL), Node(NULL) {}
+  JsonVariant(JsonNode *i_node) : Parent(NULL), Node(i_node) {}
+  JsonVariant(JsonNode *i_parent, const std::string &i_key) : Parent(i_parent), Key(i_key), Node(NULL) {}
+
+  bool isNull() const { JsonNode *n = Get(); return (NULL == n) || (JsonNode::Null == n->Kind); }
+
+  JsonVariant &operator=(const JsonVariant &);
+  JsonVariant &operator=(const char *);
+  JsonVariant &operator=(char *i_value) { return operator=((const char *)i_value); }
+  JsonVariant &operator=(const String &i_value) { return operator=(i_value.c_str()); }
+  JsonVariant &operator=(bool);
+  JsonVariant &operator=(std::nullptr_t) {
+    JsonNode *n = GetOrCreate();
+    if (NULL != n) {
+      n->Clear();
+    }
+    return *this;
+  }
+  JsonVariant &operator=(double);
+  JsonVariant &operator=(float);
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+  JsonVariant &operator=(T i_value) {
+    JsonNode *n = GetOrCreate();
+    if (NULL != n) {
+      n->Clear();
+      if (std::is_signed<T>::value) {
+        n->Kind = JsonNode::Signed;
+        n->SignedValue = (int64_t)i_value;
+      } else {
+        n->Kind = JsonNode::Unsigned;
+        n->UnsignedValue = (uint64_t)i_value;
+      }
+    }
+    return *this;
+  }
+  template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+  JsonVariant &operator=(T i_value) { return operator=((int)i_value); }
+
+  JsonVariant operator[](const char *);
+  JsonVariant operator[](const String &i_key) { return operator[](i_key.c_str()); }
+  JsonVariant operator[](int);
+
+  template <typename T> T to();
+  template <typename T> T as() const;
+
+  operator const char *() const;
+  operator JsonArray() const;
+  operator JsonObject() const;
+
+  JsonNode *GetNode() const { return Get(); }
+};
+
+class JsonArray {
+private:
+  JsonNode *Node;
+
+public:
+  JsonArray() : Node(NULL) {}
+  JsonArray(JsonNode *i_node) : Node(i_node) {}
+
+  size_t size() const { return (NULL == Node) ? 0 : Node->Items.size(); }
+  bool isNull() const { return NULL == Node; }
+  JsonVariant operator[](size_t i_index) const { return JsonVariant(((NULL != Node) && (i_index < Node->Items.size())) ? Node->Items[i_index].get() : NULL); }
+
+  template <typename T> bool add(T i_value) {
+    if (NULL == Node) {
+      return false;
+    }
+    JsonVariant(Node->Append()) = i_value;
+    return true;
+  }
+  template <typename T> T add();
+};
+
+class JsonObject {
+private:
+  JsonNode *Node;
+
+public:
+  JsonObject() : Node(NULL) {}
+  JsonObject(JsonNode *i_node) : Node(i_node) {}
+
+  bool isNull() const { return NULL == Node; }
+  size_t size() const { return (NULL == Node) ? 0 : Node->Members.size(); }
+  JsonVariant operator[](const char *i_key) const { return (NULL == Node) ? JsonVariant() : JsonVariant(Node, i_key); }
+  JsonVariant operator[](const String &i_key) const { return operator[](i_key.c_str()); }
+  bool containsKey(const char *i_key) const { return (NULL != Node) && (NULL != Node->Find(i_key)); }
+};
+
+class JsonDocument {
+private:
+  std::shared_ptr<JsonNode> Root;
+
+public:
+  JsonDocument() : Root(std::make_shared<JsonNode>()) {}
+
+  JsonVariant operator[](const char *i_key) { return JsonVariant(Root.get())[i_key]; }
+  JsonVariant operator[](const String &i_key) { return operator[](i_key.c_str()); }
+  JsonVariant operator[](int i_index) { return JsonVariant(Root.get())[i_index]; }
+  template <typename T> T to() { return JsonVariant(Root.get()).to<T>(); }
+  template <typename T> T as() const { return JsonVariant(Root.get()).as<T>(); }
+  void clear() { Root->Clear(); }
+  bool isNull() const { return JsonNode::Null == Root->Kind; }
+  JsonNode *GetNode() const { return Root.get(); }
+};
+
+template <> JsonArray JsonVariant::to<JsonArray>();
+template <> JsonObject JsonVariant::to<JsonObject>();
+template <> JsonArray JsonVariant::as<JsonArray>() const;
+template <> JsonObject JsonVariant::as<JsonObject>() const;
+template <> const char *JsonVariant::as<const char *>() const;
+template <> String JsonVariant::as<String>() const;
+template <> bool JsonVariant::as<bool>() const;
+template <> long JsonVariant::as<long>() const;
+template <> int JsonVariant::as<int>() const;
+template <> double JsonVariant::as<double>() const;
+
+template <typename T> T JsonArray::add() {
+  return (NULL == Node) ? T() : JsonVariant(Node->Append()).to<T>();
+}
+
+/**
+ * @brief Result of the deserialization. True in the boolean context means error
+ */
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+  DeserializationError(Code i_code = Ok) : ErrorCode(i_code) {}
+  explicit operator bool() const { return Ok != ErrorCode; }
+  Code code() const { return ErrorCode; }
+  const char *c_str() const;
+
+private:
+  Code ErrorCode;
+};
+
+size_t serializeJson(const JsonDocument &, String &);
+size_t serializeJson(const JsonVariant &, String &);
+size_t measureJson(const JsonDocument &);
+DeserializationError deserializeJson(JsonDocument &, const String &);
+DeserializationError deserializeJson(JsonDocument &, const char *);
+
+#endif
+
+/* EOF */
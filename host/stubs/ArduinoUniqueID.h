@@ -0,0 +1,23 @@
+/**
+   @file ArduinoUniqueID.h
+
+   @brief Host stub of the ArduinoUniqueID, fixed ID of the host
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ARDUINOUNIQUEID_H_
+#define _HOST_ARDUINOUNIQUEID_H_
+
+#include <stdint.h>
+
+#define UniqueIDsize 8
+
+extern const uint8_t UniqueID[UniqueIDsize];
+
+#endif
+
+/* EOF */
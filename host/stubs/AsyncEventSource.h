@@ -0,0 +1,19 @@
+/**
+   @file AsyncEventSource.h
+
+   @brief Host stub, the firmware uses only ESPAsyncWebSrv.h
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ASYNCEVENTSOURCE_H_
+#define _HOST_ASYNCEVENTSOURCE_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#endif
+
+/* EOF */
@@ -0,0 +1,19 @@
+/**
+   @file AsyncWebSocket.h
+
+   @brief Host stub, the firmware uses only ESPAsyncWebSrv.h
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ASYNCWEBSOCKET_H_
+#define _HOST_ASYNCWEBSOCKET_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#endif
+
+/* EOF */
@@ -0,0 +1,19 @@
+/**
+   @file AsyncWebSynchronization.h
+
+   @brief Host stub, the firmware uses only ESPAsyncWebSrv.h
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ASYNCWEBSYNCHRONIZATION_H_
+#define _HOST_ASYNCWEBSYNCHRONIZATION_H_
+
+#include "ESPAsyncWebSrv.h"
+
+#endif
+
+/* EOF */
@@ -0,0 +1,35 @@
+/**
+   @file EEPROM.h
+
+   @brief Host stub of the Arduino-ESP32 EEPROM. Content is kept in memory and optionally in the file HOST_EEPROM_FILE
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_EEPROM_H_
+#define _HOST_EEPROM_H_
+
+#include <vector>
+
+#include "Arduino.h"
+
+class EEPROMClass {
+private:
+  std::vector<uint8_t> Data;
+
+public:
+  bool begin(size_t);
+  uint8_t read(int);
+  void write(int, uint8_t);
+  bool commit();
+  size_t length() { return Data.size(); }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
+
+/* EOF */
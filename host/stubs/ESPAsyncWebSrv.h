@@ -0,0 +1,197 @@
+/**
+   @file ESPAsyncWebSrv.h
+
+   @brief Host stub of the ESPAsyncWebServer. Handlers are registered and can be called by the host tests,
+          response is read by the same _fillBuffer loop as the TCP stack of the MCU
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESPASYNCWEBSRV_H_
+#define _HOST_ESPASYNCWEBSRV_H_
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+#include "FS.h"
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+
+typedef std::function<void(AsyncWebServerRequest *)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *, const String &, size_t, uint8_t *, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<size_t(uint8_t *, size_t, size_t)> AwsResponseFiller;
+
+class AsyncWebParameter {
+private:
+  String _name;
+  String _value;
+
+public:
+  AsyncWebParameter(const String &i_name, const String &i_value) : _name(i_name), _value(i_value) {}
+  const String &name() const { return _name; }
+  const String &value() const { return _value; }
+};
+
+/**
+ * @brief Response with the content in the memory
+ */
+class AsyncWebServerResponse {
+protected:
+  int _code;
+  String _contentType;
+  size_t _contentLength;
+  bool _sendContentLength;
+  bool _chunked;
+  String _body;
+  std::vector<std::pair<String, String>> _headers;
+
+public:
+  AsyncWebServerResponse() : _code(0), _contentLength(0), _sendContentLength(true), _chunked(false) {}
+  AsyncWebServerResponse(int i_code, const String &i_type, const String &i_content)
+      : _code(i_code), _contentType(i_type), _contentLength(i_content.length()), _sendContentLength(true), _chunked(false), _body(i_content) {}
+  virtual ~AsyncWebServerResponse() {}
+
+  void addHeader(const String &i_name, const String &i_value) { _headers.push_back(std::make_pair(i_name, i_value)); }
+  void setCode(int i_code) { _code = i_code; }
+  void setContentLength(size_t i_len) { _contentLength = i_len; }
+  void setContentType(const String &i_type) { _contentType = i_type; }
+
+  /* host test interface */
+  int GetCode() const { return _code; }
+  const String &GetContentType() const { return _contentType; }
+  size_t GetContentLength() const { return _contentLength; }
+  String GetHeader(const String &) const;
+  virtual std::string HostRead(size_t i_max = SIZE_MAX, size_t i_chunk = 1436);
+};
+
+/**
+ * @brief Response with the content produced by _fillBuffer
+ */
+class AsyncAbstractResponse : public AsyncWebServerResponse {
+protected:
+  ArRequestHandlerFunction _callback;
+
+public:
+  AsyncAbstractResponse(ArRequestHandlerFunction i_callback = nullptr) : _callback(i_callback) {}
+  virtual ~AsyncAbstractResponse() {}
+  virtual bool _sourceValid() const { return false; }
+  virtual size_t _fillBuffer(uint8_t *, size_t) { return 0; }
+
+  std::string HostRead(size_t i_max = SIZE_MAX, size_t i_chunk = 1436) override;
+};
+
+class AsyncChunkedResponse : public AsyncAbstractResponse {
+private:
+  AwsResponseFiller _filler;
+  size_t _index;
+
+public:
+  AsyncChunkedResponse(const String &, AwsResponseFiller);
+  bool _sourceValid() const override { return !!(_filler); }
+  size_t _fillBuffer(uint8_t *, size_t) override;
+};
+
+class AsyncResponseStream : public AsyncAbstractResponse, public Print {
+private:
+  std::string _buffer;
+  size_t _index;
+
+public:
+  AsyncResponseStream(const String &, size_t);
+  bool _sourceValid() const override { return true; }
+  size_t _fillBuffer(uint8_t *, size_t) override;
+  size_t write(uint8_t) override;
+  size_t write(const uint8_t *, size_t) override;
+  using Print::write;
+};
+
+class AsyncWebServerRequest {
+private:
+  String _url;
+  WebRequestMethodComposite _method;
+  std::vector<AsyncWebParameter> _params;
+  std::vector<std::pair<String, String>> _headers;
+  AsyncWebServerResponse *_response;
+
+public:
+  AsyncWebServerRequest(const String &i_url, WebRequestMethodComposite i_method = HTTP_GET) : _url(i_url), _method(i_method), _response(NULL) {}
+  ~AsyncWebServerRequest() { delete _response; }
+
+  const String &url() const { return _url; }
+  WebRequestMethodComposite method() const { return _method; }
+
+  bool hasParam(const String &, bool post = false, bool file = false) const;
+  AsyncWebParameter *getParam(const String &, bool post = false, bool file = false);
+  size_t args() const { return _params.size(); }
+  const String &arg(size_t i_index) const { return _params[i_index].value(); }
+  const String &argName(size_t i_index) const { return _params[i_index].name(); }
+  bool hasHeader(const String &) const;
+  String header(const char *) const;
+
+  bool authenticate(const char *, const char *) { return true; }
+  void requestAuthentication() { send(401); }
+
+  void send(AsyncWebServerResponse *);
+  void send(int i_code, const String &i_type = String(), const String &i_content = String()) { send(beginResponse(i_code, i_type, i_content)); }
+  void send(fs::FS &, const String &, const String &i_type = String());
+  void send_P(int i_code, const String &i_type, const char *i_content) { send(beginResponse_P(i_code, i_type, i_content)); }
+
+  AsyncWebServerResponse *beginResponse(int i_code, const String &i_type = String(), const String &i_content = String()) { return new AsyncWebServerResponse(i_code, i_type, i_content); }
+  AsyncWebServerResponse *beginResponse_P(int i_code, const String &i_type, const char *i_content) { return new AsyncWebServerResponse(i_code, i_type, String(i_content)); }
+  AsyncResponseStream *beginResponseStream(const String &i_type, size_t i_size = 1460) { return new AsyncResponseStream(i_type, i_size); }
+  AsyncWebServerResponse *beginChunkedResponse(const String &i_type, AwsResponseFiller i_callback) { return new AsyncChunkedResponse(i_type, i_callback); }
+
+  /* host test interface */
+  void AddParam(const String &i_name, const String &i_value) { _params.push_back(AsyncWebParameter(i_name, i_value)); }
+  void AddHeader(const String &i_name, const String &i_value) { _headers.push_back(std::make_pair(i_name, i_value)); }
+  AsyncWebServerResponse *GetResponse() const { return _response; }
+};
+
+class AsyncWebServer {
+private:
+  struct Handler {
+    String Uri;
+    WebRequestMethodComposite Method;
+    ArRequestHandlerFunction OnRequest;
+    ArUploadHandlerFunction OnUpload;
+  };
+  std::vector<Handler> Handlers;
+  ArRequestHandlerFunction NotFound;
+
+public:
+  AsyncWebServer(uint16_t) {}
+
+  void on(const char *, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction i_upload = nullptr);
+  void onNotFound(ArRequestHandlerFunction i_fn) { NotFound = i_fn; }
+  void begin() {}
+  void end() {}
+
+  /* host test interface */
+  bool HostDispatch(AsyncWebServerRequest *);
+};
+
+#endif
+
+/* EOF */
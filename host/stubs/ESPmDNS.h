@@ -0,0 +1,28 @@
+/**
+   @file ESPmDNS.h
+
+   @brief Host stub of the mDNS responder
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESPMDNS_H_
+#define _HOST_ESPMDNS_H_
+
+#include "Arduino.h"
+
+class MDNSResponder {
+public:
+  bool begin(const String &) { return true; }
+  bool addService(const char *, const char *, uint16_t) { return true; }
+  void end() {}
+};
+
+extern MDNSResponder MDNS;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,99 @@
+/**
+   @file FS.h
+
+   @brief Host stub of the Arduino-ESP32 file system. Files are stored in the host directory
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_FS_H_
+#define _HOST_FS_H_
+
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+struct FileImpl;
+
+class File : public Stream {
+private:
+  std::shared_ptr<FileImpl> Impl;
+
+public:
+  File() {}
+  File(std::shared_ptr<FileImpl> i_impl) : Impl(i_impl) {}
+
+  size_t write(uint8_t) override;
+  size_t write(const uint8_t *, size_t) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t *, size_t);
+  size_t readBytes(uint8_t *i_buf, size_t i_len) override { return read(i_buf, i_len); }
+  void flush() override;
+  bool seek(uint32_t, SeekMode);
+  bool seek(uint32_t i_pos) { return seek(i_pos, SeekSet); }
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  time_t getLastWrite();
+  const char *path() const;
+  const char *name() const;
+  bool isDirectory();
+  File openNextFile(const char *i_mode = FILE_READ);
+  void rewindDirectory();
+};
+
+class FS {
+protected:
+  std::string Root;  ///< host directory of the file system root
+
+  std::string HostPath(const char *) const;
+
+public:
+  FS() {}
+
+  File open(const char *, const char *i_mode = FILE_READ, const bool i_create = false);
+  File open(const String &i_path, const char *i_mode = FILE_READ, const bool i_create = false) { return open(i_path.c_str(), i_mode, i_create); }
+  bool exists(const char *);
+  bool exists(const String &i_path) { return exists(i_path.c_str()); }
+  bool remove(const char *);
+  bool remove(const String &i_path) { return remove(i_path.c_str()); }
+  bool rename(const char *, const char *);
+  bool rename(const String &i_from, const String &i_to) { return rename(i_from.c_str(), i_to.c_str()); }
+  bool mkdir(const char *);
+  bool mkdir(const String &i_path) { return mkdir(i_path.c_str()); }
+  bool rmdir(const char *);
+  bool rmdir(const String &i_path) { return rmdir(i_path.c_str()); }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::FS;
+
+#endif
+
+/* EOF */
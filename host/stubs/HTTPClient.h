@@ -0,0 +1,26 @@
+/**
+   @file HTTPClient.h
+
+   @brief Host stub of the HTTPClient, only the redirect policy is used
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_HTTPCLIENT_H_
+#define _HOST_HTTPCLIENT_H_
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+typedef enum {
+  HTTPC_DISABLE_FOLLOW_REDIRECTS,
+  HTTPC_STRICT_FOLLOW_REDIRECTS,
+  HTTPC_FORCE_FOLLOW_REDIRECTS
+} followRedirects_t;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,59 @@
+/**
+   @file HTTPUpdate.h
+
+   @brief Host stub of the HTTPUpdate. OTA update is not available on the host
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_HTTPUPDATE_H_
+#define _HOST_HTTPUPDATE_H_
+
+#include <functional>
+
+#include "Arduino.h"
+#include "HTTPClient.h"
+
+enum HTTPUpdateResult {
+  HTTP_UPDATE_FAILED,
+  HTTP_UPDATE_NO_UPDATES,
+  HTTP_UPDATE_OK
+};
+typedef HTTPUpdateResult t_httpUpdate_return;
+
+typedef std::function<void()> HTTPUpdateStartCB;
+typedef std::function<void()> HTTPUpdateEndCB;
+typedef std::function<void(int)> HTTPUpdateErrorCB;
+typedef std::function<void(int, int)> HTTPUpdateProgressCB;
+
+class HTTPUpdate {
+private:
+  HTTPUpdateErrorCB ErrorCb;
+
+public:
+  void setFollowRedirects(followRedirects_t) {}
+  void rebootOnUpdate(bool) {}
+  void setLedPin(int, uint8_t) {}
+  void onStart(HTTPUpdateStartCB) {}
+  void onEnd(HTTPUpdateEndCB) {}
+  void onError(HTTPUpdateErrorCB i_cb) { ErrorCb = i_cb; }
+  void onProgress(HTTPUpdateProgressCB) {}
+
+  t_httpUpdate_return update(WiFiClient &, const String &) {
+    if (ErrorCb) {
+      ErrorCb(getLastError());
+    }
+    return HTTP_UPDATE_FAILED;
+  }
+  int getLastError() { return -1; }
+  String getLastErrorString() { return "not available on host"; }
+};
+
+extern HTTPUpdate httpUpdate;
+
+#endif
+
+/* EOF */
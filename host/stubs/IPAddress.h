@@ -0,0 +1,47 @@
+/**
+   @file IPAddress.h
+
+   @brief Host stub of the Arduino IPAddress class
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_IPADDRESS_H_
+#define _HOST_IPADDRESS_H_
+
+#include <stdint.h>
+
+#include "WString.h"
+
+/* system headers define INADDR_NONE as macro, Arduino as constant */
+#ifdef INADDR_NONE
+#undef INADDR_NONE
+#endif
+
+class IPAddress {
+private:
+  uint8_t Bytes[4];
+
+public:
+  IPAddress() : Bytes{ 0, 0, 0, 0 } {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : Bytes{ a, b, c, d } {}
+  IPAddress(uint32_t i_addr) { for (uint8_t i = 0; i < 4; i++) Bytes[i] = (uint8_t)(i_addr >> (8 * i)); }
+
+  operator uint32_t() const { return (uint32_t)Bytes[0] | ((uint32_t)Bytes[1] << 8) | ((uint32_t)Bytes[2] << 16) | ((uint32_t)Bytes[3] << 24); }
+  bool operator==(const IPAddress &i_addr) const { return (uint32_t)*this == (uint32_t)i_addr; }
+  uint8_t operator[](int i_index) const { return Bytes[i_index]; }
+  uint8_t &operator[](int i_index) { return Bytes[i_index]; }
+
+  bool fromString(const char *);
+  bool fromString(const String &i_str) { return fromString(i_str.c_str()); }
+  String toString() const;
+};
+
+extern const IPAddress INADDR_NONE;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,61 @@
+/**
+   @file Print.h
+
+   @brief Host stub of the Arduino Print class
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_PRINT_H_
+#define _HOST_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "WString.h"
+
+class Print {
+private:
+  int WriteError;
+
+public:
+  Print() : WriteError(0) {}
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *i_buf, size_t i_len) {
+    size_t n = 0;
+    while ((i_len--) && (1 == write(*i_buf++))) {
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char *i_str) { return (NULL == i_str) ? 0 : write((const uint8_t *)i_str, strlen(i_str)); }
+  size_t write(const char *i_buf, size_t i_len) { return write((const uint8_t *)i_buf, i_len); }
+  virtual void flush() {}
+
+  int getWriteError() { return WriteError; }
+  void setWriteError(int i_err = 1) { WriteError = i_err; }
+  void clearWriteError() { WriteError = 0; }
+
+  size_t printf(const char *, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const String &i_str) { return write((const uint8_t *)i_str.c_str(), i_str.length()); }
+  size_t print(const char *i_str) { return write(i_str); }
+  size_t print(const __FlashStringHelper *i_str) { return write((const char *)i_str); }
+  size_t print(char i_c) { return write((uint8_t)i_c); }
+  template <typename T> size_t print(T i_val) { return print(String(i_val)); }
+  template <typename T> size_t print(T i_val, int i_base) { return print(String(i_val, i_base)); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T i_val) { size_t n = print(i_val); return n + println(); }
+  template <typename T> size_t println(T i_val, int i_base) { size_t n = print(i_val, i_base); return n + println(); }
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,49 @@
+/**
+   @file SD_MMC.h
+
+   @brief Host stub of the Arduino-ESP32 SD_MMC card. Card is the directory HOST_SD_DIR or new temporary directory
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_SD_MMC_H_
+#define _HOST_SD_MMC_H_
+
+#include "FS.h"
+
+typedef enum {
+  CARD_NONE,
+  CARD_MMC,
+  CARD_SD,
+  CARD_SDHC,
+  CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs {
+
+class SDMMCFS : public FS {
+private:
+  bool Mounted;
+
+public:
+  SDMMCFS() : Mounted(false) {}
+
+  bool begin(const char *i_mountpoint = "/sdcard", bool i_mode1bit = false, bool i_format_if_mount_failed = false, int i_sdmmc_frequency = 20000, uint8_t i_maxOpenFiles = 5);
+  void end();
+  sdcard_type_t cardType();
+  uint64_t cardSize();
+  uint64_t totalBytes();
+  uint64_t usedBytes();
+  const char *root() const { return Root.c_str(); }
+};
+
+}  // namespace fs
+
+extern fs::SDMMCFS SD_MMC;
+
+#endif
+
+/* EOF */
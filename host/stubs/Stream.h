@@ -0,0 +1,39 @@
+/**
+   @file Stream.h
+
+   @brief Host stub of the Arduino Stream class
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_STREAM_H_
+#define _HOST_STREAM_H_
+
+#include "Print.h"
+
+class Stream : public Print {
+protected:
+  unsigned long Timeout;
+
+public:
+  Stream() : Timeout(1000) {}
+
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long i_timeout) { Timeout = i_timeout; }
+  unsigned long getTimeout() { return Timeout; }
+
+  virtual size_t readBytes(uint8_t *, size_t);
+  size_t readBytes(char *i_buf, size_t i_len) { return readBytes((uint8_t *)i_buf, i_len); }
+  String readString();
+  String readStringUntil(char);
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,61 @@
+/**
+   @file Update.h
+
+   @brief Host stub of the flash update. Data are counted and dropped
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_UPDATE_H_
+#define _HOST_UPDATE_H_
+
+#include <functional>
+
+#include "Arduino.h"
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+#define U_FLASH             0
+#define U_SPIFFS            100
+
+class UpdateClass {
+private:
+  size_t Size;
+  size_t Progress;
+  bool Running;
+  std::function<void(size_t, size_t)> ProgressCb;
+
+public:
+  UpdateClass() : Size(0), Progress(0), Running(false) {}
+
+  bool begin(size_t i_size = UPDATE_SIZE_UNKNOWN, int = U_FLASH) {
+    Size = i_size;
+    Progress = 0;
+    Running = true;
+    return true;
+  }
+  size_t write(uint8_t *, size_t i_len) {
+    Progress += i_len;
+    if (ProgressCb) {
+      ProgressCb(Progress, Size);
+    }
+    return i_len;
+  }
+  bool end(bool = false) {
+    Running = false;
+    return true;
+  }
+  bool isRunning() { return Running; }
+  bool hasError() { return false; }
+  const char *errorString() { return "No Error"; }
+  void printError(Print &out) { out.println(errorString()); }
+  void onProgress(std::function<void(size_t, size_t)> i_cb) { ProgressCb = i_cb; }
+};
+
+extern UpdateClass Update;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,124 @@
+/**
+   @file WString.h
+
+   @brief Host stub of the Arduino String class, backed by std::string
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_WSTRING_H_
+#define _HOST_WSTRING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class String {
+private:
+  std::string s;
+
+  static std::string FromUnsigned(unsigned long long, uint8_t);
+  static std::string FromSigned(long long, uint8_t);
+  static std::string FromDouble(double, unsigned int);
+
+public:
+  String() {}
+  String(const char *i_str) : s((NULL != i_str) ? i_str : "") {}
+  String(const char *i_str, unsigned int i_len) : s(i_str, i_len) {}
+  String(const std::string &i_str) : s(i_str) {}
+  String(const __FlashStringHelper *i_str) : s((const char *)i_str) {}
+  explicit String(char i_c) : s(1, i_c) {}
+  explicit String(unsigned char i_val, unsigned char i_base = DEC) : s(FromUnsigned(i_val, i_base)) {}
+  explicit String(int i_val, unsigned char i_base = DEC) : s(FromSigned(i_val, i_base)) {}
+  explicit String(unsigned int i_val, unsigned char i_base = DEC) : s(FromUnsigned(i_val, i_base)) {}
+  explicit String(long i_val, unsigned char i_base = DEC) : s(FromSigned(i_val, i_base)) {}
+  explicit String(unsigned long i_val, unsigned char i_base = DEC) : s(FromUnsigned(i_val, i_base)) {}
+  explicit String(long long i_val, unsigned char i_base = DEC) : s(FromSigned(i_val, i_base)) {}
+  explicit String(unsigned long long i_val, unsigned char i_base = DEC) : s(FromUnsigned(i_val, i_base)) {}
+  explicit String(float i_val, unsigned int i_decimals = 2) : s(FromDouble(i_val, i_decimals)) {}
+  explicit String(double i_val, unsigned int i_decimals = 2) : s(FromDouble(i_val, i_decimals)) {}
+  explicit String(bool i_val) : s(i_val ? "1" : "0") {}
+
+  unsigned int length() const { return s.length(); }
+  const char *c_str() const { return s.c_str(); }
+  bool isEmpty() const { return s.empty(); }
+  bool reserve(unsigned int i_size) { s.reserve(i_size); return true; }
+  char charAt(unsigned int i_index) const { return (i_index < s.length()) ? s[i_index] : 0; }
+  void setCharAt(unsigned int i_index, char i_c) { if (i_index < s.length()) s[i_index] = i_c; }
+  char operator[](unsigned int i_index) const { return charAt(i_index); }
+  char &operator[](unsigned int i_index) { return s[i_index]; }
+  const char *begin() const { return s.c_str(); }
+  const char *end() const { return s.c_str() + s.length(); }
+  const std::string &str() const { return s; }
+
+  bool concat(const String &i_str) { s += i_str.s; return true; }
+  bool concat(const char *i_str) { if (NULL != i_str) s += i_str; return true; }
+  bool concat(const char *i_str, unsigned int i_len) { s.append(i_str, i_len); return true; }
+  bool concat(char i_c) { s += i_c; return true; }
+  template <typename T> bool concat(T i_val) { return concat(String(i_val)); }
+  template <typename T> String &operator+=(const T &i_val) { concat(i_val); return *this; }
+
+  bool equals(const String &i_str) const { return s == i_str.s; }
+  bool equals(const char *i_str) const { return s == ((NULL != i_str) ? i_str : ""); }
+  bool equalsIgnoreCase(const String &) const;
+  int compareTo(const String &i_str) const { return s.compare(i_str.s); }
+  bool startsWith(const String &i_str) const { return s.compare(0, i_str.s.length(), i_str.s) == 0; }
+  bool startsWith(const String &i_str, unsigned int i_offset) const { return (i_offset <= s.length()) && (s.compare(i_offset, i_str.s.length(), i_str.s) == 0); }
+  bool endsWith(const String &i_str) const { return (s.length() >= i_str.s.length()) && (s.compare(s.length() - i_str.s.length(), i_str.s.length(), i_str.s) == 0); }
+
+  int indexOf(char i_c, unsigned int i_from = 0) const;
+  int indexOf(const String &i_str, unsigned int i_from = 0) const;
+  int lastIndexOf(char i_c) const;
+  int lastIndexOf(const String &i_str) const;
+  String substring(unsigned int i_from) const;
+  String substring(unsigned int i_from, unsigned int i_to) const;
+
+  void replace(char i_find, char i_replace);
+  void replace(const String &i_find, const String &i_replace);
+  void remove(unsigned int i_index);
+  void remove(unsigned int i_index, unsigned int i_count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+  void clear() { s.clear(); }
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+  void getBytes(unsigned char *, unsigned int, unsigned int i_index = 0) const;
+  void toCharArray(char *i_buf, unsigned int i_size, unsigned int i_index = 0) const { getBytes((unsigned char *)i_buf, i_size, i_index); }
+
+  /* ArduinoJson and Print use this interface */
+  size_t write(uint8_t i_c) { s += (char)i_c; return 1; }
+  size_t write(const uint8_t *i_buf, size_t i_len) { s.append((const char *)i_buf, i_len); return i_len; }
+
+  friend bool operator==(const String &a, const String &b) { return a.s == b.s; }
+  friend bool operator==(const String &a, const char *b) { return a.equals(b); }
+  friend bool operator==(const char *a, const String &b) { return b.equals(a); }
+  friend bool operator!=(const String &a, const String &b) { return a.s != b.s; }
+  friend bool operator!=(const String &a, const char *b) { return !a.equals(b); }
+  friend bool operator!=(const char *a, const String &b) { return !b.equals(a); }
+  friend bool operator<(const String &a, const String &b) { return a.s < b.s; }
+};
+
+inline String operator+(const String &a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, const char *b) { String r(a); r.concat(b); return r; }
+inline String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, char b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, const __FlashStringHelper *b) { String r(a); r.concat((const char *)b); return r; }
+template <typename T> inline String operator+(const String &a, T b) { String r(a); r.concat(String(b)); return r; }
+
+#endif
+
+/* EOF */
@@ -0,0 +1,141 @@
+/**
+   @file WiFi.h
+
+   @brief Host stub of the Arduino-ESP32 WiFi class. Host network is always connected, WiFi events are not generated
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_WIFI_H_
+#define _HOST_WIFI_H_
+
+#include "Arduino.h"
+#include "esp_wifi.h"
+#include "WiFiClient.h"
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+typedef enum {
+  WIFI_POWER_19_5dBm = 78,
+  WIFI_POWER_19dBm = 76,
+  WIFI_POWER_18_5dBm = 74,
+  WIFI_POWER_17dBm = 68,
+  WIFI_POWER_15dBm = 60,
+  WIFI_POWER_13dBm = 52,
+  WIFI_POWER_11dBm = 44,
+  WIFI_POWER_8_5dBm = 34,
+  WIFI_POWER_7dBm = 28,
+  WIFI_POWER_5dBm = 20,
+  WIFI_POWER_2dBm = 8,
+  WIFI_POWER_MINUS_1dBm = -4
+} wifi_power_t;
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_READY = 0,
+  ARDUINO_EVENT_WIFI_SCAN_DONE,
+  ARDUINO_EVENT_WIFI_STA_START,
+  ARDUINO_EVENT_WIFI_STA_STOP,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_AUTHMODE_CHANGE,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP6,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_WIFI_AP_START,
+  ARDUINO_EVENT_WIFI_AP_STOP,
+  ARDUINO_EVENT_WIFI_AP_STACONNECTED,
+  ARDUINO_EVENT_WIFI_AP_STADISCONNECTED,
+  ARDUINO_EVENT_WIFI_AP_STAIPASSIGNED,
+  ARDUINO_EVENT_WIFI_AP_PROBEREQRECVED,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+
+typedef union {
+  wifi_event_sta_disconnected_t wifi_sta_disconnected;
+  wifi_event_ap_staconnected_t wifi_ap_staconnected;
+  wifi_event_ap_stadisconnected_t wifi_ap_stadisconnected;
+  ip_event_ap_staipassigned_t wifi_ap_staipassigned;
+} WiFiEventInfo_t;
+
+typedef void (*WiFiEventFuncCb)(WiFiEvent_t, WiFiEventInfo_t);
+
+class WiFiClass {
+private:
+  wifi_mode_t Mode;
+  wl_status_t Status;
+  String Ssid;
+  uint8_t Bssid[6];
+  int32_t Channel;
+  IPAddress LocalIp;
+  IPAddress Mask;
+  IPAddress Gateway;
+  IPAddress Dns;
+  wifi_power_t TxPower;
+
+public:
+  WiFiClass();
+
+  int onEvent(WiFiEventFuncCb, WiFiEvent_t i_event = ARDUINO_EVENT_MAX) { return 0; }
+  bool mode(wifi_mode_t i_mode) { Mode = i_mode; return true; }
+  wifi_mode_t getMode() { return Mode; }
+
+  wl_status_t begin(const char *, const char *i_pass = NULL, int32_t i_channel = 0, const uint8_t *i_bssid = NULL, bool i_connect = true);
+  wl_status_t begin(const String &i_ssid, const String &i_pass, int32_t i_channel = 0, const uint8_t *i_bssid = NULL, bool i_connect = true) { return begin(i_ssid.c_str(), i_pass.c_str(), i_channel, i_bssid, i_connect); }
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress i_dns1 = (uint32_t)0, IPAddress i_dns2 = (uint32_t)0);
+  bool disconnect(bool i_wifioff = false, bool i_eraseap = false) { Status = WL_DISCONNECTED; return true; }
+  bool setAutoReconnect(bool) { return true; }
+  bool setHostname(const char *) { return true; }
+  bool setTxPower(wifi_power_t i_power) { TxPower = i_power; return true; }
+  wifi_power_t getTxPower() { return TxPower; }
+  wl_status_t status() { return Status; }
+
+  IPAddress localIP() { return LocalIp; }
+  IPAddress subnetMask() { return Mask; }
+  IPAddress gatewayIP() { return Gateway; }
+  IPAddress dnsIP(uint8_t i_index = 0) { return Dns; }
+  String macAddress() { return "24:0A:C4:00:00:01"; }
+  String SSID() const { return Ssid; }
+  uint8_t *BSSID() { return Bssid; }
+  String BSSIDstr();
+  int8_t RSSI() { return -50; }
+  int32_t channel() { return Channel; }
+
+  int16_t scanNetworks(bool i_async = false, bool i_show_hidden = false, bool i_passive = false, uint32_t i_max_ms_per_chan = 300, uint8_t i_channel = 0, const char *i_ssid = nullptr, const uint8_t *i_bssid = nullptr) { return 0; }
+  int16_t scanComplete() { return 0; }
+  void scanDelete() {}
+  String SSID(uint8_t) { return ""; }
+  int32_t RSSI(uint8_t) { return 0; }
+  uint8_t *BSSID(uint8_t) { return Bssid; }
+  String BSSIDstr(uint8_t) { return BSSIDstr(); }
+  int32_t channel(uint8_t) { return Channel; }
+  wifi_auth_mode_t encryptionType(uint8_t) { return WIFI_AUTH_WPA2_PSK; }
+
+  bool softAP(const char *, const char *i_pass = NULL, int i_channel = 1, int i_hidden = 0, int i_max = 4) { return true; }
+  bool softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+  bool softAPdisconnect(bool i_wifioff = false) { return true; }
+  IPAddress softAPIP() { return IPAddress(192, 168, 0, 1); }
+  uint8_t softAPgetStationNum() { return 0; }
+};
+
+extern WiFiClass WiFi;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,45 @@
+/**
+   @file WiFiClient.h
+
+   @brief Host stub of the Arduino-ESP32 WiFiClient. Client is backed by the host TCP socket
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_WIFICLIENT_H_
+#define _HOST_WIFICLIENT_H_
+
+#include "Arduino.h"
+#include "Client.h"
+
+class WiFiClient : public Client {
+protected:
+  int Socket;
+
+public:
+  WiFiClient() : Socket(-1) {}
+  ~WiFiClient() { stop(); }
+  WiFiClient(const WiFiClient &) = delete;
+  WiFiClient &operator=(const WiFiClient &) = delete;
+
+  int connect(IPAddress, uint16_t) override;
+  int connect(const char *, uint16_t) override;
+  size_t write(uint8_t) override;
+  size_t write(const uint8_t *, size_t) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t *, size_t) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,32 @@
+/**
+   @file WiFiClientSecure.h
+
+   @brief Host stub of the Arduino-ESP32 WiFiClientSecure. TLS is not emulated, data are sent via plain TCP socket
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_WIFICLIENTSECURE_H_
+#define _HOST_WIFICLIENTSECURE_H_
+
+#include "WiFi.h"
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setCACert(const char *) {}
+  void setInsecure() {}
+  int lastError(char *i_buf, const size_t i_size) {
+    if (i_size > 0) {
+      i_buf[0] = '\0';
+    }
+    return (Socket < 0) ? -1 : 0;
+  }
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,14 @@
+/**
+   @file arduino.h
+
+   @brief Lower case alias of Arduino.h, the host file system is case sensitive
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "Arduino.h"
+
+/* EOF */
@@ -0,0 +1,325 @@
+/**
+   @file arduino_core.cpp
+
+   @brief Host stub of the Arduino-ESP32 core: time, GPIO, serial port, heap, system functions and small libraries
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <malloc.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "ArduinoUniqueID.h"
+#include "ESPmDNS.h"
+#include "HTTPUpdate.h"
+#include "Update.h"
+#include "base64.h"
+#include "esp_timer.h"
+
+#define HOST_HEAP_SIZE          (320 * 1024)        ///< internal RAM of the ESP32
+#define HOST_HEAP_FREE          (160 * 1024)        ///< free internal RAM after boot
+#define HOST_PSRAM_SIZE         (4 * 1024 * 1024)   ///< PSRAM of the ESP32-CAM
+
+HardwareSerial Serial;
+EspClass ESP;
+HTTPUpdate httpUpdate;
+UpdateClass Update;
+MDNSResponder MDNS;
+const uint8_t UniqueID[UniqueIDsize] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01, 0x48, 0x6F };
+
+static std::mt19937 HostRandom(std::random_device{}());
+static std::mutex HostRandomLock;
+static uint8_t HostPins[64];
+static std::vector<shutdown_handler_t> HostShutdownHandlers;
+
+/* ------------------------------ time ------------------------------ */
+
+unsigned long millis() {
+  return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)esp_timer_get_time();
+}
+
+void delay(uint32_t i_ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(i_ms));
+}
+
+void delayMicroseconds(uint32_t i_us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(i_us));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+/**
+ * @brief NTP is not used on the host, time of the host is already synchronized
+ */
+void configTime(long, int, const char *, const char *, const char *) {
+}
+
+/**
+ * @brief Get local time. Same as on the MCU, time before year 2016 is not valid
+ *
+ * @param struct tm* - output time
+ * @param uint32_t - timeout [ms]
+ * @return bool - true if time is valid
+ */
+bool getLocalTime(struct tm *o_info, uint32_t) {
+  time_t now = time(NULL);
+  localtime_r(&now, o_info);
+  return (o_info->tm_year > (2016 - 1900));
+}
+
+/* ------------------------------ random ------------------------------ */
+
+uint32_t esp_random() {
+  std::lock_guard<std::mutex> guard(HostRandomLock);
+  return (uint32_t)HostRandom();
+}
+
+long random(long i_max) {
+  return (i_max <= 0) ? 0 : (long)(esp_random() % (uint32_t)i_max);
+}
+
+long random(long i_min, long i_max) {
+  return (i_min >= i_max) ? i_min : (i_min + random(i_max - i_min));
+}
+
+/* ------------------------------ GPIO ------------------------------ */
+
+void pinMode(uint8_t i_pin, uint8_t i_mode) {
+  if ((i_pin < sizeof(HostPins)) && (INPUT_PULLUP == i_mode)) {
+    HostPins[i_pin] = HIGH;
+  }
+}
+
+void digitalWrite(uint8_t i_pin, uint8_t i_val) {
+  if (i_pin < sizeof(HostPins)) {
+    HostPins[i_pin] = i_val;
+  }
+}
+
+int digitalRead(uint8_t i_pin) {
+  return (i_pin < sizeof(HostPins)) ? HostPins[i_pin] : LOW;
+}
+
+void analogWrite(uint8_t, int) {
+}
+
+uint32_t ledcSetup(uint8_t, uint32_t i_freq, uint8_t) {
+  return i_freq;
+}
+
+void ledcAttachPin(uint8_t, uint8_t) {
+}
+
+void ledcWrite(uint8_t, uint32_t) {
+}
+
+uint32_t ledcRead(uint8_t) {
+  return 0;
+}
+
+float temperatureRead() {
+  return 45.0;
+}
+
+/* ------------------------------ serial port ------------------------------ */
+
+int HardwareSerial::available() {
+  struct pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+  return ((1 == poll(&fd, 1, 0)) && (fd.revents & POLLIN)) ? 1 : 0;
+}
+
+int HardwareSerial::read() {
+  uint8_t c;
+  if ((0 == available()) || (1 != ::read(STDIN_FILENO, &c, 1))) {
+    return -1;
+  }
+  return c;
+}
+
+int HardwareSerial::peek() {
+  return -1;
+}
+
+size_t HardwareSerial::write(uint8_t i_c) {
+  return fwrite(&i_c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *i_buf, size_t i_len) {
+  return fwrite(i_buf, 1, i_len, stdout);
+}
+
+/* ------------------------------ heap ------------------------------ */
+
+static std::mutex HostHeapLock;
+static std::map<void *, size_t> HostPsramBlocks;   ///< blocks allocated in PSRAM, pointer -> size
+static size_t HostPsramUsed = 0;
+
+void *heap_caps_malloc(size_t i_size, uint32_t i_caps) {
+  void *ptr = malloc(i_size);
+  if ((NULL != ptr) && (i_caps & MALLOC_CAP_SPIRAM)) {
+    std::lock_guard<std::mutex> guard(HostHeapLock);
+    if ((HostPsramUsed + i_size) > HOST_PSRAM_SIZE) {
+      free(ptr);
+      return NULL;
+    }
+    HostPsramBlocks[ptr] = i_size;
+    HostPsramUsed += i_size;
+  }
+  return ptr;
+}
+
+void *heap_caps_calloc(size_t i_count, size_t i_size, uint32_t i_caps) {
+  void *ptr = heap_caps_malloc(i_count * i_size, i_caps);
+  if (NULL != ptr) {
+    memset(ptr, 0, i_count * i_size);
+  }
+  return ptr;
+}
+
+void heap_caps_free(void *i_ptr) {
+  if (NULL == i_ptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(HostHeapLock);
+    auto block = HostPsramBlocks.find(i_ptr);
+    if (HostPsramBlocks.end() != block) {
+      HostPsramUsed -= block->second;
+      HostPsramBlocks.erase(block);
+    }
+  }
+  free(i_ptr);
+}
+
+void *heap_caps_realloc(void *i_ptr, size_t i_size, uint32_t i_caps) {
+  if (NULL == i_ptr) {
+    return heap_caps_malloc(i_size, i_caps);
+  }
+  void *ptr = heap_caps_malloc(i_size, i_caps);
+  if (NULL != ptr) {
+    memcpy(ptr, i_ptr, min(i_size, malloc_usable_size(i_ptr)));
+    heap_caps_free(i_ptr);
+  }
+  return ptr;
+}
+
+size_t heap_caps_get_total_size(uint32_t i_caps) {
+  return (i_caps & MALLOC_CAP_SPIRAM) ? HOST_PSRAM_SIZE : HOST_HEAP_SIZE;
+}
+
+size_t heap_caps_get_free_size(uint32_t i_caps) {
+  if (i_caps & MALLOC_CAP_SPIRAM) {
+    std::lock_guard<std::mutex> guard(HostHeapLock);
+    return HOST_PSRAM_SIZE - HostPsramUsed;
+  }
+  return HOST_HEAP_FREE;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t i_caps) {
+  return heap_caps_get_free_size(i_caps);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t i_caps) {
+  return heap_caps_get_free_size(i_caps);
+}
+
+void *ps_malloc(size_t i_size) {
+  return heap_caps_malloc(i_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+bool psramFound() {
+  return true;
+}
+
+bool esp_ptr_external_ram(const void *i_ptr) {
+  std::lock_guard<std::mutex> guard(HostHeapLock);
+  auto block = HostPsramBlocks.upper_bound((void *)i_ptr);
+  if (HostPsramBlocks.begin() == block) {
+    return false;
+  }
+  block--;
+  return ((const uint8_t *)i_ptr) < ((const uint8_t *)block->first + block->second);
+}
+
+uint32_t EspClass::getHeapSize() {
+  return heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getPsramSize() {
+  return heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+}
+
+uint32_t EspClass::getFreePsram() {
+  return heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+}
+
+void EspClass::restart() {
+  esp_restart();
+}
+
+/* ------------------------------ system ------------------------------ */
+
+/**
+ * @brief Restart of the MCU ends the host program
+ */
+void esp_restart() {
+  for (shutdown_handler_t handler : HostShutdownHandlers) {
+    handler();
+  }
+  fflush(stdout);
+  fprintf(stderr, "esp_restart: MCU restart requested\n");
+  exit(0);
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  return ESP_RST_POWERON;
+}
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t i_handler) {
+  HostShutdownHandlers.push_back(i_handler);
+  return ESP_OK;
+}
+
+/* ------------------------------ libraries ------------------------------ */
+
+String base64::encode(const uint8_t *i_data, size_t i_len) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  String ret;
+  for (size_t i = 0; i < i_len; i += 3) {
+    uint32_t block = (uint32_t)i_data[i] << 16;
+    if ((i + 1) < i_len) {
+      block |= (uint32_t)i_data[i + 1] << 8;
+    }
+    if ((i + 2) < i_len) {
+      block |= i_data[i + 2];
+    }
+    ret += table[(block >> 18) & 0x3F];
+    ret += table[(block >> 12) & 0x3F];
+    ret += ((i + 1) < i_len) ? table[(block >> 6) & 0x3F] : '=';
+    ret += ((i + 2) < i_len) ? table[block & 0x3F] : '=';
+  }
+  return ret;
+}
+
+/* EOF */
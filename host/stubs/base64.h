@@ -0,0 +1,25 @@
+/**
+   @file base64.h
+
+   @brief Host stub of the base64 encoder
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_BASE64_H_
+#define _HOST_BASE64_H_
+
+#include "WString.h"
+
+class base64 {
+public:
+  static String encode(const uint8_t *, size_t);
+  static String encode(const String &i_text) { return encode((const uint8_t *)i_text.c_str(), i_text.length()); }
+};
+
+#endif
+
+/* EOF */
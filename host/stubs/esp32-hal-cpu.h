@@ -0,0 +1,22 @@
+/**
+   @file esp32-hal-cpu.h
+
+   @brief Host stub of the Arduino-ESP32 CPU API
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP32_HAL_CPU_H_
+#define _HOST_ESP32_HAL_CPU_H_
+
+#include <stdint.h>
+
+inline bool setCpuFrequencyMhz(uint32_t) { return true; }
+inline uint32_t getCpuFrequencyMhz() { return 240; }
+
+#endif
+
+/* EOF */
@@ -0,0 +1,25 @@
+/**
+   @file rtc.h
+
+   @brief Host stub of the ESP32 ROM reset reason API
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ROM_RTC_H_
+#define _HOST_ROM_RTC_H_
+
+typedef enum {
+  NO_MEAN = 0,
+  POWERON_RESET = 1,
+  SW_RESET = 3,
+} RESET_REASON;
+
+inline RESET_REASON rtc_get_reset_reason(int) { return POWERON_RESET; }
+
+#endif
+
+/* EOF */
@@ -0,0 +1,152 @@
+/**
+   @file esp_camera.h
+
+   @brief Host stub of the esp32-camera driver. Frames are JPEG files from the directory HOST_CAMERA_DIR, replayed in the loop. Without directory is generated test pattern
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_CAMERA_H_
+#define _HOST_ESP_CAMERA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+
+#include "esp_err.h"
+
+typedef enum {
+  PIXFORMAT_RGB565,
+  PIXFORMAT_YUV422,
+  PIXFORMAT_YUV420,
+  PIXFORMAT_GRAYSCALE,
+  PIXFORMAT_JPEG,
+  PIXFORMAT_RGB888,
+  PIXFORMAT_RAW,
+  PIXFORMAT_RGB444,
+  PIXFORMAT_RGB555,
+} pixformat_t;
+
+typedef enum {
+  FRAMESIZE_96X96,
+  FRAMESIZE_QQVGA,
+  FRAMESIZE_QCIF,
+  FRAMESIZE_HQVGA,
+  FRAMESIZE_240X240,
+  FRAMESIZE_QVGA,
+  FRAMESIZE_CIF,
+  FRAMESIZE_HVGA,
+  FRAMESIZE_VGA,
+  FRAMESIZE_SVGA,
+  FRAMESIZE_XGA,
+  FRAMESIZE_HD,
+  FRAMESIZE_SXGA,
+  FRAMESIZE_UXGA,
+  FRAMESIZE_INVALID
+} framesize_t;
+
+typedef enum {
+  GAINCEILING_2X,
+  GAINCEILING_4X,
+  GAINCEILING_8X,
+  GAINCEILING_16X,
+  GAINCEILING_32X,
+  GAINCEILING_64X,
+  GAINCEILING_128X,
+} gainceiling_t;
+
+typedef enum {
+  CAMERA_GRAB_WHEN_EMPTY,
+  CAMERA_GRAB_LATEST
+} camera_grab_mode_t;
+
+typedef enum {
+  CAMERA_FB_IN_PSRAM,
+  CAMERA_FB_IN_DRAM
+} camera_fb_location_t;
+
+typedef enum {
+  LEDC_CHANNEL_0 = 0,
+} ledc_channel_t;
+
+typedef enum {
+  LEDC_TIMER_0 = 0,
+} ledc_timer_t;
+
+typedef struct {
+  int pin_pwdn;
+  int pin_reset;
+  int pin_xclk;
+  int pin_sccb_sda;
+  int pin_sccb_scl;
+  int pin_d7;
+  int pin_d6;
+  int pin_d5;
+  int pin_d4;
+  int pin_d3;
+  int pin_d2;
+  int pin_d1;
+  int pin_d0;
+  int pin_vsync;
+  int pin_href;
+  int pin_pclk;
+  int xclk_freq_hz;
+  ledc_timer_t ledc_timer;
+  ledc_channel_t ledc_channel;
+  pixformat_t pixel_format;
+  framesize_t frame_size;
+  int jpeg_quality;
+  size_t fb_count;
+  camera_fb_location_t fb_location;
+  camera_grab_mode_t grab_mode;
+} camera_config_t;
+
+typedef struct {
+  uint8_t *buf;
+  size_t len;
+  size_t width;
+  size_t height;
+  pixformat_t format;
+  struct timeval timestamp;
+} camera_fb_t;
+
+typedef struct _sensor sensor_t;
+struct _sensor {
+  int (*set_framesize)(sensor_t *, framesize_t);
+  int (*set_quality)(sensor_t *, int);
+  int (*set_brightness)(sensor_t *, int);
+  int (*set_contrast)(sensor_t *, int);
+  int (*set_saturation)(sensor_t *, int);
+  int (*set_special_effect)(sensor_t *, int);
+  int (*set_whitebal)(sensor_t *, int);
+  int (*set_awb_gain)(sensor_t *, int);
+  int (*set_wb_mode)(sensor_t *, int);
+  int (*set_exposure_ctrl)(sensor_t *, int);
+  int (*set_aec2)(sensor_t *, int);
+  int (*set_ae_level)(sensor_t *, int);
+  int (*set_aec_value)(sensor_t *, int);
+  int (*set_gain_ctrl)(sensor_t *, int);
+  int (*set_agc_gain)(sensor_t *, int);
+  int (*set_gainceiling)(sensor_t *, gainceiling_t);
+  int (*set_bpc)(sensor_t *, int);
+  int (*set_wpc)(sensor_t *, int);
+  int (*set_raw_gma)(sensor_t *, int);
+  int (*set_lenc)(sensor_t *, int);
+  int (*set_hmirror)(sensor_t *, int);
+  int (*set_vflip)(sensor_t *, int);
+  int (*set_dcw)(sensor_t *, int);
+  int (*set_colorbar)(sensor_t *, int);
+};
+
+esp_err_t esp_camera_init(const camera_config_t *);
+esp_err_t esp_camera_deinit();
+camera_fb_t *esp_camera_fb_get();
+void esp_camera_fb_return(camera_fb_t *);
+sensor_t *esp_camera_sensor_get();
+
+#endif
+
+/* EOF */
@@ -0,0 +1,41 @@
+/**
+   @file esp_heap_caps.h
+
+   @brief Host stub of the ESP-IDF heap capabilities API. All memory is allocated from the host heap, sizes of the ESP32-CAM heaps are reported
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_HEAP_CAPS_H_
+#define _HOST_ESP_HEAP_CAPS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MALLOC_CAP_EXEC     (1 << 0)
+#define MALLOC_CAP_32BIT    (1 << 1)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+void *heap_caps_malloc(size_t, uint32_t);
+void *heap_caps_calloc(size_t, size_t, uint32_t);
+void *heap_caps_realloc(void *, size_t, uint32_t);
+void heap_caps_free(void *);
+size_t heap_caps_get_total_size(uint32_t);
+size_t heap_caps_get_free_size(uint32_t);
+size_t heap_caps_get_minimum_free_size(uint32_t);
+size_t heap_caps_get_largest_free_block(uint32_t);
+
+void *ps_malloc(size_t);
+bool psramFound();
+bool esp_ptr_external_ram(const void *);
+
+#endif
+
+/* EOF */
@@ -0,0 +1,35 @@
+/**
+   @file esp_jpg_decode.h
+
+   @brief Host stub of the esp32-camera JPEG decoder, implemented by libjpeg. Output is RGB888 in the order R, G, B as on the target
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_JPG_DECODE_H_
+#define _HOST_ESP_JPG_DECODE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+typedef enum {
+  JPG_SCALE_NONE,
+  JPG_SCALE_2X,
+  JPG_SCALE_4X,
+  JPG_SCALE_8X,
+  JPG_SCALE_MAX = JPG_SCALE_8X
+} jpg_scale_t;
+
+typedef size_t (*jpg_reader_cb)(void *arg, size_t index, uint8_t *buf, size_t len);
+typedef bool (*jpg_writer_cb)(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data);
+
+esp_err_t esp_jpg_decode(size_t, jpg_scale_t, jpg_reader_cb, jpg_writer_cb, void *);
+
+#endif
+
+/* EOF */
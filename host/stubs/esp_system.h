@@ -0,0 +1,42 @@
+/**
+   @file esp_system.h
+
+   @brief Host stub of the ESP-IDF system API
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_SYSTEM_H_
+#define _HOST_ESP_SYSTEM_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef enum {
+  ESP_RST_UNKNOWN,
+  ESP_RST_POWERON,
+  ESP_RST_EXT,
+  ESP_RST_SW,
+  ESP_RST_PANIC,
+  ESP_RST_INT_WDT,
+  ESP_RST_TASK_WDT,
+  ESP_RST_WDT,
+  ESP_RST_DEEPSLEEP,
+  ESP_RST_BROWNOUT,
+  ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+typedef void (*shutdown_handler_t)(void);
+
+void esp_restart();
+uint32_t esp_random();
+esp_reset_reason_t esp_reset_reason();
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t);
+
+#endif
+
+/* EOF */
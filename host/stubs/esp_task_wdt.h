@@ -0,0 +1,25 @@
+/**
+   @file esp_task_wdt.h
+
+   @brief Host stub of the ESP-IDF task watchdog. Watchdog is not emulated
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_TASK_WDT_H_
+#define _HOST_ESP_TASK_WDT_H_
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+inline esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(TaskHandle_t) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_delete(TaskHandle_t) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+#endif
+
+/* EOF */
@@ -0,0 +1,44 @@
+/**
+   @file esp_timer.h
+
+   @brief Host stub of the ESP-IDF esp_timer API. Time base is std::chrono::steady_clock, callbacks run in one timer thread
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_TIMER_H_
+#define _HOST_ESP_TIMER_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+struct HostTimer;
+typedef HostTimer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *);
+
+typedef enum {
+  ESP_TIMER_TASK = 0,
+} esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time();
+esp_err_t esp_timer_create(const esp_timer_create_args_t *, esp_timer_handle_t *);
+esp_err_t esp_timer_start_once(esp_timer_handle_t, uint64_t);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t);
+esp_err_t esp_timer_stop(esp_timer_handle_t);
+esp_err_t esp_timer_delete(esp_timer_handle_t);
+
+#endif
+
+/* EOF */
@@ -0,0 +1,97 @@
+/**
+   @file esp_wifi.h
+
+   @brief Host stub of the ESP-IDF WiFi types
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_ESP_WIFI_H_
+#define _HOST_ESP_WIFI_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef enum {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+#define WIFI_OFF    WIFI_MODE_NULL
+#define WIFI_STA    WIFI_MODE_STA
+#define WIFI_AP     WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+  WIFI_PS_NONE,
+  WIFI_PS_MIN_MODEM,
+  WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+typedef enum {
+  WIFI_AUTH_OPEN = 0,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK,
+  WIFI_AUTH_WPA2_ENTERPRISE,
+  WIFI_AUTH_WPA3_PSK,
+  WIFI_AUTH_WPA2_WPA3_PSK,
+  WIFI_AUTH_WAPI_PSK,
+  WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum {
+  WIFI_REASON_UNSPECIFIED = 1,
+  WIFI_REASON_ASSOC_LEAVE = 8,
+  WIFI_REASON_BEACON_TIMEOUT = 200,
+  WIFI_REASON_NO_AP_FOUND = 201,
+} wifi_err_reason_t;
+
+typedef struct {
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t reason;
+} wifi_event_sta_disconnected_t;
+
+typedef struct {
+  uint8_t mac[6];
+  uint8_t aid;
+} wifi_event_ap_staconnected_t;
+
+typedef struct {
+  uint8_t mac[6];
+  uint8_t aid;
+  uint8_t reason;
+} wifi_event_ap_stadisconnected_t;
+
+typedef struct {
+  uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct {
+  esp_ip4_addr_t ip;
+} ip_event_ap_staipassigned_t;
+
+inline wifi_ps_type_t HostWifiPowerSave = WIFI_PS_NONE;   ///< modem sleep mode set by the firmware
+
+inline esp_err_t esp_wifi_set_ps(wifi_ps_type_t i_type) {
+  HostWifiPowerSave = i_type;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_get_ps(wifi_ps_type_t *o_type) {
+  *o_type = HostWifiPowerSave;
+  return ESP_OK;
+}
+
+#endif
+
+/* EOF */
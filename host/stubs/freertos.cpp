@@ -0,0 +1,362 @@
+/**
+   @file freertos.cpp
+
+   @brief Host stub of the FreeRTOS and esp_timer. Tasks are threads, semaphores are condition variables,
+          timers are dispatched from one thread as on the esp_timer task
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+/**
+ * @brief HostTask struct
+ * thread of the task
+ */
+struct HostTask {
+  std::string Name;
+  UBaseType_t Priority;
+  BaseType_t Core;
+  std::mutex NotifyLock;
+  std::condition_variable NotifyCond;
+  uint32_t NotifyValue = 0;
+};
+
+/**
+ * @brief HostSemaphore struct
+ * mutex and binary semaphore
+ */
+struct HostSemaphore {
+  std::mutex Lock;
+  std::condition_variable Cond;
+  UBaseType_t Count;
+};
+
+/**
+ * @brief Task deleted itself by vTaskDelete(NULL)
+ */
+struct HostTaskExit {};
+
+static const std::chrono::steady_clock::time_point HostStart = std::chrono::steady_clock::now();
+static std::atomic<UBaseType_t> HostTaskCount(1);
+static HostTask HostMainTask{ "loopTask", 1, 1 };
+static HostTask HostIdleTask[portNUM_PROCESSORS] = { { "IDLE0", 0, 0 }, { "IDLE1", 0, 1 } };
+static thread_local HostTask *HostCurrentTask = &HostMainTask;
+static std::recursive_mutex HostCritical;
+
+/**
+ * @brief Get time from start of the program
+ *
+ * @return int64_t - time [us]
+ */
+int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - HostStart).count();
+}
+
+void vPortEnterCritical(portMUX_TYPE *) {
+  HostCritical.lock();
+}
+
+void vPortExitCritical(portMUX_TYPE *) {
+  HostCritical.unlock();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t i_fn, const char *i_name, uint32_t, void *i_param, UBaseType_t i_priority, TaskHandle_t *o_handle, BaseType_t i_core) {
+  HostTask *task = new HostTask();
+  task->Name = (NULL != i_name) ? i_name : "";
+  task->Priority = i_priority;
+  task->Core = (tskNO_AFFINITY == i_core) ? 0 : i_core;
+  if (NULL != o_handle) {
+    *o_handle = task;
+  }
+
+  HostTaskCount++;
+  std::thread([task, i_fn, i_param]() {
+    HostCurrentTask = task;
+    try {
+      i_fn(i_param);
+    } catch (const HostTaskExit &) {
+    }
+    HostTaskCount--;
+  }).detach();
+
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t i_fn, const char *i_name, uint32_t i_stack, void *i_param, UBaseType_t i_priority, TaskHandle_t *o_handle) {
+  return xTaskCreatePinnedToCore(i_fn, i_name, i_stack, i_param, i_priority, o_handle, tskNO_AFFINITY);
+}
+
+/**
+ * @brief Delete the task. Only the calling task can be deleted on the host, thread can not be killed
+ *
+ * @param TaskHandle_t - task, NULL = calling task
+ */
+void vTaskDelete(TaskHandle_t i_task) {
+  if ((NULL == i_task) || (HostCurrentTask == i_task)) {
+    throw HostTaskExit();
+  }
+}
+
+void vTaskDelay(TickType_t i_ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(i_ticks * portTICK_PERIOD_MS));
+}
+
+void vTaskDelayUntil(TickType_t *io_prev, TickType_t i_increment) {
+  *io_prev += i_increment;
+  int32_t wait = (int32_t)(*io_prev - xTaskGetTickCount());
+  if (wait > 0) {
+    vTaskDelay(wait);
+  }
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return HostCurrentTask;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t i_core) {
+  return (i_core < portNUM_PROCESSORS) ? &HostIdleTask[i_core] : NULL;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks() {
+  return HostTaskCount + portNUM_PROCESSORS;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *, UBaseType_t, uint32_t *o_time) {
+  if (NULL != o_time) {
+    *o_time = 0;
+  }
+  return 0;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 4096;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t i_task) {
+  return (NULL == i_task) ? HostCurrentTask->Priority : i_task->Priority;
+}
+
+char *pcTaskGetTaskName(TaskHandle_t i_task) {
+  return (char *)((NULL == i_task) ? HostCurrentTask->Name.c_str() : i_task->Name.c_str());
+}
+
+BaseType_t xPortGetCoreID() {
+  return HostCurrentTask->Core;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t i_task) {
+  {
+    std::lock_guard<std::mutex> guard(i_task->NotifyLock);
+    i_task->NotifyValue++;
+  }
+  i_task->NotifyCond.notify_one();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t i_clear, TickType_t i_ticks) {
+  HostTask *task = HostCurrentTask;
+  std::unique_lock<std::mutex> guard(task->NotifyLock);
+  auto ready = [task]() { return task->NotifyValue > 0; };
+  if (portMAX_DELAY == i_ticks) {
+    task->NotifyCond.wait(guard, ready);
+  } else {
+    task->NotifyCond.wait_for(guard, std::chrono::milliseconds(i_ticks * portTICK_PERIOD_MS), ready);
+  }
+  uint32_t ret = task->NotifyValue;
+  if (ret > 0) {
+    task->NotifyValue = (pdTRUE == i_clear) ? 0 : (ret - 1);
+  }
+  return ret;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  HostSemaphore *sem = new HostSemaphore();
+  sem->Count = 1;
+  return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  HostSemaphore *sem = new HostSemaphore();
+  sem->Count = 0;
+  return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t i_sem, TickType_t i_ticks) {
+  if (NULL == i_sem) {
+    return pdFALSE;
+  }
+  std::unique_lock<std::mutex> guard(i_sem->Lock);
+  auto ready = [i_sem]() { return i_sem->Count > 0; };
+  if (portMAX_DELAY == i_ticks) {
+    i_sem->Cond.wait(guard, ready);
+  } else if (false == i_sem->Cond.wait_for(guard, std::chrono::milliseconds(i_ticks * portTICK_PERIOD_MS), ready)) {
+    return pdFALSE;
+  }
+  i_sem->Count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t i_sem) {
+  if (NULL == i_sem) {
+    return pdFALSE;
+  }
+  {
+    std::lock_guard<std::mutex> guard(i_sem->Lock);
+    if (i_sem->Count > 0) {
+      return pdFALSE;
+    }
+    i_sem->Count++;
+  }
+  i_sem->Cond.notify_one();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t i_sem) {
+  delete i_sem;
+}
+
+/**
+ * @brief HostTimer struct
+ * timer of the esp_timer
+ */
+struct HostTimer {
+  esp_timer_cb_t Callback;
+  void *Arg;
+  bool Armed = false;
+  int64_t Deadline = 0;   ///< time of the next callback [us]
+  uint64_t Period = 0;    ///< period [us], 0 = one shot
+};
+
+/* timer task runs until the end of the program, its objects are never destroyed */
+static std::mutex &HostTimerLock = *new std::mutex();
+static std::condition_variable &HostTimerCond = *new std::condition_variable();
+static std::list<HostTimer *> &HostTimers = *new std::list<HostTimer *>();
+static bool HostTimerTaskRunning = false;
+
+/**
+ * @brief Timer task, callbacks are called one by one as on the esp_timer task
+ */
+static void HostTimer_Task() {
+  std::unique_lock<std::mutex> guard(HostTimerLock);
+  while (true) {
+    HostTimer *next = NULL;
+    for (HostTimer *timer : HostTimers) {
+      if ((true == timer->Armed) && ((NULL == next) || (timer->Deadline < next->Deadline))) {
+        next = timer;
+      }
+    }
+
+    if (NULL == next) {
+      HostTimerCond.wait(guard);
+      continue;
+    }
+
+    int64_t wait = next->Deadline - esp_timer_get_time();
+    if (wait > 0) {
+      HostTimerCond.wait_for(guard, std::chrono::microseconds(wait));
+      continue;
+    }
+
+    if (next->Period > 0) {
+      next->Deadline += next->Period;
+    } else {
+      next->Armed = false;
+    }
+    esp_timer_cb_t callback = next->Callback;
+    void *arg = next->Arg;
+    guard.unlock();
+    callback(arg);
+    guard.lock();
+  }
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *i_args, esp_timer_handle_t *o_handle) {
+  if ((NULL == i_args) || (NULL == i_args->callback) || (NULL == o_handle)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  HostTimer *timer = new HostTimer();
+  timer->Callback = i_args->callback;
+  timer->Arg = i_args->arg;
+
+  std::lock_guard<std::mutex> guard(HostTimerLock);
+  HostTimers.push_back(timer);
+  if (false == HostTimerTaskRunning) {
+    HostTimerTaskRunning = true;
+    std::thread(HostTimer_Task).detach();
+  }
+  *o_handle = timer;
+
+  return ESP_OK;
+}
+
+static esp_err_t HostTimer_Start(esp_timer_handle_t i_timer, uint64_t i_timeout, uint64_t i_period) {
+  if (NULL == i_timer) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  {
+    std::lock_guard<std::mutex> guard(HostTimerLock);
+    if (true == i_timer->Armed) {
+      return ESP_ERR_INVALID_STATE;
+    }
+    i_timer->Armed = true;
+    i_timer->Deadline = esp_timer_get_time() + i_timeout;
+    i_timer->Period = i_period;
+  }
+  HostTimerCond.notify_all();
+
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t i_timer, uint64_t i_timeout) {
+  return HostTimer_Start(i_timer, i_timeout, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t i_timer, uint64_t i_period) {
+  return HostTimer_Start(i_timer, i_period, i_period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t i_timer) {
+  if (NULL == i_timer) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> guard(HostTimerLock);
+  if (false == i_timer->Armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  i_timer->Armed = false;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t i_timer) {
+  if (NULL == i_timer) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> guard(HostTimerLock);
+  if (true == i_timer->Armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  HostTimers.remove(i_timer);
+  delete i_timer;
+
+  return ESP_OK;
+}
+
+/* EOF */
@@ -0,0 +1,52 @@
+/**
+   @file FreeRTOS.h
+
+   @brief Host stub of the FreeRTOS kernel API used by the firmware. Tasks are backed by std::thread,
+          semaphores and task notifications by std::mutex and std::condition_variable
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE                        1
+#define pdFALSE                       0
+#define pdPASS                        1
+#define pdFAIL                        0
+#define portMAX_DELAY                 ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS            1
+#define portNUM_PROCESSORS            2
+#define pdMS_TO_TICKS(ms)             ((TickType_t)(ms))
+#define tskNO_AFFINITY                0x7FFFFFFF
+#define configMAX_TASK_NAME_LEN       16
+#define configUSE_TRACE_FACILITY      0
+#define configGENERATE_RUN_TIME_STATS 0
+#define configTASKLIST_INCLUDE_COREID 0
+
+/* critical sections are global lock on the host */
+typedef struct {
+  int Owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  { 0 }
+void vPortEnterCritical(portMUX_TYPE *);
+void vPortExitCritical(portMUX_TYPE *);
+#define portENTER_CRITICAL(mux)       vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)        vPortExitCritical(mux)
+
+#include "task.h"
+#include "semphr.h"
+
+#endif
+
+/* EOF */
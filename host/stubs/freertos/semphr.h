@@ -0,0 +1,28 @@
+/**
+   @file semphr.h
+
+   @brief Host stub of the FreeRTOS semaphore API
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_FREERTOS_SEMPHR_H_
+#define _HOST_FREERTOS_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+struct HostSemaphore;
+typedef HostSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+void vSemaphoreDelete(SemaphoreHandle_t);
+
+#endif
+
+/* EOF */
@@ -0,0 +1,62 @@
+/**
+   @file task.h
+
+   @brief Host stub of the FreeRTOS task API
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_FREERTOS_TASK_H_
+#define _HOST_FREERTOS_TASK_H_
+
+#include "FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum {
+  eRunning = 0,
+  eReady,
+  eBlocked,
+  eSuspended,
+  eDeleted,
+  eInvalid
+} eTaskState;
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char *pcTaskName;
+  UBaseType_t xTaskNumber;
+  eTaskState eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter;
+  uint32_t usStackHighWaterMark;
+  BaseType_t xCoreID;
+} TaskStatus_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *, BaseType_t);
+BaseType_t xTaskCreate(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *);
+void vTaskDelete(TaskHandle_t);
+void vTaskDelay(TickType_t);
+void vTaskDelayUntil(TickType_t *, TickType_t);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t);
+UBaseType_t uxTaskGetNumberOfTasks();
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *, UBaseType_t, uint32_t *);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t);
+char *pcTaskGetTaskName(TaskHandle_t);
+BaseType_t xPortGetCoreID();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t);
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t);
+
+#endif
+
+/* EOF */
@@ -0,0 +1,310 @@
+/**
+   @file fs.cpp
+
+   @brief Host stub of the file system, micro SD card and EEPROM. Card is the directory HOST_SD_DIR
+          or new temporary directory, EEPROM is saved to the file HOST_EEPROM_FILE when it is set
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "FS.h"
+#include "SD_MMC.h"
+#include "EEPROM.h"
+
+fs::SDMMCFS SD_MMC;
+EEPROMClass EEPROM;
+
+namespace fs {
+
+/**
+ * @brief FileImpl struct
+ * opened file or directory
+ */
+struct FileImpl {
+  std::string Path;       ///< path in the file system
+  std::string HostPath;   ///< path on the host
+  std::string Name;       ///< name of the file
+  FILE *Handle = NULL;    ///< opened file
+  DIR *Dir = NULL;        ///< opened directory
+
+  ~FileImpl() {
+    if (NULL != Handle) {
+      fclose(Handle);
+    }
+    if (NULL != Dir) {
+      closedir(Dir);
+    }
+  }
+};
+
+static std::shared_ptr<FileImpl> FS_OpenImpl(const std::string &i_path, const std::string &i_host, const char *i_mode) {
+  struct stat info;
+  bool exists = (0 == stat(i_host.c_str(), &info));
+  auto impl = std::make_shared<FileImpl>();
+  impl->Path = i_path;
+  impl->HostPath = i_host;
+  size_t slash = i_path.rfind('/');
+  impl->Name = (std::string::npos == slash) ? i_path : i_path.substr(slash + 1);
+
+  if ((true == exists) && S_ISDIR(info.st_mode)) {
+    impl->Dir = opendir(i_host.c_str());
+    return (NULL == impl->Dir) ? nullptr : impl;
+  }
+
+  std::string mode = std::string(i_mode) + "b";
+  if (('r' == i_mode[0]) && (false == exists)) {
+    return nullptr;
+  }
+  impl->Handle = fopen(i_host.c_str(), mode.c_str());
+  return (NULL == impl->Handle) ? nullptr : impl;
+}
+
+size_t File::write(uint8_t i_c) {
+  return write(&i_c, 1);
+}
+
+size_t File::write(const uint8_t *i_buf, size_t i_len) {
+  return ((nullptr == Impl) || (NULL == Impl->Handle)) ? 0 : fwrite(i_buf, 1, i_len, Impl->Handle);
+}
+
+int File::available() {
+  return ((nullptr == Impl) || (NULL == Impl->Handle)) ? 0 : (int)(size() - position());
+}
+
+int File::read() {
+  uint8_t c;
+  return (1 == read(&c, 1)) ? c : -1;
+}
+
+int File::peek() {
+  if ((nullptr == Impl) || (NULL == Impl->Handle)) {
+    return -1;
+  }
+  int c = fgetc(Impl->Handle);
+  if (EOF != c) {
+    ungetc(c, Impl->Handle);
+  }
+  return (EOF == c) ? -1 : c;
+}
+
+size_t File::read(uint8_t *o_buf, size_t i_len) {
+  return ((nullptr == Impl) || (NULL == Impl->Handle)) ? 0 : fread(o_buf, 1, i_len, Impl->Handle);
+}
+
+void File::flush() {
+  if ((nullptr != Impl) && (NULL != Impl->Handle)) {
+    fflush(Impl->Handle);
+  }
+}
+
+bool File::seek(uint32_t i_pos, SeekMode i_mode) {
+  int whence = (SeekCur == i_mode) ? SEEK_CUR : ((SeekEnd == i_mode) ? SEEK_END : SEEK_SET);
+  return (nullptr != Impl) && (NULL != Impl->Handle) && (0 == fseek(Impl->Handle, i_pos, whence));
+}
+
+size_t File::position() const {
+  return ((nullptr == Impl) || (NULL == Impl->Handle)) ? 0 : (size_t)ftell(Impl->Handle);
+}
+
+size_t File::size() const {
+  if ((nullptr == Impl) || (NULL == Impl->Handle)) {
+    return 0;
+  }
+  fflush(Impl->Handle);
+  struct stat info;
+  return (0 == fstat(fileno(Impl->Handle), &info)) ? (size_t)info.st_size : 0;
+}
+
+void File::close() {
+  Impl = nullptr;
+}
+
+File::operator bool() const {
+  return nullptr != Impl;
+}
+
+time_t File::getLastWrite() {
+  struct stat info;
+  return ((nullptr != Impl) && (0 == stat(Impl->HostPath.c_str(), &info))) ? info.st_mtime : 0;
+}
+
+const char *File::path() const {
+  return (nullptr == Impl) ? NULL : Impl->Path.c_str();
+}
+
+const char *File::name() const {
+  return (nullptr == Impl) ? NULL : Impl->Name.c_str();
+}
+
+bool File::isDirectory() {
+  return (nullptr != Impl) && (NULL != Impl->Dir);
+}
+
+File File::openNextFile(const char *i_mode) {
+  if ((nullptr == Impl) || (NULL == Impl->Dir)) {
+    return File();
+  }
+  struct dirent *entry;
+  while (NULL != (entry = readdir(Impl->Dir))) {
+    if ((0 == strcmp(entry->d_name, ".")) || (0 == strcmp(entry->d_name, ".."))) {
+      continue;
+    }
+    std::string path = Impl->Path;
+    if ((path.empty()) || ('/' != path.back())) {
+      path += "/";
+    }
+    std::string name(entry->d_name);
+    return File(FS_OpenImpl(path + name, Impl->HostPath + "/" + name, i_mode));
+  }
+  return File();
+}
+
+void File::rewindDirectory() {
+  if ((nullptr != Impl) && (NULL != Impl->Dir)) {
+    rewinddir(Impl->Dir);
+  }
+}
+
+std::string FS::HostPath(const char *i_path) const {
+  std::string path = (NULL != i_path) ? i_path : "";
+  if (path.empty() || ('/' != path[0])) {
+    path = "/" + path;
+  }
+  return Root + path;
+}
+
+File FS::open(const char *i_path, const char *i_mode, const bool) {
+  if (Root.empty() || (NULL == i_path)) {
+    return File();
+  }
+  return File(FS_OpenImpl(i_path, HostPath(i_path), i_mode));
+}
+
+bool FS::exists(const char *i_path) {
+  struct stat info;
+  return (false == Root.empty()) && (0 == stat(HostPath(i_path).c_str(), &info));
+}
+
+bool FS::remove(const char *i_path) {
+  return (false == Root.empty()) && (0 == unlink(HostPath(i_path).c_str()));
+}
+
+bool FS::rename(const char *i_from, const char *i_to) {
+  return (false == Root.empty()) && (0 == ::rename(HostPath(i_from).c_str(), HostPath(i_to).c_str()));
+}
+
+bool FS::mkdir(const char *i_path) {
+  return (false == Root.empty()) && (0 == ::mkdir(HostPath(i_path).c_str(), 0755));
+}
+
+bool FS::rmdir(const char *i_path) {
+  return (false == Root.empty()) && (0 == ::rmdir(HostPath(i_path).c_str()));
+}
+
+/**
+ * @brief Mount the card. HOST_SD_DIR=none simulates missing card
+ *
+ * @return bool - true if card is mounted
+ */
+bool SDMMCFS::begin(const char *, bool, bool, int, uint8_t) {
+  const char *dir = getenv("HOST_SD_DIR");
+  if ((NULL != dir) && (0 == strcmp(dir, "none"))) {
+    return false;
+  }
+  if (NULL != dir) {
+    Root = dir;
+  } else if (Root.empty()) {
+    char tmp[] = "/tmp/esp32cam-sd-XXXXXX";
+    if (NULL == mkdtemp(tmp)) {
+      return false;
+    }
+    Root = tmp;
+  }
+  struct stat info;
+  Mounted = (0 == stat(Root.c_str(), &info)) && S_ISDIR(info.st_mode);
+  if (false == Mounted) {
+    Root.clear();
+  }
+  return Mounted;
+}
+
+void SDMMCFS::end() {
+  Mounted = false;
+  Root.clear();
+}
+
+sdcard_type_t SDMMCFS::cardType() {
+  return (true == Mounted) ? CARD_SDHC : CARD_NONE;
+}
+
+uint64_t SDMMCFS::cardSize() {
+  return totalBytes();
+}
+
+uint64_t SDMMCFS::totalBytes() {
+  struct statvfs info;
+  return ((true == Mounted) && (0 == statvfs(Root.c_str(), &info))) ? (uint64_t)info.f_blocks * info.f_frsize : 0;
+}
+
+uint64_t SDMMCFS::usedBytes() {
+  struct statvfs info;
+  return ((true == Mounted) && (0 == statvfs(Root.c_str(), &info))) ? (uint64_t)(info.f_blocks - info.f_bfree) * info.f_frsize : 0;
+}
+
+}  // namespace fs
+
+/**
+ * @brief Init EEPROM. Erased EEPROM is 0xFF
+ *
+ * @param size_t - size of EEPROM
+ * @return bool - status
+ */
+bool EEPROMClass::begin(size_t i_size) {
+  Data.assign(i_size, 0xFF);
+  const char *file = getenv("HOST_EEPROM_FILE");
+  if (NULL != file) {
+    FILE *f = fopen(file, "rb");
+    if (NULL != f) {
+      size_t len = fread(Data.data(), 1, Data.size(), f);
+      (void)len;
+      fclose(f);
+    }
+  }
+  return true;
+}
+
+uint8_t EEPROMClass::read(int i_addr) {
+  return ((i_addr >= 0) && ((size_t)i_addr < Data.size())) ? Data[i_addr] : 0;
+}
+
+void EEPROMClass::write(int i_addr, uint8_t i_val) {
+  if ((i_addr >= 0) && ((size_t)i_addr < Data.size())) {
+    Data[i_addr] = i_val;
+  }
+}
+
+bool EEPROMClass::commit() {
+  const char *file = getenv("HOST_EEPROM_FILE");
+  if (NULL == file) {
+    return true;
+  }
+  FILE *f = fopen(file, "wb");
+  if (NULL == f) {
+    return false;
+  }
+  bool ret = (Data.size() == fwrite(Data.data(), 1, Data.size(), f));
+  fclose(f);
+  return ret;
+}
+
+/* EOF */
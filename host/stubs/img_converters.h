@@ -0,0 +1,30 @@
+/**
+   @file img_converters.h
+
+   @brief Host stub of the esp32-camera image converters, implemented by libjpeg. RGB888 image is in the order B, G, R as on the target
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_IMG_CONVERTERS_H_
+#define _HOST_IMG_CONVERTERS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_camera.h"
+#include "esp_jpg_decode.h"
+
+typedef size_t (*jpg_out_cb)(void *arg, size_t index, const void *data, size_t len);
+
+bool fmt2jpg_cb(uint8_t *, size_t, uint16_t, uint16_t, pixformat_t, uint8_t, jpg_out_cb, void *);
+bool fmt2jpg(uint8_t *, size_t, uint16_t, uint16_t, pixformat_t, uint8_t, uint8_t **, size_t *);
+bool frame2jpg(camera_fb_t *, uint8_t, uint8_t **, size_t *);
+bool jpg2rgb888(const uint8_t *, size_t, uint8_t *, jpg_scale_t);
+
+#endif
+
+/* EOF */
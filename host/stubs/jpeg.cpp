@@ -0,0 +1,478 @@
+/**
+   @file jpeg.cpp
+
+   @brief Host stub of the camera, JPEG decoder and JPEG encoder, implemented by the libjpeg.
+
+   Camera returns JPEG files from the directory HOST_CAMERA_DIR in the loop, or the generated test pattern
+   in the configured frame size. HOST_CAMERA_MOTION=1 moves the square of the pattern, HOST_CAMERA_FPS limits frame rate.
+   Files must have JFIF density 0, as the OV2640 photos, firmware checks byte 15 of the photo.
+   Same as on the MCU, decoder output is R,G,B and camera RGB888 layout (encoder input, jpg2rgb888 output) is B,G,R.
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jpeglib.h>
+
+#include "esp_camera.h"
+#include "esp_jpg_decode.h"
+#include "esp_timer.h"
+#include "img_converters.h"
+
+/**
+ * @brief HostJpegError struct
+ * libjpeg error handler, error jumps back instead of exit
+ */
+struct HostJpegError {
+  struct jpeg_error_mgr Mgr;
+  jmp_buf Jump;
+};
+
+static void HostJpeg_ErrorExit(j_common_ptr i_info) {
+  longjmp(((HostJpegError *)i_info->err)->Jump, 1);
+}
+
+static void HostJpeg_Silent(j_common_ptr, int) {
+}
+
+/**
+ * @brief Encode the image to JPEG
+ *
+ * @param const uint8_t* - image, B,G,R for RGB888
+ * @param uint16_t - width
+ * @param uint16_t - height
+ * @param pixformat_t - format of the image
+ * @param uint8_t - quality 0-100
+ * @param std::vector<uint8_t>& - output JPEG
+ * @return bool - status
+ */
+static bool HostJpeg_Encode(const uint8_t *i_src, uint16_t i_width, uint16_t i_height, pixformat_t i_format, uint8_t i_quality, std::vector<uint8_t> &o_jpeg) {
+  if ((NULL == i_src) || (0 == i_width) || (0 == i_height) || ((PIXFORMAT_RGB888 != i_format) && (PIXFORMAT_GRAYSCALE != i_format) && (PIXFORMAT_RGB565 != i_format))) {
+    return false;
+  }
+
+  struct jpeg_compress_struct info;
+  HostJpegError error;
+  unsigned char *out = NULL;
+  unsigned long out_len = 0;
+  std::vector<uint8_t> row((size_t)i_width * 3);
+
+  info.err = jpeg_std_error(&error.Mgr);
+  error.Mgr.error_exit = HostJpeg_ErrorExit;
+  if (setjmp(error.Jump)) {
+    jpeg_destroy_compress(&info);
+    free(out);
+    return false;
+  }
+
+  jpeg_create_compress(&info);
+  jpeg_mem_dest(&info, &out, &out_len);
+  info.image_width = i_width;
+  info.image_height = i_height;
+  info.input_components = (PIXFORMAT_GRAYSCALE == i_format) ? 1 : 3;
+  info.in_color_space = (PIXFORMAT_GRAYSCALE == i_format) ? JCS_GRAYSCALE : JCS_RGB;
+  jpeg_set_defaults(&info);
+  jpeg_set_quality(&info, std::max(1, std::min(100, (int)i_quality)), TRUE);
+  /* same JFIF header as the OV2640, firmware checks byte 15 of the photo */
+  info.density_unit = 0;
+  info.X_density = 0;
+  info.Y_density = 0;
+  jpeg_start_compress(&info, TRUE);
+
+  while (info.next_scanline < info.image_height) {
+    const uint8_t *line = i_src;
+    if (PIXFORMAT_GRAYSCALE == i_format) {
+      line += (size_t)info.next_scanline * i_width;
+    } else if (PIXFORMAT_RGB888 == i_format) {
+      const uint8_t *src = i_src + (size_t)info.next_scanline * i_width * 3;
+      for (uint16_t x = 0; x < i_width; x++) {
+        row[x * 3 + 0] = src[x * 3 + 2];
+        row[x * 3 + 1] = src[x * 3 + 1];
+        row[x * 3 + 2] = src[x * 3 + 0];
+      }
+      line = row.data();
+    } else {
+      const uint8_t *src = i_src + (size_t)info.next_scanline * i_width * 2;
+      for (uint16_t x = 0; x < i_width; x++) {
+        uint16_t px = ((uint16_t)src[x * 2] << 8) | src[x * 2 + 1];
+        row[x * 3 + 0] = (px >> 8) & 0xF8;
+        row[x * 3 + 1] = (px >> 3) & 0xFC;
+        row[x * 3 + 2] = (px << 3) & 0xF8;
+      }
+      line = row.data();
+    }
+    JSAMPROW ptr = (JSAMPROW)line;
+    jpeg_write_scanlines(&info, &ptr, 1);
+  }
+
+  jpeg_finish_compress(&info);
+  jpeg_destroy_compress(&info);
+  o_jpeg.assign(out, out + out_len);
+  free(out);
+
+  return true;
+}
+
+/* ------------------------------ JPEG decoder ------------------------------ */
+
+/**
+ * @brief Decode JPEG. Output is R,G,B rows, start and end of the image is reported with NULL data
+ *
+ * @param size_t - length of JPEG data
+ * @param jpg_scale_t - scale of the output
+ * @param jpg_reader_cb - input callback
+ * @param jpg_writer_cb - output callback
+ * @param void* - argument of the callbacks
+ * @return esp_err_t - status
+ */
+esp_err_t esp_jpg_decode(size_t i_len, jpg_scale_t i_scale, jpg_reader_cb i_reader, jpg_writer_cb i_writer, void *i_arg) {
+  if ((0 == i_len) || (NULL == i_reader) || (NULL == i_writer)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  std::vector<uint8_t> data(i_len);
+  size_t len = 0;
+  while (len < i_len) {
+    size_t ret = i_reader(i_arg, len, data.data() + len, i_len - len);
+    if (0 == ret) {
+      break;
+    }
+    len += ret;
+  }
+
+  struct jpeg_decompress_struct info;
+  HostJpegError error;
+  info.err = jpeg_std_error(&error.Mgr);
+  error.Mgr.error_exit = HostJpeg_ErrorExit;
+  error.Mgr.emit_message = HostJpeg_Silent;
+  if (setjmp(error.Jump)) {
+    jpeg_destroy_decompress(&info);
+    return ESP_FAIL;
+  }
+
+  jpeg_create_decompress(&info);
+  jpeg_mem_src(&info, data.data(), len);
+  if (JPEG_HEADER_OK != jpeg_read_header(&info, TRUE)) {
+    jpeg_destroy_decompress(&info);
+    return ESP_FAIL;
+  }
+  info.out_color_space = JCS_RGB;
+  info.scale_num = 1;
+  info.scale_denom = 1 << i_scale;
+  jpeg_start_decompress(&info);
+
+  uint16_t width = info.output_width;
+  uint16_t height = info.output_height;
+  bool ok = i_writer(i_arg, 0, 0, width, height, NULL);
+  std::vector<uint8_t> row((size_t)width * 3);
+  while ((true == ok) && (info.output_scanline < info.output_height)) {
+    uint16_t y = info.output_scanline;
+    JSAMPROW ptr = row.data();
+    jpeg_read_scanlines(&info, &ptr, 1);
+    ok = i_writer(i_arg, 0, y, width, 1, row.data());
+  }
+  if (true == ok) {
+    ok = i_writer(i_arg, width, height, 0, 0, NULL);
+    jpeg_finish_decompress(&info);
+  } else {
+    jpeg_abort_decompress(&info);
+  }
+  jpeg_destroy_decompress(&info);
+
+  return (true == ok) ? ESP_OK : ESP_FAIL;
+}
+
+/* ------------------------------ converters ------------------------------ */
+
+bool fmt2jpg_cb(uint8_t *i_src, size_t, uint16_t i_width, uint16_t i_height, pixformat_t i_format, uint8_t i_quality, jpg_out_cb i_cb, void *i_arg) {
+  std::vector<uint8_t> jpeg;
+  if ((NULL == i_cb) || (false == HostJpeg_Encode(i_src, i_width, i_height, i_format, i_quality, jpeg))) {
+    return false;
+  }
+
+  /* encoder of the MCU writes the output in small blocks */
+  const size_t block = 1024;
+  for (size_t index = 0; index < jpeg.size(); index += block) {
+    size_t len = std::min(block, jpeg.size() - index);
+    if (len != i_cb(i_arg, index, jpeg.data() + index, len)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool fmt2jpg(uint8_t *i_src, size_t i_len, uint16_t i_width, uint16_t i_height, pixformat_t i_format, uint8_t i_quality, uint8_t **o_out, size_t *o_len) {
+  std::vector<uint8_t> jpeg;
+  if (false == HostJpeg_Encode(i_src, i_width, i_height, i_format, i_quality, jpeg)) {
+    return false;
+  }
+  *o_out = (uint8_t *)malloc(jpeg.size());
+  if (NULL == *o_out) {
+    return false;
+  }
+  memcpy(*o_out, jpeg.data(), jpeg.size());
+  *o_len = jpeg.size();
+  (void)i_len;
+
+  return true;
+}
+
+bool frame2jpg(camera_fb_t *i_fb, uint8_t i_quality, uint8_t **o_out, size_t *o_len) {
+  if (PIXFORMAT_JPEG == i_fb->format) {
+    *o_out = (uint8_t *)malloc(i_fb->len);
+    if (NULL == *o_out) {
+      return false;
+    }
+    memcpy(*o_out, i_fb->buf, i_fb->len);
+    *o_len = i_fb->len;
+    return true;
+  }
+  return fmt2jpg(i_fb->buf, i_fb->len, i_fb->width, i_fb->height, i_fb->format, i_quality, o_out, o_len);
+}
+
+/**
+ * @brief HostRgbDecode struct
+ * output of jpg2rgb888
+ */
+struct HostRgbDecode {
+  const uint8_t *Src;
+  size_t Len;
+  uint8_t *Out;
+  uint16_t Width;
+};
+
+static size_t HostRgb_Reader(void *arg, size_t index, uint8_t *buf, size_t len) {
+  HostRgbDecode *decode = (HostRgbDecode *)arg;
+  len = std::min(len, decode->Len - index);
+  if (NULL != buf) {
+    memcpy(buf, decode->Src + index, len);
+  }
+  return len;
+}
+
+static bool HostRgb_Writer(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  HostRgbDecode *decode = (HostRgbDecode *)arg;
+  if (NULL == data) {
+    if ((0 == x) && (0 == y)) {
+      decode->Width = w;
+    }
+    return true;
+  }
+  for (uint16_t iy = 0; iy < h; iy++) {
+    uint8_t *out = decode->Out + (((size_t)(y + iy) * decode->Width) + x) * 3;
+    for (uint16_t ix = 0; ix < w; ix++) {
+      out[ix * 3 + 0] = data[ix * 3 + 2];
+      out[ix * 3 + 1] = data[ix * 3 + 1];
+      out[ix * 3 + 2] = data[ix * 3 + 0];
+    }
+    data += w * 3;
+  }
+  return true;
+}
+
+bool jpg2rgb888(const uint8_t *i_src, size_t i_len, uint8_t *o_out, jpg_scale_t i_scale) {
+  HostRgbDecode decode = { i_src, i_len, o_out, 0 };
+  return ESP_OK == esp_jpg_decode(i_len, i_scale, HostRgb_Reader, HostRgb_Writer, &decode);
+}
+
+/* ------------------------------ camera ------------------------------ */
+
+static const uint16_t HostFrameSize[FRAMESIZE_INVALID][2] = {
+  { 96, 96 }, { 160, 120 }, { 176, 144 }, { 240, 176 }, { 240, 240 }, { 320, 240 }, { 400, 296 },
+  { 480, 320 }, { 640, 480 }, { 800, 600 }, { 1024, 768 }, { 1280, 720 }, { 1280, 1024 }, { 1600, 1200 },
+};
+
+static std::mutex HostCameraLock;
+static bool HostCameraReady = false;
+static framesize_t HostCameraSize = FRAMESIZE_SVGA;
+static int HostCameraQuality = 12;
+static uint32_t HostCameraCount = 0;
+static int64_t HostCameraLast = 0;
+static std::vector<std::string> HostCameraFiles;
+
+static int HostSensor_Set(sensor_t *, int) {
+  return 0;
+}
+
+static int HostSensor_SetGain(sensor_t *, gainceiling_t) {
+  return 0;
+}
+
+static int HostSensor_SetFramesize(sensor_t *, framesize_t i_size) {
+  std::lock_guard<std::mutex> guard(HostCameraLock);
+  if (i_size >= FRAMESIZE_INVALID) {
+    return -1;
+  }
+  HostCameraSize = i_size;
+  return 0;
+}
+
+static int HostSensor_SetQuality(sensor_t *, int i_quality) {
+  std::lock_guard<std::mutex> guard(HostCameraLock);
+  HostCameraQuality = i_quality;
+  return 0;
+}
+
+static sensor_t HostSensor = {
+  HostSensor_SetFramesize, HostSensor_SetQuality, HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set,
+  HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set,
+  HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_SetGain, HostSensor_Set, HostSensor_Set,
+  HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set, HostSensor_Set,
+};
+
+esp_err_t esp_camera_init(const camera_config_t *i_config) {
+  std::lock_guard<std::mutex> guard(HostCameraLock);
+  if (NULL == i_config) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  HostCameraSize = i_config->frame_size;
+  HostCameraQuality = i_config->jpeg_quality;
+  HostCameraFiles.clear();
+
+  const char *dir = getenv("HOST_CAMERA_DIR");
+  if (NULL != dir) {
+    DIR *d = opendir(dir);
+    if (NULL == d) {
+      return ESP_ERR_NOT_FOUND;
+    }
+    struct dirent *entry;
+    while (NULL != (entry = readdir(d))) {
+      std::string name = entry->d_name;
+      if ((name.size() > 4) && ((0 == strcasecmp(name.c_str() + name.size() - 4, ".jpg")) || (0 == strcasecmp(name.c_str() + name.size() - 5, ".jpeg")))) {
+        HostCameraFiles.push_back(std::string(dir) + "/" + name);
+      }
+    }
+    closedir(d);
+    std::sort(HostCameraFiles.begin(), HostCameraFiles.end());
+    if (HostCameraFiles.empty()) {
+      return ESP_ERR_NOT_FOUND;
+    }
+  }
+  HostCameraReady = true;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_camera_deinit() {
+  std::lock_guard<std::mutex> guard(HostCameraLock);
+  HostCameraReady = false;
+  return ESP_OK;
+}
+
+sensor_t *esp_camera_sensor_get() {
+  return &HostSensor;
+}
+
+/**
+ * @brief Test pattern, gradient with the square. Square moves with HOST_CAMERA_MOTION=1
+ */
+static bool HostCamera_Pattern(uint16_t i_width, uint16_t i_height, uint32_t i_count, std::vector<uint8_t> &o_jpeg) {
+  std::vector<uint8_t> img((size_t)i_width * i_height * 3);
+  const char *motion = getenv("HOST_CAMERA_MOTION");
+  uint16_t size = i_height / 4;
+  uint16_t sx = i_width / 4;
+  if ((NULL != motion) && ('1' == motion[0])) {
+    sx = (uint16_t)((i_count * 8) % (i_width - size));
+  }
+  uint16_t sy = (i_height - size) / 2;
+
+  for (uint16_t y = 0; y < i_height; y++) {
+    for (uint16_t x = 0; x < i_width; x++) {
+      uint8_t *px = &img[((size_t)y * i_width + x) * 3];
+      bool square = (x >= sx) && (x < (sx + size)) && (y >= sy) && (y < (sy + size));
+      /* B,G,R */
+      px[0] = square ? 240 : (uint8_t)(255 * y / i_height);
+      px[1] = square ? 240 : 64;
+      px[2] = square ? 240 : (uint8_t)(255 * x / i_width);
+    }
+  }
+
+  return HostJpeg_Encode(img.data(), i_width, i_height, PIXFORMAT_RGB888, (uint8_t)std::max(5, 100 - (2 * HostCameraQuality)), o_jpeg);
+}
+
+camera_fb_t *esp_camera_fb_get() {
+  std::unique_lock<std::mutex> guard(HostCameraLock);
+  if (false == HostCameraReady) {
+    return NULL;
+  }
+
+  /* frame rate of the sensor */
+  const char *fps = getenv("HOST_CAMERA_FPS");
+  if ((NULL != fps) && (atoi(fps) > 0)) {
+    int64_t next = HostCameraLast + (1000000 / atoi(fps));
+    int64_t now = esp_timer_get_time();
+    if (next > now) {
+      std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+    }
+    HostCameraLast = esp_timer_get_time();
+  }
+
+  std::vector<uint8_t> jpeg;
+  uint16_t width = HostFrameSize[HostCameraSize][0];
+  uint16_t height = HostFrameSize[HostCameraSize][1];
+  if (false == HostCameraFiles.empty()) {
+    const std::string &path = HostCameraFiles[HostCameraCount % HostCameraFiles.size()];
+    FILE *f = fopen(path.c_str(), "rb");
+    if (NULL == f) {
+      return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    jpeg.resize(ftell(f));
+    fseek(f, 0, SEEK_SET);
+    size_t len = fread(jpeg.data(), 1, jpeg.size(), f);
+    fclose(f);
+    jpeg.resize(len);
+
+    struct jpeg_decompress_struct info;
+    HostJpegError error;
+    info.err = jpeg_std_error(&error.Mgr);
+    error.Mgr.error_exit = HostJpeg_ErrorExit;
+    if (0 == setjmp(error.Jump)) {
+      jpeg_create_decompress(&info);
+      jpeg_mem_src(&info, jpeg.data(), jpeg.size());
+      if (JPEG_HEADER_OK == jpeg_read_header(&info, TRUE)) {
+        width = info.image_width;
+        height = info.image_height;
+      }
+    }
+    jpeg_destroy_decompress(&info);
+  } else if (false == HostCamera_Pattern(width, height, HostCameraCount, jpeg)) {
+    return NULL;
+  }
+  HostCameraCount++;
+
+  camera_fb_t *fb = (camera_fb_t *)calloc(1, sizeof(camera_fb_t));
+  fb->buf = (uint8_t *)malloc(jpeg.size());
+  memcpy(fb->buf, jpeg.data(), jpeg.size());
+  fb->len = jpeg.size();
+  fb->width = width;
+  fb->height = height;
+  fb->format = PIXFORMAT_JPEG;
+  gettimeofday(&fb->timestamp, NULL);
+
+  return fb;
+}
+
+void esp_camera_fb_return(camera_fb_t *i_fb) {
+  if (NULL != i_fb) {
+    free(i_fb->buf);
+    free(i_fb);
+  }
+}
+
+/* EOF */
@@ -0,0 +1,718 @@
+/**
+   @file json.cpp
+
+   @brief Host stub of the ArduinoJson 7 subset used by the firmware
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ArduinoJson.h"
+
+#define JSON_NESTING_LIMIT 10   ///< same default as ArduinoJson
+
+/* ------------------------------ document tree ------------------------------ */
+
+void JsonNode::Clear() {
+  Kind = Null;
+  BoolValue = false;
+  SignedValue = 0;
+  UnsignedValue = 0;
+  FloatValue = 0;
+  Float32 = false;
+  TextValue.clear();
+  Items.clear();
+  Members.clear();
+}
+
+void JsonNode::CopyFrom(const JsonNode &i_node) {
+  if (this == &i_node) {
+    return;
+  }
+  Clear();
+  Kind = i_node.Kind;
+  BoolValue = i_node.BoolValue;
+  SignedValue = i_node.SignedValue;
+  UnsignedValue = i_node.UnsignedValue;
+  FloatValue = i_node.FloatValue;
+  Float32 = i_node.Float32;
+  TextValue = i_node.TextValue;
+  for (const auto &item : i_node.Items) {
+    Append()->CopyFrom(*item);
+  }
+  for (const auto &member : i_node.Members) {
+    Member(member.first)->CopyFrom(*member.second);
+  }
+}
+
+JsonNode *JsonNode::Find(const std::string &i_key) const {
+  if (Object != Kind) {
+    return NULL;
+  }
+  for (const auto &member : Members) {
+    if (member.first == i_key) {
+      return member.second.get();
+    }
+  }
+  return NULL;
+}
+
+JsonNode *JsonNode::Member(const std::string &i_key) {
+  if (Object != Kind) {
+    Clear();
+    Kind = Object;
+  }
+  JsonNode *node = Find(i_key);
+  if (NULL == node) {
+    Members.push_back(std::make_pair(i_key, std::make_shared<JsonNode>()));
+    node = Members.back().second.get();
+  }
+  return node;
+}
+
+JsonNode *JsonNode::Append() {
+  if (Array != Kind) {
+    Clear();
+    Kind = Array;
+  }
+  Items.push_back(std::make_shared<JsonNode>());
+  return Items.back().get();
+}
+
+/* ------------------------------ variant ------------------------------ */
+
+JsonVariant &JsonVariant::operator=(const JsonVariant &i_value) {
+  JsonNode *src = i_value.Get();
+  JsonNode *dst = GetOrCreate();
+  if (NULL != dst) {
+    if (NULL == src) {
+      dst->Clear();
+    } else if (src != dst) {
+      JsonNode tmp;
+      tmp.CopyFrom(*src);
+      dst->CopyFrom(tmp);
+    }
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::operator=(const char *i_value) {
+  JsonNode *n = GetOrCreate();
+  if (NULL != n) {
+    n->Clear();
+    if (NULL != i_value) {
+      n->Kind = JsonNode::Text;
+      n->TextValue = i_value;
+    }
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::operator=(bool i_value) {
+  JsonNode *n = GetOrCreate();
+  if (NULL != n) {
+    n->Clear();
+    n->Kind = JsonNode::Bool;
+    n->BoolValue = i_value;
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::operator=(double i_value) {
+  JsonNode *n = GetOrCreate();
+  if (NULL != n) {
+    n->Clear();
+    n->Kind = JsonNode::Float;
+    n->FloatValue = i_value;
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::operator=(float i_value) {
+  operator=((double)i_value);
+  JsonNode *n = Get();
+  if (NULL != n) {
+    n->Float32 = true;
+  }
+  return *this;
+}
+
+/**
+ * @brief Member of the object. Missing member is created as null, same as write access of ArduinoJson
+ */
+JsonVariant JsonVariant::operator[](const char *i_key) {
+  JsonNode *n = GetOrCreate();
+  if ((NULL == n) || (NULL == i_key)) {
+    return JsonVariant();
+  }
+  if (JsonNode::Null == n->Kind) {
+    n->Kind = JsonNode::Object;
+  }
+  if (JsonNode::Object != n->Kind) {
+    return JsonVariant();
+  }
+  return JsonVariant(n, i_key);
+}
+
+JsonVariant JsonVariant::operator[](int i_index) {
+  JsonNode *n = Get();
+  if ((NULL == n) || (JsonNode::Array != n->Kind) || (i_index < 0) || ((size_t)i_index >= n->Items.size())) {
+    return JsonVariant();
+  }
+  return JsonVariant(n->Items[i_index].get());
+}
+
+template <> JsonArray JsonVariant::to<JsonArray>() {
+  JsonNode *n = GetOrCreate();
+  if (NULL == n) {
+    return JsonArray();
+  }
+  n->Clear();
+  n->Kind = JsonNode::Array;
+  return JsonArray(n);
+}
+
+template <> JsonObject JsonVariant::to<JsonObject>() {
+  JsonNode *n = GetOrCreate();
+  if (NULL == n) {
+    return JsonObject();
+  }
+  n->Clear();
+  n->Kind = JsonNode::Object;
+  return JsonObject(n);
+}
+
+template <> JsonArray JsonVariant::as<JsonArray>() const {
+  JsonNode *n = Get();
+  return ((NULL != n) && (JsonNode::Array == n->Kind)) ? JsonArray(n) : JsonArray();
+}
+
+template <> JsonObject JsonVariant::as<JsonObject>() const {
+  JsonNode *n = Get();
+  return ((NULL != n) && (JsonNode::Object == n->Kind)) ? JsonObject(n) : JsonObject();
+}
+
+template <> const char *JsonVariant::as<const char *>() const {
+  JsonNode *n = Get();
+  return ((NULL != n) && (JsonNode::Text == n->Kind)) ? n->TextValue.c_str() : NULL;
+}
+
+template <> String JsonVariant::as<String>() const {
+  JsonNode *n = Get();
+  if ((NULL != n) && (JsonNode::Text == n->Kind)) {
+    return String(n->TextValue);
+  }
+  String ret;
+  serializeJson(*this, ret);
+  return ret;
+}
+
+template <> bool JsonVariant::as<bool>() const {
+  JsonNode *n = Get();
+  if (NULL == n) {
+    return false;
+  }
+  switch (n->Kind) {
+    case JsonNode::Bool:
+      return n->BoolValue;
+    case JsonNode::Signed:
+      return 0 != n->SignedValue;
+    case JsonNode::Unsigned:
+      return 0 != n->UnsignedValue;
+    case JsonNode::Float:
+      return 0 != n->FloatValue;
+    default:
+      return false;
+  }
+}
+
+template <> double JsonVariant::as<double>() const {
+  JsonNode *n = Get();
+  if (NULL == n) {
+    return 0;
+  }
+  switch (n->Kind) {
+    case JsonNode::Bool:
+      return n->BoolValue ? 1 : 0;
+    case JsonNode::Signed:
+      return (double)n->SignedValue;
+    case JsonNode::Unsigned:
+      return (double)n->UnsignedValue;
+    case JsonNode::Float:
+      return n->FloatValue;
+    default:
+      return 0;
+  }
+}
+
+template <> long JsonVariant::as<long>() const {
+  JsonNode *n = Get();
+  if ((NULL != n) && (JsonNode::Unsigned == n->Kind)) {
+    return (long)n->UnsignedValue;
+  }
+  if ((NULL != n) && (JsonNode::Signed == n->Kind)) {
+    return (long)n->SignedValue;
+  }
+  return (long)as<double>();
+}
+
+template <> int JsonVariant::as<int>() const {
+  return (int)as<long>();
+}
+
+JsonVariant::operator const char *() const {
+  return as<const char *>();
+}
+
+JsonVariant::operator JsonArray() const {
+  return as<JsonArray>();
+}
+
+JsonVariant::operator JsonObject() const {
+  return as<JsonObject>();
+}
+
+/* ------------------------------ serializer ------------------------------ */
+
+static void Json_WriteText(std::string &o_out, const std::string &i_text) {
+  o_out += '"';
+  for (unsigned char c : i_text) {
+    switch (c) {
+      case '"':
+        o_out += "\\\"";
+        break;
+      case '\\':
+        o_out += "\\\\";
+        break;
+      case '\b':
+        o_out += "\\b";
+        break;
+      case '\f':
+        o_out += "\\f";
+        break;
+      case '\n':
+        o_out += "\\n";
+        break;
+      case '\r':
+        o_out += "\\r";
+        break;
+      case '\t':
+        o_out += "\\t";
+        break;
+      default:
+        if (c < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          o_out += buf;
+        } else {
+          o_out += (char)c;
+        }
+    }
+  }
+  o_out += '"';
+}
+
+static void Json_Write(std::string &o_out, const JsonNode *i_node) {
+  char buf[32];
+  if (NULL == i_node) {
+    o_out += "null";
+    return;
+  }
+
+  switch (i_node->Kind) {
+    case JsonNode::Null:
+      o_out += "null";
+      break;
+    case JsonNode::Bool:
+      o_out += i_node->BoolValue ? "true" : "false";
+      break;
+    case JsonNode::Signed:
+      snprintf(buf, sizeof(buf), "%lld", (long long)i_node->SignedValue);
+      o_out += buf;
+      break;
+    case JsonNode::Unsigned:
+      snprintf(buf, sizeof(buf), "%llu", (unsigned long long)i_node->UnsignedValue);
+      o_out += buf;
+      break;
+    case JsonNode::Float:
+      if (isnan(i_node->FloatValue) || isinf(i_node->FloatValue)) {
+        o_out += "null";
+      } else {
+        snprintf(buf, sizeof(buf), i_node->Float32 ? "%.7g" : "%.9g", i_node->FloatValue);
+        o_out += buf;
+      }
+      break;
+    case JsonNode::Text:
+      Json_WriteText(o_out, i_node->TextValue);
+      break;
+    case JsonNode::Array:
+      o_out += '[';
+      for (size_t i = 0; i < i_node->Items.size(); i++) {
+        if (i > 0) {
+          o_out += ',';
+        }
+        Json_Write(o_out, i_node->Items[i].get());
+      }
+      o_out += ']';
+      break;
+    case JsonNode::Object:
+      o_out += '{';
+      for (size_t i = 0; i < i_node->Members.size(); i++) {
+        if (i > 0) {
+          o_out += ',';
+        }
+        Json_WriteText(o_out, i_node->Members[i].first);
+        o_out += ':';
+        Json_Write(o_out, i_node->Members[i].second.get());
+      }
+      o_out += '}';
+      break;
+  }
+}
+
+size_t serializeJson(const JsonVariant &i_value, String &o_out) {
+  std::string out;
+  Json_Write(out, i_value.GetNode());
+  o_out = String(out);
+  return out.length();
+}
+
+size_t serializeJson(const JsonDocument &i_doc, String &o_out) {
+  return serializeJson(JsonVariant(i_doc.GetNode()), o_out);
+}
+
+size_t measureJson(const JsonDocument &i_doc) {
+  std::string out;
+  Json_Write(out, i_doc.GetNode());
+  return out.length();
+}
+
+/* ------------------------------ parser ------------------------------ */
+
+/**
+ * @brief JsonParser class
+ * recursive descent parser of the standard JSON
+ */
+class JsonParser {
+private:
+  const char *Pos;
+  const char *End;
+
+  void SkipSpace() {
+    while ((Pos < End) && ((' ' == *Pos) || ('\t' == *Pos) || ('\r' == *Pos) || ('\n' == *Pos))) {
+      Pos++;
+    }
+  }
+
+  bool Literal(const char *i_text) {
+    size_t len = strlen(i_text);
+    if (((size_t)(End - Pos) < len) || (0 != strncmp(Pos, i_text, len))) {
+      return false;
+    }
+    Pos += len;
+    return true;
+  }
+
+  static void AppendUtf8(std::string &o_out, uint32_t i_code) {
+    if (i_code < 0x80) {
+      o_out += (char)i_code;
+    } else if (i_code < 0x800) {
+      o_out += (char)(0xC0 | (i_code >> 6));
+      o_out += (char)(0x80 | (i_code & 0x3F));
+    } else if (i_code < 0x10000) {
+      o_out += (char)(0xE0 | (i_code >> 12));
+      o_out += (char)(0x80 | ((i_code >> 6) & 0x3F));
+      o_out += (char)(0x80 | (i_code & 0x3F));
+    } else {
+      o_out += (char)(0xF0 | (i_code >> 18));
+      o_out += (char)(0x80 | ((i_code >> 12) & 0x3F));
+      o_out += (char)(0x80 | ((i_code >> 6) & 0x3F));
+      o_out += (char)(0x80 | (i_code & 0x3F));
+    }
+  }
+
+  bool Hex4(uint32_t &o_code) {
+    if ((End - Pos) < 4) {
+      return false;
+    }
+    o_code = 0;
+    for (int i = 0; i < 4; i++) {
+      char c = *Pos++;
+      o_code <<= 4;
+      if ((c >= '0') && (c <= '9')) {
+        o_code |= c - '0';
+      } else if ((c >= 'a') && (c <= 'f')) {
+        o_code |= c - 'a' + 10;
+      } else if ((c >= 'A') && (c <= 'F')) {
+        o_code |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  DeserializationError::Code Text(std::string &o_text) {
+    Pos++;
+    while (Pos < End) {
+      char c = *Pos++;
+      if ('"' == c) {
+        return DeserializationError::Ok;
+      }
+      if ('\\' != c) {
+        o_text += c;
+        continue;
+      }
+      if (Pos >= End) {
+        break;
+      }
+      c = *Pos++;
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          o_text += c;
+          break;
+        case 'b':
+          o_text += '\b';
+          break;
+        case 'f':
+          o_text += '\f';
+          break;
+        case 'n':
+          o_text += '\n';
+          break;
+        case 'r':
+          o_text += '\r';
+          break;
+        case 't':
+          o_text += '\t';
+          break;
+        case 'u': {
+          uint32_t code;
+          if (false == Hex4(code)) {
+            return (Pos >= End) ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+          }
+          if ((code >= 0xD800) && (code < 0xDC00) && ((End - Pos) >= 6) && ('\\' == Pos[0]) && ('u' == Pos[1])) {
+            uint32_t low;
+            Pos += 2;
+            if ((false == Hex4(low)) || (low < 0xDC00) || (low > 0xDFFF)) {
+              return DeserializationError::InvalidInput;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          AppendUtf8(o_text, code);
+          break;
+        }
+        default:
+          return DeserializationError::InvalidInput;
+      }
+    }
+    return DeserializationError::IncompleteInput;
+  }
+
+  DeserializationError::Code Number(JsonNode *o_node) {
+    const char *start = Pos;
+    bool real = false;
+    if ((Pos < End) && ('-' == *Pos)) {
+      Pos++;
+    }
+    while ((Pos < End) && (((*Pos >= '0') && (*Pos <= '9')) || ('.' == *Pos) || ('e' == *Pos) || ('E' == *Pos) || ('+' == *Pos) || ('-' == *Pos))) {
+      real |= ('.' == *Pos) || ('e' == *Pos) || ('E' == *Pos);
+      Pos++;
+    }
+    std::string text(start, Pos - start);
+    if (text.empty() || ("-" == text)) {
+      return DeserializationError::InvalidInput;
+    }
+    char *end = NULL;
+    if (false == real) {
+      errno = 0;
+      if ('-' == text[0]) {
+        long long value = strtoll(text.c_str(), &end, 10);
+        if ((0 == errno) && ('\0' == *end)) {
+          o_node->Kind = JsonNode::Signed;
+          o_node->SignedValue = value;
+          return DeserializationError::Ok;
+        }
+      } else {
+        unsigned long long value = strtoull(text.c_str(), &end, 10);
+        if ((0 == errno) && ('\0' == *end)) {
+          o_node->Kind = JsonNode::Unsigned;
+          o_node->UnsignedValue = value;
+          return DeserializationError::Ok;
+        }
+      }
+    }
+    double value = strtod(text.c_str(), &end);
+    if ('\0' != *end) {
+      return DeserializationError::InvalidInput;
+    }
+    o_node->Kind = JsonNode::Float;
+    o_node->FloatValue = value;
+    return DeserializationError::Ok;
+  }
+
+public:
+  JsonParser(const char *i_data, size_t i_len) : Pos(i_data), End(i_data + i_len) {}
+
+  DeserializationError::Code Value(JsonNode *o_node, uint8_t i_depth) {
+    SkipSpace();
+    if (Pos >= End) {
+      return DeserializationError::IncompleteInput;
+    }
+
+    DeserializationError::Code ret = DeserializationError::Ok;
+    switch (*Pos) {
+      case '{':
+        if (i_depth >= JSON_NESTING_LIMIT) {
+          return DeserializationError::TooDeep;
+        }
+        Pos++;
+        o_node->Kind = JsonNode::Object;
+        SkipSpace();
+        if ((Pos < End) && ('}' == *Pos)) {
+          Pos++;
+          return DeserializationError::Ok;
+        }
+        while (true) {
+          SkipSpace();
+          if (Pos >= End) {
+            return DeserializationError::IncompleteInput;
+          }
+          if ('"' != *Pos) {
+            return DeserializationError::InvalidInput;
+          }
+          std::string key;
+          if (DeserializationError::Ok != (ret = Text(key))) {
+            return ret;
+          }
+          SkipSpace();
+          if (Pos >= End) {
+            return DeserializationError::IncompleteInput;
+          }
+          if (':' != *Pos++) {
+            return DeserializationError::InvalidInput;
+          }
+          JsonNode *member = o_node->Member(key);
+          member->Clear();
+          if (DeserializationError::Ok != (ret = Value(member, i_depth + 1))) {
+            return ret;
+          }
+          SkipSpace();
+          if (Pos >= End) {
+            return DeserializationError::IncompleteInput;
+          }
+          char c = *Pos++;
+          if ('}' == c) {
+            return DeserializationError::Ok;
+          }
+          if (',' != c) {
+            return DeserializationError::InvalidInput;
+          }
+        }
+
+      case '[':
+        if (i_depth >= JSON_NESTING_LIMIT) {
+          return DeserializationError::TooDeep;
+        }
+        Pos++;
+        o_node->Kind = JsonNode::Array;
+        SkipSpace();
+        if ((Pos < End) && (']' == *Pos)) {
+          Pos++;
+          return DeserializationError::Ok;
+        }
+        while (true) {
+          if (DeserializationError::Ok != (ret = Value(o_node->Append(), i_depth + 1))) {
+            return ret;
+          }
+          SkipSpace();
+          if (Pos >= End) {
+            return DeserializationError::IncompleteInput;
+          }
+          char c = *Pos++;
+          if (']' == c) {
+            return DeserializationError::Ok;
+          }
+          if (',' != c) {
+            return DeserializationError::InvalidInput;
+          }
+        }
+
+      case '"':
+        o_node->Kind = JsonNode::Text;
+        return Text(o_node->TextValue);
+
+      case 't':
+        if (false == Literal("true")) {
+          return DeserializationError::InvalidInput;
+        }
+        o_node->Kind = JsonNode::Bool;
+        o_node->BoolValue = true;
+        return DeserializationError::Ok;
+
+      case 'f':
+        if (false == Literal("false")) {
+          return DeserializationError::InvalidInput;
+        }
+        o_node->Kind = JsonNode::Bool;
+        o_node->BoolValue = false;
+        return DeserializationError::Ok;
+
+      case 'n':
+        if (false == Literal("null")) {
+          return DeserializationError::InvalidInput;
+        }
+        return DeserializationError::Ok;
+
+      default:
+        return Number(o_node);
+    }
+  }
+};
+
+DeserializationError deserializeJson(JsonDocument &o_doc, const char *i_data) {
+  o_doc.clear();
+  if ((NULL == i_data) || ('\0' == *i_data)) {
+    return DeserializationError(DeserializationError::EmptyInput);
+  }
+  JsonParser parser(i_data, strlen(i_data));
+  DeserializationError::Code ret = parser.Value(o_doc.GetNode(), 0);
+  if (DeserializationError::Ok != ret) {
+    o_doc.clear();
+  }
+  return DeserializationError(ret);
+}
+
+DeserializationError deserializeJson(JsonDocument &o_doc, const String &i_data) {
+  return deserializeJson(o_doc, i_data.c_str());
+}
+
+const char *DeserializationError::c_str() const {
+  switch (ErrorCode) {
+    case Ok:
+      return "Ok";
+    case EmptyInput:
+      return "EmptyInput";
+    case IncompleteInput:
+      return "IncompleteInput";
+    case InvalidInput:
+      return "InvalidInput";
+    case NoMemory:
+      return "NoMemory";
+    case TooDeep:
+      return "TooDeep";
+  }
+  return "Unknown";
+}
+
+/* EOF */
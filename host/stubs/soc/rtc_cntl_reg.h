@@ -0,0 +1,19 @@
+/**
+   @file rtc_cntl_reg.h
+
+   @brief Host stub of the ESP32 RTC control registers
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_RTC_CNTL_REG_H_
+#define _HOST_RTC_CNTL_REG_H_
+
+#define RTC_CNTL_BROWN_OUT_REG 0
+
+#endif
+
+/* EOF */
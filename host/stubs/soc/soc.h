@@ -0,0 +1,20 @@
+/**
+   @file soc.h
+
+   @brief Host stub of the ESP32 register access
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_SOC_H_
+#define _HOST_SOC_H_
+
+#define WRITE_PERI_REG(addr, val) ((void)(addr), (void)(val))
+#define READ_PERI_REG(addr)       ((void)(addr), 0)
+
+#endif
+
+/* EOF */
@@ -0,0 +1,182 @@
+/**
+   @file web_server.cpp
+
+   @brief Host stub of the ESPAsyncWebServer
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <strings.h>
+
+#include "ESPAsyncWebSrv.h"
+
+String AsyncWebServerResponse::GetHeader(const String &i_name) const {
+  for (const auto &header : _headers) {
+    if (true == header.first.equalsIgnoreCase(i_name)) {
+      return header.second;
+    }
+  }
+  return String();
+}
+
+std::string AsyncWebServerResponse::HostRead(size_t i_max, size_t) {
+  return _body.str().substr(0, i_max);
+}
+
+/**
+ * @brief Read the body by the same loop as the TCP stack of the MCU
+ *
+ * @param size_t - maximum count of bytes, for endless stream
+ * @param size_t - size of one TCP buffer
+ * @return std::string - body
+ */
+std::string AsyncAbstractResponse::HostRead(size_t i_max, size_t i_chunk) {
+  std::string ret;
+  std::vector<uint8_t> buf(i_chunk);
+  if (false == _sourceValid()) {
+    return ret;
+  }
+
+  while (ret.size() < i_max) {
+    size_t len = i_chunk;
+    if ((false == _chunked) && (_contentLength > 0)) {
+      if (ret.size() >= _contentLength) {
+        break;
+      }
+      len = std::min(len, _contentLength - ret.size());
+    }
+    len = std::min(len, i_max - ret.size());
+    size_t count = _fillBuffer(buf.data(), len);
+    if (RESPONSE_TRY_AGAIN == count) {
+      continue;
+    }
+    if (0 == count) {
+      break;
+    }
+    ret.append((const char *)buf.data(), count);
+  }
+
+  return ret;
+}
+
+AsyncChunkedResponse::AsyncChunkedResponse(const String &i_type, AwsResponseFiller i_callback) : _filler(i_callback), _index(0) {
+  _code = 200;
+  _contentType = i_type;
+  _sendContentLength = false;
+  _chunked = true;
+}
+
+size_t AsyncChunkedResponse::_fillBuffer(uint8_t *buf, size_t maxLen) {
+  size_t ret = _filler(buf, maxLen, _index);
+  if (RESPONSE_TRY_AGAIN != ret) {
+    _index += ret;
+  }
+  return ret;
+}
+
+AsyncResponseStream::AsyncResponseStream(const String &i_type, size_t i_size) : _index(0) {
+  _code = 200;
+  _contentType = i_type;
+  _buffer.reserve(i_size);
+}
+
+size_t AsyncResponseStream::_fillBuffer(uint8_t *buf, size_t maxLen) {
+  size_t len = std::min(maxLen, _buffer.size() - _index);
+  memcpy(buf, _buffer.data() + _index, len);
+  _index += len;
+  return len;
+}
+
+size_t AsyncResponseStream::write(uint8_t i_c) {
+  return write(&i_c, 1);
+}
+
+size_t AsyncResponseStream::write(const uint8_t *i_buf, size_t i_len) {
+  _buffer.append((const char *)i_buf, i_len);
+  _contentLength = _buffer.size();
+  return i_len;
+}
+
+bool AsyncWebServerRequest::hasParam(const String &i_name, bool, bool) const {
+  for (const auto &param : _params) {
+    if (param.name() == i_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+AsyncWebParameter *AsyncWebServerRequest::getParam(const String &i_name, bool, bool) {
+  for (auto &param : _params) {
+    if (param.name() == i_name) {
+      return &param;
+    }
+  }
+  return NULL;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String &i_name) const {
+  for (const auto &header : _headers) {
+    if (true == header.first.equalsIgnoreCase(i_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+String AsyncWebServerRequest::header(const char *i_name) const {
+  for (const auto &header : _headers) {
+    if (true == header.first.equalsIgnoreCase(i_name)) {
+      return header.second;
+    }
+  }
+  return String();
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *i_response) {
+  delete _response;
+  _response = i_response;
+}
+
+void AsyncWebServerRequest::send(fs::FS &i_fs, const String &i_path, const String &i_type) {
+  File file = i_fs.open(i_path, FILE_READ);
+  if (!file) {
+    send(404);
+    return;
+  }
+  String content;
+  uint8_t buf[512];
+  size_t len;
+  while ((len = file.read(buf, sizeof(buf))) > 0) {
+    content.concat((const char *)buf, len);
+  }
+  send(200, i_type, content);
+}
+
+void AsyncWebServer::on(const char *i_uri, WebRequestMethodComposite i_method, ArRequestHandlerFunction i_fn, ArUploadHandlerFunction i_upload) {
+  Handlers.push_back({ i_uri, i_method, i_fn, i_upload });
+}
+
+/**
+ * @brief Call the handler of the request
+ *
+ * @param AsyncWebServerRequest* - request
+ * @return bool - true if handler was found
+ */
+bool AsyncWebServer::HostDispatch(AsyncWebServerRequest *i_request) {
+  for (const Handler &handler : Handlers) {
+    if ((handler.Uri == i_request->url()) && (handler.Method & i_request->method())) {
+      handler.OnRequest(i_request);
+      return true;
+    }
+  }
+  if (NotFound) {
+    NotFound(i_request);
+  }
+  return false;
+}
+
+/* EOF */
@@ -0,0 +1,194 @@
+/**
+   @file wifi.cpp
+
+   @brief Host stub of the WiFi. Station is connected at once, client is the TCP socket of the host
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "WiFi.h"
+
+#define HOST_CONNECT_TIMEOUT 5000   ///< TCP connect timeout [ms]
+
+WiFiClass WiFi;
+
+WiFiClass::WiFiClass() {
+  Mode = WIFI_MODE_NULL;
+  Status = WL_DISCONNECTED;
+  memset(Bssid, 0, sizeof(Bssid));
+  Channel = 0;
+  TxPower = WIFI_POWER_19_5dBm;
+}
+
+wl_status_t WiFiClass::begin(const char *i_ssid, const char *, int32_t i_channel, const uint8_t *i_bssid, bool i_connect) {
+  Ssid = (NULL != i_ssid) ? i_ssid : "";
+  Channel = (0 != i_channel) ? i_channel : 1;
+  if (NULL != i_bssid) {
+    memcpy(Bssid, i_bssid, sizeof(Bssid));
+  } else {
+    const uint8_t bssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    memcpy(Bssid, bssid, sizeof(Bssid));
+  }
+  if (true == i_connect) {
+    Status = WL_CONNECTED;
+    if ((uint32_t)LocalIp == 0) {
+      LocalIp = IPAddress(127, 0, 0, 1);
+      Mask = IPAddress(255, 0, 0, 0);
+      Gateway = IPAddress(127, 0, 0, 1);
+      Dns = IPAddress(127, 0, 0, 53);
+    }
+  }
+  return Status;
+}
+
+bool WiFiClass::config(IPAddress i_ip, IPAddress i_gateway, IPAddress i_mask, IPAddress i_dns1, IPAddress) {
+  LocalIp = i_ip;
+  Gateway = i_gateway;
+  Mask = i_mask;
+  Dns = i_dns1;
+  return true;
+}
+
+String WiFiClass::BSSIDstr() {
+  char buf[18];
+  snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", Bssid[0], Bssid[1], Bssid[2], Bssid[3], Bssid[4], Bssid[5]);
+  return String(buf);
+}
+
+int WiFiClient::connect(IPAddress i_ip, uint16_t i_port) {
+  return connect(i_ip.toString().c_str(), i_port);
+}
+
+/**
+ * @brief Connect to the server
+ *
+ * @param const char* - hostname
+ * @param uint16_t - port
+ * @return int - 1 = connected
+ */
+int WiFiClient::connect(const char *i_host, uint16_t i_port) {
+  stop();
+
+  struct addrinfo hints;
+  struct addrinfo *result = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if ((0 != getaddrinfo(i_host, String(i_port).c_str(), &hints, &result)) || (NULL == result)) {
+    return 0;
+  }
+
+  int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+  if (fd < 0) {
+    freeaddrinfo(result);
+    return 0;
+  }
+
+  /* connect with timeout */
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  int ret = ::connect(fd, result->ai_addr, result->ai_addrlen);
+  freeaddrinfo(result);
+  if ((ret < 0) && (EINPROGRESS == errno)) {
+    struct pollfd pfd = { fd, POLLOUT, 0 };
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if ((1 == poll(&pfd, 1, HOST_CONNECT_TIMEOUT)) && (0 == getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len)) && (0 == err)) {
+      ret = 0;
+    }
+  }
+  if (ret < 0) {
+    ::close(fd);
+    return 0;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+  int flag = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+  Socket = fd;
+
+  return 1;
+}
+
+size_t WiFiClient::write(uint8_t i_c) {
+  return write(&i_c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *i_buf, size_t i_len) {
+  size_t sent = 0;
+  while ((Socket >= 0) && (sent < i_len)) {
+    ssize_t ret = send(Socket, i_buf + sent, i_len - sent, MSG_NOSIGNAL);
+    if (ret <= 0) {
+      stop();
+      break;
+    }
+    sent += ret;
+  }
+  return sent;
+}
+
+int WiFiClient::available() {
+  int count = 0;
+  if ((Socket < 0) || (0 != ioctl(Socket, FIONREAD, &count))) {
+    return 0;
+  }
+  return count;
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return (1 == read(&c, 1)) ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *o_buf, size_t i_len) {
+  if (Socket < 0) {
+    return -1;
+  }
+  ssize_t ret = recv(Socket, o_buf, i_len, MSG_DONTWAIT);
+  return (ret < 0) ? -1 : (int)ret;
+}
+
+int WiFiClient::peek() {
+  uint8_t c;
+  if ((Socket < 0) || (1 != recv(Socket, &c, 1, MSG_PEEK | MSG_DONTWAIT))) {
+    return -1;
+  }
+  return c;
+}
+
+void WiFiClient::stop() {
+  if (Socket >= 0) {
+    ::close(Socket);
+    Socket = -1;
+  }
+}
+
+/**
+ * @brief Check connection. Same as on the MCU, connection with unread data is still connected
+ *
+ * @return uint8_t - 1 = connected
+ */
+uint8_t WiFiClient::connected() {
+  if (Socket < 0) {
+    return 0;
+  }
+  uint8_t c;
+  ssize_t ret = recv(Socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  if ((0 == ret) || ((ret < 0) && (EAGAIN != errno) && (EWOULDBLOCK != errno))) {
+    return 0;
+  }
+  return 1;
+}
+
+/* EOF */
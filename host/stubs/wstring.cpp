@@ -0,0 +1,251 @@
+/**
+   @file wstring.cpp
+
+   @brief Host stub of the Arduino String, Print, Stream and IPAddress classes
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "Arduino.h"
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+std::string String::FromUnsigned(unsigned long long i_val, uint8_t i_base) {
+  if ((i_base < 2) || (i_base > 36)) {
+    i_base = 10;
+  }
+  std::string ret;
+  do {
+    uint8_t digit = i_val % i_base;
+    ret.insert(ret.begin(), (char)((digit < 10) ? ('0' + digit) : ('a' + digit - 10)));
+    i_val /= i_base;
+  } while (i_val > 0);
+  return ret;
+}
+
+std::string String::FromSigned(long long i_val, uint8_t i_base) {
+  if ((i_val < 0) && (10 == i_base)) {
+    return "-" + FromUnsigned((unsigned long long)(-(i_val + 1)) + 1, i_base);
+  }
+  return FromUnsigned((unsigned long long)i_val, i_base);
+}
+
+std::string String::FromDouble(double i_val, unsigned int i_decimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", i_decimals, i_val);
+  return buf;
+}
+
+bool String::equalsIgnoreCase(const String &i_str) const {
+  return (s.length() == i_str.s.length()) && (0 == strcasecmp(s.c_str(), i_str.s.c_str()));
+}
+
+int String::indexOf(char i_c, unsigned int i_from) const {
+  size_t pos = s.find(i_c, i_from);
+  return (std::string::npos == pos) ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &i_str, unsigned int i_from) const {
+  size_t pos = s.find(i_str.s, i_from);
+  return (std::string::npos == pos) ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char i_c) const {
+  size_t pos = s.rfind(i_c);
+  return (std::string::npos == pos) ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String &i_str) const {
+  size_t pos = s.rfind(i_str.s);
+  return (std::string::npos == pos) ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int i_from) const {
+  return substring(i_from, s.length());
+}
+
+String String::substring(unsigned int i_from, unsigned int i_to) const {
+  if (i_from > i_to) {
+    unsigned int tmp = i_from;
+    i_from = i_to;
+    i_to = tmp;
+  }
+  if (i_from >= s.length()) {
+    return String();
+  }
+  if (i_to > s.length()) {
+    i_to = s.length();
+  }
+  return String(s.substr(i_from, i_to - i_from));
+}
+
+void String::replace(char i_find, char i_replace) {
+  for (char &c : s) {
+    if (c == i_find) {
+      c = i_replace;
+    }
+  }
+}
+
+void String::replace(const String &i_find, const String &i_replace) {
+  if (i_find.s.empty()) {
+    return;
+  }
+  size_t pos = 0;
+  while (std::string::npos != (pos = s.find(i_find.s, pos))) {
+    s.replace(pos, i_find.s.length(), i_replace.s);
+    pos += i_replace.s.length();
+  }
+}
+
+void String::remove(unsigned int i_index) {
+  if (i_index < s.length()) {
+    s.erase(i_index);
+  }
+}
+
+void String::remove(unsigned int i_index, unsigned int i_count) {
+  if (i_index < s.length()) {
+    s.erase(i_index, i_count);
+  }
+}
+
+void String::toLowerCase() {
+  for (char &c : s) {
+    c = tolower((unsigned char)c);
+  }
+}
+
+void String::toUpperCase() {
+  for (char &c : s) {
+    c = toupper((unsigned char)c);
+  }
+}
+
+void String::trim() {
+  size_t begin = s.find_first_not_of(" \t\r\n\f\v");
+  if (std::string::npos == begin) {
+    s.clear();
+    return;
+  }
+  size_t end = s.find_last_not_of(" \t\r\n\f\v");
+  s = s.substr(begin, end - begin + 1);
+}
+
+long String::toInt() const {
+  return strtol(s.c_str(), NULL, 10);
+}
+
+float String::toFloat() const {
+  return (float)toDouble();
+}
+
+double String::toDouble() const {
+  return strtod(s.c_str(), NULL);
+}
+
+void String::getBytes(unsigned char *i_buf, unsigned int i_size, unsigned int i_index) const {
+  if ((NULL == i_buf) || (0 == i_size)) {
+    return;
+  }
+  size_t len = 0;
+  if (i_index < s.length()) {
+    len = s.length() - i_index;
+    if (len > (i_size - 1)) {
+      len = i_size - 1;
+    }
+    memcpy(i_buf, s.c_str() + i_index, len);
+  }
+  i_buf[len] = '\0';
+}
+
+size_t Print::printf(const char *i_format, ...) {
+  va_list args;
+  va_start(args, i_format);
+  char *buf = NULL;
+  int len = vasprintf(&buf, i_format, args);
+  va_end(args);
+  if (len < 0) {
+    return 0;
+  }
+  size_t ret = write((const uint8_t *)buf, len);
+  free(buf);
+  return ret;
+}
+
+size_t Stream::readBytes(uint8_t *i_buf, size_t i_len) {
+  size_t count = 0;
+  unsigned long start = millis();
+  while ((count < i_len) && ((millis() - start) < Timeout)) {
+    int c = read();
+    if (c < 0) {
+      delay(1);
+      continue;
+    }
+    i_buf[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+String Stream::readString() {
+  String ret;
+  unsigned long start = millis();
+  while ((millis() - start) < Timeout) {
+    int c = read();
+    if (c < 0) {
+      if (0 == available()) {
+        break;
+      }
+      continue;
+    }
+    ret.concat((char)c);
+  }
+  return ret;
+}
+
+String Stream::readStringUntil(char i_terminator) {
+  String ret;
+  unsigned long start = millis();
+  while ((millis() - start) < Timeout) {
+    int c = read();
+    if (c < 0) {
+      delay(1);
+      continue;
+    }
+    if (c == i_terminator) {
+      break;
+    }
+    ret.concat((char)c);
+  }
+  return ret;
+}
+
+bool IPAddress::fromString(const char *i_str) {
+  unsigned int a, b, c, d;
+  char tail;
+  if ((NULL == i_str) || (4 != sscanf(i_str, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail)) || (a > 255) || (b > 255) || (c > 255) || (d > 255)) {
+    return false;
+  }
+  Bytes[0] = a;
+  Bytes[1] = b;
+  Bytes[2] = c;
+  Bytes[3] = d;
+  return true;
+}
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", Bytes[0], Bytes[1], Bytes[2], Bytes[3]);
+  return String(buf);
+}
+
+/* EOF */
@@ -0,0 +1,196 @@
+/**
+   @file make_fixtures.cpp
+
+   @brief Generator of the JPEG sequences for the test of the print failure heuristic. Synthetic print bed with
+          the printed part, frames differ by the sensor noise. Sequences are committed in the directory
+          host/tests/fixtures/, generator is kept for the regeneration
+
+     static     640x480, part is not moved                      (analysis decodes with the scale 1/4)
+     detached   320x240, part is knocked off from the 5th frame (scale 1/2)
+     spaghetti  256x192, filament strings from the 5th frame    (without scale)
+
+   Usage: make_fixtures <output directory>
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "img_converters.h"
+
+#define FIXTURE_FRAMES   8    ///< count of the frames in the sequence
+#define FIXTURE_EVENT    4    ///< first frame with the failure
+#define FIXTURE_QUALITY  85   ///< JPEG quality
+
+/**
+ * @brief Scene of the frame, position of the part is in the per mille of the frame
+ */
+struct FixtureScene {
+  uint16_t PartX;        ///< left side of the part
+  uint16_t PartY;        ///< top side of the part
+  uint16_t PartWidth;    ///< width of the part
+  uint16_t PartHeight;   ///< height of the part
+  uint8_t Strings;       ///< count of the filament strings
+};
+
+static uint32_t Fixture_Random(uint32_t *io_seed) {
+  *io_seed = (*io_seed * 1103515245UL) + 12345UL;
+  return (*io_seed >> 16) & 0x7fff;
+}
+
+/**
+ * @brief Fixed texture of the print sheet, the same in all frames
+ */
+static int Fixture_Sheet(uint16_t i_x, uint16_t i_y) {
+  uint32_t h = ((uint32_t)i_x * 73856093UL) ^ ((uint32_t)i_y * 19349663UL);
+  h ^= h >> 13;
+  h *= 0x5bd1e995UL;
+  h ^= h >> 15;
+  return (int)(h % 9) - 4;
+}
+
+/**
+ * @brief Render the scene to the B,G,R image
+ *
+ * @param FixtureScene& - scene
+ * @param uint16_t - width [px]
+ * @param uint16_t - height [px]
+ * @param uint32_t - seed of the sensor noise
+ * @return std::vector<uint8_t> - image
+ */
+static std::vector<uint8_t> Fixture_Render(const FixtureScene &i_scene, uint16_t i_width, uint16_t i_height, uint32_t i_seed) {
+  std::vector<uint8_t> img((size_t)i_width * i_height * 3);
+  uint16_t px0 = (uint32_t)i_scene.PartX * i_width / 1000;
+  uint16_t py0 = (uint32_t)i_scene.PartY * i_height / 1000;
+  uint16_t px1 = (uint32_t)(i_scene.PartX + i_scene.PartWidth) * i_width / 1000;
+  uint16_t py1 = (uint32_t)(i_scene.PartY + i_scene.PartHeight) * i_height / 1000;
+  uint16_t grid = i_width / 8;
+  uint16_t layer = (i_height / 60) + 1;
+
+  for (uint16_t y = 0; y < i_height; y++) {
+    for (uint16_t x = 0; x < i_width; x++) {
+      int r, g, b;
+      if ((x >= px0) && (x < px1) && (y >= py0) && (y < py1)) {
+        /* orange part with the layer lines */
+        int shade = (0 == (y % layer)) ? -20 : 0;
+        r = 240 + shade;
+        g = 170 + shade;
+        b = 60 + shade;
+      } else {
+        /* dark print sheet with the grid */
+        int v = 35 + Fixture_Sheet(x, y);
+        if ((0 == (x % grid)) || (0 == (y % grid))) {
+          v -= 12;
+        }
+        r = v;
+        g = v + 5;
+        b = v;
+      }
+
+      int noise = (int)(Fixture_Random(&i_seed) % 7) - 3;
+      uint8_t *p = &img[((size_t)y * i_width + x) * 3];
+      p[0] = (uint8_t)std::min(255, std::max(0, b + noise));
+      p[1] = (uint8_t)std::min(255, std::max(0, g + noise));
+      p[2] = (uint8_t)std::min(255, std::max(0, r + noise));
+    }
+  }
+
+  /* light filament strings over the part, random walk with the fixed seed */
+  uint32_t seed = 4242;
+  for (uint8_t s = 0; s < i_scene.Strings; s++) {
+    int x = (int)(px0 + (Fixture_Random(&seed) % (px1 - px0)));
+    int y = (int)(py0 + (Fixture_Random(&seed) % (py1 - py0)));
+    int dx = (int)(Fixture_Random(&seed) % 3) - 1;
+    int dy = (int)(Fixture_Random(&seed) % 3) - 1;
+    for (uint16_t i = 0; i < (i_width / 2); i++) {
+      if (0 == (Fixture_Random(&seed) % 4)) {
+        dx = (int)(Fixture_Random(&seed) % 3) - 1;
+        dy = (int)(Fixture_Random(&seed) % 3) - 1;
+      }
+      x += dx;
+      y += dy;
+      if ((x < 0) || (y < 0) || (x >= i_width) || (y >= i_height)) {
+        break;
+      }
+      uint8_t *p = &img[((size_t)y * i_width + x) * 3];
+      p[0] = 250;
+      p[1] = 250;
+      p[2] = 250;
+    }
+  }
+
+  return img;
+}
+
+/**
+ * @brief Render and save the sequence
+ *
+ * @param std::string& - output directory
+ * @param const char* - name of the sequence
+ * @param uint16_t - width [px]
+ * @param uint16_t - height [px]
+ * @param FixtureScene& - scene before the failure
+ * @param FixtureScene& - scene after the failure
+ * @return bool - true if all frames were saved
+ */
+static bool Fixture_Sequence(const std::string &i_dir, const char *i_name, uint16_t i_width, uint16_t i_height,
+                             const FixtureScene &i_before, const FixtureScene &i_after) {
+  std::string dir = i_dir + "/" + i_name;
+  mkdir(dir.c_str(), 0755);
+
+  for (uint8_t i = 0; i < FIXTURE_FRAMES; i++) {
+    std::vector<uint8_t> img = Fixture_Render((i < FIXTURE_EVENT) ? i_before : i_after, i_width, i_height, 1000 + i);
+    uint8_t *jpeg = NULL;
+    size_t len = 0;
+    if (false == fmt2jpg(img.data(), img.size(), i_width, i_height, PIXFORMAT_RGB888, FIXTURE_QUALITY, &jpeg, &len)) {
+      return false;
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "/%03u.jpg", i);
+    FILE *f = fopen((dir + name).c_str(), "wb");
+    bool ok = (NULL != f) && (len == fwrite(jpeg, 1, len, f));
+    if (NULL != f) {
+      fclose(f);
+    }
+    free(jpeg);
+    if (false == ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <output directory>\n", argv[0]);
+    return 2;
+  }
+
+  std::string dir = argv[1];
+  FixtureScene part = { 400, 450, 200, 250, 0 };
+  FixtureScene detached = { 620, 780, 250, 150, 0 };
+  FixtureScene spaghetti = { 400, 450, 200, 250, 12 };
+
+  bool ok = Fixture_Sequence(dir, "static", 640, 480, part, part);
+  ok = ok && Fixture_Sequence(dir, "detached", 320, 240, part, detached);
+  ok = ok && Fixture_Sequence(dir, "spaghetti", 256, 192, part, spaghetti);
+  if (false == ok) {
+    fprintf(stderr, "Fixtures are not saved to %s\n", dir.c_str());
+    return 1;
+  }
+
+  return 0;
+}
+
+/* EOF */
@@ -0,0 +1,33 @@
+/**
+   @file host_test.h
+
+   @brief Minimal check macros of the host tests. Test fails with non-zero exit code
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+
+#include <stdio.h>
+
+static int HostTest_Failed = 0;   ///< count of failed checks
+
+#define TEST_CHECK(cond)                                                      \
+  do {                                                                        \
+    if (!(cond)) {                                                            \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      HostTest_Failed++;                                                      \
+    }                                                                         \
+  } while (0)
+
+#define TEST_RESULT()                                                   \
+  ((0 == HostTest_Failed) ? (printf("OK\n"), 0)                         \
+                          : (fprintf(stderr, "%d check(s) failed\n", HostTest_Failed), 1))
+
+#endif
+
+/* EOF */
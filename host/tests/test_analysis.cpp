@@ -0,0 +1,340 @@
+/**
+   @file test_analysis.cpp
+
+   @brief Test of the print failure heuristic. Decoded gray frame sequences are fed to the background model
+          and to the metrics of the regions of interest. JPEG sequences from the directory tests/fixtures/
+          are passed through Submit() and Process() like photos from the camera, with the decoder and the scale selection
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <stdio.h>
+#include <vector>
+
+#include "host_test.h"
+
+#include "mcu_cfg.h"
+#include "log.h"
+#include "cfg.h"
+#include "analysis.h"
+#include "photo_store.h"
+
+#define TEST_WIDTH   64   ///< width of the gray frames [px]
+#define TEST_HEIGHT  48   ///< height of the gray frames [px]
+
+typedef std::vector<uint8_t> TestGray;
+
+/**
+ * @brief Access to the internal state of the analysis
+ */
+class FrameAnalysisTest {
+public:
+  static void Feed(FrameAnalysis &a, const TestGray &i_gray, uint16_t i_width = TEST_WIDTH, uint16_t i_height = TEST_HEIGHT) {
+    memcpy(a.Gray, i_gray.data(), i_gray.size());
+    a.Update(true, i_width, i_height);
+  }
+  static void FeedError(FrameAnalysis &a) { a.Update(false, 0, 0); }
+  static const AnalysisRoiResult &Result(FrameAnalysis &a, uint8_t i_roi) { return a.Result[i_roi]; }
+  static uint8_t Background(FrameAnalysis &a, uint32_t i_index) { return a.Background[i_index] >> 4; }
+  static uint32_t BackgroundFrames(FrameAnalysis &a) { return a.BackgroundFrames; }
+  static uint32_t Frames(FrameAnalysis &a) { return a.Frames; }
+  static uint32_t Errors(FrameAnalysis &a) { return a.Errors; }
+  static uint16_t Width(FrameAnalysis &a) { return a.Width; }
+  static uint16_t Height(FrameAnalysis &a) { return a.Height; }
+  static bool LockFree(FrameAnalysis &a) {
+    if (pdTRUE != xSemaphoreTake(a.Lock, 0)) {
+      return false;
+    }
+    xSemaphoreGive(a.Lock);
+    return true;
+  }
+};
+
+static TestGray Test_Flat(uint8_t i_value, uint16_t i_width = TEST_WIDTH, uint16_t i_height = TEST_HEIGHT) {
+  return TestGray((size_t)i_width * i_height, i_value);
+}
+
+static TestGray Test_Checkerboard(uint8_t i_a, uint8_t i_b) {
+  TestGray ret(TEST_WIDTH * TEST_HEIGHT);
+  for (uint16_t y = 0; y < TEST_HEIGHT; y++) {
+    for (uint16_t x = 0; x < TEST_WIDTH; x++) {
+      ret[(y * TEST_WIDTH) + x] = ((x + y) & 1) ? i_b : i_a;
+    }
+  }
+  return ret;
+}
+
+/**
+ * @brief Frame with the changed right half
+ */
+static TestGray Test_RightHalf(uint8_t i_left, uint8_t i_right) {
+  TestGray ret(TEST_WIDTH * TEST_HEIGHT);
+  for (uint16_t y = 0; y < TEST_HEIGHT; y++) {
+    for (uint16_t x = 0; x < TEST_WIDTH; x++) {
+      ret[(y * TEST_WIDTH) + x] = (x < (TEST_WIDTH / 2)) ? i_left : i_right;
+    }
+  }
+  return ret;
+}
+
+static void Test_Warmup(FrameAnalysis &a, uint8_t i_value) {
+  a.ResetBackground();
+  for (uint8_t i = 0; i < ANALYSIS_WARMUP_FRAMES; i++) {
+    FrameAnalysisTest::Feed(a, Test_Flat(i_value));
+  }
+}
+
+/**
+ * @brief Background model and change metric of the full frame region
+ */
+static void Test_Change(FrameAnalysis &a) {
+  /* metrics are not computed during warm-up */
+  Test_Warmup(a, 100);
+  TEST_CHECK(ANALYSIS_WARMUP_FRAMES == FrameAnalysisTest::BackgroundFrames(a));
+  TEST_CHECK(100 == FrameAnalysisTest::Background(a, 0));
+  TEST_CHECK(0 == FrameAnalysisTest::Result(a, 0).Change);
+
+  /* static scene */
+  for (uint8_t i = 0; i < 5; i++) {
+    FrameAnalysisTest::Feed(a, Test_Flat(100));
+  }
+  TEST_CHECK((0 == FrameAnalysisTest::Result(a, 0).Change) && (0 == FrameAnalysisTest::Result(a, 0).Texture));
+  TEST_CHECK(false == a.GetAlarm());
+
+  /* event is raised after ANALYSIS_CONFIRM_FRAMES consecutive frames, only once */
+  uint32_t events = a.GetEvents();
+  for (uint8_t i = 1; i <= ANALYSIS_CONFIRM_FRAMES + 2; i++) {
+    FrameAnalysisTest::Feed(a, Test_Flat(200));
+    TEST_CHECK(FrameAnalysisTest::Result(a, 0).Change >= FACTORY_CFG_ANALYSIS_CHANGE);
+    TEST_CHECK((i >= ANALYSIS_CONFIRM_FRAMES) == a.GetAlarm());
+  }
+  TEST_CHECK((events + 1) == a.GetEvents());
+
+  /* first frame after event moves background by 1/ANALYSIS_BACKGROUND_WEIGHT of the difference */
+  a.ResetBackground();
+  FrameAnalysisTest::Feed(a, Test_Flat(100));
+  FrameAnalysisTest::Feed(a, Test_Flat(200));
+  TEST_CHECK((100 + (100 / ANALYSIS_BACKGROUND_WEIGHT)) == FrameAnalysisTest::Background(a, 0));
+
+  /* background converges to the new scene and alarm is cleared */
+  for (uint16_t i = 0; i < (ANALYSIS_BACKGROUND_WEIGHT * 8); i++) {
+    FrameAnalysisTest::Feed(a, Test_Flat(200));
+  }
+  TEST_CHECK(FrameAnalysisTest::Background(a, (TEST_WIDTH * TEST_HEIGHT) - 1) >= 199);
+  TEST_CHECK(FrameAnalysisTest::Result(a, 0).Change <= 1);
+  TEST_CHECK(0 == FrameAnalysisTest::Result(a, 0).Confirm);
+  TEST_CHECK(false == a.GetAlarm());
+}
+
+/**
+ * @brief Texture metric against the flat background
+ */
+static void Test_Texture(FrameAnalysis &a) {
+  Test_Warmup(a, 100);
+  uint32_t events = a.GetEvents();
+
+  /* change 30 is under threshold, texture 120 over flat background is over threshold */
+  for (uint8_t i = 0; i < ANALYSIS_CONFIRM_FRAMES; i++) {
+    FrameAnalysisTest::Feed(a, Test_Checkerboard(70, 130));
+  }
+  const AnalysisRoiResult &r = FrameAnalysisTest::Result(a, 0);
+  TEST_CHECK(r.Change < FACTORY_CFG_ANALYSIS_CHANGE);
+  TEST_CHECK(120 == r.Texture);
+  TEST_CHECK(r.TextureBackground < r.Texture);
+  TEST_CHECK((true == a.GetAlarm()) && ((events + 1) == a.GetEvents()));
+
+  /* metrics are saturated */
+  Test_Warmup(a, 100);
+  FrameAnalysisTest::Feed(a, Test_Checkerboard(0, 255));
+  TEST_CHECK(255 == FrameAnalysisTest::Result(a, 0).Texture);
+}
+
+/**
+ * @brief Regions of interest see only own part of the frame
+ */
+static void Test_Regions(FrameAnalysis &a) {
+  AnalysisRoi_struct left = { 0, 0, 50, 100, 40, 0 };
+  AnalysisRoi_struct right = { 50, 0, 50, 100, 40, 0 };
+  AnalysisRoi_struct tiny = { 0, 0, 1, 1, 1, 1 };
+  TEST_CHECK(true == a.SetRoi(1, left));
+  TEST_CHECK(true == a.SetRoi(2, right));
+  TEST_CHECK(true == a.SetRoi(3, tiny));
+  AnalysisRoi_struct invalid = { 60, 0, 50, 100, 40, 0 };
+  TEST_CHECK(false == a.SetRoi(1, invalid));
+  TEST_CHECK(false == a.SetRoi(ANALYSIS_MAX_ROI, left));
+
+  Test_Warmup(a, 100);
+  FrameAnalysisTest::Feed(a, Test_RightHalf(100, 200));
+  TEST_CHECK(0 == FrameAnalysisTest::Result(a, 1).Change);
+  TEST_CHECK(100 == FrameAnalysisTest::Result(a, 2).Change);
+  /* full frame region sees the half of the change */
+  TEST_CHECK((FrameAnalysisTest::Result(a, 0).Change > 40) && (FrameAnalysisTest::Result(a, 0).Change < 60));
+
+  /* region smaller than 2x2 px is not evaluated */
+  TEST_CHECK((0 == FrameAnalysisTest::Result(a, 3).Change) && (0 == FrameAnalysisTest::Result(a, 3).Confirm));
+
+  AnalysisRoi_struct disabled = { 0, 0, 0, 0, 0, 0 };
+  for (uint8_t i = 1; i < ANALYSIS_MAX_ROI; i++) {
+    a.SetRoi(i, disabled);
+  }
+}
+
+/**
+ * @brief New resolution resets background model, failed decode is counted
+ */
+static void Test_Resolution(FrameAnalysis &a) {
+  Test_Warmup(a, 100);
+  FrameAnalysisTest::Feed(a, Test_Flat(200));
+  TEST_CHECK(0 != FrameAnalysisTest::Result(a, 0).Change);
+
+  FrameAnalysisTest::Feed(a, Test_Flat(200, TEST_WIDTH / 2, TEST_HEIGHT / 2), TEST_WIDTH / 2, TEST_HEIGHT / 2);
+  TEST_CHECK(1 == FrameAnalysisTest::BackgroundFrames(a));
+  TEST_CHECK(0 == FrameAnalysisTest::Result(a, 0).Change);
+  TEST_CHECK(false == a.GetAlarm());
+
+  uint32_t frames = FrameAnalysisTest::Frames(a);
+  uint32_t errors = FrameAnalysisTest::Errors(a);
+  FrameAnalysisTest::FeedError(a);
+  TEST_CHECK((frames == FrameAnalysisTest::Frames(a)) && ((errors + 1) == FrameAnalysisTest::Errors(a)));
+  TEST_CHECK(1 == FrameAnalysisTest::BackgroundFrames(a));
+  TEST_CHECK(true == FrameAnalysisTest::LockFree(a));
+}
+
+/**
+ * @brief Pass the photo through the analysis like the photo from the camera. Analysis task is the test itself
+ *
+ * @param FrameAnalysis& - analysis
+ * @param std::vector<uint8_t>& - JPEG
+ * @param uint16_t - width of the photo [px]
+ * @param uint16_t - height of the photo [px]
+ */
+static void Test_SubmitPhoto(FrameAnalysis &a, const std::vector<uint8_t> &i_jpeg, uint16_t i_width, uint16_t i_height) {
+  PhotoFrame *frame = SystemPhotoStore.Allocate(i_jpeg.size());
+  TEST_CHECK(NULL != frame);
+  if (NULL == frame) {
+    return;
+  }
+  memcpy(frame->Buf, i_jpeg.data(), i_jpeg.size());
+  frame->Len = i_jpeg.size();
+  frame->Width = i_width;
+  frame->Height = i_height;
+
+  a.Submit(frame);
+  SystemPhotoStore.Release(frame);
+  TEST_CHECK(1 == ulTaskNotifyTake(pdTRUE, 0));
+  a.Process();
+}
+
+/**
+ * @brief Pass the JPEG sequence through the analysis
+ *
+ * @param FrameAnalysis& - analysis
+ * @param const char* - name of the sequence in the fixtures directory
+ * @param uint16_t - width of the photos [px]
+ * @param uint16_t - height of the photos [px]
+ * @return uint8_t - count of the passed photos
+ */
+static uint8_t Test_SubmitSequence(FrameAnalysis &a, const char *i_name, uint16_t i_width, uint16_t i_height) {
+  uint8_t ret = 0;
+  for (;; ret++) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s/%03u.jpg", HOST_FIXTURES_DIR, i_name, ret);
+    FILE *f = fopen(path, "rb");
+    if (NULL == f) {
+      break;
+    }
+    std::vector<uint8_t> jpeg;
+    uint8_t buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), f)) > 0) {
+      jpeg.insert(jpeg.end(), buf, buf + len);
+    }
+    fclose(f);
+
+    Test_SubmitPhoto(a, jpeg, i_width, i_height);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief JPEG sequences of the static scene, detached part and spaghetti. Region is set over the printed part
+ */
+static void Test_Fixtures(FrameAnalysis &a) {
+  AnalysisRoi_struct part = { 35, 40, 30, 35, FACTORY_CFG_ANALYSIS_CHANGE, FACTORY_CFG_ANALYSIS_TEXTURE };
+  TEST_CHECK(true == a.SetRoi(1, part));
+
+  Task_FrameAnalysis = xTaskGetCurrentTaskHandle();
+  uint32_t frames = FrameAnalysisTest::Frames(a);
+  uint32_t errors = FrameAnalysisTest::Errors(a);
+
+  /* static scene, 640x480 is decoded with the scale 1/4 */
+  a.ResetBackground();
+  uint32_t events = a.GetEvents();
+  uint8_t count = Test_SubmitSequence(a, "static", 640, 480);
+  TEST_CHECK(count >= (ANALYSIS_WARMUP_FRAMES + ANALYSIS_CONFIRM_FRAMES));
+  TEST_CHECK((160 == FrameAnalysisTest::Width(a)) && (120 == FrameAnalysisTest::Height(a)));
+  TEST_CHECK((false == a.GetAlarm()) && (events == a.GetEvents()));
+  frames += count;
+
+  /* part is knocked off, 320x240 is decoded with the scale 1/2 */
+  a.ResetBackground();
+  events = a.GetEvents();
+  count = Test_SubmitSequence(a, "detached", 320, 240);
+  TEST_CHECK((160 == FrameAnalysisTest::Width(a)) && (120 == FrameAnalysisTest::Height(a)));
+  TEST_CHECK(FrameAnalysisTest::Result(a, 1).Change >= FACTORY_CFG_ANALYSIS_CHANGE);
+  TEST_CHECK((true == a.GetAlarm()) && ((events + 1) == a.GetEvents()));
+  frames += count;
+
+  /* filament strings change the texture more than the brightness, 256x192 is decoded without scale */
+  a.ResetBackground();
+  events = a.GetEvents();
+  count = Test_SubmitSequence(a, "spaghetti", 256, 192);
+  const AnalysisRoiResult &r = FrameAnalysisTest::Result(a, 1);
+  TEST_CHECK((256 == FrameAnalysisTest::Width(a)) && (192 == FrameAnalysisTest::Height(a)));
+  TEST_CHECK(r.Change < FACTORY_CFG_ANALYSIS_CHANGE);
+  TEST_CHECK(r.Texture >= (r.TextureBackground + FACTORY_CFG_ANALYSIS_TEXTURE));
+  TEST_CHECK((true == a.GetAlarm()) && ((events + 1) == a.GetEvents()));
+  frames += count;
+
+  /* all photos were decoded, broken JPEG is counted as error */
+  TEST_CHECK((frames == FrameAnalysisTest::Frames(a)) && (errors == FrameAnalysisTest::Errors(a)));
+  std::vector<uint8_t> broken(1024, 0x55);
+  Test_SubmitPhoto(a, broken, 640, 480);
+  TEST_CHECK((frames == FrameAnalysisTest::Frames(a)) && ((errors + 1) == FrameAnalysisTest::Errors(a)));
+
+  /* analysis is idle, photo references are returned to the store */
+  a.Submit(NULL);
+  TEST_CHECK(0 == ulTaskNotifyTake(pdTRUE, 0));
+  Task_FrameAnalysis = NULL;
+  AnalysisRoi_struct disabled = { 0, 0, 0, 0, 0, 0 };
+  a.SetRoi(1, disabled);
+}
+
+int main() {
+  EEPROM.begin(EEPROM_SIZE);
+  SystemLog.SetLogLevel(LogLevel_Error);
+  SystemLog.Init();
+  SystemConfig.Init();
+
+  FrameAnalysis analysis(&SystemConfig, &SystemLog);
+  analysis.Init();
+
+  Test_Change(analysis);
+  Test_Texture(analysis);
+  Test_Regions(analysis);
+  Test_Resolution(analysis);
+  analysis.SetEnable(true);
+  Test_Fixtures(analysis);
+
+  JsonDocument doc;
+  TEST_CHECK(!deserializeJson(doc, analysis.GetJson()));
+  TEST_CHECK(ANALYSIS_MAX_ROI == doc["roi"].as<JsonArray>().size());
+
+  return TEST_RESULT();
+}
+
+/* EOF */
@@ -0,0 +1,119 @@
+/**
+   @file test_firmware_core.cpp
+
+   @brief Smoke test of the host build. Firmware modules are initialized in the same order as in setup(),
+          photo is captured from the stub camera and read by the WEB server handlers
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include "host_test.h"
+
+#include "mcu_cfg.h"
+#include "log.h"
+#include "cfg.h"
+#include "camera.h"
+#include "photo_store.h"
+#include "thumbnail.h"
+#include "server.h"
+#include "stream.h"
+#include "system.h"
+#include "wifi_mngt.h"
+
+/**
+ * @brief Call the handler of the WEB server
+ *
+ * @param const char* - URL
+ * @param AsyncWebServerRequest& - request
+ * @return std::string - body of the response
+ */
+static std::string Test_Get(AsyncWebServerRequest &request) {
+  TEST_CHECK(true == server.HostDispatch(&request));
+  AsyncWebServerResponse *response = request.GetResponse();
+  TEST_CHECK(NULL != response);
+  return (NULL == response) ? std::string() : response->HostRead();
+}
+
+int main() {
+  EEPROM.begin(EEPROM_SIZE);
+  SystemLog.SetLogLevel(LogLevel_Warning);
+  SystemLog.Init();
+  SystemConfig.Init();
+  SystemCamera.LoadCameraCfgFromEeprom();
+
+  /* factory cfg is saved on the first start */
+  TEST_CHECK(CFG_FIRST_MCU_START_NAK == EEPROM.read(EEPROM_ADDR_FIRST_MCU_START_FLAG_START));
+
+  /* photo from the stub camera is published in the photo store */
+  SystemCamera.Init();
+  PhotoFrame *frame = SystemCamera.CapturePhoto();
+  TEST_CHECK(NULL != frame);
+  if (NULL != frame) {
+    /* returned photo is the published one, with own reference */
+    PhotoFrame *current = SystemPhotoStore.Acquire();
+    TEST_CHECK(frame == current);
+    SystemPhotoStore.Release(current);
+    TEST_CHECK(frame->Len > 100);
+    TEST_CHECK((0xFF == frame->Buf[0]) && (0xD8 == frame->Buf[1]));
+    TEST_CHECK((frame->Width > 0) && (frame->Height > 0));
+    SystemPhotoStore.Release(frame);
+  }
+
+  /* WEB server returns the same photo */
+  Server_InitWebServer();
+  SystemThumbnail.Init();
+  {
+    AsyncWebServerRequest request("/saved-photo.jpg");
+    std::string body = Test_Get(request);
+    TEST_CHECK(body.size() > 100);
+    TEST_CHECK((body.size() > 2) && (0xFF == (uint8_t)body[0]) && (0xD8 == (uint8_t)body[1]));
+  }
+
+  /* JSON of the stream statistics is valid */
+  JsonDocument doc;
+  TEST_CHECK(!deserializeJson(doc, Stream_GetStatsJson()));
+  TEST_CHECK(false == doc.isNull());
+
+  /* modem sleep stays disabled until the last stream client is disconnected */
+  {
+    wifi_ps_type_t ps = WIFI_PS_NONE;
+    wifi_mode_t mode = WiFi.getMode();
+    WiFiPowerProfile profile = SystemWifiMngt.GetPowerProfile();
+    WiFi.mode(WIFI_STA);
+    SystemWifiMngt.SetPowerProfile(WiFiPowerProfile_Balanced);
+    TEST_CHECK((ESP_OK == esp_wifi_get_ps(&ps)) && (WIFI_PS_MIN_MODEM == ps));
+
+    AsyncJpegStreamResponse *first = new AsyncJpegStreamResponse(&SystemCamera, &SystemLog);
+    AsyncJpegStreamResponse *second = new AsyncJpegStreamResponse(&SystemCamera, &SystemLog);
+    esp_wifi_get_ps(&ps);
+    TEST_CHECK((true == SystemCamera.GetStreamStatus()) && (WIFI_PS_NONE == ps));
+    delete first;
+    esp_wifi_get_ps(&ps);
+    TEST_CHECK((true == SystemCamera.GetStreamStatus()) && (WIFI_PS_NONE == ps));
+    TEST_CHECK(NULL == SystemCamera.CapturePhoto());
+    delete second;
+    esp_wifi_get_ps(&ps);
+    TEST_CHECK((false == SystemCamera.GetStreamStatus()) && (WIFI_PS_MIN_MODEM == ps));
+
+    WiFi.mode(mode);
+    SystemWifiMngt.SetPowerProfile(profile);
+  }
+
+  /* core load without FreeRTOS run-time stats is unknown, not 0 % */
+  System_CoreLoadInit();
+  System_CoreLoadUpdate();
+  TEST_CHECK(-1 == System_GetCoreLoad(0));
+  {
+    AsyncWebServerRequest request("/json_input");
+    JsonDocument input;
+    TEST_CHECK(!deserializeJson(input, String(Test_Get(request).c_str())));
+    TEST_CHECK((false == input["token"].isNull()) && (true == input["core0_load"].isNull()) && (true == input["core1_load"].isNull()));
+  }
+
+  return TEST_RESULT();
+}
+
+/* EOF */
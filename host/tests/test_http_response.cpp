@@ -0,0 +1,287 @@
+/**
+   @file test_http_response.cpp
+
+   @brief Edge cases and fuzz test of the incremental HTTP response parser. Every response is parsed at once,
+          byte by byte and in random fragments, the result must be the same
+
+          test_http_response [count of fuzz iterations] [seed]
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "host_test.h"
+
+#include "http_response.h"
+
+/**
+ * @brief Result of the parsing, compared between the fragmentations
+ */
+struct TestParseResult {
+  HttpParserState State;
+  uint8_t VersionMinor;
+  uint16_t StatusCode;
+  int32_t ContentLength;
+  bool ConnectionClose;
+  uint32_t RetryAfter;
+  size_t Consumed;     ///< count of bytes consumed before the response was complete or invalid
+
+  bool operator==(const TestParseResult &o) const {
+    return (State == o.State) && (VersionMinor == o.VersionMinor) && (StatusCode == o.StatusCode) && (ContentLength == o.ContentLength) &&
+           (ConnectionClose == o.ConnectionClose) && (RetryAfter == o.RetryAfter) && (Consumed == o.Consumed);
+  }
+};
+
+static uint32_t TestRandomState = 1;   ///< state of the xorshift generator
+
+static uint32_t Test_Random() {
+  TestRandomState ^= TestRandomState << 13;
+  TestRandomState ^= TestRandomState >> 17;
+  TestRandomState ^= TestRandomState << 5;
+  return TestRandomState;
+}
+
+/**
+ * @brief Parse the response in fragments. Feed is called with the rest of data, as ReadResponse does
+ *
+ * @param std::string& - response
+ * @param size_t - maximum size of the fragment, 0 = random size
+ * @param bool - connection is closed after the data
+ * @return TestParseResult - result
+ */
+static TestParseResult Test_Parse(const std::string &i_data, size_t i_fragment, bool i_close) {
+  HttpResponseParser parser;
+  size_t offset = 0;
+
+  while ((offset < i_data.size()) && (false == parser.IsComplete()) && (false == parser.IsError())) {
+    size_t len = (i_fragment > 0) ? i_fragment : (1 + (Test_Random() % 64));
+    if (len > (i_data.size() - offset)) {
+      len = i_data.size() - offset;
+    }
+    size_t used = parser.Feed((const uint8_t *)i_data.data() + offset, len);
+    TEST_CHECK(used <= len);
+    offset += used;
+    if (used < len) {
+      /* parser stops only at the end of the response */
+      TEST_CHECK((true == parser.IsComplete()) || (true == parser.IsError()));
+      break;
+    }
+  }
+
+  if (true == i_close) {
+    parser.Finish();
+    TEST_CHECK((true == parser.IsComplete()) || (true == parser.IsError()));
+  }
+
+  /* finished parser does not accept more data */
+  if ((true == parser.IsComplete()) || (true == parser.IsError())) {
+    HttpParserState state = parser.GetState();
+    TEST_CHECK(0 == parser.Feed((const uint8_t *)"HTTP/1.1 500 X\r\n", 16));
+    TEST_CHECK(state == parser.GetState());
+  }
+
+  TEST_CHECK(parser.GetStatusCode() <= 999);
+  TEST_CHECK(parser.GetVersionMinor() <= 9);
+  TEST_CHECK(parser.GetContentLength() >= -1);
+
+  TestParseResult ret = { parser.GetState(), parser.GetVersionMinor(), parser.GetStatusCode(), parser.GetContentLength(),
+                          parser.GetConnectionClose(), parser.GetRetryAfter(), offset };
+  return ret;
+}
+
+/**
+ * @brief Parse the response at once, byte by byte and in random fragments
+ *
+ * @param std::string& - response
+ * @param bool - connection is closed after the data
+ * @return TestParseResult - result of the parsing at once
+ */
+static TestParseResult Test_ParseAll(const std::string &i_data, bool i_close) {
+  TestParseResult whole = Test_Parse(i_data, (i_data.size() > 0) ? i_data.size() : 1, i_close);
+  TestParseResult bytes = Test_Parse(i_data, 1, i_close);
+  TestParseResult random = Test_Parse(i_data, 0, i_close);
+
+  if (!(whole == bytes) || !(whole == random)) {
+    fprintf(stderr, "fragmentation changed the result of: %s\n", i_data.substr(0, 200).c_str());
+    HostTest_Failed++;
+  }
+  return whole;
+}
+
+/**
+ * @brief Responses with known result
+ */
+static void Test_EdgeCases() {
+  TestParseResult r;
+
+  /* typical response of the backend, body is not needed */
+  r = Test_ParseAll("HTTP/1.1 204 No Content\r\nServer: nginx\r\nConnection: close\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (204 == r.StatusCode) && (1 == r.VersionMinor) && (true == r.ConnectionClose));
+
+  /* HTTP/1.0 status line, missed by the previous parser */
+  r = Test_ParseAll("HTTP/1.0 200 OK\r\nContent-Length: 5\r\n\r\nhello", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (200 == r.StatusCode) && (0 == r.VersionMinor) && (5 == r.ContentLength));
+
+  /* data after the complete response are not consumed */
+  std::string pipelined = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nokHTTP/1.1 500 X\r\n\r\n";
+  r = Test_ParseAll(pipelined, false);
+  TEST_CHECK((HttpParserComplete == r.State) && (200 == r.StatusCode) && (pipelined.find("okHTTP") + 2 == r.Consumed));
+
+  /* body is not complete */
+  r = Test_ParseAll("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nhello", false);
+  TEST_CHECK(HttpParserBody == r.State);
+  r = Test_ParseAll("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nhello", true);
+  TEST_CHECK(HttpParserError == r.State);
+
+  /* body without length is ended by connection close */
+  r = Test_ParseAll("HTTP/1.1 200 OK\r\n\r\nbody", false);
+  TEST_CHECK((HttpParserBodyUntilClose == r.State) && (-1 == r.ContentLength));
+  r = Test_ParseAll("HTTP/1.1 200 OK\r\n\r\nbody", true);
+  TEST_CHECK((HttpParserComplete == r.State) && (200 == r.StatusCode));
+
+  /* 304 and Content-Length 0 have no body */
+  r = Test_ParseAll("HTTP/1.1 304 Not Modified\r\nContent-Length: 100\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (304 == r.StatusCode));
+  r = Test_ParseAll("HTTP/1.1 409 Conflict\r\nContent-Length: 0\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (409 == r.StatusCode));
+
+  /* informational response is followed by the final response */
+  r = Test_ParseAll("HTTP/1.1 100 Continue\r\nRetry-After: 9\r\n\r\nHTTP/1.1 503 Busy\r\nRetry-After: 120\r\nContent-Length: 0\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (503 == r.StatusCode) && (120 == r.RetryAfter));
+
+  /* bare LF line endings, case insensitive names, white spaces around the value */
+  r = Test_ParseAll("\r\nHTTP/1.1 429 Too Many\ncontent-LENGTH:\t 3 \nretry-after: 30\nCONNECTION: Close\n\nabc", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (429 == r.StatusCode) && (3 == r.ContentLength) && (30 == r.RetryAfter) && (true == r.ConnectionClose));
+
+  /* Retry-After in the HTTP-date format is ignored */
+  r = Test_ParseAll("HTTP/1.1 503 Busy\r\nRetry-After: Wed, 21 Oct 2015 07:28:00 GMT\r\nContent-Length: 0\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (0 == r.RetryAfter));
+
+  /* status line without reason phrase */
+  r = Test_ParseAll("HTTP/1.1 204\r\n\r\n", false);
+  TEST_CHECK((HttpParserComplete == r.State) && (204 == r.StatusCode));
+
+  /* invalid status lines */
+  const char *invalid_status[] = {
+    "HTTP/2 200 OK\r\n\r\n", "HTTP/1.1 20 OK\r\n\r\n", "HTTP/1.1 2000 OK\r\n\r\n", "HTTP/1.x 200 OK\r\n\r\n",
+    "HTTP/1.1  200 OK\r\n\r\n", "HTTP/1.1 2x0 OK\r\n\r\n", "http/1.1 200 OK\r\n\r\n", "SSH-2.0-OpenSSH\r\n\r\n",
+  };
+  for (const char *data : invalid_status) {
+    r = Test_ParseAll(data, false);
+    TEST_CHECK((HttpParserError == r.State) && (0 == r.StatusCode));
+  }
+
+  /* invalid headers */
+  const char *invalid_headers[] = {
+    "HTTP/1.1 200 OK\r\nno colon\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: 1x\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length:\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: 4294967296\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: 2147483648\r\n\r\n",
+  };
+  for (const char *data : invalid_headers) {
+    r = Test_ParseAll(data, false);
+    TEST_CHECK(HttpParserError == r.State);
+  }
+
+  /* maximum body length */
+  r = Test_ParseAll("HTTP/1.1 200 OK\r\nContent-Length: 2147483647\r\n\r\nabc", false);
+  TEST_CHECK((HttpParserBody == r.State) && (INT32_MAX == r.ContentLength));
+
+  /* long header line is truncated without overflow of the line buffer */
+  std::string long_line = "HTTP/1.1 204 OK\r\nX-Long: " + std::string(HTTP_PARSER_LINE_SIZE * 4, 'a') + "\r\n\r\n";
+  r = Test_ParseAll(long_line, false);
+  TEST_CHECK((HttpParserComplete == r.State) && (204 == r.StatusCode));
+
+  /* headers are limited, endless headers can not block the upload */
+  std::string endless = "HTTP/1.1 200 OK\r\n";
+  while (endless.size() <= HTTP_PARSER_MAX_HEADER_SIZE) {
+    endless += "X-Header: value\r\n";
+  }
+  r = Test_ParseAll(endless, false);
+  TEST_CHECK((HttpParserError == r.State) && (HTTP_PARSER_MAX_HEADER_SIZE + 1 == r.Consumed));
+
+  /* empty input and connection closed before the status line */
+  r = Test_ParseAll("", false);
+  TEST_CHECK((HttpParserStatusLine == r.State) && (0 == r.StatusCode));
+  r = Test_ParseAll("HTTP/1.1 20", true);
+  TEST_CHECK((HttpParserError == r.State) && (0 == r.StatusCode));
+
+  /* parser is reusable after reset */
+  HttpResponseParser parser;
+  parser.Feed((const uint8_t *)"garbage\r\n", 9);
+  TEST_CHECK(true == parser.IsError());
+  parser.Reset();
+  parser.Feed((const uint8_t *)"HTTP/1.1 204 OK\r\n\r\n", 19);
+  TEST_CHECK((true == parser.IsComplete()) && (204 == parser.GetStatusCode()) && (-1 == parser.GetContentLength()));
+}
+
+/**
+ * @brief Random responses. Valid responses are mutated, random bytes are inserted
+ *
+ * @param uint32_t - count of iterations
+ */
+static void Test_Fuzz(uint32_t i_count) {
+  static const char *seeds[] = {
+    "HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n",
+    "HTTP/1.0 200 OK\r\nContent-Length: 5\r\n\r\nhello",
+    "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 503 Busy\r\nRetry-After: 120\r\nContent-Length: 0\r\n\r\n",
+    "HTTP/1.1 200 OK\r\n\r\nbody until close",
+    "HTTP/1.1 401 Unauthorized\r\nContent-Type: application/json\r\nContent-Length: 17\r\n\r\n{\"message\":\"no\"}",
+  };
+  static const char *tokens[] = { "\r\n", "\n", "\r", ":", " ", "HTTP/1.1 ", "Content-Length: ", "Retry-After: ", "Connection: close", "4294967295", "0", "100 " };
+
+  for (uint32_t i = 0; i < i_count; i++) {
+    std::string data = seeds[Test_Random() % (sizeof(seeds) / sizeof(seeds[0]))];
+    uint32_t mutations = 1 + (Test_Random() % 8);
+
+    for (uint32_t m = 0; m < mutations; m++) {
+      size_t pos = (data.size() > 0) ? (Test_Random() % (data.size() + 1)) : 0;
+      switch (Test_Random() % 5) {
+      case 0:
+        if (pos < data.size()) {
+          data[pos] = (char)(Test_Random() & 0xFF);
+        }
+        break;
+      case 1:
+        if (pos < data.size()) {
+          data.erase(pos, 1 + (Test_Random() % 8));
+        }
+        break;
+      case 2:
+        data.insert(pos, tokens[Test_Random() % (sizeof(tokens) / sizeof(tokens[0]))]);
+        break;
+      case 3:
+        data.insert(pos, std::string(1 + (Test_Random() % (HTTP_PARSER_LINE_SIZE * 2)), (char)(Test_Random() & 0xFF)));
+        break;
+      default:
+        data.insert(pos, data.substr(pos, Test_Random() % 32));
+        break;
+      }
+    }
+
+    Test_ParseAll(data, (0 == (Test_Random() & 1)));
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t count = (argc > 1) ? strtoul(argv[1], NULL, 10) : 20000;
+  TestRandomState = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0x2545F491;
+  if (0 == TestRandomState) {
+    TestRandomState = 1;
+  }
+
+  Test_EdgeCases();
+  Test_Fuzz(count);
+
+  return TEST_RESULT();
+}
+
+/* EOF */
@@ -0,0 +1,171 @@
+/**
+   @file test_thumbnail.cpp
+
+   @brief Test of the thumbnail. Colors of the photo are kept through the decoder and encoder,
+          ETag is changed by new thumbnail and by reboot, /thumb.jpg is revalidated by ETag,
+          response in progress is not changed by new thumbnail
+
+   @author Miroslav Pivovarsky
+   Contact: miroslav.pivovarsky@gmail.com
+
+   @bug: no know bug
+*/
+
+#include <vector>
+
+#include "host_test.h"
+
+#include "mcu_cfg.h"
+#include "log.h"
+#include "cfg.h"
+#include "thumbnail.h"
+#include "server.h"
+
+#define TEST_WIDTH   640   ///< width of the photo [px]
+#define TEST_HEIGHT  480   ///< height of the photo [px]
+
+/**
+ * @brief Encode photo with the solid color
+ *
+ * @param uint8_t - red
+ * @param uint8_t - green
+ * @param uint8_t - blue
+ * @return std::vector<uint8_t> - JPEG
+ */
+static std::vector<uint8_t> Test_SolidPhoto(uint8_t i_r, uint8_t i_g, uint8_t i_b) {
+  /* camera RGB888 layout is B,G,R */
+  std::vector<uint8_t> bgr((size_t)TEST_WIDTH * TEST_HEIGHT * 3);
+  for (size_t i = 0; i < bgr.size(); i += 3) {
+    bgr[i] = i_b;
+    bgr[i + 1] = i_g;
+    bgr[i + 2] = i_r;
+  }
+
+  uint8_t *jpeg = NULL;
+  size_t len = 0;
+  TEST_CHECK(true == fmt2jpg(bgr.data(), bgr.size(), TEST_WIDTH, TEST_HEIGHT, PIXFORMAT_RGB888, 90, &jpeg, &len));
+  std::vector<uint8_t> ret(jpeg, jpeg + len);
+  free(jpeg);
+  return ret;
+}
+
+/**
+ * @brief Decode thumbnail and check color of the center pixel
+ *
+ * @param std::string& - thumbnail JPEG
+ * @param uint8_t - expected red
+ * @param uint8_t - expected green
+ * @param uint8_t - expected blue
+ */
+static void Test_CheckColor(const std::string &i_jpeg, uint8_t i_r, uint8_t i_g, uint8_t i_b) {
+  std::vector<uint8_t> bgr((size_t)THUMB_MAX_WIDTH * THUMB_MAX_HEIGHT * 3);
+  TEST_CHECK(true == jpg2rgb888((const uint8_t *)i_jpeg.data(), i_jpeg.size(), bgr.data(), JPG_SCALE_NONE));
+
+  /* thumbnail of 640x480 photo is 320x240 */
+  size_t center = (((size_t)120 * 320) + 160) * 3;
+  int b = bgr[center];
+  int g = bgr[center + 1];
+  int r = bgr[center + 2];
+  TEST_CHECK(abs(r - i_r) < 16);
+  TEST_CHECK(abs(g - i_g) < 16);
+  TEST_CHECK(abs(b - i_b) < 16);
+  if ((abs(r - i_r) >= 16) || (abs(g - i_g) >= 16) || (abs(b - i_b) >= 16)) {
+    fprintf(stderr, "thumbnail color R%d G%d B%d, expected R%d G%d B%d\n", r, g, b, i_r, i_g, i_b);
+  }
+}
+
+/**
+ * @brief Get /thumb.jpg
+ *
+ * @param String - If-None-Match header, empty = header is not sent
+ * @param int* - response code
+ * @param String* - ETag of the response
+ * @return std::string - body
+ */
+static std::string Test_GetThumb(String i_etag, int *o_code, String *o_etag) {
+  AsyncWebServerRequest request("/thumb.jpg");
+  if (i_etag.length() > 0) {
+    request.AddHeader("If-None-Match", i_etag);
+  }
+  TEST_CHECK(true == server.HostDispatch(&request));
+  AsyncWebServerResponse *response = request.GetResponse();
+  TEST_CHECK(NULL != response);
+  if (NULL == response) {
+    return std::string();
+  }
+
+  *o_code = response->GetCode();
+  *o_etag = response->GetHeader("ETag");
+  return response->HostRead();
+}
+
+int main() {
+  EEPROM.begin(EEPROM_SIZE);
+  SystemLog.SetLogLevel(LogLevel_Error);
+  SystemLog.Init();
+  SystemConfig.Init();
+  Server_InitWebServer();
+  SystemThumbnail.Init();
+
+  int code = 0;
+  String etag;
+  Test_GetThumb("", &code, &etag);
+  TEST_CHECK(404 == code);
+
+  /* colors are not swapped */
+  std::vector<uint8_t> red = Test_SolidPhoto(230, 20, 20);
+  SystemThumbnail.Create(red.data(), red.size(), TEST_WIDTH);
+  TEST_CHECK(true == SystemThumbnail.GetAvailable());
+  std::string body = Test_GetThumb("", &code, &etag);
+  TEST_CHECK((200 == code) && (etag == SystemThumbnail.GetEtag()));
+  Test_CheckColor(body, 230, 20, 20);
+
+  /* not modified thumbnail is revalidated */
+  std::string cached = Test_GetThumb(etag, &code, &etag);
+  TEST_CHECK((304 == code) && (true == cached.empty()));
+
+  /* new thumbnail has new ETag */
+  String etag_red = etag;
+  std::vector<uint8_t> blue = Test_SolidPhoto(20, 40, 220);
+  SystemThumbnail.Create(blue.data(), blue.size(), TEST_WIDTH);
+  body = Test_GetThumb(etag_red, &code, &etag);
+  TEST_CHECK((200 == code) && (etag != etag_red));
+  Test_CheckColor(body, 20, 40, 220);
+
+  /* response holds the thumbnail, new thumbnail does not overwrite sent data */
+  {
+    AsyncWebServerRequest request("/thumb.jpg");
+    TEST_CHECK(true == server.HostDispatch(&request));
+    AsyncWebServerResponse *response = request.GetResponse();
+    TEST_CHECK(NULL != response);
+    String etag_blue = SystemThumbnail.GetEtag();
+    SystemThumbnail.Create(red.data(), red.size(), TEST_WIDTH);
+    if (NULL != response) {
+      TEST_CHECK(etag_blue == response->GetHeader("ETag"));
+      Test_CheckColor(response->HostRead(), 20, 40, 220);
+    }
+    body = Test_GetThumb("", &code, &etag);
+    Test_CheckColor(body, 230, 20, 20);
+  }
+
+  /* references of the finished responses are released, buffers are reused */
+  for (uint8_t i = 0; i < (PHOTO_STORE_FRAMES * 2); i++) {
+    String etag_last = SystemThumbnail.GetEtag();
+    SystemThumbnail.Create(blue.data(), blue.size(), TEST_WIDTH);
+    Test_GetThumb("", &code, &etag);
+    TEST_CHECK((200 == code) && (etag != etag_last));
+  }
+
+  /* thumbnail after reboot has the same generation, but different ETag */
+  Thumbnail rebooted(&SystemLog);
+  rebooted.Init();
+  rebooted.Create(red.data(), red.size(), TEST_WIDTH);
+  Thumbnail first(&SystemLog);
+  first.Init();
+  first.Create(red.data(), red.size(), TEST_WIDTH);
+  TEST_CHECK(rebooted.GetEtag() != first.GetEtag());
+
+  return TEST_RESULT();
+}
+
+/* EOF */
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Local stand-in of the Prusa Connect backend for the camera uploads.
+
+Endpoints PUT /c/snapshot and PUT /c/info are validated the same way as the camera uses them:
+fingerprint and token headers, Content-Length, JPEG/JSON body. Latency, bandwidth and error
+responses are configurable, GET /stats returns the statistics of the received uploads.
+
+Camera firmware is pointed to the server by the Prusa Connect hostname setting and by
+HOST_PORT=<port> and HOST_TLS_ENABLE=false in mcu_cfg.h (the host build sets them in host/CMakeLists.txt).
+
+    python3 tools/prusa_connect_standin.py --port 18080 --latency 200 --bandwidth 200000 --error 503:0.1 --error 409:0.05
+"""
+
+import argparse
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlsplit
+
+PATH_SNAPSHOT = "/c/snapshot"
+PATH_INFO = "/c/info"
+READ_CHUNK = 4096
+
+
+class Stats:
+    """Statistics of the received requests, shared by the handler threads"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.clear()
+
+    def clear(self):
+        self.requests = 0
+        self.snapshots = 0
+        self.infos = 0
+        self.bytes = 0
+        self.codes = {}
+        self.injected = 0
+        self.durations = []
+
+    def add(self, path, code, length, injected, duration):
+        with self.lock:
+            self.requests += 1
+            if PATH_SNAPSHOT == path:
+                self.snapshots += 1
+            elif PATH_INFO == path:
+                self.infos += 1
+            self.bytes += length
+            self.codes[str(code)] = self.codes.get(str(code), 0) + 1
+            if injected:
+                self.injected += 1
+            self.durations.append(duration)
+
+    def to_dict(self):
+        with self.lock:
+            durations = sorted(self.durations)
+            return {
+                "requests": self.requests,
+                "snapshots": self.snapshots,
+                "infos": self.infos,
+                "bytes": self.bytes,
+                "codes": dict(self.codes),
+                "injected_errors": self.injected,
+                "duration_ms_p50": percentile(durations, 50),
+                "duration_ms_p90": percentile(durations, 90),
+                "duration_ms_max": durations[-1] if durations else 0,
+            }
+
+
+def percentile(values, pct):
+    """Nearest-rank percentile of the sorted list"""
+    if not values:
+        return 0
+    index = max(0, min(len(values) - 1, (len(values) * pct + 99) // 100 - 1))
+    return values[index]
+
+
+class StandinHandler(BaseHTTPRequestHandler):
+    """Handler of the camera requests. Configuration is in the server object"""
+
+    protocol_version = "HTTP/1.0"
+    server_version = "PrusaConnectStandin/1.0"
+
+    def log_message(self, fmt, *args):
+        if self.server.cfg.verbose:
+            sys.stderr.write("standin: " + (fmt % args) + "\n")
+
+    def send_reply(self, code, text="", headers=None):
+        body = text.encode()
+        self.send_response(code)
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.send_header("Connection", "close")
+        self.end_headers()
+        if body:
+            self.wfile.write(body)
+
+    def read_body(self, length):
+        """Read request body, throttled to the configured bandwidth"""
+        cfg = self.server.cfg
+        data = bytearray()
+        start = time.monotonic()
+        while len(data) < length:
+            chunk = self.rfile.read(min(READ_CHUNK, length - len(data)))
+            if not chunk:
+                break
+            data += chunk
+            if cfg.bandwidth > 0:
+                delay = (len(data) / cfg.bandwidth) - (time.monotonic() - start)
+                if delay > 0:
+                    time.sleep(delay)
+        return bytes(data)
+
+    def validate(self, path, data):
+        """Check the request the same way as the backend. Returns error code and message, or None"""
+        cfg = self.server.cfg
+        fingerprint = self.headers.get("fingerprint", "")
+        token = self.headers.get("token", "")
+        content_type = self.headers.get("Content-Type", "")
+
+        if not fingerprint or len(fingerprint) > 80:
+            return 400, "invalid fingerprint"
+        if cfg.fingerprint and fingerprint != cfg.fingerprint:
+            return 403, "unknown fingerprint"
+        if not token:
+            return 401, "missing token"
+        if cfg.token and token != cfg.token:
+            return 403, "invalid token"
+
+        if PATH_SNAPSHOT == path:
+            if not content_type.startswith("image/jp"):
+                return 400, "invalid content type " + content_type
+            if (len(data) < 4) or (data[:2] != b"\xff\xd8") or (data[-2:] != b"\xff\xd9"):
+                return 400, "body is not JPEG"
+        else:
+            if "application/json" != content_type:
+                return 400, "invalid content type " + content_type
+            try:
+                json.loads(data.decode())
+            except ValueError:
+                return 400, "body is not JSON"
+        return None
+
+    def do_PUT(self):
+        start = time.monotonic()
+        cfg = self.server.cfg
+        path = urlsplit(self.path).path
+        if path not in (PATH_SNAPSHOT, PATH_INFO):
+            self.send_reply(404, "not found")
+            return
+
+        length_header = self.headers.get("Content-Length")
+        if length_header is None or not length_header.strip().isdigit():
+            self.send_reply(411, "missing Content-Length")
+            self.server.stats.add(path, 411, 0, False, 0)
+            return
+        length = int(length_header)
+        data = self.read_body(length)
+
+        code, text, injected, headers = 204, "", False, {}
+        if len(data) != length:
+            code, text = 400, "body is shorter than Content-Length: %d/%d" % (len(data), length)
+        else:
+            error = self.validate(path, data)
+            if error is not None:
+                code, text = error
+            else:
+                for error_code, probability in cfg.error:
+                    if self.server.random.random() < probability:
+                        code, text, injected = error_code, "injected error", True
+                        if (503 == code or 429 == code) and cfg.retry_after > 0:
+                            headers["Retry-After"] = str(cfg.retry_after)
+                        break
+
+        if cfg.latency > 0:
+            time.sleep(cfg.latency / 1000.0)
+        self.send_reply(code, text, headers)
+
+        duration = int((time.monotonic() - start) * 1000)
+        self.server.stats.add(path, code, len(data), injected, duration)
+        self.log_message("%s %d bytes -> %d %s (%d ms)", path, len(data), code, text, duration)
+
+    def do_GET(self):
+        url = urlsplit(self.path)
+        if "/stats" != url.path:
+            self.send_reply(404, "not found")
+            return
+        text = json.dumps(self.server.stats.to_dict())
+        if "clear" in url.query:
+            self.server.stats.clear()
+        self.send_reply(200, text, {"Content-Type": "application/json"})
+
+
+def parse_error(value):
+    """Parse CODE:PROBABILITY of the injected error"""
+    try:
+        code, probability = value.split(":")
+        return int(code), float(probability)
+    except ValueError:
+        raise argparse.ArgumentTypeError("expected CODE:PROBABILITY, e.g. 503:0.1")
+
+
+def build_parser():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1", help="listen address")
+    parser.add_argument("--port", type=int, default=18080, help="listen port, HOST_PORT of the firmware")
+    parser.add_argument("--token", default="", help="expected token, any non-empty token is accepted when empty")
+    parser.add_argument("--fingerprint", default="", help="expected fingerprint, any valid fingerprint is accepted when empty")
+    parser.add_argument("--latency", type=int, default=0, help="delay before the response [ms]")
+    parser.add_argument("--bandwidth", type=int, default=0, help="limit of the upload bandwidth [B/s], 0 = unlimited")
+    parser.add_argument("--error", type=parse_error, action="append", default=[], help="inject error CODE with PROBABILITY, repeatable")
+    parser.add_argument("--retry-after", type=int, default=0, help="Retry-After header of injected 429/503 [s]")
+    parser.add_argument("--seed", type=int, default=None, help="seed of the error injection")
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    return parser
+
+
+def create_server(cfg):
+    """Create the server. Used by the benchmark harness, which runs it in a thread"""
+    server = ThreadingHTTPServer((cfg.host, cfg.port), StandinHandler)
+    server.daemon_threads = True
+    server.cfg = cfg
+    server.stats = Stats()
+    server.random = random.Random(cfg.seed)
+    return server
+
+
+def main():
+    cfg = build_parser().parse_args()
+    server = create_server(cfg)
+    sys.stderr.write("Prusa Connect stand-in on http://%s:%d\n" % (cfg.host, cfg.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print(json.dumps(server.stats.to_dict(), indent=2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
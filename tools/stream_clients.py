@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Multi-client reader of the camera MJPEG stream.
+
+N clients read /stream.mjpg at the same time, each with its own consumption rate, so slow and fast
+viewers can be mixed. Every part of the multipart stream is checked (Content-Length, JPEG SOI/EOI).
+Report contains FPS, bytes per second and frame gaps per client, and /json_stream_stats of the camera
+(frames, filler time without the yield delays, capture wait and yield time per frame, copies per byte),
+which is cleared at the start of the run.
+
+    python3 tools/stream_clients.py --url http://192.168.0.20 --clients 3 --rate 0 --rate 200000 --rate 50000 --duration 30
+
+With STREAM_SYNTHETIC_SOURCE enabled in mcu_cfg.h, the camera replays the same JPEG frames from
+/synthetic on the micro SD card, so runs before and after a change are comparable.
+
+Without the camera, host/bench/stream_bench.cpp replays JPEG files with simulated clients in the host build:
+
+    HOST_CAMERA_DIR=host/tests/fixtures/static build/stream_bench 3 100
+"""
+
+import argparse
+import base64
+import http.client
+import json
+import sys
+import threading
+import time
+from urllib.parse import urlsplit
+
+
+class StreamClient(threading.Thread):
+    """One viewer of the stream. Rate 0 = reads as fast as the camera sends"""
+
+    def __init__(self, index, cfg, rate, stop):
+        super().__init__(daemon=True)
+        self.index = index
+        self.cfg = cfg
+        self.rate = rate
+        self.stop = stop
+        self.frames = 0
+        self.bytes = 0
+        self.invalid = 0
+        self.gaps = []
+        self.first_frame_ms = None
+        self.error = ""
+        self.elapsed = 0.0
+
+    def run(self):
+        url = urlsplit(self.cfg.url)
+        start = time.monotonic()
+        try:
+            conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=self.cfg.timeout)
+            conn.request("GET", "/stream.mjpg", headers=auth_headers(self.cfg))
+            resp = conn.getresponse()
+            if 200 != resp.status:
+                self.error = "HTTP %d" % resp.status
+                return
+            self.read_parts(resp, start)
+            conn.close()
+        except (OSError, http.client.HTTPException) as err:
+            self.error = str(err)
+        finally:
+            self.elapsed = time.monotonic() - start
+
+    def read_parts(self, resp, start):
+        last = None
+        while not self.stop.is_set():
+            line = resp.readline()
+            if not line:
+                self.error = "stream closed by camera"
+                return
+            if not line.startswith(b"--"):
+                continue
+
+            length = -1
+            while True:
+                header = resp.readline()
+                if not header:
+                    self.error = "stream closed by camera"
+                    return
+                if header in (b"\r\n", b"\n"):
+                    break
+                name, _, value = header.decode("latin-1").partition(":")
+                if "content-length" == name.strip().lower():
+                    length = int(value.strip())
+            if length < 0:
+                self.invalid += 1
+                continue
+
+            data = resp.read(length)
+            now = time.monotonic()
+            if (len(data) != length) or (data[:2] != b"\xff\xd8") or (data[-2:] != b"\xff\xd9"):
+                self.invalid += 1
+            self.frames += 1
+            self.bytes += len(data)
+            if last is None:
+                self.first_frame_ms = int((now - start) * 1000)
+            else:
+                self.gaps.append(now - last)
+            last = now
+
+            if self.rate > 0:
+                delay = (self.bytes / self.rate) - (now - start)
+                if delay > 0:
+                    time.sleep(delay)
+
+    def report(self):
+        gaps = sorted(self.gaps)
+        return {
+            "client": self.index,
+            "rate_limit_bps": self.rate,
+            "frames": self.frames,
+            "invalid_frames": self.invalid,
+            "fps": round(self.frames / self.elapsed, 2) if self.elapsed > 0 else 0,
+            "bytes_per_s": int(self.bytes / self.elapsed) if self.elapsed > 0 else 0,
+            "first_frame_ms": self.first_frame_ms,
+            "gap_ms_p50": int(gaps[len(gaps) // 2] * 1000) if gaps else 0,
+            "gap_ms_max": int(gaps[-1] * 1000) if gaps else 0,
+            "error": self.error,
+        }
+
+
+def auth_headers(cfg):
+    if not cfg.user:
+        return {}
+    token = base64.b64encode(("%s:%s" % (cfg.user, cfg.password)).encode()).decode()
+    return {"Authorization": "Basic " + token}
+
+
+def get_json(cfg, path):
+    """GET route of the camera WEB server with JSON response"""
+    url = urlsplit(cfg.url)
+    conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=cfg.timeout)
+    try:
+        conn.request("GET", path, headers=auth_headers(cfg))
+        resp = conn.getresponse()
+        body = resp.read()
+        return json.loads(body.decode()) if 200 == resp.status else {"error": "HTTP %d" % resp.status}
+    except (OSError, ValueError, http.client.HTTPException) as err:
+        return {"error": str(err)}
+    finally:
+        conn.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--url", required=True, help="URL of the camera, e.g. http://192.168.0.20")
+    parser.add_argument("--clients", type=int, default=2, help="count of the clients")
+    parser.add_argument("--rate", type=int, action="append", default=[], help="consumption rate of the client [B/s], 0 = unlimited. Repeatable, last value is used for the rest of clients")
+    parser.add_argument("--duration", type=float, default=20.0, help="duration of the run [s]")
+    parser.add_argument("--timeout", type=float, default=10.0, help="socket timeout [s]")
+    parser.add_argument("--user", default="", help="user name of the WEB authentication")
+    parser.add_argument("--password", default="", help="password of the WEB authentication")
+    cfg = parser.parse_args()
+
+    rates = cfg.rate or [0]
+    get_json(cfg, "/json_stream_stats?clear=1")
+
+    stop = threading.Event()
+    clients = [StreamClient(i, cfg, rates[min(i, len(rates) - 1)], stop) for i in range(cfg.clients)]
+    for client in clients:
+        client.start()
+    time.sleep(cfg.duration)
+    stop.set()
+    for client in clients:
+        client.join(cfg.timeout)
+
+    report = {
+        "clients": [client.report() for client in clients],
+        "camera": get_json(cfg, "/json_stream_stats"),
+    }
+    print(json.dumps(report, indent=2))
+
+    failed = [c for c in clients if (c.error and "stream closed by camera" != c.error) or (0 == c.frames) or c.invalid]
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
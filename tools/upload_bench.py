@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Benchmark of the camera uploads against the local Prusa Connect stand-in.
+
+The stand-in server (prusa_connect_standin.py) runs in this process, the host build of the firmware
+(host/bench/upload_bench.cpp) drives the PrusaConnect class against it. Report contains the latency
+distribution, throughput and heap churn seen by the firmware, and the statistics of the server.
+
+    cmake -S host -B build && cmake --build build
+    python3 tools/upload_bench.py --bench build/upload_bench --photos 50 --latency 150 --bandwidth 500000 --error 503:0.1
+
+--check returns non-zero exit code when the firmware and the server do not agree on the uploads.
+When one error is injected with probability 1, --check verifies the retry policy of the firmware too:
+class of the error, count of retries and the last retry delay (Retry-After, or backoff of mcu_cfg.h)
+
+    python3 tools/upload_bench.py --bench build/upload_bench --photos 3 --info-every 0 --error 503:1 --retry-after 7 --check
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import prusa_connect_standin  # noqa: E402
+
+MCU_CFG = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "ESP32_PrusaConnectCam", "mcu_cfg.h")
+
+
+def read_retry_cfg():
+    """Retry constants UPLOAD_RETRY_* of the firmware, the check follows mcu_cfg.h"""
+    with open(MCU_CFG, encoding="utf-8") as f:
+        return {name: int(value) for name, value in re.findall(r"#define\s+UPLOAD_RETRY_(\w+)\s+(\d+)", f.read())}
+
+
+def check_retry(cfg, firmware):
+    """Retry policy of the firmware after the same error on every upload. Returns list of failed checks"""
+    code = cfg.error[0][0]
+    retry = read_retry_cfg()
+    errors = []
+    if code in (429, 503):
+        error_class, base = "throttle", retry["BASE_THROTTLE"]
+    elif 300 <= code < 500:
+        error_class, base = "rejected", 0
+    else:
+        error_class, base = "server", retry["BASE_SERVER"]
+
+    if firmware["errors"].get(error_class) != cfg.photos:
+        errors.append("firmware classified errors as %s, expected %d x %s" % (firmware["errors"], cfg.photos, error_class))
+    if firmware["retry_error"] != error_class:
+        errors.append("last retry error is %s, expected %s" % (firmware["retry_error"], error_class))
+
+    delay = firmware["retry_delay_last_ms"]
+    if "rejected" == error_class:
+        # retry does not help, regular interval is used
+        if (0 != firmware["retries"]) or (0 != delay) or (-1 != firmware["retry_in_ms"]):
+            errors.append("rejected upload was scheduled for retry: %d retries, delay %d ms" % (firmware["retries"], delay))
+        return errors
+
+    if firmware["retries"] != cfg.photos:
+        errors.append("firmware scheduled %d retries, expected %d" % (firmware["retries"], cfg.photos))
+    if ("throttle" == error_class) and (cfg.retry_after > 0):
+        expected = min(cfg.retry_after, retry["AFTER_MAX"]) * 1000
+        low, high = expected, expected
+    else:
+        # jittered exponential backoff of the last attempt
+        backoff = min(base << min(cfg.photos - 1, 16), retry["MAX_DELAY"])
+        low, high = backoff // 2, backoff
+    if not low <= delay <= high:
+        errors.append("last retry delay %d ms, expected %d-%d ms" % (delay, low, high))
+    if not 0 <= firmware["retry_in_ms"] <= delay:
+        errors.append("retry deadline in %d ms, expected 0-%d ms" % (firmware["retry_in_ms"], delay))
+    return errors
+
+
+def main():
+    parser = prusa_connect_standin.build_parser()
+    parser.description = __doc__
+    parser.add_argument("--bench", required=True, help="path to the upload_bench binary of the host build")
+    parser.add_argument("--photos", type=int, default=20, help="count of uploaded photos")
+    parser.add_argument("--info-every", type=int, default=10, help="device information is sent after every N photos")
+    parser.add_argument("--check", action="store_true", help="verify the statistics of the firmware against the server")
+    cfg = parser.parse_args()
+    if not cfg.token:
+        cfg.token = "standin-token"
+
+    server = prusa_connect_standin.create_server(cfg)
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+
+    env = dict(os.environ)
+    env.setdefault("HOST_SD_DIR", "none")
+    result = subprocess.run([cfg.bench, cfg.host, cfg.token, str(cfg.photos), str(cfg.info_every)],
+                            stdout=subprocess.PIPE, env=env, check=False, timeout=600)
+    server.shutdown()
+    if 0 != result.returncode:
+        sys.stderr.write("upload_bench failed with exit code %d\n" % result.returncode)
+        return 1
+
+    bench = json.loads(result.stdout.decode().strip().splitlines()[-1])
+    report = {"bench": bench, "server": server.stats.to_dict()}
+    print(json.dumps(report, indent=2))
+
+    if cfg.check:
+        firmware = bench["firmware"]
+        stats = report["server"]
+        infos = (cfg.photos // cfg.info_every) if cfg.info_every > 0 else 0
+        errors = []
+        if stats["snapshots"] != cfg.photos:
+            errors.append("server received %d photos, expected %d" % (stats["snapshots"], cfg.photos))
+        if stats["infos"] != infos:
+            errors.append("server received %d infos, expected %d" % (stats["infos"], infos))
+        if firmware["count"] != stats["requests"]:
+            errors.append("firmware counted %d uploads, server %d" % (firmware["count"], stats["requests"]))
+        if firmware["failed"] != stats["requests"] - stats["codes"].get("204", 0):
+            errors.append("firmware counted %d failed uploads, server %s" % (firmware["failed"], stats["codes"]))
+        if (not cfg.error) and (bench["photos_ok"] != cfg.photos):
+            errors.append("%d of %d photos were accepted" % (bench["photos_ok"], cfg.photos))
+        if (1 == len(cfg.error)) and (cfg.error[0][1] >= 1.0):
+            if bench["photos_ok"] != 0:
+                errors.append("%d photos were accepted, all uploads have to fail" % bench["photos_ok"])
+            errors.extend(check_retry(cfg, firmware))
+        for error in errors:
+            sys.stderr.write("check failed: %s\n" % error)
+        if errors:
+            return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -86,6 +86,7 @@ function get_data(val) {
 
 			if (val == "system") {
 				$("#uptime").text(obj.uptime);
+				$("#sd_health").text(obj.sd_health);
 				$("#sw_ver").text(obj.sw_ver);
 				$("#sw_build").text(obj.sw_build);
 				$("#last_upload_status").text(obj.last_upload_status);
@@ -138,6 +139,8 @@ var OpenImageclickCount = 0;
 function openImage() {
 	var img = document.getElementById("photo");
 	if (OpenImageclickCount % 2 == 0) {
+		/* preview is the thumbnail, full resolution photo is loaded only for the enlarged view */
+		img.src = "saved-photo.jpg";
 		img.style.position = "fixed";
 		img.style.top = "5%";
 		img.style.left = "5%";
@@ -153,6 +156,7 @@ function openImage() {
 		img.style.width = "";
 		img.style.height = "";
 		img.style.zIndex = "";
+		img.src = "thumb.jpg";
 	}
 	OpenImageclickCount++;
 }